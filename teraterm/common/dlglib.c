@@ -130,7 +130,7 @@ void InitDlgProgress(HWND HDlg, int id_Progress, int *CurProgStat) {
 	return;
 }
 
-void SetDlgPercent(HWND HDlg, int id_Item, int id_Progress, LONG a, LONG b, int *p)
+void SetDlgPercent(HWND HDlg, int id_Item, int id_Progress, unsigned long long a, unsigned long long b, int *p)
 {
 	// 20MBȏ̃t@CAbv[h悤ƂƁAbuffer overflow
 	// ւ̑ΏB(2005.3.18 yutaka)
@@ -153,7 +153,7 @@ void SetDlgPercent(HWND HDlg, int id_Item, int id_Progress, LONG a, LONG b, int
 	}
 }
 
-void SetDlgTime(HWND HDlg, int id_Item, DWORD stime, int bytes)
+void SetDlgTime(HWND HDlg, int id_Item, DWORD stime, unsigned long long bytes)
 {
 	static int prev_elapsed;
 	int elapsed, rate;
@@ -172,7 +172,7 @@ void SetDlgTime(HWND HDlg, int id_Item, DWORD stime, int bytes)
 	}
 	prev_elapsed = elapsed;
 
-	rate = bytes / elapsed;
+	rate = (int)(bytes / elapsed);
 	if (rate < 1200) {
 		_snwprintf_s(buff, _countof(buff), _TRUNCATE, L"%d:%02d (%dBytes/s)", elapsed / 60, elapsed % 60, rate);
 	}
@@ -43,8 +43,8 @@ void ShowDlgItem(HWND HDlg, int FirstId, int LastId);
 void SetRB(HWND HDlg, int R, int FirstId, int LastId);
 void GetRB(HWND HDlg, LPWORD R, int FirstId, int LastId);
 void SetDlgNum(HWND HDlg, int id_Item, LONG Num);
-void SetDlgPercent(HWND HDlg, int id_Item, int id_Progress, LONG a, LONG b, int *prog);
-void SetDlgTime(HWND HDlg, int id_Item, DWORD elapsed, int bytes);
+void SetDlgPercent(HWND HDlg, int id_Item, int id_Progress, unsigned long long a, unsigned long long b, int *prog);
+void SetDlgTime(HWND HDlg, int id_Item, DWORD elapsed, unsigned long long bytes);
 void SetDropDownList(HWND HDlg, int Id_Item, const char *List[], int nsel);
 void SetDropDownListW(HWND HDlg, int Id_Item, const wchar_t *List[], int nsel);
 LONG GetCurSel(HWND HDlg, int Id_Item);
@@ -362,6 +362,7 @@
 #define HlpMacroCommandRotateright      92121
 #define HlpMacroCommandScprecv          92131
 #define HlpMacroCommandScpsend          92132
+#define HlpMacroCommandScpsendstatus    92226
 #define HlpMacroCommandSend             92074
 #define HlpMacroCommandSendbinary       92218
 #define HlpMacroCommandSendbreak        92075
@@ -392,6 +393,9 @@
 #define HlpMacroCommandSetsync          92084
 #define HlpMacroCommandSettime          92085
 #define HlpMacroCommandSettitle         92086
+#define HlpMacroCommandSftpget          92224
+#define HlpMacroCommandSftpput          92225
+#define HlpMacroCommandSftpstatus       92227
 #define HlpMacroCommandShow             92087
 #define HlpMacroCommandShowtt           92088
 #define HlpMacroCommandSprintf          92117
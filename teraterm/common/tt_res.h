@@ -32,6 +32,7 @@
 #define IDD_TABSHEET_FONT               129
 #define IDI_TTERM_FLAT                  130
 #define IDI_VT_FLAT                     131
+#define IDD_FIND_DIALOG                 132
 #define IDR_TEKMENU                     1000
 #define IDC_EDIT_FULLPATH               1001
 #define IDC_FULLPATH_LABEL              1002
@@ -253,6 +254,12 @@
 #define IDC_FILE_DIR_SELECT             2629
 #define IDC_GENUILANG                   2630
 #define IDC_GENUILANG_LABEL             2631
+#define IDC_FIND_EDIT                   2632
+#define IDC_FIND_REGEX                  2633
+#define IDC_FIND_MATCHCASE              2634
+#define IDC_FIND_NEXT                   2635
+#define IDC_FIND_STATUS                 2636
+#define IDC_FIND_LABEL                  2637
 #define ID_ACC_SENDBREAK                50001
 #define ID_ACC_COPY                     50002
 #define ID_ACC_NEWCONNECTION            50003
@@ -304,6 +311,7 @@
 #define ID_EDIT_CANCELSELECT            50270
 #define ID_EDIT_SELECTSCREEN            50280
 #define ID_EDIT_SELECTALL               50290
+#define ID_EDIT_FIND                    50295
 #define ID_SETUP_TERMINAL               50310
 #define ID_SETUP_WINDOW                 50320
 #define ID_SETUP_FONT                   50330
@@ -349,9 +357,9 @@
 #ifdef APSTUDIO_INVOKED
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NO_MFC                     1
-#define _APS_NEXT_RESOURCE_VALUE        132
+#define _APS_NEXT_RESOURCE_VALUE        133
 #define _APS_NEXT_COMMAND_VALUE         52031
-#define _APS_NEXT_CONTROL_VALUE         2630
+#define _APS_NEXT_CONTROL_VALUE         2638
 #define _APS_NEXT_SYMED_VALUE           101
 #endif
 #endif
@@ -62,7 +62,7 @@ DllExport int PASCAL CommReadRawByte(PComVar cv, LPBYTE b);
 DllExport int PASCAL CommRead1Byte(PComVar cv, LPBYTE b);
 DllExport void PASCAL CommInsert1Byte(PComVar cv, BYTE b);
 DllExport int PASCAL CommRawOut(PComVar cv, PCHAR B, int C);
-DllExport int PASCAL CommBinaryOut(PComVar cv, PCHAR B, int C);
+DllExport int PASCAL CommBinaryOut(PComVar cv, const char *B, int C);
 DllExport int PASCAL CommBinaryBuffOut(PComVar cv, PCHAR B, int C);
 DllExport int PASCAL CommTextOutW(PComVar cv, const wchar_t *B, int C);
 DllExport int PASCAL CommBinaryEcho(PComVar cv, PCHAR B, int C);
@@ -92,6 +92,10 @@
 #define CmdSendBinary       'b'
 #define CmdSendCompatString 'c'	// ]̕Mƌ݊, StringBinaryKv
 #define CmdGetTTPos         'd'
+#define CmdSftpGet          'e'
+#define CmdSftpPut          'f'
+#define CmdGetScpStatus     'g'
+#define CmdGetSftpStatus    'h'
 
 #define LogOptBinary        1
 #define LogOptAppend        2
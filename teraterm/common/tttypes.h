@@ -43,6 +43,7 @@
 #define IdPrnProcTimer       9
 #define IdCancelConnectTimer 10  // add (2007.1.10 yutaka)
 #define IdPasteDelayTimer    11
+#define IdRenderTimer        12
 
   /* Window Id */
 #define IdVT  1
@@ -118,6 +119,7 @@ typedef enum {
 #define KmtOptLongPacket 1
 #define KmtOptFileAttr 2
 #define KmtOptSlideWin 4
+#define KmtOptStreaming 8
 
 // log rotate mode
 enum rotate_mode {
@@ -616,6 +618,10 @@ struct tttset {
 	DWORD SendfileSize;
 	WORD SendfileMethod4;
 	WORD SendfileSkipOptionDialog;
+	WORD RenderFrameRate;		// M̕`Ԉt[[g(fps), 0=MƂɕ`
+	LONG ScrollBuffColdSize;	// ScrollBuffSize Âskĕێs, 0=ێȂ
+	LONG ScrollBuffColdMemory;	// kŝɒus, Âs͈ꎞt@Cɏo, 0=ׂă
+	WORD KermitWinSize;			// Kermit XCfBOEBhẼTCY(1-31)
 
 	// Experimental
 	BYTE ExperimentalTreePropertySheetEnable;
@@ -785,11 +791,13 @@ typedef struct tttset TTTSet, *PTTSet;
 #define PM   0x9E
 #define APC  0x9F
 
-#define InBuffSize  1024
+#define InBuffSize  1024			// Mobt@TCY(݊̂ߎcĂ)
+#define InBuffSizeMin (1024*64)		// Mobt@TCY
+#define InBuffSizeMax (1024*1024)	// Mobt@őTCY
 #define OutBuffSize (1024*16)
 
 typedef struct {
-	BYTE InBuff[InBuffSize];
+	BYTE reserve_InBuff[InBuffSize];	// gp, Mobt@ InBuff ()
 	int InBuffCount, InPtr;
 	BYTE OutBuff[OutBuffSize];
 	int OutBuffCount, OutPtr;
@@ -882,6 +890,11 @@ typedef struct {
 
 	void *StateSend;
 	void *StateEcho;
+
+	// Mobt@
+	//	TCY͎Mʂɉ InBuffSizeMin ` InBuffSizeMax ̊Ԃŕω
+	BYTE *InBuff;
+	int InBuffMax;		// InBuff ̃TCY
 } TComVar;
 typedef TComVar *PComVar;
 
@@ -36,6 +36,8 @@
 #define _CRTDBG_MAP_ALLOC
 #include <crtdbg.h>
 #include <assert.h>
+#include <zlib.h>
+#include <winioctl.h>
 
 #include "tttypes.h"
 #include "tttypes_charset.h"
@@ -49,35 +51,45 @@
 #include "buffer.h"
 #include "asprintf.h"
 #include "ttcstd.h"
+#include "buffsearch.h"
 
 #define	ENABLE_CELL_INDEX	0
 
 // obt@̔p1̏
+//	XN[obt@S(ő BuffSizeMax Z)̂ŏĂ(12byte)
+//	ȂǁAقƂǂ̃ZŎgpȂ̓TChe[u(buff_comb_t)ɒu
+//	UTF-16, ANSI u32 KvȂƂɕϊ
 typedef struct {
-	char32_t u32;
-	char32_t u32_last;
-	char WidthProperty;				// 'W' or 'F' or 'H' or 'A' or 'n'(Narrow) or 'N'(Neutual) (̑)
-	char cell;			// cell 1/2/3+=p,Sp,3ȏ
-						// 2ȏ̂ƂǍ̕paddingcell-1
-	char Padding;					// TRUE = Sp̎̋lߕ or s̋lߕ
-	char Emoji;						// TRUE = G
-	unsigned char CombinationCharCount16;	// character count
-	unsigned char CombinationCharSize16;		// buffer size
-	unsigned char CombinationCharCount32;
-	unsigned char CombinationCharSize32;
-	wchar_t *pCombinationChars16;
-	char32_t *pCombinationChars32;
-	wchar_t	wc2[2];
+	unsigned int u32 : 21;			// Unicode(UTF-32), U+10FFFF ܂
+	unsigned int Padding : 1;		// TRUE = Sp̎̋lߕ or s̋lߕ
+	unsigned int Emoji : 1;			// TRUE = G
+	unsigned int : 1;
+	unsigned int WidthProperty : 8;	// 'W' or 'F' or 'H' or 'A' or 'n'(Narrow) or 'N'(Neutual) (̑)
 	unsigned char fg;
 	unsigned char bg;
 	unsigned char attr;
 	unsigned char attr2;
-	unsigned short ansi_char;
+	unsigned int cell : 8;			// cell 1/2/3+=p,Sp,3ȏ
+									// 2ȏ̂ƂǍ̕paddingcell-1
+	unsigned int comb : 24;			// e[u(CombTable[])index, 0=Ȃ
 #if ENABLE_CELL_INDEX
 	int idx;	// Zʂԍ
 #endif
 } buff_char_t;
 
+// ̏(TChe[u)
+//	̕т1̃GgL(QƃJEg)
+//	e͕ύXȂAǉƂ͕ʂ̃Ggɂ
+typedef struct {
+	char32_t u32_last;				// ŌɌ, gp̂Ƃ͎̋index
+	unsigned char CombinationCharCount16;	// character count
+	unsigned char CombinationCharCount32;
+	LONG ref;						// QƂĂZ̐, 0=QƂĂȂ(ėpł悤ɎcĂ)
+	DWORD hash;
+	wchar_t *pCombinationChars16;	// pCombinationChars32 Ɠ̈
+	char32_t *pCombinationChars32;	// NULL=gp̃Gg
+} buff_comb_t;
+
 #define BuffXMax TermWidthMax
 //#define BuffYMax 100000
 //#define BuffSizeMax 8000000
@@ -88,6 +100,9 @@ typedef struct {
 // 1̃Rrl[Vobt@őTCY
 #define MAX_CHAR_SIZE	100
 
+// e[u̍ő吔 (buff_char_t.comb bit)
+#define CombTableMax	(1UL << 24)
+
 // status line
 int StatusLine;	//0: none 1: shown
 /* top, bottom, left & right margin */
@@ -101,6 +116,12 @@ static WORD BuffLock = 0;
 
 static buff_char_t *CodeBuffW;
 static LONG LinePtr;
+static buff_comb_t *CombTable;	// e[u, [0]͖gp(Ȃ)
+static DWORD CombTableSize;		// CombTable[] ̐
+static DWORD CombTableFree;		// index̃Xg̐擪, 0=󂫂Ȃ
+static DWORD CombTableUsed;		// QƂĂindex̐
+static DWORD CombTableCached;	// QƂĂȂcĂindex̐
+static DWORD *CombHash;			// ̕т index nbV\, CombTableSize * 2 
 static LONG BufferSize;
 static int NumOfLinesInBuff;
 static int BuffStartAbs, BuffEndAbs;
@@ -119,6 +140,64 @@ static int StrChangeStart;	// 
 static int StrChangeCount;	// `LN^(pP),0̂Ƃ`悷̂Ȃ
 static BOOL UseUnicodeApi;
 
+// x` (ts.RenderFrameRate > 0 ̂Ƃ)
+//	Mf[^͕`悹ĕ`悪KvȔ͈͂L^ĂA
+//	t[Ԋu(1000/ts.RenderFrameRate ms)Ƃɂ܂Ƃ߂ĕ`悷
+static BOOL DrawDeferred;	// TRUE=`悹L^̂ݍs
+static BOOL DirtyAny;		// TRUE=ĕ`悪KvȔ͈͂
+static BOOL DirtyAll;		// TRUE=EBhEŜĕ`悷(XN[)
+static DWORD *DirtyBits;	// sƂ̍ĕ`悪KvȃZ̃rbg}bv(XN[W)
+							//	1s DirtyWords , DirtyGen[y] != DirtyGeneration ̍s͕ωȂ
+static DWORD *DirtyGen;		// sƂ̐
+static DWORD DirtyGeneration;	// ݂̐, `̂тɐi߂đSsNA
+static int DirtyLines;		// DirtyBits[], DirtyGen[] ̍s
+static int DirtyWords;
+static BOOL FramePending;	// IdRenderTimer 쒆
+static DWORD FrameTick;		// ŌɃt[`悵
+// kXN[obt@
+#define ColdBlockLines	128		// kPʂ̍s
+#define ColdCacheSlots	4		// WJĂubN
+#define ColdCellBytes	10		// 1Z̃oCg()
+
+typedef struct {
+	BYTE *data;			// ubÑf[^, ꎞt@CɏoƂ NULL
+	DWORD size;			// data ̃TCY, raw_size ƓƂ͖k
+	DWORD raw_size;		// WJ̃TCY
+	LONGLONG offset;	// ꎞt@C̈ʒu
+} cold_block_t;
+
+static int ColdLines;				// kĕێĂs, sԍ 0..ColdLines-1
+static cold_block_t *ColdBlocks;	// kubN, [0]łÂ
+static int ColdBlockNum;
+static int ColdBlockCap;
+static BYTE *ColdOpen;				// kÕubN(ColdBlockLinessɖȂ)
+static DWORD ColdOpenSize;
+static DWORD ColdOpenCap;
+static int ColdOpenLines;
+static BYTE *ColdWork;				// WJp
+static DWORD ColdWorkCap;
+static LONG ColdDroppedBlocks;		// jubN
+static LONG ColdCacheSize;			// LbṼZ, 0=kXN[obt@gpȂ
+static LONG ColdCacheTag[ColdCacheSlots];	// WJĂubN̒ʂԍ, -1=
+static DWORD ColdCacheUse[ColdCacheSlots];
+static DWORD ColdCacheClock;
+// kXN[obt@̈ꎞt@C
+static int ColdSpilled;				// ꎞt@CɏoubN, ColdBlocks[0..ColdSpilled-1]
+static HANDLE SpillFile = INVALID_HANDLE_VALUE;
+static HANDLE SpillMap;				// SpillFile ̃t@C}bsO
+static LONGLONG SpillSize;			// SpillFile ɏ񂾃TCY
+static LONGLONG SpillMapSize;		// SpillMap 쐬̃TCY
+static LONGLONG SpillFreed;			// ς݂̗̈̏I
+static DWORD SpillGranularity;		// MapViewOfFile() ̃ItZbg̒P
+// XN[obt@̌
+static LONGLONG BuffLineBase;		// sԍ0̍s̒ʂԍ(oĔjs)
+static BuffTextRow **TextRows;		// ʂ̍s̕LbV
+static int TextRowsNum;				// TextRows[i] ͒ʂԍ TextRowsBase + i ̍s
+static int TextRowsCap;
+static LONGLONG TextRowsBase;
+static BuffSearch *Search;			// s܂͏I
+static LONGLONG FindFeedLine;		// XbhɓnłÂs̒ʂԍ
+
 static BOOL SeveralPageSelect;  // add (2005.5.15 yutaka)
 
 static TCharAttr CurCharAttr;
@@ -132,6 +211,9 @@ static int CodePage = 932;
 
 static void BuffDrawLineI(int DrawX, int DrawY, int SY, int IStart, int IEnd);
 static void BuffDrawLineIPrn(int SY, int IStart, int IEnd);
+static void DirtyMarkAll(void);
+static void FreeCodeBuff(void);
+static void TextRowsClear(void);
 
 /**
  *	buff_char_t  relZړ
@@ -160,39 +242,247 @@ static buff_char_t *GetPtrRel(buff_char_t *CodeBuffW_, size_t BufferSize_, buff_
 	return p;
 }
 
-static void FreeCombinationBuf(buff_char_t *b)
+/**
+ *	Ž擾
+ *	ȂƂ͋̏Ԃ
+ */
+static const buff_comb_t *GetComb(const buff_char_t *b)
 {
-	if (b->pCombinationChars16 != NULL) {
-		free(b->pCombinationChars16);
-		b->pCombinationChars16 = NULL;
+	static const buff_comb_t empty;
+	if (b->comb == 0) {
+		return &empty;
 	}
-	b->CombinationCharSize16 = 0;
-	b->CombinationCharCount16 = 0;
+	return &CombTable[b->comb];
+}
 
-	if (b->pCombinationChars32 != NULL) {
-		free(b->pCombinationChars32);
-		b->pCombinationChars32 = NULL;
+/*
+ *	e[u
+ *
+ *	̕тƂɃGg1(nbV\ŒT)AZ index ŎQƂB
+ *	Z̃Rs[͎QƃJEg𑝂₷Ȃ̂ŁAXN[}ŃmۂȂB
+ *	QƂȂȂGg͂ɂ͉AтꂽƂɍėpB
+ *	e[uςɂȂAQƂĂȂGg܂Ƃ߂ĉB
+ */
+
+static DWORD CombHashOf(const char32_t *s, int n)
+{
+	// FNV-1a
+	DWORD h = 2166136261U;
+	int i;
+	for (i = 0; i < n; i++) {
+		h = (h ^ s[i]) * 16777619U;
 	}
-	b->CombinationCharSize32 = 0;
-	b->CombinationCharCount32 = 0;
+	return h;
 }
 
-static void DupCombinationBuf(buff_char_t *b)
+static void CombHashInsert(DWORD index)
+{
+	DWORD mask = CombTableSize * 2 - 1;
+	DWORD i = CombTable[index].hash & mask;
+	while (CombHash[i] != 0) {
+		i = (i + 1) & mask;
+	}
+	CombHash[i] = index;
+}
+
+static void CombHashRebuild(void)
+{
+	DWORD i;
+	memset(CombHash, 0, sizeof(DWORD) * CombTableSize * 2);
+	for (i = 1; i < CombTableSize; i++) {
+		if (CombTable[i].pCombinationChars32 != NULL) {
+			CombHashInsert(i);
+		}
+	}
+}
+
+/**
+ *	QƂĂȂGgāA󂫃Xgɖ߂
+ */
+static void CombSweep(void)
+{
+	DWORD i;
+	for (i = 1; i < CombTableSize; i++) {
+		buff_comb_t *c = &CombTable[i];
+		if (c->pCombinationChars32 != NULL && c->ref == 0) {
+			free(c->pCombinationChars32);
+			c->pCombinationChars16 = NULL;
+			c->pCombinationChars32 = NULL;
+			c->u32_last = CombTableFree;
+			CombTableFree = i;
+		}
+	}
+	CombTableCached = 0;
+	CombHashRebuild();
+}
+
+/**
+ *	e[ũGgmۂ
+ *
+ *	@retval	index, 0 ̂ƂmۂłȂ
+ */
+static DWORD CombAlloc(void)
+{
+	DWORD index;
+	buff_comb_t *c;
+
+	if (CombTableFree == 0 && CombTableCached > CombTableSize / 4) {
+		// QƂĂȂGgƂ́Ag傹ɉ
+		CombSweep();
+	}
+	if (CombTableFree == 0) {
+		// e[ug傷
+		DWORD new_size = CombTableSize == 0 ? 256 : CombTableSize * 2;
+		buff_comb_t *new_table;
+		DWORD *new_hash;
+		DWORD i;
+		if (new_size > CombTableMax) {
+			new_size = CombTableMax;
+		}
+		new_table = NULL;
+		new_hash = NULL;
+		if (new_size > CombTableSize) {
+			new_table = (buff_comb_t *)realloc(CombTable, sizeof(buff_comb_t) * new_size);
+			if (new_table != NULL) {
+				CombTable = new_table;
+				new_hash = (DWORD *)realloc(CombHash, sizeof(DWORD) * new_size * 2);
+			}
+		}
+		if (new_hash == NULL) {
+			// głȂ
+			if (CombTableCached == 0) {
+				return 0;
+			}
+			CombSweep();
+		}
+		else {
+			CombHash = new_hash;
+			// [0]͎gpȂ
+			for (i = (CombTableSize == 0 ? 1 : CombTableSize); i < new_size; i++) {
+				CombTable[i].pCombinationChars16 = NULL;
+				CombTable[i].pCombinationChars32 = NULL;
+				CombTable[i].u32_last = (i + 1 < new_size) ? i + 1 : 0;
+			}
+			CombTableFree = CombTableSize == 0 ? 1 : CombTableSize;
+			CombTableSize = new_size;
+			CombHashRebuild();
+		}
+	}
+
+	index = CombTableFree;
+	c = &CombTable[index];
+	CombTableFree = c->u32_last;
+	memset(c, 0, sizeof(*c));
+	return index;
+}
+
+/**
+ *	̕т̃Gg擾
+ *	т̃Gg΁AQƂ
+ *
+ *	@param	s		(UTF-32)
+ *	@param	n		, 1ȏ MAX_CHAR_SIZE ȉ
+ *	@retval	index(QƃJEg𑝂₵Ă), 0 ̂ƂmۂłȂ
+ */
+static DWORD CombIntern(const char32_t *s, int n)
+{
+	DWORD hash = CombHashOf(s, n);
+	DWORD index;
+	buff_comb_t *c;
+	wchar_t u16[MAX_CHAR_SIZE + 2];
+	int n16;
+	int i;
+
+	if (CombTableSize != 0) {
+		DWORD mask = CombTableSize * 2 - 1;
+		DWORD pos;
+		for (pos = hash & mask; CombHash[pos] != 0; pos = (pos + 1) & mask) {
+			c = &CombTable[CombHash[pos]];
+			if (c->hash == hash && c->CombinationCharCount32 == n &&
+				memcmp(c->pCombinationChars32, s, sizeof(char32_t) * n) == 0) {
+				if (c->ref++ == 0) {
+					CombTableCached--;
+					CombTableUsed++;
+				}
+				return CombHash[pos];
+			}
+		}
+	}
+
+	n16 = 0;
+	for (i = 0; i < n; i++) {
+		if (n16 + 2 > MAX_CHAR_SIZE) {
+			break;
+		}
+		n16 += (int)UTF32ToUTF16(s[i], &u16[n16], 2);
+	}
+
+	// ͂߂Čꂽ
+	index = CombAlloc();
+	if (index == 0) {
+		return 0;
+	}
+	c = &CombTable[index];
+	c->pCombinationChars32 = malloc(sizeof(char32_t) * n + sizeof(wchar_t) * n16);
+	if (c->pCombinationChars32 == NULL) {
+		c->u32_last = CombTableFree;
+		CombTableFree = index;
+		return 0;
+	}
+	memcpy(c->pCombinationChars32, s, sizeof(char32_t) * n);
+	c->pCombinationChars16 = (wchar_t *)(c->pCombinationChars32 + n);
+	memcpy(c->pCombinationChars16, u16, sizeof(wchar_t) * n16);
+	c->CombinationCharCount32 = (unsigned char)n;
+	c->CombinationCharCount16 = (unsigned char)n16;
+	c->u32_last = s[n - 1];
+	c->hash = hash;
+	c->ref = 1;
+	CombTableUsed++;
+	CombHashInsert(index);
+	return index;
+}
+
+static void FreeCombinationBuf(buff_char_t *b)
 {
-	size_t size;
+	buff_comb_t *c;
 
-	size = b->CombinationCharSize16;
-	if (size > 0) {
-		wchar_t *new_buf = malloc(sizeof(wchar_t) * size);
-		memcpy(new_buf, b->pCombinationChars16, sizeof(wchar_t) * size);
-		b->pCombinationChars16 = new_buf;
+	if (b->comb == 0) {
+		return;
 	}
-	size = b->CombinationCharSize32;
-	if (size > 0) {
-		char32_t *new_buf = malloc(sizeof(char32_t) * size);
-		memcpy(new_buf, b->pCombinationChars32, sizeof(char32_t) * size);
-		b->pCombinationChars32 = new_buf;
+	c = &CombTable[b->comb];
+	if (--c->ref == 0) {
+		// ėpł悤ɎcĂ
+		CombTableUsed--;
+		CombTableCached++;
 	}
+	b->comb = 0;
+}
+
+static void DupCombinationBuf(buff_char_t *b)
+{
+	if (b->comb == 0) {
+		return;
+	}
+	CombTable[b->comb].ref++;
+}
+
+/**
+ *	e[uׂĉ
+ *	QƂĂZȂƂĂ
+ */
+static void CombFreeAll(void)
+{
+	DWORD i;
+	for (i = 1; i < CombTableSize; i++) {
+		free(CombTable[i].pCombinationChars32);
+	}
+	free(CombTable);
+	CombTable = NULL;
+	free(CombHash);
+	CombHash = NULL;
+	CombTableSize = 0;
+	CombTableFree = 0;
+	CombTableCached = 0;
 }
 
 static void CopyCombinationBuf(buff_char_t *dest, const buff_char_t *src)
@@ -211,63 +501,90 @@ static void CopyCombinationBuf(buff_char_t *dest, const buff_char_t *src)
 	DupCombinationBuf(dest);
 }
 
+/**
+ *	Z̍Ō̕(Ƃ͍Ō̌)
+ */
+static char32_t GetU32Last(const buff_char_t *b)
+{
+	if (b->comb == 0) {
+		return b->u32;
+	}
+	return CombTable[b->comb].u32_last;
+}
+
+/**
+ *	Z̕() UTF-16 Ŏ擾
+ *
+ *	@param[out]	wc2		wc2[0],wc2[1], TQ[gyAłȂƂ wc2[1]=0
+ */
+static void GetWC2(const buff_char_t *b, wchar_t *wc2)
+{
+	char32_t u32 = b->u32;
+	if (u32 < 0x10000) {
+		wc2[0] = (wchar_t)u32;
+		wc2[1] = 0;
+	}
+	else {
+		u32 -= 0x10000;
+		wc2[0] = (wchar_t)(0xd800 | (u32 >> 10));
+		wc2[1] = (wchar_t)(0xdc00 | (u32 & 0x3ff));
+	}
+}
+
+static unsigned short ConvertACPChar(const buff_char_t *b);
+
+/**
+ *	Z̕ ANSI(CodePage) Ŏ擾
+ *
+ *	@return	ANSI, 2bytêƂ͏byte1byte
+ */
+static unsigned short GetAnsiChar(const buff_char_t *b)
+{
+	char32_t u32 = b->u32;
+	char strA[4];
+	size_t lenA;
+
+	if (b->comb != 0) {
+		return ConvertACPChar(b);
+	}
+	if (u32 < 0x80) {
+		return (unsigned short)u32;
+	}
+	if (u32 == 0x203e && CodePage == 932) {
+		// U+203e OVERLINE ʏ
+		//	 U+203e0x7e'~'ɕϊ
+		//return 0x7e7e;
+		return 0x7e;
+	}
+	lenA = UTF32ToMBCP(u32, CodePage, strA, sizeof(strA));
+	switch (lenA) {
+	case 0:
+	default:
+		return '?';
+	case 1:
+		return (unsigned char)strA[0];
+	case 2:
+		return (unsigned char)strA[1] | ((unsigned char)strA[0] << 8);
+	}
+}
+
 static void BuffSetChar2(buff_char_t *buff, char32_t u32, char property, BOOL half_width, char emoji)
 {
-	size_t wstr_len;
 	buff_char_t *p = buff;
 
+	if (u32 > 0x10ffff) {
+		// Unicode͈̔͊O
+		u32 = 0xfffd;
+	}
+
 	FreeCombinationBuf(p);
 	p->WidthProperty = property;
 	p->cell = half_width ? 1 : 2;
 	p->u32 = u32;
-	p->u32_last = u32;
 	p->Padding = FALSE;
 	p->Emoji = emoji;
 	p->fg = AttrDefaultFG;
 	p->bg = AttrDefaultBG;
-
-	//
-	wstr_len = UTF32ToUTF16(u32, &p->wc2[0], 2);
-	switch (wstr_len) {
-	case 0:
-	default:
-		p->wc2[0] = 0;
-		p->wc2[1] = 0;
-		break;
-	case 1:
-		p->wc2[1] = 0;
-		break;
-	case 2:
-		break;
-	}
-
-	if (u32 < 0x80) {
-		p->ansi_char = (unsigned short)u32;
-	}
-	else {
-		if (u32 == 0x203e && CodePage == 932) {
-			// U+203e OVERLINE ʏ
-			//	 U+203e0x7e'~'ɕϊ
-			//p->ansi_char = 0x7e7e;
-			p->ansi_char = 0x7e;
-		}
-		else {
-			char strA[4];
-			size_t lenA = UTF32ToMBCP(u32, CodePage, strA, sizeof(strA));
-			switch (lenA) {
-			case 0:
-			default:
-				p->ansi_char = '?';
-				break;
-			case 1:
-				p->ansi_char = (unsigned char)strA[0];
-				break;
-			case 2:
-				p->ansi_char = (unsigned char)strA[1] | ((unsigned char)strA[0] << 8);
-				break;
-			}
-		}
-	}
 }
 
 static void BuffSetChar4(buff_char_t *buff, char32_t u32, unsigned char fg, unsigned char bg, unsigned char attr, unsigned char attr2, char property)
@@ -287,56 +604,33 @@ static void BuffSetChar(buff_char_t *buff, char32_t u32, char property)
 
 /**
  *	̒ǉARrl[V
+ *	ǉт̃Ggɕtւ
  */
 static void BuffAddChar(buff_char_t *buff, char32_t u32)
 {
-	buff_char_t *p = buff;
-	assert(p->u32 != 0);
-	// ɑ̈g傷
-	if (p->CombinationCharSize16 < p->CombinationCharCount16 + 2) {
-		size_t new_size = p->CombinationCharSize16;
-		new_size = new_size == 0 ? 5 : new_size * 2;
-		if (new_size > MAX_CHAR_SIZE) {
-			new_size = MAX_CHAR_SIZE;
-		}
-		if (p->CombinationCharSize16 != new_size) {
-			p->pCombinationChars16 = realloc(p->pCombinationChars16, sizeof(wchar_t) * new_size);
-			p->CombinationCharSize16 = (char)new_size;
-		}
-	}
-	if (p->CombinationCharSize32 < p->CombinationCharCount32 + 2) {
-		size_t new_size = p->CombinationCharSize32;
-		new_size = new_size == 0 ? 5 : new_size * 2;
-		if (new_size > MAX_CHAR_SIZE) {
-			new_size = MAX_CHAR_SIZE;
-		}
-		if (p->CombinationCharSize32 != new_size) {
-			p->pCombinationChars32 = realloc(p->pCombinationChars32, sizeof(char32_t) * new_size);
-			p->CombinationCharSize32 = (char)new_size;
-		}
-	}
-
-	// UTF-32
-	if (p->CombinationCharCount32 < p->CombinationCharSize32) {
-		p->u32_last = u32;
-		p->pCombinationChars32[(size_t)p->CombinationCharCount32] = u32;
-		p->CombinationCharCount32++;
-	}
-
-	// UTF-16
-	if (p->CombinationCharCount16 < p->CombinationCharSize16) {
-		wchar_t u16_str[2];
-		size_t wlen = UTF32ToUTF16(u32, &u16_str[0], 2);
-		if (p->CombinationCharCount16 + wlen <= p->CombinationCharSize16) {
-			size_t i = (size_t)p->CombinationCharCount16;
-			p->pCombinationChars16[i] = u16_str[0];
-			if (wlen == 2) {
-				i++;
-				p->pCombinationChars16[i] = u16_str[1];
-			}
-			p->CombinationCharCount16 += (unsigned char)wlen;
-		}
+	buff_char_t *buff_p = buff;
+	const buff_comb_t *p = GetComb(buff_p);
+	char32_t s[MAX_CHAR_SIZE];
+	int n = p->CombinationCharCount32;
+	DWORD index;
+	assert(buff_p->u32 != 0);
+
+	if (n >= MAX_CHAR_SIZE || p->CombinationCharCount16 + 2 > MAX_CHAR_SIZE) {
+		// ȏ㌋łȂ
+		return;
+	}
+	if (n > 0) {
+		memcpy(s, p->pCombinationChars32, sizeof(char32_t) * n);
 	}
+	s[n++] = u32;
+
+	index = CombIntern(s, n);
+	if (index == 0) {
+		// e[uςÂĂ
+		return;
+	}
+	FreeCombinationBuf(buff_p);
+	buff_p->comb = index;
 }
 
 static void memcpyW(buff_char_t *dest, const buff_char_t *src, size_t count)
@@ -366,6 +660,43 @@ static void memsetW(buff_char_t *dest, wchar_t ch, unsigned char fg, unsigned ch
 		dest++;
 	}
 }
+/**
+ *	Zw̔p(Ȃ)Ɠׂ
+ */
+static BOOL IsSameCell(const buff_char_t *b, char32_t u32, unsigned char fg, unsigned char bg, unsigned char attr, unsigned char attr2)
+{
+	return b->u32 == u32 && b->cell == 1 && !b->Padding && !b->Emoji &&
+		b->comb == 0 &&
+		b->fg == fg && b->bg == bg && b->attr == attr && b->attr2 == attr2;
+}
+
+/**
+ *	memsetW() ŏƂɕωZ͈̔͂𒲂ׂ
+ *
+ *	@param[out]	first,last	ωZ͈̔(dest ̈ʒu)
+ *	@retval	FALSE			ωZȂ
+ */
+static BOOL memsetWChangedRange(const buff_char_t *dest, wchar_t ch, unsigned char fg, unsigned char bg, unsigned char attr, unsigned char attr2, int count, int *first, int *last)
+{
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if (!IsSameCell(&dest[i], ch, fg, bg, attr, attr2)) {
+			break;
+		}
+	}
+	if (i == count) {
+		return FALSE;
+	}
+	*first = i;
+	for (i = count - 1; i > *first; i--) {
+		if (!IsSameCell(&dest[i], ch, fg, bg, attr, attr2)) {
+			break;
+		}
+	}
+	*last = i;
+	return TRUE;
+}
 
 static void memmoveW(buff_char_t *dest, const buff_char_t *src, size_t count)
 {
@@ -408,11 +739,506 @@ static BOOL IsBuffFullWidth(const buff_char_t *b)
 	return FALSE;
 }
 
+/*
+ *	kXN[obt@
+ *
+ *	Oobt@(CodeBuffW)牟oꂽs ColdBlockLines sƂ
+ *	zlib ňkĕێB
+ *	sԍ(BuffEnd, PageStart, I͈͂Ȃ)͈ks܂߂ʂԍŁA
+ *	0..ColdLines-1 ksAColdLines ȍ~Oobt@̍sɂȂB
+ *	ksQƂƂ̓ubN CodeBuffW ̌̃LbV
+ *	(ColdCacheSlots ubN)ɓWJāÃZ̈ʒuԂB
+ */
+
+static void ColdInvalidateCache(void)
+{
+	int i;
+	for (i = 0; i < ColdCacheSlots; i++) {
+		ColdCacheTag[i] = -1;
+		ColdCacheUse[i] = 0;
+	}
+}
+
+/*
+ *	kXN[obt@̈ꎞt@C
+ *
+ *	ɒuubN ScrollBuffColdMemory s𒴂AÂubN
+ *	ꎞt@CɒǋL data B
+ *	QƂƂ̓ubN͈̔͂}bvāA璼ړWJB
+ *	ColdTrim() ŔjubN̗̈́AXp[Xt@C̋@\ŉB
+ */
+
+#define SpillReleaseUnit	(1024 * 1024)	// j̈܂Ƃ߂ĉP
+
+static void SpillUnmap(void)
+{
+	if (SpillMap != NULL) {
+		CloseHandle(SpillMap);
+		SpillMap = NULL;
+		SpillMapSize = 0;
+	}
+}
+
+static void SpillClose(void)
+{
+	SpillUnmap();
+	if (SpillFile != INVALID_HANDLE_VALUE) {
+		// FILE_FLAG_DELETE_ON_CLOSE Ȃ̂ō폜
+		CloseHandle(SpillFile);
+		SpillFile = INVALID_HANDLE_VALUE;
+	}
+	SpillSize = 0;
+	SpillFreed = 0;
+	ColdSpilled = 0;
+}
+
+static BOOL SpillOpen(void)
+{
+	wchar_t dir[MAX_PATH];
+	wchar_t name[MAX_PATH];
+	SYSTEM_INFO si;
+	DWORD ret;
+
+	if (SpillFile != INVALID_HANDLE_VALUE) {
+		return TRUE;
+	}
+	if (GetTempPathW(_countof(dir), dir) == 0 || GetTempFileNameW(dir, L"tts", 0, name) == 0) {
+		return FALSE;
+	}
+	SpillFile = CreateFileW(name, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+							FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, NULL);
+	if (SpillFile == INVALID_HANDLE_VALUE) {
+		DeleteFileW(name);
+		return FALSE;
+	}
+	// NTFS ȊOł͎s邪ÂƂ͗̈Ȃ
+	DeviceIoControl(SpillFile, FSCTL_SET_SPARSE, NULL, 0, NULL, 0, &ret, NULL);
+
+	GetSystemInfo(&si);
+	SpillGranularity = si.dwAllocationGranularity;
+	SpillSize = 0;
+	SpillFreed = 0;
+	return TRUE;
+}
+
+/**
+ *	ubNꎞt@CɒǋLāA
+ */
+static BOOL SpillBlock(cold_block_t *c)
+{
+	LARGE_INTEGER pos;
+	DWORD written;
+
+	if (!SpillOpen()) {
+		return FALSE;
+	}
+	pos.QuadPart = SpillSize;
+	if (!SetFilePointerEx(SpillFile, pos, NULL, FILE_BEGIN) ||
+		!WriteFile(SpillFile, c->data, c->size, &written, NULL) || written != c->size) {
+		return FALSE;
+	}
+	c->offset = SpillSize;
+	SpillSize += c->size;
+	free(c->data);
+	c->data = NULL;
+	return TRUE;
+}
+
+/**
+ *	oubN}bv
+ *
+ *	@param	view	UnmapViewOfFile() ɓnAhX
+ *	@return			ubÑf[^, NULL=s
+ */
+static const BYTE *SpillMapBlock(const cold_block_t *c, void **view)
+{
+	LONGLONG base;
+	DWORD delta;
+
+	*view = NULL;
+	if (SpillMap == NULL || c->offset + c->size > SpillMapSize) {
+		// t@C傫Ȃ̂ō蒼
+		SpillUnmap();
+		SpillMap = CreateFileMappingW(SpillFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (SpillMap == NULL) {
+			return NULL;
+		}
+		SpillMapSize = SpillSize;
+	}
+	delta = (DWORD)(c->offset % SpillGranularity);
+	base = c->offset - delta;
+	*view = MapViewOfFile(SpillMap, FILE_MAP_READ, (DWORD)(base >> 32), (DWORD)base, delta + c->size);
+	if (*view == NULL) {
+		return NULL;
+	}
+	return (const BYTE *)*view + delta;
+}
+
+/**
+ *	ɒuubN ScrollBuffColdMemory s𒴂Â珑o
+ */
+static void ColdSpill(void)
+{
+	if (ts.ScrollBuffColdMemory == 0) {
+		return;
+	}
+	while (ColdSpilled < ColdBlockNum &&
+		   (LONG)(ColdBlockNum - ColdSpilled) * ColdBlockLines > ts.ScrollBuffColdMemory) {
+		if (!SpillBlock(&ColdBlocks[ColdSpilled])) {
+			// oȂƂ̓ɒu܂܂ɂ
+			break;
+		}
+		ColdSpilled++;
+	}
+}
+
+/**
+ *	jubN̗̈
+ *	ColdTrim() ̂ƁAColdBlocks[0] cĂłÂubN
+ */
+static void SpillRelease(void)
+{
+	FILE_ZERO_DATA_INFORMATION z;
+	LONGLONG live = ColdSpilled > 0 ? ColdBlocks[0].offset : SpillSize;
+	DWORD ret;
+
+	if (SpillFile == INVALID_HANDLE_VALUE || live - SpillFreed < SpillReleaseUnit) {
+		return;
+	}
+	z.FileOffset.QuadPart = SpillFreed;
+	z.BeyondFinalZero.QuadPart = live;
+	// }bv܂܂ł͉łȂ
+	SpillUnmap();
+	DeviceIoControl(SpillFile, FSCTL_SET_ZERO_DATA, &z, sizeof(z), NULL, 0, &ret, NULL);
+	SpillFreed = live;
+}
+
+/**
+ *	kXN[obt@ׂĔj
+ */
+static void ColdClear(void)
+{
+	int i;
+	for (i = 0; i < ColdBlockNum; i++) {
+		free(ColdBlocks[i].data);
+	}
+	free(ColdBlocks);
+	ColdBlocks = NULL;
+	ColdBlockNum = 0;
+	ColdBlockCap = 0;
+	free(ColdOpen);
+	ColdOpen = NULL;
+	ColdOpenSize = 0;
+	ColdOpenCap = 0;
+	ColdOpenLines = 0;
+	free(ColdWork);
+	ColdWork = NULL;
+	ColdWorkCap = 0;
+	ColdLines = 0;
+	ColdInvalidateCache();
+	SpillClose();
+}
+
+/**
+ *	kȂĂ悢s̋󔒂ׂ
+ */
+static BOOL IsColdBlank(const buff_char_t *b)
+{
+	return IsSameCell(b, 0x20, AttrDefaultFG, AttrDefaultBG, AttrDefault, AttrDefault) &&
+		b->WidthProperty == 'H';
+}
+
+/**
+ *	1s ColdOpen ɒǉ
+ *
+ *	s̋󔒂Z(2byte)̂ƁAl₷悤
+ *	oƂɂ܂Ƃ߂ĕׂ
+ *		u32(,,byte), flags, WidthProperty, cell, fg, bg, attr, attr2
+ *	ŌɌ̂ZƂ (1byte) + u32(3byte/)
+ */
+static BOOL ColdPutLine(const buff_char_t *b)
+{
+	int ncells = NumOfColumns;
+	int i, j;
+	DWORD size;
+	BYTE *p;
+
+	while (ncells > 0 && IsColdBlank(&b[ncells - 1])) {
+		ncells--;
+	}
+	size = 2 + ColdCellBytes * ncells;
+	for (i = 0; i < ncells; i++) {
+		if (b[i].comb != 0) {
+			size += 1 + 3 * GetComb(&b[i])->CombinationCharCount32;
+		}
+	}
+
+	if (ColdOpenSize + size > ColdOpenCap) {
+		DWORD cap = ColdOpenCap == 0 ? 16 * 1024 : ColdOpenCap;
+		while (cap < ColdOpenSize + size) {
+			cap *= 2;
+		}
+		p = realloc(ColdOpen, cap);
+		if (p == NULL) {
+			return FALSE;
+		}
+		ColdOpen = p;
+		ColdOpenCap = cap;
+	}
+
+	p = ColdOpen + ColdOpenSize;
+	*p++ = (BYTE)ncells;
+	*p++ = (BYTE)(ncells >> 8);
+	for (i = 0; i < ncells; i++) *p++ = (BYTE)b[i].u32;
+	for (i = 0; i < ncells; i++) *p++ = (BYTE)(b[i].u32 >> 8);
+	for (i = 0; i < ncells; i++) *p++ = (BYTE)(b[i].u32 >> 16);
+	for (i = 0; i < ncells; i++) *p++ = (BYTE)(b[i].Padding | (b[i].Emoji << 1) | ((b[i].comb != 0) << 2));
+	for (i = 0; i < ncells; i++) *p++ = (BYTE)b[i].WidthProperty;
+	for (i = 0; i < ncells; i++) *p++ = (BYTE)b[i].cell;
+	for (i = 0; i < ncells; i++) *p++ = b[i].fg;
+	for (i = 0; i < ncells; i++) *p++ = b[i].bg;
+	for (i = 0; i < ncells; i++) *p++ = b[i].attr;
+	for (i = 0; i < ncells; i++) *p++ = b[i].attr2;
+	for (i = 0; i < ncells; i++) {
+		const buff_comb_t *c;
+		if (b[i].comb == 0) {
+			continue;
+		}
+		c = GetComb(&b[i]);
+		*p++ = c->CombinationCharCount32;
+		for (j = 0; j < c->CombinationCharCount32; j++) {
+			char32_t u32 = c->pCombinationChars32[j];
+			*p++ = (BYTE)u32;
+			*p++ = (BYTE)(u32 >> 8);
+			*p++ = (BYTE)(u32 >> 16);
+		}
+	}
+	ColdOpenSize += size;
+	return TRUE;
+}
+
+/**
+ *	ColdPutLine() Œǉ1sWJ
+ *
+ *	@param	p		s̐擪
+ *	@param	dest	WJ(NumOfColumns Z)
+ *	@return			̍s̐擪
+ */
+static const BYTE *ColdGetLine(const BYTE *p, buff_char_t *dest)
+{
+	int ncells = p[0] | (p[1] << 8);
+	const BYTE *u = p + 2;
+	const BYTE *comb = u + ColdCellBytes * ncells;
+	int n = ncells < NumOfColumns ? ncells : NumOfColumns;
+	int i, j;
+
+	for (i = 0; i < ncells; i++) {
+		BYTE flags = u[3 * ncells + i];
+		if (i < n) {
+			buff_char_t *d = &dest[i];
+			FreeCombinationBuf(d);
+			d->u32 = u[i] | (u[ncells + i] << 8) | (u[2 * ncells + i] << 16);
+			d->Padding = flags & 1;
+			d->Emoji = (flags >> 1) & 1;
+			d->WidthProperty = u[4 * ncells + i];
+			d->cell = u[5 * ncells + i];
+			d->fg = u[6 * ncells + i];
+			d->bg = u[7 * ncells + i];
+			d->attr = u[8 * ncells + i];
+			d->attr2 = u[9 * ncells + i];
+		}
+		if (flags & 4) {
+			int count = *comb++;
+			char32_t s[MAX_CHAR_SIZE];
+			for (j = 0; j < count; j++) {
+				if (j < MAX_CHAR_SIZE) {
+					s[j] = comb[0] | (comb[1] << 8) | (comb[2] << 16);
+				}
+				comb += 3;
+			}
+			if (i < n && count > 0) {
+				// т̃GgQƂ
+				dest[i].comb = CombIntern(s, count < MAX_CHAR_SIZE ? count : MAX_CHAR_SIZE);
+			}
+		}
+	}
+	for (i = n; i < NumOfColumns; i++) {
+		BuffSetChar4(&dest[i], 0x20, AttrDefaultFG, AttrDefaultBG, AttrDefault, AttrDefault, 'H');
+	}
+	if (n > 0 && n < ncells && (dest[n - 1].attr & AttrKanji)) {
+		// [̕ȂĂ
+		BuffSetChar(&dest[n - 1], ' ', 'H');
+		dest[n - 1].attr ^= AttrKanji;
+	}
+	return comb;
+}
+
+/**
+ *	ColdOpen k ColdBlocks Ɉڂ
+ *	ColdBlocks[] ̋󂫂 ColdPushLines() ŊmۂĂ
+ */
+static void ColdCloseBlock(void)
+{
+	cold_block_t *c = &ColdBlocks[ColdBlockNum];
+	uLongf size = compressBound(ColdOpenSize);
+	BYTE *data = malloc(size);
+
+	if (data != NULL &&
+		compress2(data, &size, ColdOpen, ColdOpenSize, Z_BEST_SPEED) == Z_OK &&
+		size < ColdOpenSize) {
+		BYTE *shrunk = realloc(data, size);
+		c->data = shrunk != NULL ? shrunk : data;
+		c->size = (DWORD)size;
+		c->raw_size = ColdOpenSize;
+	}
+	else {
+		// kłȂƂ͂̂܂ܕێ
+		free(data);
+		c->data = ColdOpen;
+		c->size = ColdOpenSize;
+		c->raw_size = ColdOpenSize;
+		ColdOpen = NULL;
+		ColdOpenCap = 0;
+	}
+	ColdBlockNum++;
+	ColdOpenSize = 0;
+	ColdOpenLines = 0;
+}
+
+/**
+ *	ubNLbVɓWJ
+ */
+static void ColdLoadBlock(int slot, int block)
+{
+	buff_char_t *dest = &CodeBuffW[BufferSize + (LONG)slot * ColdBlockLines * NumOfColumns];
+	const BYTE *p = NULL;
+	void *view = NULL;
+	int lines;
+	int i;
+
+	if (block < ColdBlockNum) {
+		const cold_block_t *c = &ColdBlocks[block];
+		const BYTE *data = c->data;
+		lines = ColdBlockLines;
+		if (data == NULL) {
+			data = SpillMapBlock(c, &view);
+		}
+		if (data == NULL) {
+			// ǂ߂ȂubN͋sɂ
+			p = NULL;
+		}
+		else if (c->size == c->raw_size) {
+			p = data;
+		}
+		else {
+			if (ColdWorkCap < c->raw_size) {
+				BYTE *work = realloc(ColdWork, c->raw_size);
+				if (work != NULL) {
+					ColdWork = work;
+					ColdWorkCap = c->raw_size;
+				}
+			}
+			if (ColdWorkCap >= c->raw_size) {
+				uLongf size = c->raw_size;
+				if (uncompress(ColdWork, &size, data, c->size) == Z_OK) {
+					p = ColdWork;
+				}
+			}
+		}
+	}
+	else {
+		p = ColdOpen;
+		lines = ColdOpenLines;
+	}
+
+	for (i = 0; i < ColdBlockLines; i++) {
+		buff_char_t *row = dest + (LONG)i * NumOfColumns;
+		if (p != NULL && i < lines) {
+			p = ColdGetLine(p, row);
+		}
+		else {
+			memsetW(row, 0x20, AttrDefaultFG, AttrDefaultBG, AttrDefault, AttrDefault, NumOfColumns);
+		}
+	}
+	if (view != NULL) {
+		UnmapViewOfFile(view);
+	}
+}
+
+/**
+ *	ks̃|C^(CodeBuffW[]index)Ԃ
+ */
+static LONG ColdGetLinePtr(int Line)
+{
+	int block = Line / ColdBlockLines;
+	LONG tag = ColdDroppedBlocks + block;
+	int slot = 0;
+	int i;
+
+	for (i = 0; i < ColdCacheSlots; i++) {
+		if (ColdCacheTag[i] == tag) {
+			slot = i;
+			break;
+		}
+		if (ColdCacheUse[i] < ColdCacheUse[slot]) {
+			slot = i;
+		}
+	}
+	if (i == ColdCacheSlots) {
+		ColdLoadBlock(slot, block);
+		ColdCacheTag[slot] = tag;
+	}
+	ColdCacheUse[slot] = ++ColdCacheClock;
+
+	return BufferSize + ((LONG)slot * ColdBlockLines + Line % ColdBlockLines) * NumOfColumns;
+}
+
+/**
+ *	LbṼ|C^sԍ߂
+ */
+static int ColdLineFromPtr(LONG Ptr)
+{
+	LONG row = (Ptr - BufferSize) / NumOfColumns;
+	int slot = (int)(row / ColdBlockLines);
+	return (int)((ColdCacheTag[slot] - ColdDroppedBlocks) * ColdBlockLines + row % ColdBlockLines);
+}
+
+/**
+ *	ScrollBuffColdSize 𒴂ÂubNj
+ *
+ *	@return	js
+ */
+static int ColdTrim(void)
+{
+	int n = 0;
+	int i;
+
+	while (n < ColdBlockNum && ColdLines - n * ColdBlockLines > ts.ScrollBuffColdSize) {
+		n++;
+	}
+	if (n == 0) {
+		return 0;
+	}
+	for (i = 0; i < n; i++) {
+		free(ColdBlocks[i].data);
+	}
+	memmove(&ColdBlocks[0], &ColdBlocks[n], sizeof(cold_block_t) * (ColdBlockNum - n));
+	ColdBlockNum -= n;
+	ColdDroppedBlocks += n;
+	ColdLines -= n * ColdBlockLines;
+	ColdSpilled = ColdSpilled > n ? ColdSpilled - n : 0;
+	SpillRelease();
+	return n * ColdBlockLines;
+}
 static LONG GetLinePtr(int Line)
 {
 	LONG Ptr;
 
-	Ptr = (LONG)(BuffStartAbs + Line) * (LONG)(NumOfColumns);
+	if (Line >= 0 && Line < ColdLines) {
+		return ColdGetLinePtr(Line);
+	}
+
+	Ptr = (LONG)(BuffStartAbs + Line - ColdLines) * (LONG)(NumOfColumns);
 	while (Ptr>=BufferSize) {
 		Ptr = Ptr - BufferSize;
 	}
@@ -421,6 +1247,10 @@ static LONG GetLinePtr(int Line)
 
 static LONG NextLinePtr(LONG Ptr)
 {
+	if (Ptr >= BufferSize) {
+		// ks
+		return GetLinePtr(ColdLineFromPtr(Ptr) + 1) + Ptr % NumOfColumns;
+	}
 	Ptr = Ptr + (LONG)NumOfColumns;
 	if (Ptr >= BufferSize) {
 		Ptr = Ptr - BufferSize;
@@ -430,6 +1260,18 @@ static LONG NextLinePtr(LONG Ptr)
 
 static LONG PrevLinePtr(LONG Ptr)
 {
+	if (Ptr >= BufferSize) {
+		// ks
+		int Line = ColdLineFromPtr(Ptr);
+		if (Line == 0) {
+			return Ptr;
+		}
+		return GetLinePtr(Line - 1) + Ptr % NumOfColumns;
+	}
+	if (ColdLines > 0 && Ptr / NumOfColumns == BuffStartAbs) {
+		// Oobt@̐擪̑O͈ks
+		return GetLinePtr(ColdLines - 1) + Ptr % NumOfColumns;
+	}
 	Ptr = Ptr - (LONG)NumOfColumns;
 	if (Ptr < 0) {
 		Ptr = Ptr + BufferSize;
@@ -445,6 +1287,12 @@ static void GetPosFromPtr(const buff_char_t *b, int *bx, int *by)
 	size_t index = b - CodeBuffW;
 	int x = (int)(index % NumOfColumns);
 	int y = (int)(index / NumOfColumns);
+	if (index >= (size_t)BufferSize) {
+		// ks
+		*bx = x;
+		*by = ColdLineFromPtr((LONG)index);
+		return;
+	}
 	if (y >= BuffStartAbs) {
 		y -= BuffStartAbs;
 	}
@@ -452,12 +1300,57 @@ static void GetPosFromPtr(const buff_char_t *b, int *bx, int *by)
 		y = y - BuffStartAbs + NumOfLinesInBuff;
 	}
 	*bx = x;
-	*by = y;
+	*by = y + ColdLines;
+}
+
+/**
+ *	Oobt@̌Âs n skXN[obt@ֈڂ
+ *	sԍ͕ςȂ(BuffEnd ͂̂܂܂ŁAOobt@̐擪i)
+ *	mۂłȂƂ͓rł߂
+ */
+static void ColdPushLines(int n)
+{
+	LONG open_tag = ColdDroppedBlocks + ColdBlockNum;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		if (ColdOpenLines == 0 && ColdBlockNum == ColdBlockCap) {
+			int cap = ColdBlockCap == 0 ? 16 : ColdBlockCap * 2;
+			cold_block_t *blocks = realloc(ColdBlocks, sizeof(cold_block_t) * cap);
+			if (blocks == NULL) {
+				break;
+			}
+			ColdBlocks = blocks;
+			ColdBlockCap = cap;
+		}
+		if (!ColdPutLine(&CodeBuffW[GetLinePtr(ColdLines)])) {
+			break;
+		}
+		ColdOpenLines++;
+		ColdLines++;
+		BuffStartAbs++;
+		if (BuffStartAbs >= NumOfLinesInBuff) {
+			BuffStartAbs = 0;
+		}
+		if (ColdOpenLines == ColdBlockLines) {
+			ColdCloseBlock();
+		}
+	}
+
+	ColdSpill();
+
+	// ǉO ColdOpen WJLbV͌ÂȂ
+	for (i = 0; i < ColdCacheSlots; i++) {
+		if (ColdCacheTag[i] >= open_tag) {
+			ColdCacheTag[i] = -1;
+			ColdCacheUse[i] = 0;
+		}
+	}
 }
 
 static BOOL ChangeBuffer(int Nx, int Ny)
 {
-	LONG NewSize;
+	LONG NewSize, NewColdSize;
 	int NxCopy, NyCopy, i;
 	LONG SrcPtr, DestPtr;
 	WORD LockOld;
@@ -479,22 +1372,28 @@ static BOOL ChangeBuffer(int Nx, int Ny)
 
 	NewSize = (LONG)Nx * (LONG)Ny;
 
+	// kXN[obt@̃LbV̓Oobt@̌ɒu
+	NewColdSize = 0;
+	if (ts.EnableScrollBuff > 0 && ts.ScrollBuffColdSize > 0) {
+		NewColdSize = (LONG)ColdCacheSlots * ColdBlockLines * Nx;
+	}
+
 	CodeDestW = NULL;
-	CodeDestW = malloc(NewSize * sizeof(buff_char_t));
+	CodeDestW = malloc((NewSize + NewColdSize) * sizeof(buff_char_t));
 	if (CodeDestW == NULL) {
 		goto allocate_error;
 	}
 
-	memset(&CodeDestW[0], 0, NewSize * sizeof(buff_char_t));
+	memset(&CodeDestW[0], 0, (NewSize + NewColdSize) * sizeof(buff_char_t));
 #if ENABLE_CELL_INDEX
 	{
 		int i;
-		for (i = 0; i < NewSize; i++) {
+		for (i = 0; i < NewSize + NewColdSize; i++) {
 			CodeDestW[i].idx = i;
 		}
 	}
 #endif
-	memsetW(&CodeDestW[0], 0x20, AttrDefaultFG, AttrDefaultBG, AttrDefault, AttrDefault, NewSize);
+	memsetW(&CodeDestW[0], 0x20, AttrDefaultFG, AttrDefaultBG, AttrDefault, AttrDefault, NewSize + NewColdSize);
 	if ( CodeBuffW != NULL ) {
 		if ( NumOfColumns > Nx ) {
 			NxCopy = Nx;
@@ -503,11 +1402,16 @@ static BOOL ChangeBuffer(int Nx, int Ny)
 			NxCopy = NumOfColumns;
 		}
 
-		if ( BuffEnd > Ny ) {
+		if (NewColdSize > 0 && BuffEnd - ColdLines > Ny) {
+			// 肫Ȃs͈kXN[obt@ֈڂ
+			ColdPushLines(BuffEnd - ColdLines - Ny);
+		}
+
+		if ( BuffEnd - ColdLines > Ny ) {
 			NyCopy = Ny;
 		}
 		else {
-			NyCopy = BuffEnd;
+			NyCopy = BuffEnd - ColdLines;
 		}
 		LockOld = BuffLock;
 		LockBuffer();
@@ -522,7 +1426,12 @@ static BOOL ChangeBuffer(int Nx, int Ny)
 			SrcPtr = NextLinePtr(SrcPtr);
 			DestPtr = DestPtr + (LONG)Nx;
 		}
-		FreeBuffer();
+		FreeCodeBuff();
+
+		if (NewColdSize == 0 && ColdLines > 0) {
+			ColdClear();
+		}
+		BuffLineBase += BuffEnd - (ColdLines + NyCopy);
 	}
 	else {
 		LockOld = 0;
@@ -531,8 +1440,8 @@ static BOOL ChangeBuffer(int Nx, int Ny)
 	}
 
 	if (Selected) {
-		SelectStart.y = SelectStart.y - BuffEnd + NyCopy;
-		SelectEnd.y = SelectEnd.y - BuffEnd + NyCopy;
+		SelectStart.y = SelectStart.y - BuffEnd + ColdLines + NyCopy;
+		SelectEnd.y = SelectEnd.y - BuffEnd + ColdLines + NyCopy;
 		if (SelectStart.y < 0) {
 			SelectStart.y = 0;
 			SelectStart.x = 0;
@@ -551,13 +1460,16 @@ static BOOL ChangeBuffer(int Nx, int Ny)
 	BufferSize = NewSize;
 	NumOfLinesInBuff = Ny;
 	BuffStartAbs = 0;
-	BuffEnd = NyCopy;
+	BuffEnd = ColdLines + NyCopy;
+	ColdCacheSize = NewColdSize;
+	TextRowsClear();
+	ColdInvalidateCache();
 
-	if (BuffEnd==NumOfLinesInBuff) {
+	if (NyCopy==NumOfLinesInBuff) {
 		BuffEndAbs = 0;
 	}
 	else {
-		BuffEndAbs = BuffEnd;
+		BuffEndAbs = NyCopy;
 	}
 
 	PageStart = BuffEnd - NumOfLines;
@@ -644,11 +1556,11 @@ void UnlockBuffer(void)
 	}
 }
 
-void FreeBuffer(void)
+static void FreeCodeBuff(void)
 {
-	int i;
+	LONG i;
 
-	for (i = 0; i < NumOfColumns * NumOfLinesInBuff; i++) {
+	for (i = 0; i < BufferSize + ColdCacheSize; i++) {
 		FreeCombinationBuf(&CodeBuffW[i]);
 	}
 
@@ -658,6 +1570,24 @@ void FreeBuffer(void)
 		free(CodeBuffW);
 		CodeBuffW = NULL;
 	}
+
+	free(DirtyBits);
+	DirtyBits = NULL;
+	free(DirtyGen);
+	DirtyGen = NULL;
+	DirtyLines = 0;
+	DirtyWords = 0;
+
+	if (CombTableUsed == 0) {
+		// ۑ(SaveBuff)Ȃǂ܂߂ČgpĂȂ
+		CombFreeAll();
+	}
+}
+
+void FreeBuffer(void)
+{
+	FreeCodeBuff();
+	ColdClear();
 }
 
 void BuffAllSelect(void)
@@ -745,6 +1675,11 @@ static void BuffScroll(int Count, int Bottom)
 		Count = NumOfLinesInBuff;
 	}
 
+	if (ColdCacheSize > 0 && BuffEnd - ColdLines + Count > NumOfLinesInBuff) {
+		// Oobt@牟oskXN[obt@ֈڂ
+		ColdPushLines(BuffEnd - ColdLines + Count - NumOfLinesInBuff);
+	}
+
 	DestPtr = GetLinePtr(PageStart+NumOfLines-1+Count);
 	n = Count;
 	if (Bottom<NumOfLines-1) {
@@ -769,12 +1704,19 @@ static void BuffScroll(int Count, int Bottom)
 	}
 	BuffEndOld = BuffEnd;
 	BuffEnd = BuffEnd + Count;
-	if (BuffEnd >= NumOfLinesInBuff) {
-		BuffEnd = NumOfLinesInBuff;
+	if (BuffEnd - ColdLines >= NumOfLinesInBuff) {
+		BuffEnd = ColdLines + NumOfLinesInBuff;
 		BuffStartAbs = BuffEndAbs;
 	}
+	if (ColdLines > ts.ScrollBuffColdSize) {
+		BuffEnd -= ColdTrim();
+	}
+	BuffLineBase += BuffEndOld + Count - BuffEnd;
 	PageStart = BuffEnd-NumOfLines;
 
+	// ʏ̑Ssړ
+	DirtyMarkAll();
+
 	if (Selected) {
 		SelectStart.y = SelectStart.y - Count + BuffEnd - BuffEndOld;
 		SelectEnd.y = SelectEnd.y - Count + BuffEnd - BuffEndOld;
@@ -939,20 +1881,26 @@ void BuffEraseCurToEnd(void)
 	if (StatusLine && !isCursorOnStatusLine) {
 		YEnd--;
 	}
+	if (head == 1) {
+		XStart--;
+	}
 	for (i = CursorY ; i <= YEnd ; i++) {
+		int first, last;
+		BOOL changed = memsetWChangedRange(&(CodeBuffW[TmpPtr+offset]),0x20,CurCharAttr.Fore, CurCharAttr.Back, AttrDefault, CurCharAttr.Attr2 & Attr2ColorMask, NumOfColumns-offset, &first, &last);
 		memsetW(&(CodeBuffW[TmpPtr+offset]),0x20,CurCharAttr.Fore, CurCharAttr.Back, AttrDefault, CurCharAttr.Attr2 & Attr2ColorMask, NumOfColumns-offset);
+
+		/* update window */
+		//	ωZ`悷
+		if (i == CursorY && head == 1) {
+			// Sp̍
+			BuffDrawLineI(-1, -1, i + PageStart, XStart, changed ? offset + last : offset);
+		}
+		else if (changed) {
+			BuffDrawLineI(-1, -1, i + PageStart, offset + first, offset + last);
+		}
 		offset = 0;
 		TmpPtr = NextLinePtr(TmpPtr);
 	}
-
-	/* update window */
-	if (head == 1) {
-		XStart--;
-	}
-	BuffDrawLineI(-1, -1, CursorY + PageStart, XStart, NumOfColumns);
-	for (i = CursorY + 1; i <= YEnd; i++) {
-		BuffDrawLineI(-1, -1, i + PageStart, 0, NumOfColumns);
-	}
 }
 
 /**
@@ -979,20 +1927,27 @@ void BuffEraseHomeToCur(void)
 		YHome = 0;
 	}
 	TmpPtr = GetLinePtr(PageStart+YHome);
+	draw_len = tail == 0 ? CursorX : CursorX + 1;
 	for (i = YHome ; i <= CursorY ; i++) {
+		int first, last;
+		BOOL changed;
 		if (i==CursorY) {
 			offset = CursorX+1;
 		}
+		changed = memsetWChangedRange(&(CodeBuffW[TmpPtr]),0x20, CurCharAttr.Fore, CurCharAttr.Back, AttrDefault, CurCharAttr.Attr2 & Attr2ColorMask, offset, &first, &last);
 		memsetW(&(CodeBuffW[TmpPtr]),0x20, CurCharAttr.Fore, CurCharAttr.Back, AttrDefault, CurCharAttr.Attr2 & Attr2ColorMask, offset);
-		TmpPtr = NextLinePtr(TmpPtr);
-	}
 
-	/* update window */
-	draw_len = tail == 0 ? CursorX : CursorX + 1;
-	for (i = YHome; i < CursorY; i++) {
-		BuffDrawLineI(-1, -1, i + PageStart, 0, NumOfColumns);
+		/* update window */
+		//	ωZ`悷
+		if (i == CursorY && tail != 0) {
+			// Sp̉E
+			BuffDrawLineI(-1, -1, i + PageStart, changed ? first : CursorX, draw_len);
+		}
+		else if (changed) {
+			BuffDrawLineI(-1, -1, i + PageStart, first, last);
+		}
+		TmpPtr = NextLinePtr(TmpPtr);
 	}
-	BuffDrawLineI(-1, -1, CursorY + PageStart, 0, draw_len);
 }
 
 void BuffInsertLines(int Count, int YEnd)
@@ -1026,7 +1981,7 @@ void BuffInsertLines(int Count, int YEnd)
 		DestPtr = PrevLinePtr(DestPtr);
 	}
 
-	if (CursorLeftM > 0 || CursorRightM < NumOfColumns-1 || !DispInsertLines(Count, YEnd)) {
+	if (CursorLeftM > 0 || CursorRightM < NumOfColumns-1 || DrawDeferred || !DispInsertLines(Count, YEnd)) {
 		BuffUpdateRect(CursorLeftM-extl, CursorY, CursorRightM+extr, YEnd);
 	}
 }
@@ -1042,6 +1997,8 @@ void BuffEraseCharsInLine(int XStart, int Count)
 	BOOL LineContinued=FALSE;
 	int head = 0;
 	int tail = 0;
+	int first, last;
+	BOOL changed;
 
 	if (ts.EnableContinuedLineCopy && XStart == 0 && (CodeLineW[0].attr & AttrLineContinued)) {
 		LineContinued = TRUE;
@@ -1062,6 +2019,7 @@ void BuffEraseCharsInLine(int XStart, int Count)
 	}
 
 	NewLine(PageStart+CursorY);
+	changed = memsetWChangedRange(&(CodeLineW[XStart]),0x20, CurCharAttr.Fore, CurCharAttr.Back, AttrDefault, CurCharAttr.Attr2 & Attr2ColorMask, Count, &first, &last);
 	memsetW(&(CodeLineW[XStart]),0x20, CurCharAttr.Fore, CurCharAttr.Back, AttrDefault, CurCharAttr.Attr2 & Attr2ColorMask, Count);
 
 	if (ts.EnableContinuedLineCopy) {
@@ -1074,6 +2032,13 @@ void BuffEraseCharsInLine(int XStart, int Count)
 		}
 	}
 
+	if (head == 0 && tail == 0) {
+		//	ωZ`悷
+		if (changed) {
+			BuffDrawLineI(-1, -1, CursorY + PageStart, XStart + first, XStart + last);
+		}
+		return;
+	}
 	if (head != 0) {
 		XStart -= 1;
 		Count += 1;
@@ -1115,7 +2080,7 @@ void BuffDeleteLines(int Count, int YEnd)
 		DestPtr = NextLinePtr(DestPtr);
 	}
 
-	if (CursorLeftM > 0 || CursorRightM < NumOfColumns-1 || ! DispDeleteLines(Count,YEnd)) {
+	if (CursorLeftM > 0 || CursorRightM < NumOfColumns-1 || DrawDeferred || ! DispDeleteLines(Count,YEnd)) {
 		BuffUpdateRect(CursorLeftM-extl, CursorY, CursorRightM+extr, YEnd);
 	}
 }
@@ -1403,6 +2368,28 @@ void BuffCopyBox(
 	BuffUpdateRect(DstX,DstY,DstX+C-1,DstY+L-1);
 }
 
+/**
+ *	Z̃Agr[gύX(DECCARA)
+ *
+ *	@retval	TRUE	Zω
+ */
+static BOOL ChangeCellAttr(buff_char_t *b, const PCharAttr attr, const PCharAttr mask)
+{
+	unsigned char a = (b->attr & ~mask->Attr) | attr->Attr;
+	unsigned char a2 = (b->attr2 & ~mask->Attr2) | attr->Attr2;
+	unsigned char fg = (mask->Attr2 & Attr2Fore) ? attr->Fore : b->fg;
+	unsigned char bg = (mask->Attr2 & Attr2Back) ? attr->Back : b->bg;
+
+	if (b->attr == a && b->attr2 == a2 && b->fg == fg && b->bg == bg) {
+		return FALSE;
+	}
+	b->attr = a;
+	b->attr2 = a2;
+	b->fg = fg;
+	b->bg = bg;
+	return TRUE;
+}
+
 void BuffChangeAttrBox(int XStart, int YStart, int XEnd, int YEnd, const PCharAttr attr, const PCharAttr mask)
 {
 	int C, i, j;
@@ -1421,28 +2408,38 @@ void BuffChangeAttrBox(int XStart, int YStart, int XEnd, int YEnd, const PCharAt
 	Ptr = GetLinePtr(PageStart+YStart);
 
 	if (mask) { // DECCARA
+		// ωZ͈̔͂sƂɕ`悷
 		for (i=YStart; i<=YEnd; i++) {
+			int first = -1;
+			int last = -1;
 			j = Ptr+XStart-1;
 			if (XStart>0 && (CodeBuffW[j].attr & AttrKanji)) {
-				CodeBuffW[j].attr = (CodeBuffW[j].attr & ~mask->Attr) | attr->Attr;
-				CodeBuffW[j].attr2 = (CodeBuffW[j].attr2 & ~mask->Attr2) | attr->Attr2;
-				if (mask->Attr2 & Attr2Fore) { CodeBuffW[j].fg = attr->Fore; }
-				if (mask->Attr2 & Attr2Back) { CodeBuffW[j].bg = attr->Back; }
+				if (ChangeCellAttr(&CodeBuffW[j], attr, mask)) {
+					first = last = j - Ptr;
+				}
 			}
 			while (++j < Ptr+XStart+C) {
-				CodeBuffW[j].attr = (CodeBuffW[j].attr & ~mask->Attr) | attr->Attr;
-				CodeBuffW[j].attr2 = (CodeBuffW[j].attr2 & ~mask->Attr2) | attr->Attr2;
-				if (mask->Attr2 & Attr2Fore) { CodeBuffW[j].fg = attr->Fore; }
-				if (mask->Attr2 & Attr2Back) { CodeBuffW[j].bg = attr->Back; }
+				if (ChangeCellAttr(&CodeBuffW[j], attr, mask)) {
+					if (first < 0) {
+						first = j - Ptr;
+					}
+					last = j - Ptr;
+				}
 			}
 			if (XStart+C<NumOfColumns && (CodeBuffW[j-1].attr & AttrKanji)) {
-				CodeBuffW[j].attr = (CodeBuffW[j].attr & ~mask->Attr) | attr->Attr;
-				CodeBuffW[j].attr2 = (CodeBuffW[j].attr2 & ~mask->Attr2) | attr->Attr2;
-				if (mask->Attr2 & Attr2Fore) { CodeBuffW[j].fg = attr->Fore; }
-				if (mask->Attr2 & Attr2Back) { CodeBuffW[j].bg = attr->Back; }
+				if (ChangeCellAttr(&CodeBuffW[j], attr, mask)) {
+					if (first < 0) {
+						first = j - Ptr;
+					}
+					last = j - Ptr;
+				}
+			}
+			if (first >= 0) {
+				BuffUpdateRect(first, i, last, i);
 			}
 			Ptr = NextLinePtr(Ptr);
 		}
+		return;
 	}
 	else { // DECRARA
 		for (i=YStart; i<=YEnd; i++) {
@@ -1766,9 +2763,11 @@ static wchar_t *BuffGetStringForCB(int sx, int sy, int ex, int ey, BOOL box_sele
 		while (x < IEnd) {
 			const buff_char_t *b = &CodeBuffW[TmpPtr + x];
 			if (b->u32 != 0) {
-				str_w[k++] = b->wc2[0];
-				if (b->wc2[1] != 0) {
-					str_w[k++] = b->wc2[1];
+				wchar_t wc2[2];
+				GetWC2(b, wc2);
+				str_w[k++] = wc2[0];
+				if (wc2[1] != 0) {
+					str_w[k++] = wc2[1];
 				}
 				if (k + 2 >= str_size) {
 					str_size *= 2;
@@ -1776,13 +2775,14 @@ static wchar_t *BuffGetStringForCB(int sx, int sy, int ex, int ey, BOOL box_sele
 				}
 				{
 					int i;
+					const buff_comb_t *comb = GetComb(b);
 					// Rrl[V
-					if (k + b->CombinationCharCount16 >= str_size) {
-						str_size += + b->CombinationCharCount16;
+					if (k + comb->CombinationCharCount16 >= str_size) {
+						str_size += + comb->CombinationCharCount16;
 						str_w = realloc(str_w, sizeof(wchar_t) * str_size);
 					}
-					for (i = 0 ; i < (int)b->CombinationCharCount16; i++) {
-						str_w[k++] = b->pCombinationChars16[i];
+					for (i = 0 ; i < (int)comb->CombinationCharCount16; i++) {
+						str_w[k++] = comb->pCombinationChars16[i];
 					}
 				}
 			}
@@ -1827,6 +2827,8 @@ static wchar_t *BuffGetStringForCB(int sx, int sy, int ex, int ey, BOOL box_sele
 static size_t expand_wchar(const buff_char_t *b, wchar_t *buf, size_t buf_size, BOOL *too_samll)
 {
 	size_t len;
+	wchar_t wc2[2];
+	const buff_comb_t *comb;
 
 	if (IsBuffPadding(b)) {
 		if (too_samll != NULL) {
@@ -1834,10 +2836,12 @@ static size_t expand_wchar(const buff_char_t *b, wchar_t *buf, size_t buf_size,
 		}
 		return 0;
 	}
+	GetWC2(b, wc2);
+	comb = GetComb(b);
 
 	// 𑪂
 	len = 0;
-	if (b->wc2[1] == 0) {
+	if (wc2[1] == 0) {
 		// TQ[gyAł͂Ȃ
 		len++;
 	} else {
@@ -1845,7 +2849,7 @@ static size_t expand_wchar(const buff_char_t *b, wchar_t *buf, size_t buf_size,
 		len += 2;
 	}
 	// Rrl[V
-	len += b->CombinationCharCount16;
+	len += comb->CombinationCharCount16;
 
 	if (buf == NULL) {
 		// Ԃ
@@ -1865,12 +2869,12 @@ static size_t expand_wchar(const buff_char_t *b, wchar_t *buf, size_t buf_size,
 	}
 
 	// WJĂ
-	*buf++ = b->wc2[0];
-	if (b->wc2[1] != 0) {
-		*buf++ = b->wc2[1];
+	*buf++ = wc2[0];
+	if (wc2[1] != 0) {
+		*buf++ = wc2[1];
 	}
-	if (b->CombinationCharCount16 != 0) {
-		memcpy(buf, b->pCombinationChars16, b->CombinationCharCount16 * sizeof(wchar_t));
+	if (comb->CombinationCharCount16 != 0) {
+		memcpy(buf, comb->pCombinationChars16, comb->CombinationCharCount16 * sizeof(wchar_t));
 	}
 
 	return len;
@@ -1889,12 +2893,16 @@ static size_t expand_wchar(const buff_char_t *b, wchar_t *buf, size_t buf_size,
 static size_t MatchOneStringPtr(const buff_char_t *b, const wchar_t *str, size_t len)
 {
 	int match_pos = 0;
+	wchar_t wc2[2];
+	const buff_comb_t *comb;
 	if (len == 0) {
 		return 0;
 	}
-	if (b->wc2[1] == 0) {
+	GetWC2(b, wc2);
+	comb = GetComb(b);
+	if (wc2[1] == 0) {
 		// TQ[gyAł͂Ȃ
-		if (str[match_pos] != b->wc2[0]) {
+		if (str[match_pos] != wc2[0]) {
 			return 0;
 		}
 		match_pos++;
@@ -1904,25 +2912,25 @@ static size_t MatchOneStringPtr(const buff_char_t *b, const wchar_t *str, size_t
 		if (len < 2) {
 			return 0;
 		}
-		if (str[match_pos+0] != b->wc2[0] ||
-			str[match_pos+1] != b->wc2[1]) {
+		if (str[match_pos+0] != wc2[0] ||
+			str[match_pos+1] != wc2[1]) {
 			return 0;
 		}
 		match_pos+=2;
 		len-=2;
 	}
-	if (b->CombinationCharCount16 > 0) {
+	if (comb->CombinationCharCount16 > 0) {
 		// Rrl[V
 		int i;
-		if (len < b->CombinationCharCount16) {
+		if (len < comb->CombinationCharCount16) {
 			return 0;
 		}
-		for (i = 0 ; i < (int)b->CombinationCharCount16; i++) {
-			if (str[match_pos++] != b->pCombinationChars16[i]) {
+		for (i = 0 ; i < (int)comb->CombinationCharCount16; i++) {
+			if (str[match_pos++] != comb->pCombinationChars16[i]) {
 				return 0;
 			}
 		}
-		len -= b->CombinationCharCount16;
+		len -= comb->CombinationCharCount16;
 	}
 	return match_pos;
 }
@@ -2003,125 +3011,458 @@ static BOOL MatchStringPtr(const buff_char_t *b, const wchar_t *str, BOOL LineCo
 		}
 	}
 
-	return result;
+	return result;
+}
+#endif
+
+/**
+ *	(x,y) strƓꂩׂ
+ *
+ *	@param		x		}CiX̎A̍sΏۂɂȂ
+ *	@param		y		PageStart + CursorY
+ *	@param		LineCntinued	TRUE=špl
+ *	@retval		TRUE	}b`
+ *	@retval		FALSE	}b`ĂȂ
+ */
+static BOOL MatchString(int x, int y, const wchar_t *str, BOOL LineContinued)
+{
+	BOOL result;
+	int TmpPtr = GetLinePtr(y);
+	size_t len = wcslen(str);
+	if (len == 0) {
+		return FALSE;
+	}
+	while(x < 0) {
+		if (LineContinued && (CodeBuffW[TmpPtr+0].attr & AttrLineContinued) == 0) {
+			// spĂ邩l & pĂȂ
+			x = 0;	// sƂ
+			break;
+		}
+		TmpPtr = PrevLinePtr(TmpPtr);
+		x += NumOfColumns;
+		y--;
+	}
+	while(x > NumOfColumns) {
+		if (LineContinued && (CodeBuffW[TmpPtr+NumOfColumns-1].attr & AttrLineContinued) == 0) {
+			// spĂ邩l & pĂȂ
+			x = 0;	// sƂ
+			break;
+		}
+		TmpPtr = NextLinePtr(TmpPtr);
+		x -= NumOfColumns;
+	}
+
+	for(;;) {
+		// 1ꂩׂ
+		size_t match_len = MatchOneString(x, y, str, len);
+		if (match_len == 0) {
+			result = FALSE;
+			break;
+		}
+		len -= match_len;
+		if (len == 0) {
+			// S׏I
+			result = TRUE;
+			break;
+		}
+		str += match_len;
+
+		// ̕
+		x++;
+		if (x == NumOfColumns) {
+			if (LineContinued && (CodeBuffW[TmpPtr+NumOfColumns-1].attr & AttrLineContinued) != 0) {
+				// ̍s
+				x = 0;
+				TmpPtr = NextLinePtr(TmpPtr);
+				y++;
+			} else {
+				// s
+				result = FALSE;
+				break;
+			}
+		}
+	}
+
+	return result;
+}
+
+/**
+ *	(sx,sy)(ex,ey)܂ł str Ƀ}b`镶T
+ *	ʒuԂ
+ *
+ *	@param		sy,ex	PageStart + CursorY
+ *	@param[out]	x		}b`ʒu
+ *	@param[out]	y		}b`ʒu
+ *	@retval		TRUE	}b`
+ */
+static BOOL BuffGetMatchPosFromString(
+	int sx, int sy, int ex, int ey, const wchar_t *str,
+	int *match_x, int *match_y)
+{
+	int IStart, IEnd;
+	int x, y;
+
+	for (y = sy; y<=ey ; y++) {
+		IStart = 0;
+		IEnd = NumOfColumns-1;
+		if (y== sy) {
+			IStart = sx;
+		}
+		if (y== ey) {
+			IEnd = ex;
+		}
+
+		x = IStart;
+		while (x <= IEnd) {
+			if (MatchString(x, y, str, TRUE)) {
+				// }b`
+				if (match_x != NULL) {
+					*match_x = x;
+				}
+				if (match_y != NULL) {
+					*match_y = y;
+				}
+				return TRUE;
+			}
+			x++;
+		}
+	}
+	return FALSE;
+}
+
+
+/*
+ *	XN[obt@̌
+ *
+ *	sƂɕ(BuffTextRow)ČXbh(buffsearch.c)ɓnB
+ *	Xbhv邽т BUFF_FIND_CHUNK s̂ŁA
+ *	XN[obt@傫Ă UI Xbh͎~܂ȂB
+ *	ʂ̍s͕ωȂ̂ŁALbVĎ̌ŎgB
+ *	s͉oĂςȂʂԍ(BuffLineBase + sԍ)ŎʂB
+ */
+
+#define BUFF_FIND_CHUNK	2048		// xɍs
+
+static void TextRowsClear(void)
+{
+	int i;
+	for (i = 0; i < TextRowsNum; i++) {
+		BuffTextRowRelease(TextRows[i]);
+	}
+	free(TextRows);
+	TextRows = NULL;
+	TextRowsNum = 0;
+	TextRowsCap = 0;
+}
+
+/**
+ *	LbVʂԍ [first, last) ͈̔͂ɂ
+ */
+static void TextRowsTrim(LONGLONG first, LONGLONG last)
+{
+	int i;
+	int n;
+
+	// oꂽs
+	n = 0;
+	while (n < TextRowsNum && TextRowsBase + n < first) {
+		BuffTextRowRelease(TextRows[n]);
+		n++;
+	}
+	if (n > 0) {
+		memmove(&TextRows[0], &TextRows[n], sizeof(BuffTextRow *) * (TextRowsNum - n));
+		TextRowsNum -= n;
+		TextRowsBase += n;
+	}
+
+	// ʓ̍s
+	for (i = TextRowsNum - 1; i >= 0 && TextRowsBase + i >= last; i--) {
+		BuffTextRowRelease(TextRows[i]);
+		TextRowsNum--;
+	}
+}
+
+/**
+ *	ʂԍ [first, first + count) ̍sLbVɉ
+ *	LbVƗĂƂ͉Ȃ
+ */
+static void TextRowsMerge(LONGLONG first, BuffTextRow **rows, int count)
+{
+	LONGLONG last = first + count;
+	LONGLONG old_end;
+	LONGLONG new_base;
+	LONGLONG new_end;
+	LONGLONG line;
+	int num;
+	int head;
+
+	if (count <= 0) {
+		return;
+	}
+	if (TextRowsNum == 0) {
+		TextRowsBase = first;
+	}
+	else if (last < TextRowsBase || first > TextRowsBase + TextRowsNum) {
+		return;
+	}
+	old_end = TextRowsBase + TextRowsNum;
+	new_base = first < TextRowsBase ? first : TextRowsBase;
+	new_end = last > old_end ? last : old_end;
+	num = (int)(new_end - new_base);
+	if (num > TextRowsCap) {
+		int cap = TextRowsCap == 0 ? 1024 : TextRowsCap;
+		BuffTextRow **p;
+		while (cap < num) {
+			cap *= 2;
+		}
+		p = realloc(TextRows, sizeof(BuffTextRow *) * cap);
+		if (p == NULL) {
+			return;
+		}
+		TextRows = p;
+		TextRowsCap = cap;
+	}
+
+	// Oɉ
+	head = (int)(TextRowsBase - new_base);
+	if (head > 0) {
+		memmove(&TextRows[head], &TextRows[0], sizeof(BuffTextRow *) * TextRowsNum);
+		for (line = new_base; line < TextRowsBase; line++) {
+			BuffTextRow *row = rows[line - first];
+			BuffTextRowAddRef(row);
+			TextRows[line - new_base] = row;
+		}
+	}
+	// ɉ
+	for (line = old_end; line < new_end; line++) {
+		BuffTextRow *row = rows[line - first];
+		BuffTextRowAddRef(row);
+		TextRows[line - new_base] = row;
+	}
+	TextRowsBase = new_base;
+	TextRowsNum = num;
+}
+
+/**
+ *	1s̕
+ *	s̋󔒂͊܂߂Ȃ
+ */
+static BuffTextRow *MakeTextRow(int y)
+{
+	const buff_char_t *b = &CodeBuffW[GetLinePtr(y)];
+	BuffTextRow *row;
+	int x;
+	int len = 0;
+	int keep_len = 0;
+	int cells = 0;
+	int irregular = NumOfColumns;	// ŏ text[i] ̃Zʒu i ɂȂȂZ
+
+	for (x = 0; x < NumOfColumns; x++) {
+		size_t l;
+		if (IsBuffPadding(&b[x])) {
+			if (irregular > x) {
+				irregular = x;
+			}
+			continue;
+		}
+		l = expand_wchar(&b[x], NULL, 0, NULL);
+		if (irregular > x && (l != 1 || b[x].cell != 1)) {
+			irregular = x;
+		}
+		len += (int)l;
+		if (b[x].u32 != 0x20 || b[x].comb != 0) {
+			keep_len = len;
+			cells = x + b[x].cell;
+		}
+	}
+	if (cells > NumOfColumns) {
+		cells = NumOfColumns;
+	}
+
+	row = BuffTextRowAlloc(keep_len, irregular < cells);
+	if (row == NULL) {
+		return NULL;
+	}
+	row->cells = cells;
+	len = 0;
+	for (x = 0; x < cells; x++) {
+		size_t l;
+		if (IsBuffPadding(&b[x])) {
+			continue;
+		}
+		l = expand_wchar(&b[x], &row->text[len], keep_len - len, NULL);
+		if (row->x != NULL) {
+			size_t i;
+			for (i = 0; i < l; i++) {
+				row->x[len + i] = (WORD)x;
+			}
+		}
+		len += (int)l;
+	}
+	return row;
+}
+
+/**
+ *	XN[obt@̌Jn
+ *	ƂƌIƂ hWnd  msg 𑗂
+ *
+ *	@param	options		BUFF_SEARCH_REGEX, BUFF_SEARCH_IGNORECASE
+ *	@param	error		JnłȂR(K\̌Ȃ), free() 邱
+ *	@retval	FALSE		JnłȂ
+ */
+BOOL BuffFindStart(const wchar_t *pattern, DWORD options, HWND hWnd, UINT msg, wchar_t **error)
+{
+	if (error != NULL) {
+		*error = NULL;
+	}
+	BuffSearchEnd(Search);
+	Search = NULL;
+
+	// ʓ̍s͕ω̂ŃLbVȂ
+	TextRowsTrim(BuffLineBase, BuffLineBase + PageStart);
+
+	Search = BuffSearchStart(pattern, options, hWnd, msg, error);
+	if (Search == NULL) {
+		return FALSE;
+	}
+	FindFeedLine = BuffLineBase + BuffEnd;
+	BuffFindFeed();
+	return TRUE;
+}
+
+/**
+ *	XbhɎ̍sn
+ *	ʂɋ߂̍s BUFF_FIND_CHUNK sn
+ *	Xbh BUFF_SEARCH_NEED_ROWS ͂ƂɌĂ
+ */
+void BuffFindFeed(void)
+{
+	LONGLONG screen_top = BuffLineBase + PageStart;
+	LONGLONG first;
+	LONGLONG last;
+	BuffTextRow **rows = NULL;
+	int count = 0;
+	int i;
+
+	if (Search == NULL || !BuffSearchWantRows(Search)) {
+		return;
+	}
+
+	last = FindFeedLine;
+	if (last > BuffLineBase + BuffEnd) {
+		// obt@Ȃ
+		last = BuffLineBase + BuffEnd;
+	}
+	first = last - BUFF_FIND_CHUNK;
+	if (first < BuffLineBase) {
+		// oꂽs͒TȂ
+		first = BuffLineBase;
+	}
+	if (last > first) {
+		count = (int)(last - first);
+		rows = malloc(sizeof(BuffTextRow *) * count);
+		if (rows == NULL) {
+			count = 0;
+		}
+	}
+	for (i = 0; i < count; i++) {
+		LONGLONG line = first + i;
+		BuffTextRow *row;
+		if (line >= TextRowsBase && line < TextRowsBase + TextRowsNum) {
+			row = TextRows[line - TextRowsBase];
+			BuffTextRowAddRef(row);
+		}
+		else {
+			row = MakeTextRow((int)(line - BuffLineBase));
+			if (row == NULL) {
+				// ŌI
+				while (i > 0) {
+					BuffTextRowRelease(rows[--i]);
+				}
+				free(rows);
+				rows = NULL;
+				count = 0;
+				break;
+			}
+		}
+		rows[i] = row;
+	}
+
+	if (count > 0 && first < screen_top) {
+		LONGLONG end = last < screen_top ? last : screen_top;
+		TextRowsMerge(first, rows, (int)(end - first));
+	}
+	FindFeedLine = first;
+	BuffSearchAddRows(Search, rows, count, first, count == 0 || first <= BuffLineBase);
 }
-#endif
 
 /**
- *	(x,y) strƓꂩׂ
+ *	Ԃ
  *
- *	@param		x		}CiX̎A̍sΏۂɂȂ
- *	@param		y		PageStart + CursorY
- *	@param		LineCntinued	TRUE=špl
- *	@retval		TRUE	}b`
- *	@retval		FALSE	}b`ĂȂ
+ *	@param	done	TRUE=I
  */
-static BOOL MatchString(int x, int y, const wchar_t *str, BOOL LineContinued)
+int BuffFindGetCount(BOOL *done)
 {
-	BOOL result;
-	int TmpPtr = GetLinePtr(y);
-	size_t len = wcslen(str);
-	if (len == 0) {
-		return FALSE;
-	}
-	while(x < 0) {
-		if (LineContinued && (CodeBuffW[TmpPtr+0].attr & AttrLineContinued) == 0) {
-			// spĂ邩l & pĂȂ
-			x = 0;	// sƂ
-			break;
-		}
-		TmpPtr = PrevLinePtr(TmpPtr);
-		x += NumOfColumns;
-		y--;
-	}
-	while(x > NumOfColumns) {
-		if (LineContinued && (CodeBuffW[TmpPtr+NumOfColumns-1].attr & AttrLineContinued) == 0) {
-			// spĂ邩l & pĂȂ
-			x = 0;	// sƂ
-			break;
-		}
-		TmpPtr = NextLinePtr(TmpPtr);
-		x -= NumOfColumns;
-	}
-
-	for(;;) {
-		// 1ꂩׂ
-		size_t match_len = MatchOneString(x, y, str, len);
-		if (match_len == 0) {
-			result = FALSE;
-			break;
-		}
-		len -= match_len;
-		if (len == 0) {
-			// S׏I
-			result = TRUE;
-			break;
-		}
-		str += match_len;
-
-		// ̕
-		x++;
-		if (x == NumOfColumns) {
-			if (LineContinued && (CodeBuffW[TmpPtr+NumOfColumns-1].attr & AttrLineContinued) != 0) {
-				// ̍s
-				x = 0;
-				TmpPtr = NextLinePtr(TmpPtr);
-				y++;
-			} else {
-				// s
-				result = FALSE;
-				break;
-			}
+	if (Search == NULL) {
+		if (done != NULL) {
+			*done = TRUE;
 		}
+		return 0;
 	}
-
-	return result;
+	return BuffSearchGetCount(Search, done);
 }
 
 /**
- *	(sx,sy)(ex,ey)܂ł str Ƀ}b`镶T
- *	ʒuԂ
+ *	index ԖڂɌIĕ\
+ *	index 0 ł̍s(ʂɋ߂)
  *
- *	@param		sy,ex	PageStart + CursorY
- *	@param[out]	x		}b`ʒu
- *	@param[out]	y		}b`ʒu
- *	@retval		TRUE	}b`
+ *	@retval	FALSE	̍s͂Ȃ
  */
-static BOOL BuffGetMatchPosFromString(
-	int sx, int sy, int ex, int ey, const wchar_t *str,
-	int *match_x, int *match_y)
+BOOL BuffFindSelect(int index)
 {
-	int IStart, IEnd;
-	int x, y;
+	BuffSearchMatch m;
+	int y;
 
-	for (y = sy; y<=ey ; y++) {
-		IStart = 0;
-		IEnd = NumOfColumns-1;
-		if (y== sy) {
-			IStart = sx;
-		}
-		if (y== ey) {
-			IEnd = ex;
-		}
+	if (Search == NULL || !BuffSearchGetMatch(Search, index, &m)) {
+		return FALSE;
+	}
+	if (m.line < BuffLineBase || m.line >= BuffLineBase + BuffEnd) {
+		// oꂽ
+		return FALSE;
+	}
+	y = (int)(m.line - BuffLineBase);
+	if (m.ex > NumOfColumns) {
+		m.ex = NumOfColumns;
+	}
+	if (m.sx >= m.ex) {
+		return FALSE;
+	}
 
-		x = IStart;
-		while (x <= IEnd) {
-			if (MatchString(x, y, str, TRUE)) {
-				// }b`
-				if (match_x != NULL) {
-					*match_x = x;
-				}
-				if (match_y != NULL) {
-					*match_y = y;
-				}
-				return TRUE;
-			}
-			x++;
-		}
+	BoxSelect = FALSE;
+	Selecting = FALSE;
+	SelectStart.x = m.sx;
+	SelectStart.y = y;
+	SelectEnd.x = m.ex;
+	SelectEnd.y = y;
+	SelectEndOld = SelectEnd;
+	Selected = TRUE;
+
+	if (y < PageStart + WinOrgY || y >= PageStart + WinOrgY + WinHeight) {
+		DispVScroll(SCROLL_POS, y - WinHeight / 2);
 	}
-	return FALSE;
+	InvalidateRect(HVTWin, NULL, FALSE);
+	return TRUE;
 }
 
+/**
+ *	IāÃLbVj
+ */
+void BuffFindEnd(void)
+{
+	BuffSearchEnd(Search);
+	Search = NULL;
+	TextRowsClear();
+}
 
 /**
  *	AXy[X^u1ɒu
@@ -2266,12 +3607,12 @@ void BuffDumpCurrentLine(PrintFile *handle, BYTE TERM)
 	char *p = bufA;
 
 	i = NumOfColumns;
-	while ((i>0) && (b[i-1].ansi_char == 0x20)) {
+	while ((i>0) && (GetAnsiChar(&b[i-1]) == 0x20)) {
 		i--;
 	}
 	p = bufA;
 	for (j=0; j<i; j++) {
-		unsigned short c = b[j].ansi_char;
+		unsigned short c = GetAnsiChar(&b[j]);
 		*p++ = (c & 0xff);
 		if (c > 0x100) {
 			*p++ = (c & 0xff);
@@ -2747,20 +4088,24 @@ static void mark_url_w(int cur_x, int cur_y)
  */
 static wchar_t *GetWCS(const buff_char_t *b)
 {
-	size_t len = (b->wc2[1] == 0) ? 2 : 3;
+	const buff_comb_t *comb = GetComb(b);
+	size_t len;
+	wchar_t wc2[2];
 	wchar_t *strW;
 	wchar_t *p;
 	int i;
 
-	len += b->CombinationCharCount16;
+	GetWC2(b, wc2);
+	len = (wc2[1] == 0) ? 2 : 3;
+	len += comb->CombinationCharCount16;
 	strW = malloc(sizeof(wchar_t) * len);
 	p = strW;
-	*p++ = b->wc2[0];
-	if (b->wc2[1] != 0) {
-		*p++ = b->wc2[1];
+	*p++ = wc2[0];
+	if (wc2[1] != 0) {
+		*p++ = wc2[1];
 	}
-	for (i=0; i<b->CombinationCharCount16; i++) {
-		*p++ = b->pCombinationChars16[i];
+	for (i=0; i<comb->CombinationCharCount16; i++) {
+		*p++ = comb->pCombinationChars16[i];
 	}
 	*p = L'\0';
 	return strW;
@@ -2827,17 +4172,17 @@ static buff_char_t *IsCombiningChar(int x, int y, BOOL wrap, unsigned int u32, i
 
 	// ?
 	// 		1O ZWJ
-	if (combine_type != 0 || (p->u32_last == 0x200d)) {
+	if (combine_type != 0 || (GetU32Last(p) == 0x200d)) {
 		return p;
 	}
 
 	// B[}
-	if (UnicodeIsVirama(p->u32_last) != 0) {
+	if (UnicodeIsVirama(GetU32Last(p)) != 0) {
 		// 1ÕB[}Ɠ block ̕ł
-		int block_index_last = UnicodeBlockIndex(p->u32_last);
+		int block_index_last = UnicodeBlockIndex(GetU32Last(p));
 		int block_index = UnicodeBlockIndex(u32);
 #if 0
-		OutputDebugPrintf("U+%06x, %d, %s\n", p->u32_last, block_index_last, UnicodeBlockName(block_index_last));
+		OutputDebugPrintf("U+%06x, %d, %s\n", GetU32Last(p), block_index_last, UnicodeBlockName(block_index_last));
 		OutputDebugPrintf("U+%06x, %d, %s\n", u32, block_index, UnicodeBlockName(block_index));
 #endif
 		if (block_index_last == block_index) {
@@ -2919,6 +4264,7 @@ int BuffPutUnicode(unsigned int u32, const TCharAttr *Attr, BOOL Insert)
 	buff_char_t *p;
 	int combining_type;
 	BYTE Attr_Attr = Attr->Attr;
+	BOOL same_cell = FALSE;
 
 	assert(Attr_Attr == (Attr->AttrEx & 0xff));
 
@@ -2956,7 +4302,7 @@ int BuffPutUnicode(unsigned int u32, const TCharAttr *Attr, BOOL Insert)
 
 		// ͕́ANonspacing mark ȊO?
 		//		J[\+1, +1
-		if (p->u32_last != 0x200d && combining_type != 1) {
+		if (GetU32Last(p) != 0x200d && combining_type != 1) {
 			// J[\ړʂ1
 			move_x = 1;
 
@@ -3023,9 +4369,6 @@ int BuffPutUnicode(unsigned int u32, const TCharAttr *Attr, BOOL Insert)
 				}
 			}
 		}
-
-		// ANSIR[hXV
-		p->ansi_char = ConvertACPChar(p);
 	}
 	else {
 		char width_property;
@@ -3185,6 +4528,10 @@ int BuffPutUnicode(unsigned int u32, const TCharAttr *Attr, BOOL Insert)
 			else {
 				// Vǉ
 
+				// ŏ㏑邩?
+				same_cell = half_width && !emoji &&
+					IsSameCell(&CodeLineW[CursorX], u32, Attr->Fore, Attr->Back, Attr_Attr, Attr->Attr2);
+
 				if (half_width) {
 					// pƂĈ
 					move_x = 1;
@@ -3243,6 +4590,15 @@ int BuffPutUnicode(unsigned int u32, const TCharAttr *Attr, BOOL Insert)
 
 			// URĽo
 			mark_url_w(CursorX, CursorY);
+
+			if (same_cell &&
+				IsSameCell(&CodeLineW[CursorX], u32, Attr->Fore, Attr->Back, Attr_Attr, Attr->Attr2) &&
+				StrChangeStart + StrChangeCount - 1 == CursorX) {
+				// Z͕ωĂȂ̂ŕ`͈͂O
+				//	`͈͂͂ŋ؂ĕ`悷
+				StrChangeCount--;
+				UpdateStr();
+			}
 		}
 	}
 
@@ -3358,36 +4714,39 @@ void BuffGetDrawInfoW(int SY, int IStart, int IEnd,
 		}
 
 		if (SetString) {
+			const buff_comb_t *comb = GetComb(b);
+			wchar_t wc2[2];
+			GetWC2(b, wc2);
 			if (b->u32 < 0x10000) {
-				bufW[lenW] = b->wc2[0];
+				bufW[lenW] = wc2[0];
 				bufWW[lenW] = b->cell;
 				lenW++;
 			} else {
 				// UTF-16ŃTQ[gyA
-				bufW[lenW] = b->wc2[0];
+				bufW[lenW] = wc2[0];
 				bufWW[lenW] = 0;
 				lenW++;
-				bufW[lenW] = b->wc2[1];
+				bufW[lenW] = wc2[1];
 				bufWW[lenW] = b->cell;
 				lenW++;
 			}
-			if (b->CombinationCharCount16 != 0) {
+			if (comb->CombinationCharCount16 != 0) {
 				// Rrl[V
 				int i;
 				const char cell_tmp = bufWW[lenW - 1];
 				bufWW[lenW - 1] = 0;
-				for (i = 0; i < (int)b->CombinationCharCount16; i++) {
-					bufW[lenW + i] = b->pCombinationChars16[i];
+				for (i = 0; i < (int)comb->CombinationCharCount16; i++) {
+					bufW[lenW + i] = comb->pCombinationChars16[i];
 					bufWW[lenW + i] = 0;
 				}
-				bufWW[lenW + b->CombinationCharCount16 - 1] = cell_tmp;
-				lenW += b->CombinationCharCount16;
+				bufWW[lenW + comb->CombinationCharCount16 - 1] = cell_tmp;
+				lenW += comb->CombinationCharCount16;
 				DrawFlag = TRUE;  // Rrl[Vꍇ͂`
 			}
 
 			// ANSI
-			{
-				unsigned short ansi_char = b->ansi_char;
+			if (!UseUnicodeApi) {
+				unsigned short ansi_char = GetAnsiChar(b);
 				int i;
 				char cell = b->cell;
 				int c = 0;
@@ -3480,6 +4839,183 @@ static void l_disp_strA(const char *buf, const char *width_info, int count, void
 	data->draw_x = x;
 }
 
+/**
+ *	ĕ`͈͂NA
+ *	i߂邾Ŋes̃rbg}bv͎ɋL^ƂɃNA
+ */
+static void DirtyClear(void)
+{
+	DirtyGeneration++;
+	DirtyAny = FALSE;
+	DirtyAll = FALSE;
+}
+
+/**
+ *	EBhEŜĕ`ΏۂƂ
+ *	x`撆łȂΉȂ
+ */
+static void DirtyMarkAll(void)
+{
+	if (!DrawDeferred) {
+		return;
+	}
+	DirtyAny = TRUE;
+	DirtyAll = TRUE;
+}
+
+/**
+ *	ʃTCYɍ킹ărbg}bvmۂ
+ *	@retval	FALSE	mۂłȂ
+ */
+static BOOL DirtyAlloc(void)
+{
+	int words = (NumOfColumns + 31) / 32;
+	int y;
+
+	if (DirtyLines == NumOfLines && DirtyWords == words) {
+		return TRUE;
+	}
+	free(DirtyBits);
+	free(DirtyGen);
+	DirtyBits = (DWORD *)malloc(sizeof(DWORD) * words * NumOfLines);
+	DirtyGen = (DWORD *)malloc(sizeof(DWORD) * NumOfLines);
+	if (DirtyBits == NULL || DirtyGen == NULL) {
+		free(DirtyBits);
+		DirtyBits = NULL;
+		free(DirtyGen);
+		DirtyGen = NULL;
+		DirtyLines = 0;
+		DirtyWords = 0;
+		return FALSE;
+	}
+	DirtyLines = NumOfLines;
+	DirtyWords = words;
+	for (y = 0; y < DirtyLines; y++) {
+		DirtyGen[y] = DirtyGeneration - 1;
+	}
+	return TRUE;
+}
+
+/**
+ *	ĕ`͈͂L^
+ *
+ *	@param	XStart,XEnd		 (XN[W)
+ *	@param	Y				s (XN[W)
+ */
+static void DirtyMark(int XStart, int Y, int XEnd)
+{
+	DWORD *bits;
+	int x;
+
+	DirtyAny = TRUE;
+	if (DirtyAll) {
+		return;
+	}
+	if (DirtyLines != NumOfLines || DirtyWords != (NumOfColumns + 31) / 32) {
+		// ʃTCYς
+		BOOL resized = DirtyLines != 0;
+		if (!DirtyAlloc() || resized) {
+			DirtyAll = TRUE;
+			return;
+		}
+	}
+	if (Y < 0 || Y >= DirtyLines) {
+		// XN[obt@̍s
+		DirtyAll = TRUE;
+		return;
+	}
+	if (XStart < 0) {
+		XStart = 0;
+	}
+	if (XEnd >= NumOfColumns) {
+		XEnd = NumOfColumns - 1;
+	}
+	if (XStart > XEnd) {
+		return;
+	}
+
+	bits = &DirtyBits[Y * DirtyWords];
+	if (DirtyGen[Y] != DirtyGeneration) {
+		memset(bits, 0, sizeof(DWORD) * DirtyWords);
+		DirtyGen[Y] = DirtyGeneration;
+	}
+	x = XStart;
+	while (x <= XEnd) {
+		if ((x & 31) == 0 && x + 31 <= XEnd) {
+			bits[x >> 5] = 0xffffffff;
+			x += 32;
+		}
+		else {
+			bits[x >> 5] |= 1UL << (x & 31);
+			x++;
+		}
+	}
+}
+
+/**
+ *	s̍ĕ`悪KvȃZ̘A͈͂擾
+ *
+ *	@param	Y		s (XN[W)
+ *	@param	X		׎n߂錅
+ *	@param[out]	XEnd	͈͂̍Ō̌
+ *	@return	͈͂̐擪̌, ͈͂ȂƂ -1
+ */
+static int DirtyNextRun(int Y, int X, int *XEnd)
+{
+	const DWORD *bits = &DirtyBits[Y * DirtyWords];
+	int x = X;
+
+	if (DirtyGen[Y] != DirtyGeneration) {
+		return -1;
+	}
+	while (x < NumOfColumns && (bits[x >> 5] & (1UL << (x & 31))) == 0) {
+		if ((x & 31) == 0 && bits[x >> 5] == 0) {
+			x += 32;
+		}
+		else {
+			x++;
+		}
+	}
+	if (x >= NumOfColumns) {
+		return -1;
+	}
+	X = x;
+	while (x < NumOfColumns && (bits[x >> 5] & (1UL << (x & 31))) != 0) {
+		x++;
+	}
+	*XEnd = x - 1;
+	return X;
+}
+
+/**
+ *	XN[̈XN[
+ *	x`撆͉ʂXN[Ä̍sĕ`ΏۂƂ
+ */
+static void ScrollNLines(int Top, int Bottom, int Direction)
+{
+	if (DrawDeferred) {
+		int y;
+		for (y = Top; y <= Bottom; y++) {
+			DirtyMark(0, y, NumOfColumns - 1);
+		}
+		return;
+	}
+	DispScrollNLines(Top, Bottom, Direction);
+}
+
+/**
+ *	ʑŜ̃XN[s𐔂
+ *	x`撆̓EBhEŜĕ`ΏۂƂ
+ *	(\ʒu BuffUpdateScroll() ōXV)
+ */
+static void CountScroll(int n)
+{
+	if (DrawDeferred) {
+		DirtyMarkAll();
+		return;
+	}
+	DispCountScroll(n);
+}
 /**
  *	1s` ʗp
  *
@@ -3493,6 +5029,10 @@ static void BuffDrawLineI(int DrawX, int DrawY, int SY, int IStart, int IEnd)
 {
 	int X = DrawX;
 	int Y = DrawY;
+	if (DrawDeferred) {
+		DirtyMark(IStart, SY - PageStart, IEnd);
+		return;
+	}
 	{
 		// J[\ʒuA\Jnʒu`ʒu킩͂
 		int X2 = IStart;
@@ -3554,6 +5094,13 @@ void BuffUpdateRect
 	LONG TmpPtr;
 	BOOL TempSel, Caret;
 
+	if (DrawDeferred) {
+		for (j = YStart; j <= YEnd; j++) {
+			DirtyMark(XStart, j, XEnd);
+		}
+		return;
+	}
+
 	if (XStart >= WinOrgX+WinWidth) {
 		return;
 	}
@@ -3702,7 +5249,7 @@ void ScrollUp1Line(void)
 		if (CursorLeftM > 0 || CursorRightM < NumOfColumns-1)
 			BuffUpdateRect(CursorLeftM-extl, CursorTop, CursorRightM+extr, CursorBottom);
 		else
-			DispScrollNLines(CursorTop, CursorBottom, -1);
+			ScrollNLines(CursorTop, CursorBottom, -1);
 	}
 }
 
@@ -3725,7 +5272,7 @@ void BuffScrollNLines(int n)
 				NewOrgY = WinOrgY;
 			}
 			BuffScroll(n,CursorBottom);
-			DispCountScroll(n);
+			CountScroll(n);
 			return;
 		}
 		else if (CursorY <= CursorBottom) {
@@ -3735,10 +5282,10 @@ void BuffScrollNLines(int n)
 				WinOrgY = WinOrgY-n;
 				NewOrgY = WinOrgY;
 				BuffScroll(n,CursorBottom);
-				DispCountScroll(n);
+				CountScroll(n);
 			} else {
 				BuffScroll(n,CursorBottom);
-				DispScrollNLines(WinOrgY,CursorBottom,n);
+				ScrollNLines(WinOrgY,CursorBottom,n);
 			}
 			return;
 		}
@@ -3772,7 +5319,7 @@ void BuffScrollNLines(int n)
 		if (CursorLeftM > 0 || CursorRightM < NumOfColumns-1)
 			BuffUpdateRect(CursorLeftM-extl, CursorTop, CursorRightM+extr, CursorBottom);
 		else
-			DispScrollNLines(CursorTop, CursorBottom, n);
+			ScrollNLines(CursorTop, CursorBottom, n);
 	}
 }
 
@@ -3790,11 +5337,11 @@ void BuffRegionScrollUpNLines(int n) {
 		if (CursorBottom == NumOfLines-1) {
 			WinOrgY = WinOrgY-n;
 			BuffScroll(n,CursorBottom);
-			DispCountScroll(n);
+			CountScroll(n);
 		}
 		else {
 			BuffScroll(n,CursorBottom);
-			DispScrollNLines(WinOrgY,CursorBottom,n);
+			ScrollNLines(WinOrgY,CursorBottom,n);
 		}
 	}
 	else {
@@ -3827,7 +5374,7 @@ void BuffRegionScrollUpNLines(int n) {
 			BuffUpdateRect(CursorLeftM-extl, CursorTop, CursorRightM+extr, CursorBottom);
 		}
 		else {
-			DispScrollNLines(CursorTop, CursorBottom, n);
+			ScrollNLines(CursorTop, CursorBottom, n);
 		}
 	}
 }
@@ -3871,7 +5418,7 @@ void BuffRegionScrollDownNLines(int n) {
 		BuffUpdateRect(CursorLeftM-extl, CursorTop, CursorRightM+extr, CursorBottom);
 	}
 	else {
-		DispScrollNLines(CursorTop, CursorBottom, -n);
+		ScrollNLines(CursorTop, CursorBottom, -n);
 	}
 }
 
@@ -3883,7 +5430,7 @@ void BuffClearScreen(void)
 	else { /* clear main screen */
 		UpdateStr();
 		BuffScroll(NumOfLines-StatusLine,NumOfLines-1-StatusLine);
-		DispScrollNLines(WinOrgY,NumOfLines-1-StatusLine,NumOfLines-StatusLine);
+		ScrollNLines(WinOrgY,NumOfLines-1-StatusLine,NumOfLines-StatusLine);
 	}
 }
 
@@ -3891,9 +5438,95 @@ void BuffUpdateScroll(void)
 // Updates scrolling
 {
 	UpdateStr();
+	if (DrawDeferred) {
+		if (DispUpdateScrollPos()) {
+			DirtyMarkAll();
+		}
+		return;
+	}
 	DispUpdateScroll();
 }
 
+/**
+ *	x`Jn
+ *	BuffEndDeferredDraw() ܂ł̕`͍ĕ`͈͂ƂċL^
+ */
+void BuffStartDeferredDraw(void)
+{
+	DrawDeferred = TRUE;
+}
+
+/**
+ *	x`I
+ *	Õt[t[Ԋuo߂ĂΕ`悵A
+ *	łȂ IdRenderTimer ŕ`悷
+ */
+void BuffEndDeferredDraw(void)
+{
+	DWORD interval;
+	DWORD elapsed;
+
+	DrawDeferred = FALSE;
+	if (!DirtyAny) {
+		return;
+	}
+
+	interval = ts.RenderFrameRate > 0 ? 1000 / ts.RenderFrameRate : 0;
+	elapsed = GetTickCount() - FrameTick;
+	if (elapsed >= interval) {
+		BuffDrawDeferred();
+	}
+	else if (!FramePending) {
+		SetTimer(HVTWin, IdRenderTimer, interval - elapsed, NULL);
+		FramePending = TRUE;
+	}
+}
+
+/**
+ *	L^ĕ`͈͂`悷(1t[`)
+ */
+void BuffDrawDeferred(void)
+{
+	int y;
+
+	if (FramePending) {
+		KillTimer(HVTWin, IdRenderTimer);
+		FramePending = FALSE;
+	}
+	FrameTick = GetTickCount();
+	if (!DirtyAny || DrawDeferred) {
+		return;
+	}
+	if (DirtyLines != NumOfLines || DirtyWords != (NumOfColumns + 31) / 32) {
+		// L^ɉʃTCYς
+		DirtyAll = TRUE;
+	}
+
+	LockBuffer();
+	DispInitDC();
+	if (DirtyAll) {
+		BuffUpdateRect(WinOrgX, WinOrgY, WinOrgX+WinWidth-1, WinOrgY+WinHeight-1);
+	}
+	else {
+		// ωZ̘A͈͂Ƃɕ`悷
+		for (y = 0; y < DirtyLines; y++) {
+			int x = 0;
+			int xs, xe;
+			while ((xs = DirtyNextRun(y, x, &xe)) >= 0) {
+				BuffUpdateRect(xs, y, xe, y);
+				x = xe + 1;
+			}
+		}
+	}
+	DispReleaseDC();
+	UnlockBuffer();
+
+	if (DirtyAll) {
+		DispUpdateScrollBar();
+	}
+	DirtyClear();
+}
+
 void CursorUpWithScroll(void)
 {
 	if (((0 < CursorY) && (CursorY < CursorTop)) || (CursorTop < CursorY)) {
@@ -4785,9 +6418,9 @@ void BuffChangeTerminalSize(int Nx, int Ny)
 		if ((ts.TermFlag & TF_CLEARONRESIZE) == 0 && Ny != NumOfLines) {
 			if (Ny > NumOfLines) {
 				CursorY += Ny - NumOfLines;
-				if (Ny > BuffEnd) {
-					CursorY -= Ny - BuffEnd;
-					BuffEnd = Ny;
+				if (Ny > BuffEnd - ColdLines) {
+					CursorY -= Ny - (BuffEnd - ColdLines);
+					BuffEnd = ColdLines + Ny;
 				}
 			}
 			else {
@@ -4884,6 +6517,7 @@ void BuffChangeTerminalSize(int Nx, int Ny)
 	BuffChangeWinSize(W,H);
 	WinOrgY = -NumOfLines;
 
+	DirtyMarkAll();
 	DispScrollHomePos();
 
 	if (cv.Ready && cv.TelFlag) {
@@ -4928,6 +6562,9 @@ void ChangeWin(void)
 void ClearBuffer(void)
 {
 	/* Reset buffer */
+	ColdClear();
+	TextRowsClear();
+	BuffLineBase += BuffEnd;
 	PageStart = 0;
 	BuffStartAbs = 0;
 	BuffEnd = NumOfLines;
@@ -4963,6 +6600,7 @@ void ClearBuffer(void)
 
 	StrChangeCount = 0;
 
+	DirtyMarkAll();
 	DispClearWin();
 }
 
@@ -5142,6 +6780,7 @@ void ShowStatusLine(int Show)
 	/* Change Window Size */
 	BuffChangeWinSize(W,H);
 	WinOrgY = -NumOfLines;
+	DirtyMarkAll();
 	DispScrollHomePos();
 
 	MoveCursor(CursorX,CursorY);
@@ -5571,7 +7210,7 @@ int BuffGetAnyLineData(int offset_y, char *buf, int bufsize)
 		if (IsBuffPadding(b)) {
 			continue;
 		}
-		c = b->ansi_char;
+		c = GetAnsiChar(b);
 		buf[idx++] = c & 0xff;
 		if (c >= 0x100) {
 			buf[idx++] = (c >> 8) & 0xff;
@@ -5615,6 +7254,7 @@ int BuffGetAnyLineDataW(int offset_y, wchar_t *buf, size_t bufsize)
 		BOOL too_small;
 		size_t len;
 		if (IsBuffPadding(b)) {
+			b++;
 			continue;
 		}
 		len = expand_wchar(b, &buf[idx], left, &too_small);
@@ -5791,7 +7431,7 @@ wchar_t *BuffGetCharInfo(int Xw, int Yw)
 	// ANSI
 	{
 		unsigned char mb[4];
-		unsigned short c = b->ansi_char;
+		unsigned short c = GetAnsiChar(b);
 		if (c == 0) {
 			mb[0] = 0;
 		}
@@ -5824,22 +7464,25 @@ wchar_t *BuffGetCharInfo(int Xw, int Yw)
 	{
 		wchar_t *codes_ptr = NULL;
 		wchar_t *code_str;
+		const buff_comb_t *comb = GetComb(b);
+		wchar_t wc2[2];
 		int i;
 
+		GetWC2(b, wc2);
 		aswprintf(&code_str,
 				  L"Unicode UTF-16:\n"
 				  L" 0x%04x\n",
-				  b->wc2[0]);
+				  wc2[0]);
 		awcscat(&codes_ptr, code_str);
 		free(code_str);
-		if (b->wc2[1] != 0 ) {
+		if (wc2[1] != 0 ) {
 			wchar_t buf[32];
-			swprintf(buf, _countof(buf), L" 0x%04x\n", b->wc2[1]);
+			swprintf(buf, _countof(buf), L" 0x%04x\n", wc2[1]);
 			awcscat(&codes_ptr, buf);
 		}
-		for (i=0; i<b->CombinationCharCount16; i++) {
+		for (i=0; i<comb->CombinationCharCount16; i++) {
 			wchar_t buf[32];
-			swprintf(buf, _countof(buf), L" 0x%04x\n", b->pCombinationChars16[i]);
+			swprintf(buf, _countof(buf), L" 0x%04x\n", comb->pCombinationChars16[i]);
 			awcscat(&codes_ptr, buf);
 		}
 		unicode_utf16_str = codes_ptr;
@@ -5849,14 +7492,15 @@ wchar_t *BuffGetCharInfo(int Xw, int Yw)
 	{
 		wchar_t *codes_ptr = NULL;
 		wchar_t *code_str;
+		const buff_comb_t *comb = GetComb(b);
 		int i;
 
 		awcscat(&codes_ptr, L"Unicode UTF-32:\n");
 		code_str = UnicodeCodePointStr(b->u32);
 		awcscats(&codes_ptr, L" ", code_str, L"\n", NULL);
 		free(code_str);
-		for (i=0; i<b->CombinationCharCount32; i++) {
-			code_str = UnicodeCodePointStr(b->pCombinationChars32[i]);
+		for (i=0; i<comb->CombinationCharCount32; i++) {
+			code_str = UnicodeCodePointStr(comb->pCombinationChars32[i]);
 			awcscats(&codes_ptr, L" ", code_str, L"\n", NULL);
 			free(code_str);
 		}
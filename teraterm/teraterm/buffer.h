@@ -108,6 +108,9 @@ void BuffSetCaretWidth(void);
 void BuffScrollNLines(int n);
 void BuffClearScreen(void);
 void BuffUpdateScroll(void);
+void BuffStartDeferredDraw(void);
+void BuffEndDeferredDraw(void);
+void BuffDrawDeferred(void);
 void CursorUpWithScroll(void);
 int BuffUrlDblClk(int Xw, int Yw);
 void BuffDblClk(int Xw, int Yw);
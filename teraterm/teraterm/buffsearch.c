@@ -0,0 +1,527 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* TERATERM.EXE, scroll buffer search */
+
+#include <windows.h>
+#include <process.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <crtdbg.h>
+
+#define ONIG_STATIC
+#include "oniguruma.h"
+
+#include "codeconv.h"
+#include "buffsearch.h"
+
+struct BuffSearchTag {
+	// 
+	DWORD options;
+	wchar_t *pattern;		// BUFF_SEARCH_IGNORECASE ̂Ƃ͏ɂ
+	size_t pattern_len;
+	regex_t *reg;			// BUFF_SEARCH_REGEX ̂Ƃ
+
+	// Ώ, BuffSearchAddRows() ŉʂɋ߂班󂯎
+	// lock ŕی삷
+	HANDLE rows_event;		// s͂/f
+	BOOL ready;				// TRUE=Xbh܂oĂȂs
+	BuffTextRow **rows;
+	int count;
+	LONGLONG first_line;	// rows[0] ̍s̒ʂԍ
+	BOOL last;				// TRUE=rows Ō
+	BOOL fed_last;			// TRUE=Ō̍s󂯎
+
+	// ʒm
+	HWND hWnd;
+	UINT msg;
+	LONG notified;			// TRUE=ʒmς݂Ōʂǂ܂ĂȂ
+
+	// Xbh
+	HANDLE thread;
+	volatile LONG cancel;
+	volatile LONG done;
+
+	// , ̍s珇ɕ
+	CRITICAL_SECTION lock;
+	BuffSearchMatch *matches;
+	int match_count;
+	int match_cap;
+};
+
+/**
+ *	s̕mۂ
+ *
+ *	@param	len		
+ *	@param	need_x	TRUE ̂Ƃ x[] mۂ
+ *	@return			QƃJEg 1
+ */
+BuffTextRow *BuffTextRowAlloc(int len, BOOL need_x)
+{
+	size_t size = sizeof(BuffTextRow) + sizeof(wchar_t) * len;
+	BuffTextRow *row;
+
+	if (need_x) {
+		size += sizeof(WORD) * len;
+	}
+	row = (BuffTextRow *)malloc(size);
+	if (row == NULL) {
+		return NULL;
+	}
+	row->ref = 1;
+	row->len = len;
+	row->cells = 0;
+	row->text = (wchar_t *)(row + 1);
+	row->x = need_x ? (WORD *)(row->text + len) : NULL;
+	return row;
+}
+
+void BuffTextRowAddRef(BuffTextRow *row)
+{
+	InterlockedIncrement(&row->ref);
+}
+
+void BuffTextRowRelease(BuffTextRow *row)
+{
+	if (row != NULL && InterlockedDecrement(&row->ref) == 0) {
+		free(row);
+	}
+}
+
+static void ReleaseRows(BuffTextRow **rows, int count)
+{
+	int i;
+	if (rows == NULL) {
+		return;
+	}
+	for (i = 0; i < count; i++) {
+		BuffTextRowRelease(rows[i]);
+	}
+	free(rows);
+}
+
+/**
+ *	ʒuZʒuɂ
+ */
+static int CellPos(const BuffTextRow *row, int i)
+{
+	if (i >= row->len) {
+		return row->cells;
+	}
+	return row->x != NULL ? row->x[i] : i;
+}
+
+/**
+ *	text[from] ȍ~ pattern T
+ *	擪1 wmemchr() ŒTĂr
+ *
+ *	@retval	-1		Ȃ
+ *	@retval	0ȏ	ʒu
+ */
+static int FindPlain(const BuffSearch *s, const wchar_t *text, int len, int from)
+{
+	const wchar_t *p = text + from;
+	const wchar_t *last;
+	const wchar_t c0 = s->pattern[0];
+
+	if (len - from < (int)s->pattern_len) {
+		return -1;
+	}
+	last = text + len - s->pattern_len;
+	while (p <= last) {
+		p = wmemchr(p, c0, last - p + 1);
+		if (p == NULL) {
+			break;
+		}
+		if (wmemcmp(p + 1, s->pattern + 1, s->pattern_len - 1) == 0) {
+			return (int)(p - text);
+		}
+		p++;
+	}
+	return -1;
+}
+
+/**
+ *	1šʂǉ
+ *	hits[] ͍s珇ɕł̂Ō납ǉ
+ */
+static void AddMatches(BuffSearch *s, LONGLONG line, const BuffTextRow *row, const int *hits, int n)
+{
+	int i;
+
+	EnterCriticalSection(&s->lock);
+	if (s->match_count + n > s->match_cap) {
+		int cap = s->match_cap == 0 ? 64 : s->match_cap;
+		BuffSearchMatch *p;
+		while (cap < s->match_count + n) {
+			cap *= 2;
+		}
+		p = (BuffSearchMatch *)realloc(s->matches, sizeof(BuffSearchMatch) * cap);
+		if (p == NULL) {
+			LeaveCriticalSection(&s->lock);
+			return;
+		}
+		s->matches = p;
+		s->match_cap = cap;
+	}
+	for (i = n - 1; i >= 0; i--) {
+		BuffSearchMatch *m = &s->matches[s->match_count++];
+		m->line = line;
+		m->sx = CellPos(row, hits[i * 2]);
+		m->ex = CellPos(row, hits[i * 2 + 1]);
+		if (m->ex <= m->sx) {
+			// ̓r܂
+			m->ex = m->sx + 1;
+		}
+	}
+	LeaveCriticalSection(&s->lock);
+}
+
+/* Xbh̍Ɨ̈ */
+typedef struct {
+	OnigRegion *region;
+	wchar_t *work;
+	int work_len;
+	int *hits;
+	int hits_cap;
+} SearchWork;
+
+/**
+ *	󂯎s
+ *	ʂɋ߂̍sT
+ *
+ *	@retval	FALSE	f, Ȃ
+ */
+static BOOL SearchRows(BuffSearch *s, SearchWork *w, BuffTextRow **rows, int count, LONGLONG first_line)
+{
+	int i;
+
+	for (i = count - 1; i >= 0; i--) {
+		const BuffTextRow *row = rows[i];
+		const wchar_t *text = row->text;
+		int n = 0;
+		int pos = 0;
+
+		if (s->cancel) {
+			return FALSE;
+		}
+		if (row->len == 0) {
+			continue;
+		}
+		if (s->reg == NULL && (s->options & BUFF_SEARCH_IGNORECASE)) {
+			if (w->work_len < row->len) {
+				wchar_t *p = (wchar_t *)realloc(w->work, sizeof(wchar_t) * row->len);
+				if (p == NULL) {
+					return FALSE;
+				}
+				w->work = p;
+				w->work_len = row->len;
+			}
+			wmemcpy(w->work, row->text, row->len);
+			CharLowerBuffW(w->work, row->len);
+			text = w->work;
+		}
+
+		for (;;) {
+			int start, end;
+			if (s->reg != NULL) {
+				const UChar *str = (const UChar *)text;
+				const UChar *str_end = (const UChar *)(text + row->len);
+				int r;
+				if (pos > row->len) {
+					break;
+				}
+				r = onig_search(s->reg, str, str_end, str + pos * sizeof(wchar_t), str_end, w->region, ONIG_OPTION_NONE);
+				if (r < 0) {
+					break;
+				}
+				start = w->region->beg[0] / (int)sizeof(wchar_t);
+				end = w->region->end[0] / (int)sizeof(wchar_t);
+				if (start == end) {
+					// ̃}b`͌ʂɂȂ
+					pos = end + 1;
+					continue;
+				}
+			}
+			else {
+				start = FindPlain(s, text, row->len, pos);
+				if (start < 0) {
+					break;
+				}
+				end = start + (int)s->pattern_len;
+			}
+			if (n == w->hits_cap) {
+				int cap = w->hits_cap == 0 ? 16 : w->hits_cap * 2;
+				int *p = (int *)realloc(w->hits, sizeof(int) * 2 * cap);
+				if (p == NULL) {
+					break;
+				}
+				w->hits = p;
+				w->hits_cap = cap;
+			}
+			w->hits[n * 2] = start;
+			w->hits[n * 2 + 1] = end;
+			n++;
+			pos = end;
+		}
+
+		if (n > 0) {
+			AddMatches(s, first_line + i, row, w->hits, n);
+			if (InterlockedExchange(&s->notified, TRUE) == FALSE) {
+				PostMessageW(s->hWnd, s->msg, 0, 0);
+			}
+		}
+	}
+	return TRUE;
+}
+
+static unsigned __stdcall SearchThread(void *arg)
+{
+	BuffSearch *s = (BuffSearch *)arg;
+	SearchWork w;
+
+	memset(&w, 0, sizeof(w));
+	if (s->reg != NULL) {
+		w.region = onig_region_new();
+	}
+
+	for (;;) {
+		BuffTextRow **rows;
+		int count;
+		LONGLONG first_line;
+		BOOL last;
+		BOOL ready;
+		BOOL r;
+
+		EnterCriticalSection(&s->lock);
+		ready = s->ready;
+		rows = s->rows;
+		count = s->count;
+		first_line = s->first_line;
+		last = s->last;
+		s->ready = FALSE;
+		s->rows = NULL;
+		s->count = 0;
+		LeaveCriticalSection(&s->lock);
+
+		if (!ready) {
+			if (s->cancel) {
+				break;
+			}
+			WaitForSingleObject(s->rows_event, INFINITE);
+			continue;
+		}
+
+		// ĂԂɎ̍sĂ炤
+		if (!last) {
+			PostMessageW(s->hWnd, s->msg, BUFF_SEARCH_NEED_ROWS, 0);
+		}
+		r = SearchRows(s, &w, rows, count, first_line);
+		ReleaseRows(rows, count);
+		if (!r || last) {
+			break;
+		}
+	}
+
+	free(w.hits);
+	free(w.work);
+	if (w.region != NULL) {
+		onig_region_free(w.region, 1);
+	}
+
+	InterlockedExchange(&s->done, TRUE);
+	InterlockedExchange(&s->notified, TRUE);
+	PostMessageW(s->hWnd, s->msg, 0, 0);
+	return 0;
+}
+
+/**
+ *	XbhJn
+ *	ʂƂƏIƂ hWnd  msg (wParam=0) 𑗂
+ *	̍sKvɂȂƂ hWnd  msg (wParam=BUFF_SEARCH_NEED_ROWS) 𑗂
+ *	s BuffSearchAddRows() œn
+ *
+ *	@param	error		NULL ȊÔƂAsRԂ, free() 邱
+ *	@retval	NULL		s
+ */
+BuffSearch *BuffSearchStart(const wchar_t *pattern, DWORD options,
+							HWND hWnd, UINT msg, wchar_t **error)
+{
+	BuffSearch *s;
+	unsigned tid;
+
+	if (error != NULL) {
+		*error = NULL;
+	}
+	if (pattern == NULL || pattern[0] == 0) {
+		return NULL;
+	}
+
+	s = (BuffSearch *)calloc(1, sizeof(BuffSearch));
+	if (s == NULL) {
+		return NULL;
+	}
+	s->options = options;
+	s->pattern_len = wcslen(pattern);
+	s->pattern = _wcsdup(pattern);
+	s->hWnd = hWnd;
+	s->msg = msg;
+	InitializeCriticalSection(&s->lock);
+	s->rows_event = CreateEventW(NULL, FALSE, FALSE, NULL);
+	if (s->pattern == NULL || s->rows_event == NULL) {
+		BuffSearchEnd(s);
+		return NULL;
+	}
+
+	if (options & BUFF_SEARCH_REGEX) {
+		OnigErrorInfo einfo;
+		OnigOptionType opt = (options & BUFF_SEARCH_IGNORECASE) ? ONIG_OPTION_IGNORECASE : ONIG_OPTION_NONE;
+		int r = onig_new(&s->reg, (const UChar *)s->pattern, (const UChar *)(s->pattern + s->pattern_len),
+						 opt, ONIG_ENCODING_UTF16_LE, ONIG_SYNTAX_RUBY, &einfo);
+		if (r != ONIG_NORMAL) {
+			if (error != NULL) {
+				char msgA[ONIG_MAX_ERROR_MESSAGE_LEN];
+				onig_error_code_to_str((UChar *)msgA, r, &einfo);
+				*error = ToWcharA(msgA);
+			}
+			s->reg = NULL;
+			BuffSearchEnd(s);
+			return NULL;
+		}
+	}
+	else if (options & BUFF_SEARCH_IGNORECASE) {
+		CharLowerBuffW(s->pattern, (DWORD)s->pattern_len);
+	}
+
+	s->thread = (HANDLE)_beginthreadex(NULL, 0, SearchThread, s, 0, &tid);
+	if (s->thread == NULL) {
+		BuffSearchEnd(s);
+		return NULL;
+	}
+	return s;
+}
+
+/**
+ *	IĔj
+ *	̂Ƃ͒f
+ */
+void BuffSearchEnd(BuffSearch *s)
+{
+	if (s == NULL) {
+		return;
+	}
+	if (s->thread != NULL) {
+		InterlockedExchange(&s->cancel, TRUE);
+		SetEvent(s->rows_event);
+		WaitForSingleObject(s->thread, INFINITE);
+		CloseHandle(s->thread);
+	}
+	if (s->rows_event != NULL) {
+		CloseHandle(s->rows_event);
+	}
+	ReleaseRows(s->rows, s->count);
+	if (s->reg != NULL) {
+		onig_free(s->reg);
+	}
+	DeleteCriticalSection(&s->lock);
+	free(s->matches);
+	free(s->pattern);
+	free(s);
+}
+
+/**
+ *	̍s󂯎邩
+ *
+ *	@retval	FALSE	Oɓns܂oĂȂ, Ō̍s󂯎
+ */
+BOOL BuffSearchWantRows(BuffSearch *s)
+{
+	BOOL r;
+	EnterCriticalSection(&s->lock);
+	r = !s->ready && !s->fed_last;
+	LeaveCriticalSection(&s->lock);
+	return r;
+}
+
+/**
+ *	sn
+ *	ʂɋ߂̍s珇ɁAn
+ *	BuffSearchWantRows()  TRUE ̂ƂĂԂ
+ *
+ *	@param	rows		s, rows Ɗes̎QƂ͈p
+ *	@param	first_line	rows[0] ̍s̒ʂԍ
+ *	@param	last		TRUE=ōŌ
+ */
+void BuffSearchAddRows(BuffSearch *s, BuffTextRow **rows, int count, LONGLONG first_line, BOOL last)
+{
+	EnterCriticalSection(&s->lock);
+	_ASSERTE(!s->ready && !s->fed_last);
+	s->ready = TRUE;
+	s->rows = rows;
+	s->count = count;
+	s->first_line = first_line;
+	s->last = last;
+	s->fed_last = last;
+	LeaveCriticalSection(&s->lock);
+	SetEvent(s->rows_event);
+}
+
+/**
+ *	Ԃ
+ *
+ *	@param	done	TRUE=I
+ */
+int BuffSearchGetCount(BuffSearch *s, BOOL *done)
+{
+	int count;
+	if (done != NULL) {
+		*done = s->done;
+	}
+	InterlockedExchange(&s->notified, FALSE);
+	EnterCriticalSection(&s->lock);
+	count = s->match_count;
+	LeaveCriticalSection(&s->lock);
+	return count;
+}
+
+/**
+ *	index Ԗڂ̌ʂԂ
+ *	index 0 ł̍s(ʂɋ߂)̌
+ */
+BOOL BuffSearchGetMatch(BuffSearch *s, int index, BuffSearchMatch *match)
+{
+	BOOL r = FALSE;
+	EnterCriticalSection(&s->lock);
+	if (index >= 0 && index < s->match_count) {
+		*match = s->matches[index];
+		r = TRUE;
+	}
+	LeaveCriticalSection(&s->lock);
+	return r;
+}
@@ -0,0 +1,88 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* TERATERM.EXE, scroll buffer search */
+
+#pragma once
+
+#include <windows.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* IvV */
+#define BUFF_SEARCH_REGEX		0x0001	// K\(Oniguruma)
+#define BUFF_SEARCH_IGNORECASE	0x0002	// 啶ʂȂ
+
+/* ʒm wParam */
+#define BUFF_SEARCH_NEED_ROWS	1		// ̍sKv, BuffFindFeed() Ă
+
+/**
+ *	1s̕
+ *	XbhƋL̂ŎQƃJEgŊǗA쐬͕ύXȂ
+ */
+typedef struct {
+	LONG ref;			// QƃJEg
+	int len;			// text ̕
+	int cells;			// s̋󔒂Z
+	wchar_t *text;		// s̕(UTF-16, ܂)
+	WORD *x;			// text[i] ̃Zʒu, NULL ̂Ƃ text[i] ̃Zʒu i
+} BuffTextRow;
+
+/*  */
+typedef struct {
+	LONGLONG line;		// s̒ʂԍ
+	int sx;				// }b`Z͈ [sx, ex)
+	int ex;
+} BuffSearchMatch;
+
+typedef struct BuffSearchTag BuffSearch;
+
+BuffTextRow *BuffTextRowAlloc(int len, BOOL need_x);
+void BuffTextRowAddRef(BuffTextRow *row);
+void BuffTextRowRelease(BuffTextRow *row);
+
+BuffSearch *BuffSearchStart(const wchar_t *pattern, DWORD options,
+							HWND hWnd, UINT msg, wchar_t **error);
+void BuffSearchEnd(BuffSearch *s);
+BOOL BuffSearchWantRows(BuffSearch *s);
+void BuffSearchAddRows(BuffSearch *s, BuffTextRow **rows, int count, LONGLONG first_line, BOOL last);
+int BuffSearchGetCount(BuffSearch *s, BOOL *done);
+BOOL BuffSearchGetMatch(BuffSearch *s, int index, BuffSearchMatch *match);
+
+/* XN[obt@̌ (buffer.c) */
+BOOL BuffFindStart(const wchar_t *pattern, DWORD options, HWND hWnd, UINT msg, wchar_t **error);
+void BuffFindFeed(void);
+int BuffFindGetCount(BOOL *done);
+BOOL BuffFindSelect(int index);
+void BuffFindEnd(void);
+
+#ifdef __cplusplus
+}
+#endif
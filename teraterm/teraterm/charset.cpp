@@ -890,6 +890,102 @@ void ParseFirst(CharSetData *w, BYTE b)
 	else if (b>=0xA0)
 		w->Op.PutU32(b, w->ClientData);
 }
+/**
+ *	4byteׂĂ󎚉\ASCII(0x20-0x7e)?
+ */
+static BOOL IsPrintableASCII4(const BYTE *ptr)
+{
+	DWORD x;
+	memcpy(&x, ptr, sizeof(x));
+	if ((x & 0x80808080) != 0) {
+		// 0x80ȏ܂
+		return FALSE;
+	}
+	if (((x - 0x20202020) & ~x & 0x80808080) != 0) {
+		// 0x20(C0)܂
+		return FALSE;
+	}
+	if (((x + 0x01010101) & 0x80808080) != 0) {
+		// 0x7f(DEL)܂
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/**
+ *	ParseFirstRun() ł܂Ƃ߂ďłoCgԂ
+ *
+ *	䕶(C0,C1)𐶐ȂoCg𐔂
+ *	ParseFirst() 1byteׂԂ̎ 0 Ԃ
+ *
+ *	@param	ptr		Mf[^
+ *	@param	len		Mf[^
+ *	@return			擪܂Ƃ߂ďłoCg
+ */
+size_t CharSetPrintableRun(CharSetData *w, const BYTE *ptr, size_t len)
+{
+	BOOL utf8;
+	size_t i;
+
+	if (w->DebugFlag != DEBUG_FLAG_NONE || w->SSflag) {
+		return 0;
+	}
+
+	utf8 = (ts.KanjiCode == IdUTF8);
+	if (utf8) {
+		if (w->Fallbacked || (w->count > 0 && w->buf[0] == 0xc2)) {
+			// fallback, C1䕶(U+0080..U+009F)ɂȂ邩Ȃ
+			return 0;
+		}
+		if (ts.FallbackToCP932) {
+			// Shift_JIS  fallback \̂ ASCII ̂
+			utf8 = FALSE;
+		}
+	}
+
+	i = 0;
+	while (i + 4 <= len && IsPrintableASCII4(ptr + i)) {
+		i += 4;
+	}
+	for (; i < len; i++) {
+		BYTE b = ptr[i];
+		if (0x20 <= b && b <= 0x7e) {
+			continue;
+		}
+		if (utf8 && b >= 0x80 && b != 0xc2 && b != 0xff) {
+			// 0xc2  C1䕶1byteڂɂȂ肤
+			// 0xff  telnet  IAC
+			continue;
+		}
+		break;
+	}
+	return i;
+}
+
+/**
+ *	CharSetPrintableRun() œ͈͂܂Ƃ߂ď
+ *	䕶͊܂܂Ȃ̂ŁAr ParseControl() ͌Ă΂Ȃ
+ */
+void ParseFirstRun(CharSetData *w, const BYTE *ptr, size_t len)
+{
+	const BYTE *end = ptr + len;
+
+	if (ts.KanjiCode == IdUTF8) {
+		while (ptr < end) {
+			BYTE b = *ptr++;
+			if (b < 0x80 && w->count == 0 && !w->Fallbacked) {
+				w->Op.PutU32(b, w->ClientData);
+				continue;
+			}
+			ParseFirstUTF8(w, b);
+		}
+		return;
+	}
+
+	while (ptr < end) {
+		ParseFirst(w, *ptr++);
+	}
+}
 
 /**
  *	w(Designate)
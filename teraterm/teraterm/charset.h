@@ -56,6 +56,8 @@ typedef enum {
 
 // input
 void ParseFirst(CharSetData *w, BYTE b);
+size_t CharSetPrintableRun(CharSetData *w, const BYTE *ptr, size_t len);
+void ParseFirstRun(CharSetData *w, const BYTE *ptr, size_t len);
 
 // control
 typedef enum {
@@ -125,6 +125,67 @@ BOOL TCPIPClosed = TRUE;
 static HANDLE PrnID = INVALID_HANDLE_VALUE;
 static BOOL LPTFlag;
 
+/* Mobt@TCY̎
+ *	MvTCYς܂œǂ߂邱Ƃ(f[^܂Ă)
+ *	obt@{ɂBInBuffShrinkTime ̊Ԃς܂œǂ߂邱ƂȂ
+ *	TCY֖߂B
+ */
+#define InBuffGrowCount		4		// ̉񐔘AĂς܂œǂ߂g
+#define InBuffShrinkTime	10000	// [ms]
+#define InBuffCompactSpace(cv)	((cv)->InBuffMax / 4)	// ̋󂫂ꖢɂȂl߂
+static int InBuffFullCount;
+static DWORD InBuffFullTick;
+
+/**
+ *	Mobt@̃TCYύX
+ *	̃f[^͐擪ɋl߂Ĉp
+ *	mۂłȂƂ͉Ȃ
+ */
+static void InBuffResize(PComVar cv, int size)
+{
+	BYTE *p;
+
+	if (size == cv->InBuffMax || size < cv->InBuffCount) {
+		return;
+	}
+	p = (BYTE *)malloc(size);
+	if (p == NULL) {
+		return;
+	}
+	if (cv->InBuffCount > 0) {
+		memcpy(p, &(cv->InBuff[cv->InPtr]), cv->InBuffCount);
+	}
+	free(cv->InBuff);
+	cv->InBuff = p;
+	cv->InBuffMax = size;
+	cv->InPtr = 0;
+}
+
+/**
+ *	MʂMobt@̃TCY𒲐
+ *	@param	req		MvTCY
+ *	@param	C		MTCY
+ */
+static void InBuffAdjust(PComVar cv, DWORD req, DWORD C)
+{
+	// ̋󂫂ȂƂ(ǂĂȂ)͂ςłg̑ΏۂƂȂ
+	if (C >= req && req >= (DWORD)(cv->InBuffMax / 2)) {
+		InBuffFullTick = GetTickCount();
+		InBuffFullCount++;
+		if (InBuffFullCount >= InBuffGrowCount && cv->InBuffMax < InBuffSizeMax) {
+			InBuffResize(cv, cv->InBuffMax * 2);
+			InBuffFullCount = 0;
+		}
+	}
+	else {
+		InBuffFullCount = 0;
+		if (cv->InBuffMax > InBuffSizeMin && cv->InBuffCount == 0 &&
+		    GetTickCount() - InBuffFullTick > InBuffShrinkTime) {
+			InBuffResize(cv, InBuffSizeMin);
+		}
+	}
+}
+
 // Initialize ComVar.
 // This routine is called only once
 // by the initialization procedure of Tera Term.
@@ -142,6 +203,23 @@ void CommInit(PComVar cv)
 	cv->NotifyIcon = NULL;
 
 	cv->ConnectedTime = 0;
+
+	cv->InBuff = (BYTE *)malloc(InBuffSizeMin);
+	cv->InBuffMax = (cv->InBuff != NULL) ? InBuffSizeMin : 0;
+	cv->InBuffCount = 0;
+	cv->InPtr = 0;
+}
+
+// Free ComVar.
+// This routine is called only once
+// by the finalization procedure of Tera Term.
+void CommUninit(PComVar cv)
+{
+	free(cv->InBuff);
+	cv->InBuff = NULL;
+	cv->InBuffMax = 0;
+	cv->InBuffCount = 0;
+	cv->InPtr = 0;
 }
 
 /* reset a serial port which is already open */
@@ -832,6 +910,8 @@ void CommClose(PComVar cv)
 	cv->Ready = FALSE;
 	cv->InPtr = 0;
 	cv->InBuffCount = 0;
+	InBuffResize(cv, InBuffSizeMin);
+	InBuffFullCount = 0;
 	cv->OutPtr = 0;
 	cv->OutBuffCount = 0;
 	cv->LineModeBuffCount = 0;
@@ -911,34 +991,46 @@ void CommReceive(PComVar cv)
 {
 	DWORD C;
 	DWORD DErr;
+	DWORD Req;
+	DWORD Total;
+	int Tail;
 
 	if (! cv->Ready || ! cv->RRQ ||
-	    (cv->InBuffCount>=InBuffSize)) {
+	    (cv->InBuffCount>=cv->InBuffMax)) {
 		return;
 	}
 
 	/* Compact buffer */
-	if ((cv->InBuffCount>0) && (cv->InPtr>0)) {
+	//	f[^̌ɓǂݍށB
+	//	̋󂫂ȂȂƂ擪֋l߂B
+	if ((cv->InBuffCount>0) && (cv->InPtr>0) &&
+	    (cv->InBuffMax - (cv->InPtr + cv->InBuffCount) < InBuffCompactSpace(cv))) {
 		memmove(cv->InBuff,&(cv->InBuff[cv->InPtr]),cv->InBuffCount);
 		cv->InPtr = 0;
 	}
+	else if (cv->InBuffCount==0) {
+		cv->InPtr = 0;
+	}
+	Tail = cv->InPtr + cv->InBuffCount;
+	Req = cv->InBuffMax - Tail;
 
-	if (cv->InBuffCount<InBuffSize) {
+	if (Req > 0) {
 		switch (cv->PortType) {
 			case IdTCPIP:
-				C = Precv(cv->s, &(cv->InBuff[cv->InBuffCount]),
-				          InBuffSize-cv->InBuffCount, 0);
+				C = Precv(cv->s, &(cv->InBuff[Tail]), Req, 0);
 				if (C == SOCKET_ERROR) {
 					C = 0;
 					PWSAGetLastError();
 				}
 				cv->InBuffCount = cv->InBuffCount + C;
+				InBuffAdjust(cv, Req, C);
 				break;
 			case IdSerial:
+				Total = 0;
 				do {
 					ClearCommError(cv->ComID,&DErr,NULL);
-					if (! PReadFile(cv->ComID,&(cv->InBuff[cv->InBuffCount]),
-					                InBuffSize-cv->InBuffCount,&C,&rol)) {
+					if (! PReadFile(cv->ComID,&(cv->InBuff[Tail]),
+					                cv->InBuffMax-Tail,&C,&rol)) {
 						if (GetLastError() == ERROR_IO_PENDING) {
 							if (WaitForSingleObject(rol.hEvent, 1000) != WAIT_OBJECT_0) {
 								C = 0;
@@ -952,17 +1044,20 @@ void CommReceive(PComVar cv)
 						}
 					}
 					cv->InBuffCount = cv->InBuffCount + C;
-				} while ((C!=0) && (cv->InBuffCount<InBuffSize));
+					Tail = Tail + C;
+					Total = Total + C;
+				} while ((C!=0) && (Tail<cv->InBuffMax));
 				ClearCommError(cv->ComID,&DErr,NULL);
+				InBuffAdjust(cv, Req, Total);
 				break;
 			case IdFile:
-				if (PReadFile(cv->ComID,&(cv->InBuff[cv->InBuffCount]),
-				              InBuffSize-cv->InBuffCount,&C,NULL)) {
+				if (PReadFile(cv->ComID,&(cv->InBuff[Tail]),Req,&C,NULL)) {
 					if (C == 0) {
 						DErr = ERROR_HANDLE_EOF;
 					}
 					else {
 						cv->InBuffCount = cv->InBuffCount + C;
+						InBuffAdjust(cv, Req, C);
 					}
 				}
 				else {
@@ -973,13 +1068,13 @@ void CommReceive(PComVar cv)
 			case IdNamedPipe:
 				// L[̒ɍŒ1oCgȏ̃f[^Ă邱ƂmFłĂ邽߁A
 				// ReadFile() ̓ubN邱Ƃ͂Ȃ߁AꊇēǂށB
-				if (PReadFile(cv->ComID,&(cv->InBuff[cv->InBuffCount]),
-				              InBuffSize-cv->InBuffCount,&C,NULL)) {
+				if (PReadFile(cv->ComID,&(cv->InBuff[Tail]),Req,&C,NULL)) {
 					if (C == 0) {
 						DErr = ERROR_HANDLE_EOF;
 					}
 					else {
 						cv->InBuffCount = cv->InBuffCount + C;
+						InBuffAdjust(cv, Req, C);
 					}
 				}
 				else {
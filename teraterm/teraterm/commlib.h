@@ -33,6 +33,7 @@ extern "C" {
 #endif
 
 void CommInit(PComVar cv);
+void CommUninit(PComVar cv);
 void CommOpen(HWND HW, PTTSet ts, PComVar cv);
 #ifndef NO_I18N
 void CommStart(PComVar cv, LONG lParam, PTTSet ts);
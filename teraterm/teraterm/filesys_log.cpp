@@ -58,6 +58,9 @@
 
 #define TitLog      L"Log"
 
+// OpOobt@̃TCY, Mobt@̏TCYƓ
+#define LogBuffSize	InBuffSizeMin
+
 /*
    Line Head flag for timestamping
    2007.05.24 Gentaro
@@ -471,14 +474,14 @@ void LogPut1(BYTE b)
 
 	cv_LogBuf[cv_LogPtr] = b;
 	cv_LogPtr++;
-	if (cv_LogPtr>=InBuffSize)
-		cv_LogPtr = cv_LogPtr-InBuffSize;
+	if (cv_LogPtr>=LogBuffSize)
+		cv_LogPtr = cv_LogPtr-LogBuffSize;
 
 	if (fv->FileLog)
 	{
-		if (cv_LCount>=InBuffSize)
+		if (cv_LCount>=LogBuffSize)
 		{
-			cv_LCount = InBuffSize;
+			cv_LCount = LogBuffSize;
 			cv_LStart = cv_LogPtr;
 		}
 		else
@@ -493,8 +496,8 @@ static BOOL Get1(PCHAR Buf, int *Start, int *Count, PBYTE b)
 	if (*Count<=0) return FALSE;
 	*b = Buf[*Start];
 	(*Start)++;
-	if (*Start>=InBuffSize)
-		*Start = *Start-InBuffSize;
+	if (*Start>=LogBuffSize)
+		*Start = *Start-LogBuffSize;
 	(*Count)--;
 	return TRUE;
 }
@@ -702,7 +705,7 @@ static BOOL CreateLogBuf(void)
 {
 	if (cv_LogBuf==NULL)
 	{
-		cv_LogBuf = (char *)malloc(InBuffSize);
+		cv_LogBuf = (char *)malloc(LogBuffSize);
 		cv_LogPtr = 0;
 		cv_LStart = 0;
 		cv_LCount = 0;
@@ -723,7 +726,7 @@ static BOOL CreateBinBuf(void)
 {
 	if (cv_BinBuf==NULL)
 	{
-		cv_BinBuf = (PCHAR)malloc(InBuffSize);
+		cv_BinBuf = (PCHAR)malloc(LogBuffSize);
 		cv_BinPtr = 0;
 		cv_BStart = 0;
 		cv_BCount = 0;
@@ -1134,11 +1137,11 @@ static void Log1Bin(BYTE b)
 	}
 	cv_BinBuf[cv_BinPtr] = b;
 	cv_BinPtr++;
-	if (cv_BinPtr>=InBuffSize) {
-		cv_BinPtr = cv_BinPtr-InBuffSize;
+	if (cv_BinPtr>=LogBuffSize) {
+		cv_BinPtr = cv_BinPtr-LogBuffSize;
 	}
-	if (cv_BCount>=InBuffSize) {
-		cv_BCount = InBuffSize;
+	if (cv_BCount>=LogBuffSize) {
+		cv_BCount = LogBuffSize;
 		cv_BStart = cv_BinPtr;
 	}
 	else {
@@ -1181,10 +1184,10 @@ int FLogGetFreeCount(void)
 		return 0;
 	}
 	if (fv->FileLog) {
-		return InBuffSize - cv_LCount;
+		return LogBuffSize - cv_LCount;
 	}
 	if (fv->BinLog) {
-		return InBuffSize - cv_BCount;
+		return LogBuffSize - cv_BCount;
 	}
 	return 0;
 }
@@ -52,6 +52,7 @@
 #include "filesys_proto.h"
 #include "tt_res.h"
 #include "filesys_win32.h"
+#include "filesys_buffered.h"
 
 #include "kermit.h"
 #include "xmodem.h"
@@ -100,7 +101,7 @@ static int ProtoId;
 static PProtoDlg PtDlg = NULL;
 static BOOL cv_ProtoFlag = FALSE;
 
-static void _SetDlgTime(TFileVarProto *fv, DWORD elapsed, int bytes)
+static void _SetDlgTime(TFileVarProto *fv, DWORD elapsed, unsigned long long bytes)
 {
 	SetDlgTime(fv->HWin, IDC_PROTOELAPSEDTIME, elapsed, bytes);
 }
@@ -110,12 +111,15 @@ static void _SetDlgPacketNum(struct FileVarProto *fv, LONG Num)
 	SetDlgNum(fv->HWin, IDC_PROTOPKTNUM, Num);
 }
 
-static void _SetDlgByteCount(struct FileVarProto *fv, LONG Num)
+static void _SetDlgByteCount(struct FileVarProto *fv, unsigned long long Num)
 {
-	SetDlgNum(fv->HWin, IDC_PROTOBYTECOUNT, Num);
+	// 2GBȏ̃t@Ĉ SetDlgNum() ͎gȂ
+	wchar_t Temp[32];
+	_snwprintf_s(Temp, _countof(Temp), _TRUNCATE, L"%llu", Num);
+	SetDlgItemTextW(fv->HWin, IDC_PROTOBYTECOUNT, Temp);
 }
 
-static void _SetDlgPercent(struct FileVarProto *fv, LONG a, LONG b, int *p)
+static void _SetDlgPercent(struct FileVarProto *fv, unsigned long long a, unsigned long long b, int *p)
 {
 	SetDlgPercent(fv->HWin, IDC_PROTOPERCENT, IDC_PROTOPROGRESS, a, b, p);
 }
@@ -232,7 +236,7 @@ static BOOL NewFileVar_(PFileVarProto *pfv)
 	fv->Success = FALSE;
 	fv->NoMsg = FALSE;
 
-	fv->file = FilesysCreateWin32();
+	fv->file = FilesysCreateBuffered(FilesysCreateWin32(), 0);
 
 	fv->GetNextFname = GetNextFname;
 	fv->GetRecievePath = GetRecievePath;
@@ -84,10 +84,10 @@ typedef struct ProtoOp_ {
 // UIȂǏ\p֐
 typedef struct InfoOp_ {
 	void (*InitDlgProgress)(struct FileVarProto *fv, int *CurProgStat);
-	void (*SetDlgTime)(struct FileVarProto *fv, DWORD elapsed, int bytes);
+	void (*SetDlgTime)(struct FileVarProto *fv, DWORD elapsed, unsigned long long bytes);
 	void (*SetDlgPacketNum)(struct FileVarProto *fv, LONG Num);
-	void (*SetDlgByteCount)(struct FileVarProto *fv, LONG Num);
-	void (*SetDlgPercent)(struct FileVarProto *fv, LONG a, LONG b, int *p);
+	void (*SetDlgByteCount)(struct FileVarProto *fv, unsigned long long Num);
+	void (*SetDlgPercent)(struct FileVarProto *fv, unsigned long long a, unsigned long long b, int *p);
 	void (*SetDlgProtoText)(struct FileVarProto *fv, const char *text);
 	void (*SetDlgProtoFileName)(struct FileVarProto *fv, const char *text);
 } TInfoOp;
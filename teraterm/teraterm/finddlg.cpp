@@ -0,0 +1,315 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* TERATERM.EXE, find dialog */
+
+#include <windows.h>
+#include <stdio.h>
+#include <wchar.h>
+#define _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+
+#include "teraterm.h"
+#include "tttypes.h"
+#include "ttlib.h"
+#include "dlglib.h"
+#include "i18n.h"
+#include "win32helper.h"
+#include "tt_res.h"
+#include "teraterml.h"
+#include "buffer.h"
+#include "buffsearch.h"
+#include "tmfc.h"
+
+#include "finddlg.h"
+
+// Xbh̒ʒm
+#define WM_FIND_RESULT	(WM_APP + 1)
+
+class CFindDlg : public TTCDialog
+{
+public:
+	CFindDlg(const wchar_t *UILanguageFile) {
+		UILanguageFile_ = UILanguageFile;
+		pattern_ = NULL;
+		options_ = 0;
+		index_ = -1;
+		pending_ = 0;
+		error_ = NULL;
+	}
+
+	BOOL Create(HINSTANCE hInstance, HWND hParent) {
+		return TTCDialog::Create(hInstance, hParent, IDD_FIND_DIALOG);
+	}
+
+	void Activate() {
+		ShowWindow(SW_SHOWNORMAL);
+		::SetForegroundWindow(m_hWnd);
+		::SetFocus(GetDlgItem(IDC_FIND_EDIT));
+	}
+
+private:
+	virtual BOOL OnInitDialog() {
+		static const DlgTextInfo TextInfos[] = {
+			{ 0, "DLG_FIND_TITLE" },
+			{ IDC_FIND_LABEL, "DLG_FIND_LABEL" },
+			{ IDC_FIND_REGEX, "DLG_FIND_REGEX" },
+			{ IDC_FIND_MATCHCASE, "DLG_FIND_MATCHCASE" },
+			{ IDOK, "DLG_FIND_PREV" },
+			{ IDC_FIND_NEXT, "DLG_FIND_NEXT" },
+			{ IDCANCEL, "BTN_CLOSE" },
+		};
+		SetDlgTextsW(m_hWnd, TextInfos, _countof(TextInfos), UILanguageFile_);
+		TTSetIcon(m_hInst, m_hWnd, MAKEINTRESOURCEW(IDI_TTERM), 0);
+		AddModelessHandle(m_hWnd);
+		return TRUE;
+	}
+
+	// (Âs)
+	virtual BOOL OnOK() {
+		Move(+1);
+		return TRUE;
+	}
+
+	virtual BOOL OnCancel() {
+		TTSetIcon(m_hInst, m_hWnd, NULL, 0);
+		EndSearch();
+		DestroyWindow();
+		return TRUE;
+	}
+
+	virtual BOOL OnCommand(WPARAM wp, LPARAM lp) {
+		switch (LOWORD(wp)) {
+		case IDC_FIND_NEXT:
+			// (Vs)
+			Move(-1);
+			return TRUE;
+		case IDC_FIND_EDIT:
+			if (HIWORD(wp) == EN_CHANGE) {
+				EndSearch();
+				SetDlgItemTextW(IDC_FIND_STATUS, L"");
+			}
+			return TRUE;
+		case IDC_FIND_REGEX:
+		case IDC_FIND_MATCHCASE:
+			EndSearch();
+			SetDlgItemTextW(IDC_FIND_STATUS, L"");
+			return TRUE;
+		default:
+			return TTCDialog::OnCommand(wp, lp);
+		}
+	}
+
+	virtual BOOL PostNcDestroy();
+
+	virtual LRESULT DlgProc(UINT msg, WPARAM wp, LPARAM lp);
+
+	void EndSearch();
+	BOOL StartSearch();
+	void Move(int dir);
+	void ApplyPending();
+	void UpdateStatus(BOOL done, int count);
+
+	const wchar_t *UILanguageFile_;
+	wchar_t *pattern_;		// ̕, NULL=ĂȂ
+	DWORD options_;
+	int index_;				// IĂ錋, -1=I
+	int pending_;			// ʂ͂ړ
+	wchar_t *error_;
+
+public:
+	virtual ~CFindDlg() {
+		free(pattern_);
+		free(error_);
+	}
+};
+
+static CFindDlg *FindDlg;
+
+BOOL CFindDlg::PostNcDestroy()
+{
+	RemoveModelessHandle(m_hWnd);
+	if (FindDlg == this) {
+		FindDlg = NULL;
+	}
+	delete this;
+	return TRUE;
+}
+
+LRESULT CFindDlg::DlgProc(UINT msg, WPARAM wp, LPARAM lp)
+{
+	switch (msg) {
+	case WM_FIND_RESULT:
+		if (wp == BUFF_SEARCH_NEED_ROWS) {
+			BuffFindFeed();
+			return TRUE;
+		}
+		if (pattern_ != NULL) {
+			ApplyPending();
+		}
+		return TRUE;
+	case WM_ACTIVATE:
+		// P̃XbgȂ̂ŁAANeBuɂȂƂɓo^Ȃ
+		if (LOWORD(wp) != WA_INACTIVE) {
+			AddModelessHandle(m_hWnd);
+		}
+		return FALSE;
+	case WM_DPICHANGED:
+		TTSetIcon(m_hInst, m_hWnd, MAKEINTRESOURCEW(IDI_TTERM), LOWORD(wp));
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
+void CFindDlg::EndSearch()
+{
+	BuffFindEnd();
+	free(pattern_);
+	pattern_ = NULL;
+	free(error_);
+	error_ = NULL;
+	index_ = -1;
+	pending_ = 0;
+}
+
+BOOL CFindDlg::StartSearch()
+{
+	wchar_t *pattern;
+	DWORD options = 0;
+
+	EndSearch();
+
+	hGetDlgItemTextW(m_hWnd, IDC_FIND_EDIT, &pattern);
+	if (pattern == NULL || pattern[0] == 0) {
+		free(pattern);
+		return FALSE;
+	}
+	if (GetCheck(IDC_FIND_REGEX) == BST_CHECKED) {
+		options |= BUFF_SEARCH_REGEX;
+	}
+	if (GetCheck(IDC_FIND_MATCHCASE) != BST_CHECKED) {
+		options |= BUFF_SEARCH_IGNORECASE;
+	}
+
+	if (!BuffFindStart(pattern, options, m_hWnd, WM_FIND_RESULT, &error_)) {
+		free(pattern);
+		if (error_ == NULL) {
+			GetI18nStrWW("Tera Term", "DLG_FIND_FAILED", L"Cannot start searching", UILanguageFile_, &error_);
+		}
+		SetDlgItemTextW(IDC_FIND_STATUS, error_);
+		return FALSE;
+	}
+	pattern_ = pattern;
+	options_ = options;
+	return TRUE;
+}
+
+/**
+ *	Ǒʂֈړ
+ *	܂ʂ͂ĂȂƂ́A͂ƂɈړ
+ *
+ *	@param	dir		+1=(Âs), -1=(Vs)
+ */
+void CFindDlg::Move(int dir)
+{
+	if (pattern_ == NULL) {
+		if (!StartSearch()) {
+			return;
+		}
+	}
+	pending_ = dir;
+	ApplyPending();
+}
+
+void CFindDlg::ApplyPending()
+{
+	BOOL done;
+	int count = BuffFindGetCount(&done);
+
+	while (pending_ != 0) {
+		int target = index_ + pending_;
+		if (target < 0 || (target >= count && done)) {
+			// ȏȂ
+			pending_ = 0;
+			MessageBeep(MB_OK);
+			break;
+		}
+		if (target >= count) {
+			// , ʂ҂
+			break;
+		}
+		index_ = target;
+		if (BuffFindSelect(index_)) {
+			pending_ = 0;
+		}
+		// IłȂ(oꂽ)Ƃ͎̌ʂ
+	}
+	UpdateStatus(done, count);
+}
+
+void CFindDlg::UpdateStatus(BOOL done, int count)
+{
+	wchar_t *format;
+	wchar_t buf[128];
+
+	if (done && count == 0) {
+		GetI18nStrWW("Tera Term", "DLG_FIND_NOTFOUND", L"Not found", UILanguageFile_, &format);
+		SetDlgItemTextW(IDC_FIND_STATUS, format);
+		free(format);
+		return;
+	}
+	if (done) {
+		GetI18nStrWW("Tera Term", "DLG_FIND_RESULT", L"%d / %d", UILanguageFile_, &format);
+	}
+	else {
+		GetI18nStrWW("Tera Term", "DLG_FIND_SEARCHING", L"%d / %d (searching...)", UILanguageFile_, &format);
+	}
+	_snwprintf_s(buf, _countof(buf), _TRUNCATE, format, index_ + 1, count);
+	free(format);
+	SetDlgItemTextW(IDC_FIND_STATUS, buf);
+}
+
+/**
+ *	_CAO\
+ *	łɕ\ĂƂ̓ANeBuɂ
+ */
+void ShowFindDialog(HINSTANCE hInstance, HWND hWndParent, const wchar_t *UILanguageFile)
+{
+	if (FindDlg != NULL) {
+		FindDlg->Activate();
+		return;
+	}
+	FindDlg = new CFindDlg(UILanguageFile);
+	if (!FindDlg->Create(hInstance, hWndParent)) {
+		delete FindDlg;
+		FindDlg = NULL;
+		return;
+	}
+	FindDlg->Activate();
+}
@@ -46,13 +46,19 @@
 
 typedef int (CALLBACK *PSSH_start_scp)(char *, char *);
 typedef int (CALLBACK * PSSH_scp_sending_status)(void);
+typedef int (CALLBACK *PSSH_scp_sending_progress)(int *, int *, int *);
 typedef size_t (CALLBACK *PSSH_GetKnownHostsFileName)(wchar_t *, size_t);
+typedef int (CALLBACK *PSSH_sftp_transfer_status)(int *, int *);
 
 static HMODULE h = NULL;
 static PSSH_start_scp start_scp = NULL;
 static PSSH_start_scp receive_file = NULL;
 static PSSH_scp_sending_status scp_sending_status = NULL;
 static PSSH_GetKnownHostsFileName GetKnownHostsFileName;
+static PSSH_start_scp sftp_get = NULL;
+static PSSH_start_scp sftp_put = NULL;
+static PSSH_scp_sending_progress scp_sending_progress = NULL;
+static PSSH_sftp_transfer_status sftp_transfer_status = NULL;
 
 /**
  * @brief SCP֐̃AhX擾
@@ -139,6 +145,32 @@ BOOL ScpGetStatus(void)
 	return r;
 }
 
+/**
+ *	t@CM̐i݋
+ *	Âttxssh.dllł scp g悤AScpInit() Ƃ͕ʂɎ擾
+ *	@param	sending	MȂTRUE
+ *	@param	percent	Mς݂̊(%)
+ *	@param	rate	]x(KB/s)
+ *	@param	eta		cb(-1 = s)
+ *	@retval	FALSE	dllΉĂȂ
+ */
+BOOL ScpGetSendingProgress(BOOL *sending, int *percent, int *rate, int *eta)
+{
+	if (scp_sending_progress == NULL) {
+		if (h == NULL) {
+			if ((h = GetModuleHandle("ttxssh.dll")) == NULL) {
+				return FALSE;
+			}
+		}
+		scp_sending_progress = (PSSH_scp_sending_progress)GetProcAddress(h, "TTXScpSendingProgress");
+		if (scp_sending_progress == NULL) {
+			return FALSE;
+		}
+	}
+	*sending = (BOOL)scp_sending_progress(percent, rate, eta);
+	return TRUE;
+}
+
 /**
  *	t@CM
  */
@@ -158,6 +190,78 @@ BOOL ScpReceive(const wchar_t *remotefile, const wchar_t *localfile)
 	return r;
 }
 
+/**
+ *	SFTPŃt@CM/M
+ *	Âttxssh.dllł scp g悤AScpInit() Ƃ͕ʂɎ擾
+ *	@return SFTP_REQUEST_OK	ok(NGXgł)
+ *	@return ̑			ng, SFTP_REQUEST_*
+ */
+static int SftpTransfer(PSSH_start_scp *func, const char *name, const wchar_t *file1, const wchar_t *file2)
+{
+	if (*func == NULL) {
+		if (h == NULL) {
+			if ((h = GetModuleHandle("ttxssh.dll")) == NULL) {
+				return SFTP_REQUEST_NOT_SUPPORTED;
+			}
+		}
+		*func = (PSSH_start_scp)GetProcAddress(h, name);
+		if (*func == NULL) {
+			return SFTP_REQUEST_NOT_SUPPORTED;
+		}
+	}
+	char *file1U8 = ToU8W(file1);
+	char *file2U8 = ToU8W(file2);
+	int r = (*func)(file1U8, file2U8);
+	free(file1U8);
+	free(file2U8);
+	return r;
+}
+
+/**
+ *	@param	remotefile	[g(sshT[o[)̃t@C
+ *	@param	localfile	[J(PC,Windows)̃t@C
+ *						L""Ń_E[htH_
+ */
+int SftpGet(const wchar_t *remotefile, const wchar_t *localfile)
+{
+	return SftpTransfer(&sftp_get, "TTXSftpGetfile", remotefile, localfile);
+}
+
+/**
+ *	@param	localfile	[J(PC,Windows)̃t@C
+ *	@param	remotefile	[g(sshT[o[)̃t@C
+ *						L""Ńz[fBNg, '/'ŏIƂ͂̃tH_
+ */
+int SftpPut(const wchar_t *localfile, const wchar_t *remotefile)
+{
+	return SftpTransfer(&sftp_put, "TTXSftpPutfile", localfile, remotefile);
+}
+
+/**
+ *	SFTP̓]v̏
+ *	 ttxssh.dll ǂݍł̗݌v
+ *	@param	pending	o^āA܂IĂȂ
+ *	@param	done	
+ *	@param	failed	s
+ *	@retval	FALSE	dllΉĂȂ
+ */
+BOOL SftpGetTransferStatus(int *pending, int *done, int *failed)
+{
+	if (sftp_transfer_status == NULL) {
+		if (h == NULL) {
+			if ((h = GetModuleHandle("ttxssh.dll")) == NULL) {
+				return FALSE;
+			}
+		}
+		sftp_transfer_status = (PSSH_sftp_transfer_status)GetProcAddress(h, "TTXSftpTransferStatus");
+		if (sftp_transfer_status == NULL) {
+			return FALSE;
+		}
+	}
+	*pending = sftp_transfer_status(done, failed);
+	return TRUE;
+}
+
 /**
  *	knownhostt@C擾
  *	svɂȂfree()邱
@@ -34,7 +34,19 @@ extern "C" {
 
 BOOL ScpSend(const wchar_t *local, const wchar_t *remote);
 BOOL ScpGetStatus(void);
+BOOL ScpGetSendingProgress(BOOL *sending, int *percent, int *rate, int *eta);
 BOOL ScpReceive(const wchar_t *remotefile, const wchar_t *localfile);
+/* SftpGet()/SftpPut() ̖߂l
+ * SFTP_REQUEST_NOT_SUPPORTED ȊO ttssh2/ttxssh/sftp.h ƍ킹邱 */
+#define SFTP_REQUEST_OK				1	// ]vo^
+#define SFTP_REQUEST_FAILED			0	// o^łȂ
+#define SFTP_REQUEST_NOT_CONNECTED	-1	// SSH2 ŐڑĂȂ
+#define SFTP_REQUEST_BAD_ARGUMENT	-2	// t@CȂ
+#define SFTP_REQUEST_NOT_SUPPORTED	-3	// ttxssh.dll Ȃ, sftp ɑΉĂȂ
+
+int SftpGet(const wchar_t *remotefile, const wchar_t *localfile);
+int SftpPut(const wchar_t *localfile, const wchar_t *remotefile);
+BOOL SftpGetTransferStatus(int *pending, int *done, int *failed);
 BOOL TTXSSHGetKnownHostsFileName(wchar_t **filename);
 
 #ifdef __cplusplus
@@ -114,12 +114,12 @@ void DDEPut1(BYTE b)
 
 	cv_LogBuf[cv_LogPtr] = b;
 	cv_LogPtr++;
-	if (cv_LogPtr >= InBuffSize)
-		cv_LogPtr = cv_LogPtr - InBuffSize;
+	if (cv_LogPtr >= DDEBuffSize)
+		cv_LogPtr = cv_LogPtr - DDEBuffSize;
 
-	if (cv_DCount >= InBuffSize)
+	if (cv_DCount >= DDEBuffSize)
 	{
-		cv_DCount = InBuffSize;
+		cv_DCount = DDEBuffSize;
 		cv_DStart = cv_LogPtr;
 	}
 	else
@@ -128,7 +128,7 @@ void DDEPut1(BYTE b)
 
 static BOOL DDECreateBuf(void)
 {
-	cv_LogBuf = (char *)malloc(InBuffSize);
+	cv_LogBuf = (char *)malloc(DDEBuffSize);
 	if (cv_LogBuf == NULL) {
 		return FALSE;
 	}
@@ -254,8 +254,8 @@ static BOOL DDEGet1(LPBYTE b)
 	if (cv_DCount <= 0) return FALSE;
 	*b = ((LPSTR)cv_LogBuf)[cv_DStart];
 	cv_DStart++;
-	if (cv_DStart>=InBuffSize)
-		cv_DStart = cv_DStart-InBuffSize;
+	if (cv_DStart>=DDEBuffSize)
+		cv_DStart = cv_DStart-DDEBuffSize;
 	cv_DCount--;
 	return TRUE;
 }
@@ -274,7 +274,7 @@ static LONG DDEGetDataLen()
 		b = ((LPSTR)cv_LogBuf)[Start];
 		if ((b==0x00) || (b==0x01)) Len++;
 		Start++;
-		if (Start>=InBuffSize) Start = Start-InBuffSize;
+		if (Start>=DDEBuffSize) Start = Start-DDEBuffSize;
 		Count--;
 	}
 
@@ -958,6 +958,39 @@ static HDDEDATA AcceptExecute(HSZ TopicHSz, HDDEDATA Data)
 		}
 		break;
 
+	case CmdSftpGet:
+	case CmdSftpPut:
+		{
+			wchar_t *ParamFileNameW = ToWcharU8(ParamFileName);
+			wchar_t *ParamSecondFileNameW = ToWcharU8(ParamSecondFileName);
+			int r = (Command[0] == CmdSftpGet) ?
+				SftpGet(ParamFileNameW, ParamSecondFileNameW) :
+				SftpPut(ParamFileNameW, ParamSecondFileNameW);
+			free(ParamFileNameW);
+			free(ParamSecondFileNameW);
+			if (r != SFTP_REQUEST_OK) {
+				const char *msg;
+				switch (r) {
+				case SFTP_REQUEST_NOT_SUPPORTED:
+					msg = "ttxssh.dll not support sftp";
+					break;
+				case SFTP_REQUEST_NOT_CONNECTED:
+					msg = "not connected to SSH2 server";
+					break;
+				case SFTP_REQUEST_BAD_ARGUMENT:
+					msg = "invalid file name";
+					break;
+				default:
+					msg = "cannot start sftp transfer";
+					break;
+				}
+				MessageBox(NULL, msg, (Command[0] == CmdSftpGet) ? "Tera Term: sftpget command error" : "Tera Term: sftpput command error",
+				           MB_OK | MB_ICONERROR);
+				result = DDE_FNOTPROCESSED;
+			}
+		}
+		break;
+
 	case CmdSetBaud:  // add 'setbaud' (2008.2.13 steven patch)
 		{
 		int val;
@@ -1074,6 +1107,35 @@ static HDDEDATA AcceptExecute(HSZ TopicHSz, HDDEDATA Data)
 		}
 		break;
 
+	case CmdGetScpStatus:
+		{
+		BOOL sending;
+		int percent, rate, eta;
+
+		if (!ScpGetSendingProgress(&sending, &percent, &rate, &eta)) {
+			ParamFileName[0] = 0;
+			result = DDE_FNOTPROCESSED;
+			break;
+		}
+		_snprintf_s(ParamFileName, sizeof(ParamFileName), _TRUNCATE,
+		            "%d %d %d %d", sending, percent, rate, eta);
+		}
+		break;
+
+	case CmdGetSftpStatus:
+		{
+		int pending, done, failed;
+
+		if (!SftpGetTransferStatus(&pending, &done, &failed)) {
+			ParamFileName[0] = 0;
+			result = DDE_FNOTPROCESSED;
+			break;
+		}
+		_snprintf_s(ParamFileName, sizeof(ParamFileName), _TRUNCATE,
+		            "%d %d %d", pending, done, failed);
+		}
+		break;
+
 	case CmdGetTTPos:
 		int showflag;
 		int w_x, w_y, w_width, w_height;	// EChË
@@ -48,6 +48,9 @@ extern BOOL AdvFlag;
 extern BOOL CloseTT;
 
 // DDE buffer
+//	}N 0x00,0x01 ̓GXP[včő2{ɂȂ邽߁A
+//	}ÑOobt@(RingBufSize)̔ƂĂ
+#define DDEBuffSize	(1024*8)
 extern BOOL DDELog;
 void DDEPut1(BYTE b);
 int DDEGetCount(void);
@@ -3170,14 +3170,7 @@ void DispUpdateScroll(void)
     BGScrollWindow(HVTWin,0,-d,&R,&R);
 
     if ((SRegionTop==0) && (dScroll>0))
-	{ // update scroll bar if BuffEnd is changed
-	  if ((BuffEnd==WinHeight) &&
-          (ts.EnableScrollBuff>0))
-        SetScrollRange(HVTWin,SB_VERT,0,1,TRUE);
-      else
-        SetScrollRange(HVTWin,SB_VERT,0,BuffEnd-WinHeight,FALSE);
-      SetScrollPos(HVTWin,SB_VERT,WinOrgY+PageStart,TRUE);
-	}
+      DispUpdateScrollBar();
     dScroll = 0;
   }
 
@@ -3239,6 +3232,48 @@ void DispUpdateScroll(void)
   if (IsCaretOn()) CaretOn();
 }
 
+void DispUpdateScrollBar(void)
+// update scroll bar if BuffEnd is changed
+{
+  if ((BuffEnd==WinHeight) &&
+      (ts.EnableScrollBuff>0))
+    SetScrollRange(HVTWin,SB_VERT,0,1,TRUE);
+  else
+    SetScrollRange(HVTWin,SB_VERT,0,BuffEnd-WinHeight,FALSE);
+  SetScrollPos(HVTWin,SB_VERT,WinOrgY+PageStart,TRUE);
+}
+
+BOOL DispUpdateScrollPos(void)
+//  Updates the window origin and scroll bars without drawing
+//    used while drawing is deferred (ts.RenderFrameRate > 0)
+//  Return: TRUE if the window origin is changed.
+//    the caller must redraw the whole window.
+{
+  BOOL Changed;
+
+  ScrollCount = 0;
+
+  if (NewOrgX < 0) NewOrgX = 0;
+  if (NewOrgX>NumOfColumns-WinWidth)
+    NewOrgX = NumOfColumns-WinWidth;
+  if (NewOrgY < -PageStart) NewOrgY = -PageStart;
+  if (NewOrgY>BuffEnd-WinHeight-PageStart)
+    NewOrgY = BuffEnd-WinHeight-PageStart;
+
+  Changed = (NewOrgX!=WinOrgX) || (NewOrgY!=WinOrgY);
+
+  if (NewOrgX!=WinOrgX)
+    SetScrollPos(HVTWin,SB_HORZ,NewOrgX,TRUE);
+
+  WinOrgX = NewOrgX;
+  WinOrgY = NewOrgY;
+
+  if (Changed || ts.AutoScrollOnlyInBottomLine != 0)
+    DispUpdateScrollBar();
+
+  return Changed;
+}
+
 void DispScrollHomePos(void)
 {
   NewOrgX = 0;
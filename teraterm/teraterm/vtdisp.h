@@ -108,6 +108,8 @@ void DispScrollToCursor(int CurX, int CurY);
 void DispScrollNLines(int Top, int Bottom, int Direction);
 void DispCountScroll(int n);
 void DispUpdateScroll(void);
+void DispUpdateScrollBar(void);
+BOOL DispUpdateScrollPos(void);
 void DispScrollHomePos(void);
 void DispAutoScroll(POINT p);
 void DispHScroll(int Func, int Pos);
@@ -5279,7 +5279,7 @@ static void CANSeen(BYTE b)
  */
 static int CommRead1Byte_(PComVar cv, LPBYTE b)
 {
-	if (DDELog && DDEGetCount() >= InBuffSize - 10) {
+	if (DDELog && DDEGetCount() >= DDEBuffSize - 10) {
 		/* obt@ɗ]TȂꍇ */
 		Sleep(1);
 		return 0;
@@ -5295,6 +5295,67 @@ static int CommRead1Byte_(PComVar cv, LPBYTE b)
 
 	return CommRead1Byte(cv, b);
 }
+/**
+ *	Mobt@̘A󎚉\܂Ƃ߂ď
+ *		ModeFirst ̂Ƃ
+ *		telnetAO/macroMobt@ɗ]TȂꍇ͏Ȃ
+ *		(CommRead1Byte_() 1byte)
+ *
+ *	@return	oCg
+ */
+static int ParsePrintableRun(PComVar cv)
+{
+	const BYTE *ptr;
+	int len;
+	int i;
+
+	if (ParseMode != ModeFirst || ChangeEmu != 0) {
+		return 0;
+	}
+	if (!cv->Ready || cv->InBuffCount <= 0 ||
+		cv->TelMode || cv->IACFlag || cv->TelCRFlag) {
+		return 0;
+	}
+
+	ptr = &cv->InBuff[cv->InPtr];
+	len = (int)CharSetPrintableRun(charset_data, ptr, cv->InBuffCount);
+	if (len == 0) {
+		return 0;
+	}
+
+	// 1byteő4byte(+s)o͂邱Ƃ
+	if (DDELog) {
+		int room = (DDEBuffSize - 10 - DDEGetCount()) / 4;
+		if (len > room) {
+			len = room;
+		}
+	}
+	if (FLogIsOpend()) {
+		int room = (FLogGetFreeCount() - FILESYS_LOG_FREE_SPACE) / 4;
+		if (len > room) {
+			len = room;
+		}
+	}
+	if (len <= 0) {
+		return 0;
+	}
+
+	cv->InPtr += len;
+	cv->InBuffCount -= len;
+	if (cv->InBuffCount == 0) {
+		cv->InPtr = 0;
+	}
+	if (cv->Log1Bin != NULL) {
+		for (i = 0; i < len; i++) {
+			cv->Log1Bin(ptr[i]);
+		}
+	}
+
+	ParseFirstRun(charset_data, ptr, len);
+
+	PrevCharacter = ptr[len - 1];
+	return len;
+}
 
 int VTParse()
 {
@@ -5315,6 +5376,11 @@ int VTParse()
 
 	LockBuffer();
 
+	if (ts.RenderFrameRate > 0) {
+		// `̓t[Pʂł܂Ƃ߂čs
+		BuffStartDeferredDraw();
+	}
+
 	while ((c>0) && (ChangeEmu==0)) {
 #if defined(DEBUG_DUMP_INPUTCODE)
 		{
@@ -5370,8 +5436,10 @@ int VTParse()
 			LastPutCharacter = 0;
 		}
 
-		if (ChangeEmu==0)
+		if (ChangeEmu==0) {
+			ParsePrintableRun(&cv);
 			c = CommRead1Byte_(&cv,&b);
+		}
 	}
 
 	BuffUpdateScroll();
@@ -5382,6 +5450,8 @@ int VTParse()
 	/* release device context */
 	DispReleaseDC();
 
+	BuffEndDeferredDraw();
+
 	CaretOn();
 
 	if (ChangeEmu > 0)
@@ -115,6 +115,7 @@
 #include "makeoutputstring.h"
 #include "ttlib_types.h"
 #include "externalsetup.h"
+#include "finddlg.h"
 
 #include <initguid.h>
 #if _MSC_VER < 1600
@@ -760,6 +761,7 @@ void CVTWindow::InitMenu(HMENU *Menu)
 		{ ID_EDIT_CANCELSELECT, "MENU_EDIT_CANCELSELECT" },
 		{ ID_EDIT_SELECTSCREEN, "MENU_EDIT_SELECTSCREEN" },
 		{ ID_EDIT_SELECTALL, "MENU_EDIT_SELECTALL" },
+		{ ID_EDIT_FIND, "MENU_EDIT_FIND" },
 	};
 	static const DlgTextInfo SetupMenuTextInfo[] = {
 		{ ID_SETUP_TERMINAL, "MENU_SETUP_TERMINAL" },
@@ -1500,6 +1502,8 @@ void CVTWindow::OnDestroy()
 
 	TTXEnd(); /* TTPLUG */
 
+	CommUninit(&cv);
+
 	TTSetUnInit(&ts);
 
 	Notify2Uninitialize((NotifyIcon *)cv.NotifyIcon);
@@ -2702,6 +2706,9 @@ void CVTWindow::OnTimer(UINT_PTR nIDEvent)
 		case IdDblClkTimer:
 			AfterDblClk = FALSE;
 			break;
+		case IdRenderTimer:
+			BuffDrawDeferred();
+			break;
 		case IdComEndTimer:
 			if (! CommCanClose(&cv)) {
 				// wait if received data remains
@@ -4212,6 +4219,11 @@ void CVTWindow::OnEditSelectScreenBuffer()
 	ChangeSelectRegion();
 }
 
+void CVTWindow::OnEditFind()
+{
+	ShowFindDialog(m_hInst, m_hWnd, ts.UILanguageFileW);
+}
+
 void CVTWindow::OnEditCancelSelection()
 {
 	// Cancel selected buffer
@@ -5127,6 +5139,7 @@ LRESULT CVTWindow::Proc(UINT msg, WPARAM wp, LPARAM lp)
 		case ID_EDIT_CANCELSELECT: OnEditCancelSelection(); break;
 		case ID_EDIT_SELECTALL: OnEditSelectAllBuffer(); break;
 		case ID_EDIT_SELECTSCREEN: OnEditSelectScreenBuffer(); break;
+		case ID_EDIT_FIND: OnEditFind(); break;
 		case ID_SETUP_ADDITIONALSETTINGS: OnExternalSetup(); break;
 		case ID_SETUP_TERMINAL: OnSetupTerminal(); break;
 		case ID_SETUP_WINDOW: OnSetupWindow(); break;
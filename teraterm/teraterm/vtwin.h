@@ -201,6 +201,7 @@ protected:
 	void OnEditCancelSelection();
 	void OnEditSelectScreenBuffer();
 	void OnEditSelectAllBuffer();
+	void OnEditFind();
 	void OnSetupTerminal();
 	void OnSetupWindow();
 	void OnSetupFont();
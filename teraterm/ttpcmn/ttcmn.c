@@ -519,6 +519,9 @@ void WINAPI CommInsert1Byte(PComVar cv, BYTE b)
 	}
 
 	if (cv->InPtr == 0) {
+		if (cv->InBuffCount >= cv->InBuffMax) {
+			return;
+		}
 		memmove(&(cv->InBuff[1]),&(cv->InBuff[0]),cv->InBuffCount);
 	}
 	else {
@@ -613,7 +616,7 @@ int WINAPI CommRawOut(PComVar cv, /*const*/ PCHAR B, int C)
 	return a;
 }
 
-int WINAPI CommBinaryOut(PComVar cv, PCHAR B, int C)
+int WINAPI CommBinaryOut(PComVar cv, const char *B, int C)
 {
 	int a, i, Len;
 	char d[3];
@@ -706,19 +709,27 @@ static BOOL WriteOutBuff(PComVar cv, const char *TempStr, int TempLen)
  */
 static BOOL WriteInBuff(PComVar cv, const char *TempStr, int TempLen)
 {
-	BOOL Full;
+	int Tail;
 
 	if (TempLen == 0) {
 		return TRUE;
 	}
 
-	Full = InBuffSize-cv->InBuffCount-TempLen < 0;
-	if (! Full) {
-		memcpy(&(cv->InBuff[cv->InBuffCount]),TempStr,TempLen);
-		cv->InBuffCount = cv->InBuffCount + TempLen;
-		return TRUE;
+	Tail = cv->InPtr + cv->InBuffCount;
+	if (cv->InBuffMax - Tail < TempLen && cv->InPtr > 0) {
+		// ɓȂƂ͐擪̋󂫂l߂
+		if (cv->InBuffCount > 0) {
+			memmove(cv->InBuff,&(cv->InBuff[cv->InPtr]),cv->InBuffCount);
+		}
+		cv->InPtr = 0;
+		Tail = cv->InBuffCount;
+	}
+	if (cv->InBuffMax - Tail < TempLen) {
+		return FALSE;
 	}
-	return FALSE;
+	memcpy(&(cv->InBuff[Tail]),TempStr,TempLen);
+	cv->InBuffCount = cv->InBuffCount + TempLen;
+	return TRUE;
 }
 
 /**
@@ -160,7 +160,11 @@ static BOOL BPInit(PFileVarProto fv, PComVar cv, PTTSet ts)
 
   /* file name, file size */
   if (bv->BPMode==IdBPSend)
+  {
+    /* M_CAOŎw肵t@C */
+    bv->FullName = fv->GetNextFname(fv);
     BPOpenFileToBeSent(fv);
+  }
 
   /* default parameters */
   for (i = 0 ; i<= 7 ; i++)
@@ -0,0 +1,334 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *	ǂݏobt@O TFileIO
+ *		evgR ReadFile()/WriteFile()  1byte ĂԂƂ̂ŁA
+ *		ʂ TFileIO (Win32, POSIX) ̑OɒuāA܂Ƃ߂ēǂݏB
+ *		t@C֌W̊֐͉ʂ TFileIO ̂܂܌ĂԁB
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "filesys_io.h"
+#include "filesys_buffered.h"
+
+typedef enum {
+	BUF_NONE,
+	BUF_READ,		// buf[pos..len) ǂ݂f[^
+	BUF_WRITE,		// buf[0..len) ܂łȂf[^
+} BufMode;
+
+typedef struct FileIOBuffered {
+	TFileIO *io;		// ʂ TFileIO
+	unsigned char *buf;
+	size_t size;
+	size_t pos;
+	size_t len;
+	BufMode mode;
+	unsigned long long file_pos;	// ʂ TFileIO ̃t@Cʒu
+} TFileIOBuffered;
+
+static void ResetBuffer(TFileIOBuffered *data)
+{
+	data->mode = BUF_NONE;
+	data->pos = 0;
+	data->len = 0;
+}
+
+/**
+ *	ݑ҂̃f[^ʂ TFileIO ֏
+ *	߂Ȃf[^͎̂Ă
+ */
+static void FlushBuffer(TFileIOBuffered *data)
+{
+	TFileIO *io = data->io;
+	size_t done = 0;
+
+	if (data->mode != BUF_WRITE) {
+		return;
+	}
+	while (done < data->len) {
+		size_t n = io->WriteFile(io, data->buf + done, data->len - done);
+		if (n == 0) {
+			break;
+		}
+		done += n;
+	}
+	data->file_pos += done;
+	ResetBuffer(data);
+}
+
+/**
+ *	ǂ݂āA܂ǂłȂʂ TFileIO ̃t@Cʒu߂
+ */
+static void UnreadBuffer(TFileIOBuffered *data)
+{
+	TFileIO *io = data->io;
+
+	if (data->mode != BUF_READ) {
+		return;
+	}
+	if (data->pos < data->len) {
+		unsigned long long offset = data->file_pos - (data->len - data->pos);
+		if (io->Seek(io, offset) == 0) {
+			data->file_pos = offset;
+		}
+	}
+	ResetBuffer(data);
+}
+
+static BOOL _OpenRead(TFileIO *fv, const char *filename)
+{
+	TFileIOBuffered *data = (TFileIOBuffered *)fv->data;
+	ResetBuffer(data);
+	data->file_pos = 0;
+	return data->io->OpenRead(data->io, filename);
+}
+
+static BOOL _OpenWrite(TFileIO *fv, const char *filename)
+{
+	TFileIOBuffered *data = (TFileIOBuffered *)fv->data;
+	ResetBuffer(data);
+	data->file_pos = 0;
+	return data->io->OpenWrite(data->io, filename);
+}
+
+static size_t _ReadFile(TFileIO *fv, void *buf, size_t bytes)
+{
+	TFileIOBuffered *data = (TFileIOBuffered *)fv->data;
+	TFileIO *io = data->io;
+	unsigned char *p = (unsigned char *)buf;
+	size_t done = 0;
+
+	FlushBuffer(data);
+	while (done < bytes) {
+		size_t n;
+		if (data->mode == BUF_READ && data->pos < data->len) {
+			n = data->len - data->pos;
+			if (n > bytes - done) {
+				n = bytes - done;
+			}
+			memcpy(p + done, data->buf + data->pos, n);
+			data->pos += n;
+			done += n;
+			continue;
+		}
+
+		// obt@
+		ResetBuffer(data);
+		if (bytes - done >= data->size) {
+			// obt@傫Ƃ͒ړǂ
+			n = io->ReadFile(io, p + done, bytes - done);
+			data->file_pos += n;
+			done += n;
+			break;
+		}
+		n = io->ReadFile(io, data->buf, data->size);
+		if (n == 0) {
+			// EOF
+			break;
+		}
+		data->file_pos += n;
+		data->mode = BUF_READ;
+		data->len = n;
+	}
+	return done;
+}
+
+static size_t _WriteFile(TFileIO *fv, const void *buf, size_t bytes)
+{
+	TFileIOBuffered *data = (TFileIOBuffered *)fv->data;
+	TFileIO *io = data->io;
+
+	UnreadBuffer(data);
+	if (data->len + bytes > data->size) {
+		FlushBuffer(data);
+	}
+	if (bytes >= data->size) {
+		// obt@傫Ƃ͒ڏ
+		size_t n = io->WriteFile(io, buf, bytes);
+		data->file_pos += n;
+		return n;
+	}
+	memcpy(data->buf + data->len, buf, bytes);
+	data->len += bytes;
+	data->mode = BUF_WRITE;
+	return bytes;
+}
+
+static void _Close(TFileIO *fv)
+{
+	TFileIOBuffered *data = (TFileIOBuffered *)fv->data;
+	FlushBuffer(data);
+	ResetBuffer(data);
+	data->io->Close(data->io);
+}
+
+/**
+ *	@retval	0	ok
+ *	@retval	-1	error
+ *
+ *	ǂ݂͈͓ւ̈ړ (ZMODEM  ZRPOS ŏ߂ꍇȂ) 
+ *	obt@̓ǂވʒuς邾ɂ
+ */
+static int Seek(TFileIO *fv, unsigned long long offset)
+{
+	TFileIOBuffered *data = (TFileIOBuffered *)fv->data;
+	TFileIO *io = data->io;
+
+	FlushBuffer(data);
+	if (data->mode == BUF_READ) {
+		unsigned long long start = data->file_pos - data->len;
+		if (offset >= start && offset <= data->file_pos) {
+			data->pos = (size_t)(offset - start);
+			return 0;
+		}
+	}
+	ResetBuffer(data);
+	if (io->Seek(io, offset) != 0) {
+		return -1;
+	}
+	data->file_pos = offset;
+	return 0;
+}
+
+static unsigned long long _GetFSize(TFileIO *fv, const char *filename)
+{
+	TFileIOBuffered *data = (TFileIOBuffered *)fv->data;
+	return data->io->GetFSize(data->io, filename);
+}
+
+static int __utime(TFileIO *fv, const char *filename, struct _utimbuf* const _Time)
+{
+	TFileIOBuffered *data = (TFileIOBuffered *)fv->data;
+	return data->io->utime(data->io, filename, _Time);
+}
+
+static BOOL _SetFMtime(TFileIO *fv, const char *FName, DWORD mtime)
+{
+	TFileIOBuffered *data = (TFileIOBuffered *)fv->data;
+	return data->io->SetFMtime(data->io, FName, mtime);
+}
+
+static int __stat(TFileIO *fv, const char *filename, struct _stati64* _Stat)
+{
+	TFileIOBuffered *data = (TFileIOBuffered *)fv->data;
+	return data->io->stat(data->io, filename, _Stat);
+}
+
+static char *GetSendFilename(TFileIO *fv, const char *fullname, BOOL utf8, BOOL space, BOOL upper)
+{
+	TFileIOBuffered *data = (TFileIOBuffered *)fv->data;
+	return data->io->GetSendFilename(data->io, fullname, utf8, space, upper);
+}
+
+static char *GetRecieveFilename(TFileIO *fv, const char *filename, BOOL utf8, const char *path, BOOL unique)
+{
+	TFileIOBuffered *data = (TFileIOBuffered *)fv->data;
+	return data->io->GetRecieveFilename(data->io, filename, utf8, path, unique);
+}
+
+static long GetFMtime(TFileIO *fv, const char *fullname)
+{
+	TFileIOBuffered *data = (TFileIOBuffered *)fv->data;
+	return data->io->GetFMtime(data->io, fullname);
+}
+
+static BOOL SetFilenameEncodeUTF8(TFileIO *fv, BOOL utf8)
+{
+	TFileIOBuffered *data = (TFileIOBuffered *)fv->data;
+	return data->io->SetFilenameEncodeUTF8(data->io, utf8);
+}
+
+static void FileSysDestroy(TFileIO *fv)
+{
+	TFileIOBuffered *data = (TFileIOBuffered *)fv->data;
+	fv->Close(fv);
+	data->io->FileSysDestroy(data->io);
+	free(data->buf);
+	free(data);
+	fv->data = NULL;
+	free(fv);
+}
+
+/**
+ *	io ̓ǂݏobt@O TFileIO 쐬
+ *
+ *	@param[in]	io		ʂ TFileIOAFileSysDestroy() ňꏏɔj
+ *	@param[in]	size	obt@TCYA0 ̂Ƃ FILESYS_BUFFER_SIZE
+ *	@retval		쐬 TFileIO
+ *				쐬łȂƂ io ̂܂ܕԂ
+ */
+TFileIO *FilesysCreateBuffered(TFileIO *io, size_t size)
+{
+	TFileIOBuffered *data;
+	TFileIO *fv;
+
+	if (io == NULL) {
+		return NULL;
+	}
+	if (size == 0) {
+		size = FILESYS_BUFFER_SIZE;
+	}
+	data = (TFileIOBuffered *)calloc(1, sizeof(TFileIOBuffered));
+	if (data == NULL) {
+		return io;
+	}
+	data->buf = (unsigned char *)malloc(size);
+	fv = (TFileIO *)calloc(1, sizeof(TFileIO));
+	if (data->buf == NULL || fv == NULL) {
+		free(data->buf);
+		free(data);
+		free(fv);
+		return io;
+	}
+	data->io = io;
+	data->size = size;
+	ResetBuffer(data);
+	fv->data = data;
+	fv->OpenRead = _OpenRead;
+	fv->OpenWrite = _OpenWrite;
+	fv->ReadFile = _ReadFile;
+	fv->WriteFile = _WriteFile;
+	fv->Close = _Close;
+	fv->Seek = Seek;
+	fv->GetFSize = _GetFSize;
+	fv->utime = __utime;
+	fv->stat = __stat;
+	fv->FileSysDestroy = FileSysDestroy;
+	fv->GetSendFilename = GetSendFilename;
+	fv->GetRecieveFilename = GetRecieveFilename;
+	fv->GetFMtime = GetFMtime;
+	fv->SetFMtime = _SetFMtime;
+	if (io->SetFilenameEncodeUTF8 != NULL) {
+		fv->SetFilenameEncodeUTF8 = SetFilenameEncodeUTF8;
+	}
+	return fv;
+}
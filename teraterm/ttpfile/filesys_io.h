@@ -30,7 +30,14 @@
 
 #include <sys/types.h>	// for struct utimbuf
 #include <sys/stat.h>
+#if defined(_WIN32)
 #include <sys/utime.h>
+#else
+// POSIX (filesys_posix.c)
+#include <utime.h>
+#define _utimbuf utimbuf
+#define _stati64 stat
+#endif
 #include <windows.h>	// for BOOL
 
 typedef struct FileIO {
@@ -40,10 +47,10 @@ typedef struct FileIO {
 	size_t (*ReadFile)(struct FileIO *fv, void *buf, size_t bytes);
 	size_t (*WriteFile)(struct FileIO *fv, const void *buf, size_t bytes);
 	void (*Close)(struct FileIO *fv);
-	int (*Seek)(struct FileIO *fv, size_t offset);
+	int (*Seek)(struct FileIO *fv, unsigned long long offset);
 	void (*FileSysDestroy)(struct FileIO *fv);
 	//
-	size_t (*GetFSize)(struct FileIO *fv, const char *filename);
+	unsigned long long (*GetFSize)(struct FileIO *fv, const char *filename);
 	int (*utime)(struct FileIO *fv, const char *filename, struct _utimbuf* const _Time);
 	BOOL (*SetFMtime)(struct FileIO *fv, const char *FName, DWORD mtime);
 	int (*stat)(struct FileIO *fv, const char *filename, struct _stati64* _Stat);
@@ -0,0 +1,268 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *	POSIX  TFileIO
+ *		Windows ȊOŃvgR (xmodem.c Ȃ) 𓮂ƂɎg
+ *		t@C UTF-8 ̂܂܈
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <utime.h>
+
+#include "filesys_io.h"
+#include "filesys_posix.h"
+
+typedef struct FileIOPosix {
+	int fd;
+} TFileIOPosix;
+
+static BOOL _OpenRead(TFileIO *fv, const char *filename)
+{
+	TFileIOPosix *data = (TFileIOPosix *)fv->data;
+	data->fd = open(filename, O_RDONLY);
+	return data->fd >= 0;
+}
+
+static BOOL _OpenWrite(TFileIO *fv, const char *filename)
+{
+	TFileIOPosix *data = (TFileIOPosix *)fv->data;
+	data->fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	return data->fd >= 0;
+}
+
+static size_t _ReadFile(TFileIO *fv, void *buf, size_t bytes)
+{
+	TFileIOPosix *data = (TFileIOPosix *)fv->data;
+	ssize_t n;
+
+	do {
+		n = read(data->fd, buf, bytes);
+	} while (n < 0 && errno == EINTR);
+	if (n < 0) {
+		return 0;
+	}
+	return (size_t)n;
+}
+
+static size_t _WriteFile(TFileIO *fv, const void *buf, size_t bytes)
+{
+	TFileIOPosix *data = (TFileIOPosix *)fv->data;
+	ssize_t n;
+
+	do {
+		n = write(data->fd, buf, bytes);
+	} while (n < 0 && errno == EINTR);
+	if (n < 0) {
+		return 0;
+	}
+	return (size_t)n;
+}
+
+static void _Close(TFileIO *fv)
+{
+	TFileIOPosix *data = (TFileIOPosix *)fv->data;
+	if (data->fd >= 0) {
+		close(data->fd);
+		data->fd = -1;
+	}
+}
+
+/**
+ *	@retval	0	ok
+ *	@retval	-1	error
+ */
+static int Seek(TFileIO *fv, unsigned long long offset)
+{
+	TFileIOPosix *data = (TFileIOPosix *)fv->data;
+	if (lseek(data->fd, (off_t)offset, SEEK_SET) == (off_t)-1) {
+		return -1;
+	}
+	return 0;
+}
+
+static unsigned long long _GetFSize(TFileIO *fv, const char *filename)
+{
+	struct stat st;
+	(void)fv;
+	if (stat(filename, &st) != 0) {
+		return 0;
+	}
+	return (unsigned long long)st.st_size;
+}
+
+static int __utime(TFileIO *fv, const char *filename, struct _utimbuf* const _Time)
+{
+	(void)fv;
+	return utime(filename, _Time);
+}
+
+static int __stat(TFileIO *fv, const char *filename, struct _stati64* _Stat)
+{
+	(void)fv;
+	return stat(filename, _Stat);
+}
+
+static long GetFMtime(TFileIO *fv, const char *FName)
+{
+	struct stat st;
+	(void)fv;
+	if (stat(FName, &st) != 0) {
+		return 0;
+	}
+	return (long)st.st_mtime;
+}
+
+static BOOL _SetFMtime(TFileIO *fv, const char *FName, DWORD mtime)
+{
+	struct utimbuf filetime;
+	(void)fv;
+	filetime.actime = mtime;
+	filetime.modtime = mtime;
+	return utime(FName, &filetime);
+}
+
+// pX؂ ('/'  '\\') ̌̃t@C
+static const char *GetFileNamePart(const char *fullname)
+{
+	const char *p = fullname;
+	const char *s;
+	for (s = fullname; *s != 0; s++) {
+		if (*s == '/' || *s == '\\') {
+			p = s + 1;
+		}
+	}
+	return p;
+}
+
+static char *GetSendFilename(TFileIO *fv, const char *fullname, BOOL utf8, BOOL space, BOOL upper)
+{
+	char *filename = strdup(GetFileNamePart(fullname));
+	char *p;
+	(void)fv;
+	(void)utf8;
+	if (filename == NULL) {
+		return NULL;
+	}
+	for (p = filename; *p != 0; p++) {
+		if (space && *p == ' ') {
+			*p = '_';
+		}
+		if (upper) {
+			*p = (char)toupper((unsigned char)*p);
+		}
+	}
+	return filename;
+}
+
+static BOOL DoesFileExist(const char *filename)
+{
+	struct stat st;
+	return stat(filename, &st) == 0;
+}
+
+static char *GetRecieveFilename(TFileIO *fv, const char *filename, BOOL utf8, const char *path, BOOL unique)
+{
+	const char *name = GetFileNamePart(filename);
+	const char *ext;
+	size_t len;
+	char *full;
+	int i;
+	(void)fv;
+	(void)utf8;
+
+	if (path == NULL) {
+		path = "";
+	}
+	len = strlen(path) + strlen(name) + 12;
+	full = (char *)malloc(len);
+	if (full == NULL) {
+		return NULL;
+	}
+	snprintf(full, len, "%s%s", path, name);
+
+	// łɂƂ́At@Č (gq̑O) ɐt
+	ext = strrchr(name, '.');
+	if (ext == NULL) {
+		ext = name + strlen(name);
+	}
+	for (i = 1; unique && DoesFileExist(full); i++) {
+		snprintf(full, len, "%s%.*s%u%s", path, (int)(ext - name), name, i, ext);
+	}
+	return full;
+}
+
+static void FileSysDestroy(TFileIO *fv)
+{
+	TFileIOPosix *data = (TFileIOPosix *)fv->data;
+	fv->Close(fv);
+	free(data);
+	fv->data = NULL;
+	free(fv);
+}
+
+TFileIO *FilesysCreatePosix(void)
+{
+	TFileIOPosix *data;
+	TFileIO *fv;
+
+	data = (TFileIOPosix *)calloc(1, sizeof(TFileIOPosix));
+	if (data == NULL) {
+		return NULL;
+	}
+	data->fd = -1;
+	fv = (TFileIO *)calloc(1, sizeof(TFileIO));
+	if (fv == NULL) {
+		free(data);
+		return NULL;
+	}
+	fv->data = data;
+	fv->OpenRead = _OpenRead;
+	fv->OpenWrite = _OpenWrite;
+	fv->ReadFile = _ReadFile;
+	fv->WriteFile = _WriteFile;
+	fv->Close = _Close;
+	fv->Seek = Seek;
+	fv->GetFSize = _GetFSize;
+	fv->utime = __utime;
+	fv->stat = __stat;
+	fv->FileSysDestroy = FileSysDestroy;
+	fv->GetSendFilename = GetSendFilename;
+	fv->GetRecieveFilename = GetRecieveFilename;
+	fv->GetFMtime = GetFMtime;
+	fv->SetFMtime = _SetFMtime;
+	return fv;
+}
@@ -132,34 +132,25 @@ static void _Close(TFileIO *fv)
  *	@param[in]	filename		t@C(UTF-8)
  *	@retval		t@CTCY
  */
-static size_t _GetFSize(TFileIO *fv, const char *filename)
+static unsigned long long _GetFSize(TFileIO *fv, const char *filename)
 {
 	TFileIOWin32 *data = (TFileIOWin32 *)fv->data;
 	wc filenameW = GetFilenameW(data, filename);
-	size_t file_size = GetFSize64W(filenameW);
+	unsigned long long file_size = GetFSize64W(filenameW);
 	return file_size;
 }
 
 /**
  *	@retval	0	ok
  *	@retval	-1	error
- * TODO size_t ȏ̃t@C̈
- *
  */
-static int Seek(TFileIO *fv, size_t offset)
+static int Seek(TFileIO *fv, unsigned long long offset)
 {
 	TFileIOWin32 *data = (TFileIOWin32 *)fv->data;
-#if _M_X64
-	// sizeof(size_t) == 8
-	LONG lo = (LONG)((offset >> 0) & 0xffffffff);
-	LONG hi = (LONG)((offset >> 32) & 0xffffffff);
-#else
-	// sizeof(size_t) == 4
-	LONG lo = (LONG)((offset >> 0) & 0xffffffff);
-	LONG hi = 0;
-#endif
-	SetFilePointer(data->FileHandle, lo, &hi, 0);
-	if (GetLastError() != 0) {
+	LARGE_INTEGER pos;
+	pos.QuadPart = (LONGLONG)offset;
+	// SetFilePointer() ͐Ă GetLastError() NAȂ̂ŁA߂lŔ肷
+	if (!SetFilePointerEx(data->FileHandle, pos, NULL, FILE_BEGIN)) {
 		return -1;
 	}
 	return 0;
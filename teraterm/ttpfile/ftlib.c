@@ -29,31 +29,130 @@
 
 /* routines for file transfer protocol */
 
-#include <windows.h> // for BYTE, WORD, LONG
+#include <windows.h> // for BYTE, WORD, LONG, DWORD
 #include "ftlib.h"
 
+/*
+ * CRC
+ *   1byte rbgPʂŌvZƒx̂ŁAe[ugB
+ *   ubNł 8byte ܂Ƃ߂ČvZ (slicing-by-8)B
+ *     CRC16Table[k][v]  : v ̌ 0  k byte Ƃ CRC-16 (CCITT, MSB first)
+ *     CRC16RTable[k][v] :  CRC-16 (CCITT, LSB first)
+ *     CRC32Table[k][v]  :  CRC-32 (LSB first)
+ *   e[u͍ŏɎgƂɍ쐬B
+ */
+#define CRC16_POLY  0x1021
+#define CRC16R_POLY 0x8408
+#define CRC32_POLY  0xedb88320
+
+static WORD CRC16Table[8][256];
+static WORD CRC16RTable[8][256];
+static DWORD CRC32Table[8][256];
+static volatile BOOL CRCTableReady = FALSE;
+
+static void MakeCRCTable(void)
+{
+  int i, j, k;
+
+  if (CRCTableReady)
+    return;
+
+  for (i = 0 ; i < 256 ; i++) {
+    WORD c16 = (WORD)(i << 8);
+    WORD c16r = (WORD)i;
+    DWORD c32 = (DWORD)i;
+    for (j = 0 ; j < 8 ; j++) {
+      c16 = (c16 & 0x8000) ? (WORD)((c16 << 1) ^ CRC16_POLY) : (WORD)(c16 << 1);
+      c16r = (c16r & 1) ? (WORD)((c16r >> 1) ^ CRC16R_POLY) : (WORD)(c16r >> 1);
+      c32 = (c32 & 1) ? ((c32 >> 1) ^ CRC32_POLY) : (c32 >> 1);
+    }
+    CRC16Table[0][i] = c16;
+    CRC16RTable[0][i] = c16r;
+    CRC32Table[0][i] = c32;
+  }
+  for (k = 1 ; k < 8 ; k++) {
+    for (i = 0 ; i < 256 ; i++) {
+      WORD c16 = CRC16Table[k - 1][i];
+      WORD c16r = CRC16RTable[k - 1][i];
+      DWORD c32 = CRC32Table[k - 1][i];
+      CRC16Table[k][i] = (WORD)((c16 << 8) ^ CRC16Table[0][c16 >> 8]);
+      CRC16RTable[k][i] = (WORD)((c16r >> 8) ^ CRC16RTable[0][c16r & 0xff]);
+      CRC32Table[k][i] = (c32 >> 8) ^ CRC32Table[0][c32 & 0xff];
+    }
+  }
+  CRCTableReady = TRUE;
+}
+
+/* CRC-16 (CCITT, XMODEM/ZMODEM/B-Plus) */
 WORD UpdateCRC(BYTE b, WORD CRC)
 {
-  int i;
-
-  CRC = CRC ^ (WORD)((WORD)b << 8);
-  for (i = 1 ; i <= 8 ; i++)
-    if ((CRC & 0x8000)!=0)
-      CRC = (CRC << 1) ^ 0x1021;
-    else
-      CRC = CRC << 1;
+  MakeCRCTable();
+  return (WORD)((CRC << 8) ^ CRC16Table[0][(CRC >> 8) ^ b]);
+}
+
+WORD UpdateCRC16Block(WORD CRC, const BYTE *buf, size_t len)
+{
+  MakeCRCTable();
+  while (len >= 8) {
+    CRC = (WORD)(CRC16Table[7][(CRC >> 8) ^ buf[0]] ^
+                 CRC16Table[6][(CRC & 0xff) ^ buf[1]] ^
+                 CRC16Table[5][buf[2]] ^ CRC16Table[4][buf[3]] ^
+                 CRC16Table[3][buf[4]] ^ CRC16Table[2][buf[5]] ^
+                 CRC16Table[1][buf[6]] ^ CRC16Table[0][buf[7]]);
+    buf += 8;
+    len -= 8;
+  }
+  while (len > 0) {
+    CRC = (WORD)((CRC << 8) ^ CRC16Table[0][(CRC >> 8) ^ *buf++]);
+    len--;
+  }
+  return CRC;
+}
+
+/* CRC-16 (CCITT, LSB first) }N crc16, crc16file */
+WORD UpdateCRC16RBlock(WORD CRC, const BYTE *buf, size_t len)
+{
+  MakeCRCTable();
+  while (len >= 8) {
+    CRC = (WORD)(CRC16RTable[7][(CRC & 0xff) ^ buf[0]] ^
+                 CRC16RTable[6][(CRC >> 8) ^ buf[1]] ^
+                 CRC16RTable[5][buf[2]] ^ CRC16RTable[4][buf[3]] ^
+                 CRC16RTable[3][buf[4]] ^ CRC16RTable[2][buf[5]] ^
+                 CRC16RTable[1][buf[6]] ^ CRC16RTable[0][buf[7]]);
+    buf += 8;
+    len -= 8;
+  }
+  while (len > 0) {
+    CRC = (WORD)((CRC >> 8) ^ CRC16RTable[0][(CRC ^ *buf++) & 0xff]);
+    len--;
+  }
   return CRC;
 }
 
+/* CRC-32 (ZMODEM, }N crc32, crc32file) */
 LONG UpdateCRC32(BYTE b, LONG CRC)
 {
-  int i;
-
-  CRC = CRC ^ (LONG)b;
-  for (i = 1 ; i <= 8 ; i++)
-    if ((CRC & 0x00000001)!=0)
-      CRC = (CRC >> 1) ^ 0xedb88320;
-    else
-      CRC = CRC >> 1;
+  DWORD c = (DWORD)CRC;
+
+  MakeCRCTable();
+  return (LONG)((c >> 8) ^ CRC32Table[0][(c ^ b) & 0xff]);
+}
+
+DWORD UpdateCRC32Block(DWORD CRC, const BYTE *buf, size_t len)
+{
+  MakeCRCTable();
+  while (len >= 8) {
+    CRC ^= (DWORD)buf[0] | ((DWORD)buf[1] << 8) | ((DWORD)buf[2] << 16) | ((DWORD)buf[3] << 24);
+    CRC = CRC32Table[7][CRC & 0xff] ^ CRC32Table[6][(CRC >> 8) & 0xff] ^
+          CRC32Table[5][(CRC >> 16) & 0xff] ^ CRC32Table[4][CRC >> 24] ^
+          CRC32Table[3][buf[4]] ^ CRC32Table[2][buf[5]] ^
+          CRC32Table[1][buf[6]] ^ CRC32Table[0][buf[7]];
+    buf += 8;
+    len -= 8;
+  }
+  while (len > 0) {
+    CRC = (CRC >> 8) ^ CRC32Table[0][(CRC ^ *buf++) & 0xff];
+    len--;
+  }
   return CRC;
 }
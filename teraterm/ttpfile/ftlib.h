@@ -31,12 +31,17 @@
 
 #pragma once
 
+#include <stddef.h>	// for size_t
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 WORD UpdateCRC(BYTE b, WORD CRC);
 LONG UpdateCRC32(BYTE b, LONG CRC);
+WORD UpdateCRC16Block(WORD CRC, const BYTE *buf, size_t len);
+WORD UpdateCRC16RBlock(WORD CRC, const BYTE *buf, size_t len);
+DWORD UpdateCRC32Block(DWORD CRC, const BYTE *buf, size_t len);
 
 #ifdef __cplusplus
 }
@@ -36,16 +36,29 @@
 #include "protolog.h"
 
 #include "kermit.h"
+#include "ftlib.h"
 
 typedef struct {
 	int MAXL;
 	int MAXLX;
-	BYTE TIME,NPAD,PADC,EOL,QCTL,QBIN,CHKT,REPT,CAPAS,WINDO,MAXLX1,MAXLX2;
+	BYTE TIME,NPAD,PADC,EOL,QCTL,QBIN,CHKT,REPT,CAPAS,WINDO,MAXLX1,MAXLX2,WHATAMI;
 } KermitParam;
 
-#define	KMT_DATAMAX		4000
+#define	KMT_DATAMAX		9024
 #define	KMT_PKTMAX		(KMT_DATAMAX + 32)
-#define	KMT_PKTQUE		4
+#define	KMT_WINMAX		31		/* XCfBOEBhE̍őTCY */
+#define	KMT_WINSLOT		32		/* EBhẼpPbgێ鐔 (KMT_WINMAX 傫) */
+#define	KMT_FILEBUF		8192	/* t@Cǂݏ̃obt@TCY */
+
+/* XCfBOEBhẼpPbg */
+typedef struct {
+	BOOL Used;			/* M: ACK ҂, M: Mς݂Ŗ */
+	int Len;			/* M: PktOutCount, M: PktInLen */
+	int LongLen;		/* M: PktInLongPacketLen */
+	int Count;			/* M: PktInCount */
+	DWORD TxSeq;		/* M: Ōɑ */
+	BYTE Buf[KMT_PKTMAX];
+} KmtWinSlot;
 
 typedef struct {
 	BYTE PktIn[KMT_PKTMAX], PktOut[KMT_PKTMAX];
@@ -61,6 +74,7 @@ typedef struct {
 	BYTE NextSeq;
 	BYTE NextByte;
 	KermitParam KmtMy, KmtYour;
+	BYTE ChkType;		/* Send-Init ŌubN`FbN̎, I܂ KmtMy.CHKT  1 */
 	int PktOutCount, PktInLongPacketLen;
 	int FileAttrFlag;
 	BOOL FileType;
@@ -80,6 +94,20 @@ typedef struct {
 	DWORD StartTime;
 
 	DWORD FileMtime;
+
+	/* XCfBOEBhE/Xg[~O */
+	int WinSize;		/* EBhETCY, 1 Ȃ stop-and-wait */
+	BOOL Streaming;		/* f[^pPbg ACK ҂ɑ */
+	int WinLow;			/* M: ACK ҂̍ŏpPbgԍ */
+	int WinHigh;		/* M: MőpPbgԍ */
+	BOOL DataEOF;		/* M: t@CŌ܂œǂ */
+	KmtWinSlot *Win;	/* KMT_WINSLOT , WinSize > 1 ̂Ƃmۂ */
+	DWORD PktInTotal;	/* MpPbg */
+	DWORD TxSeq;		/* M: pPbg𑗂 */
+
+	/* t@Cǂݍ݃obt@ */
+	BYTE FileBuf[KMT_FILEBUF];
+	int FileBufPtr, FileBufLen;
 } TKmtVar;
 typedef TKmtVar *PKmtVar;
 
@@ -96,13 +124,13 @@ typedef TKmtVar *PKmtVar;
 #define SendEOT 5
 #define SendFileAttr 6
 
-#define ReceiveInit 6
-#define ReceiveFile 7
-#define ReceiveData 8
+#define ReceiveInit 7
+#define ReceiveFile 8
+#define ReceiveData 9
 
-#define ServerInit 9
-#define GetInit 10
-#define Finish 11
+#define ServerInit 10
+#define GetInit 11
+#define Finish 12
 
 /* kermit parameters */
 #define MaxNum 94
@@ -118,11 +146,16 @@ typedef TKmtVar *PKmtVar;
 #define DefQCTL '#'
 #define MyQBIN  'Y'
 #define DefCHKT 1
+#define LongCHKT 3	/* Long Packet gƂɗvubN`FbN (CRC-16) */
 #define MyREPT  '~'
 
 #define	KMT_CAP_LONGPKT	2
 #define	KMT_CAP_SLIDWIN	4
 #define	KMT_CAP_FILATTR	8
+
+/* WHATAMI (Send-Init  18 Ԗڂ̃p[^, C-Kermit ݊) */
+#define	KMT_WMI_STREAM	16	/* Xg[~O\ */
+#define	KMT_WMI_FLAG	32	/* WHATAMI L */
 /*
  * Long Packet ̓
  * - M
@@ -146,6 +179,7 @@ typedef TKmtVar *PKmtVar;
 #define LONGPKT_HEADNUM 6
 
 static BYTE KmtNum(BYTE b);
+static void KmtSendFirstData(PFileVarProto fv, PKmtVar kv, PComVar cv);
 
 
 static void KmtOutputCommonLog(PFileVarProto fv, PKmtVar kv, BYTE *buf, int len)
@@ -308,10 +342,33 @@ static void KmtCalcCheck(WORD Sum, BYTE CHKT, PCHAR Check)
 		Check[0] = KmtChar((BYTE)((Sum / 0x40) & 0x3F));
 		Check[1] = KmtChar((BYTE)(Sum & 0x3F));
 		break;
-	case 3: break;
+	case 3:
+		Check[0] = KmtChar((BYTE)((Sum >> 12) & 0x0F));
+		Check[1] = KmtChar((BYTE)((Sum >> 6) & 0x3F));
+		Check[2] = KmtChar((BYTE)(Sum & 0x3F));
+		break;
 	}
 }
 
+/*
+ *	ubN`FbNvZ
+ *		type 1, 2 ͎ZpaAtype 3  CRC-16 (CCITT, LSB first, l 0)
+ */
+static void KmtCalcBlockCheck(const BYTE *Buf, int Len, BYTE CHKT, PCHAR Check)
+{
+	WORD Sum;
+	int i;
+
+	if (CHKT == 3)
+		Sum = UpdateCRC16RBlock(0, Buf, Len);
+	else {
+		Sum = 0;
+		for (i = 0 ; i < Len ; i++)
+			Sum = Sum + Buf[i];
+	}
+	KmtCalcCheck(Sum, CHKT, Check);
+}
+
 // a single-character type 1 checksum vZ
 static int KmtCheckSumType1(BYTE *buf, int len)
 {
@@ -327,32 +384,49 @@ static int KmtCheckSumType1(BYTE *buf, int len)
 	return (check);
 }
 
-static void KmtSendPacket(PFileVarProto fv, PKmtVar kv, PComVar cv)
+/*
+ *	Mobt@ Len oCg̃pPbg邩
+ *		pPbg̓rőMobt@ӂƉꂽpPbgɂȂ邽߁A
+ *		ȂƂ͑炸Ƀ^CAEgł̍đɂ܂
+ *		f[^̐䕶 QCTL  quote ̂ŁAtelnet Ŕ{ɂȂ̂ PADC  EOL 
+ */
+static BOOL KmtCanSend(PKmtVar kv, PComVar cv, int Len)
+{
+	return OutBuffSize - cv->OutBuffCount >= Len + (kv->KmtYour.NPAD + 1) * 2;
+}
+
+static void KmtSendPacketBuf(PFileVarProto fv, PKmtVar kv, PComVar cv, BYTE *Buf, int Len)
 {
 	int C;
 
-	/* padding characters */
-	for (C = 1 ; C <= kv->KmtYour.NPAD ; C++)
-		CommBinaryOut(cv,&(kv->KmtYour.PADC), 1);
+	if (KmtCanSend(kv, cv, Len)) {
+		/* padding characters */
+		for (C = 1 ; C <= kv->KmtYour.NPAD ; C++)
+			CommBinaryOut(cv,&(kv->KmtYour.PADC), 1);
 
-	/* packet */
-	C = kv->PktOutCount;
-	CommBinaryOut(cv,&kv->PktOut[0], C);
+		/* packet */
+		CommBinaryOut(cv,&Buf[0], Len);
 
-	if (kv->log != NULL) {
-		KmtWriteLog(fv, kv, &(kv->PktOut[0]), C);
-	}
+		if (kv->log != NULL) {
+			KmtWriteLog(fv, kv, &Buf[0], Len);
+		}
 
-	/* end-of-line character */
-	if (kv->KmtYour.EOL > 0)
-		CommBinaryOut(cv,&(kv->KmtYour.EOL), 1);
+		/* end-of-line character */
+		if (kv->KmtYour.EOL > 0)
+			CommBinaryOut(cv,&(kv->KmtYour.EOL), 1);
+	}
 
 	fv->FTSetTimeOut(fv,kv->KmtYour.TIME);
 }
 
+static void KmtSendPacket(PFileVarProto fv, PKmtVar kv, PComVar cv)
+{
+	KmtSendPacketBuf(fv, kv, cv, &kv->PktOut[0], kv->PktOutCount);
+}
+
 static void KmtMakePacket(PFileVarProto fv, PKmtVar kv, BYTE SeqNum, BYTE PktType, int DataLen)
 {
-	int i, nlen, headnum;
+	int nlen, headnum;
 	WORD Sum;
 
 	// SEQCHECK܂ł̒BMARKLEN͊܂܂ȂB
@@ -383,10 +457,7 @@ static void KmtMakePacket(PFileVarProto fv, PKmtVar kv, BYTE SeqNum, BYTE PktTyp
 	}
 
 	/* check sum */
-	Sum = 0;
-	for (i = 1 ; i <= DataLen + headnum ; i++)
-		Sum = Sum + kv->PktOut[i];
-	KmtCalcCheck(Sum, kv->KmtMy.CHKT, &(kv->PktOut[DataLen + headnum + 1]));
+	KmtCalcBlockCheck(&kv->PktOut[1], DataLen + headnum, kv->KmtMy.CHKT, &(kv->PktOut[DataLen + headnum + 1]));
 
 	/* obt@̑S̃TCY */
 	kv->PktOutCount = 1 + headnum + DataLen + kv->KmtMy.CHKT;
@@ -411,18 +482,27 @@ static void KmtSendInitPkt(PFileVarProto fv, PKmtVar kv, PComVar cv, BYTE PktTyp
 	kv->PktOut[8] = KmtChar(kv->KmtMy.EOL);
 	kv->PktOut[9] = kv->KmtMy.QCTL;
 	kv->PktOut[10] = kv->KmtMy.QBIN;
-	kv->PktOut[11] = kv->KmtMy.CHKT + 0x30;
+	kv->PktOut[11] = kv->ChkType + 0x30;
 	kv->PktOut[12] = kv->KmtMy.REPT;
 
 	if (kv->KmtMy.CAPAS > 0) {
 		kv->PktOut[13] = KmtChar(kv->KmtMy.CAPAS);
 		NParam++;
-		if (kv->KmtMy.CAPAS & KMT_CAP_LONGPKT) {
-			kv->PktOut[14] = KmtChar(0);
+		if ((kv->KmtMy.CAPAS & (KMT_CAP_LONGPKT | KMT_CAP_SLIDWIN)) || kv->KmtMy.WHATAMI != 0) {
+			kv->PktOut[14] = KmtChar((kv->KmtMy.CAPAS & KMT_CAP_SLIDWIN) ? kv->KmtMy.WINDO : 0);
 			kv->PktOut[15] = KmtChar(kv->KmtMy.MAXLX / 95);
 			kv->PktOut[16] = KmtChar(kv->KmtMy.MAXLX % 95);
 			NParam += 3;
 		}
+		if (kv->KmtMy.WHATAMI != 0) {
+			/* CHKPNT, CHKINT (`FbN|Cg͎gȂ), WHATAMI */
+			kv->PktOut[17] = '0';
+			kv->PktOut[18] = '_';
+			kv->PktOut[19] = '_';
+			kv->PktOut[20] = '_';
+			kv->PktOut[21] = KmtChar(kv->KmtMy.WHATAMI);
+			NParam += 5;
+		}
 	}
 
 	KmtMakePacket(fv,kv,(BYTE)(kv->PktNum - kv->PktNumOffset),PktType,NParam);
@@ -455,28 +535,27 @@ static BOOL KmtCheckPacket(PKmtVar kv)
 	int i, len;
 	WORD Sum;
 	BYTE Check[3];
+	BYTE CHKT;
+
+	/* Send-Init ͏ type 1 */
+	CHKT = (kv->PktIn[3] == 'S') ? DefCHKT : kv->KmtMy.CHKT;
 
 	/* Long Packet ̏ꍇA܂ HCHECK ؂B */
 	if (kv->PktInLen == 0) {
 		Sum = KmtCheckSumType1(&kv->PktIn[1], 5);
 		if ((BYTE)Sum != kv->PktIn[6])
 			return FALSE;
-		len = kv->PktInCount - 1 - kv->KmtMy.CHKT;
+		len = kv->PktInCount - 1 - CHKT;
 
 	} else {
-		len = kv->PktInLen+1-kv->KmtMy.CHKT;
+		len = kv->PktInLen+1-CHKT;
 
 	}
 
-	/* Calc sum */
-	Sum = 0;
-	for (i = 1 ; i <= len ; i++)
-		Sum = Sum + kv->PktIn[i];
-
 	/* Calc CHECK */
-	KmtCalcCheck(Sum, kv->KmtMy.CHKT, &Check[0]);
+	KmtCalcBlockCheck(&kv->PktIn[1], len, CHKT, &Check[0]);
 
-	for (i = 1 ; i <= kv->KmtMy.CHKT ; i++)
+	for (i = 1 ; i <= CHKT ; i++)
 		if (Check[i-1] !=
 			kv->PktIn[ len + i ])
 			return FALSE;
@@ -489,11 +568,44 @@ static BOOL KmtCheckQuote(BYTE b)
 		((b>0x5F) && (b<0x7f)));
 }
 
+/*
+ *	EBhETCYƃXg[~O߂
+ *		EBhETCY͑o CAPAS ŃXCfBOEBhEƂɏق
+ *		Xg[~O͑o WHATAMI ŎƂg
+ */
+static void KmtSetWindow(PKmtVar kv)
+{
+	kv->WinSize = 1;
+	if ((kv->KmtMy.CAPAS & KMT_CAP_SLIDWIN) &&
+	    (kv->KmtYour.CAPAS & KMT_CAP_SLIDWIN)) {
+		kv->WinSize = kv->KmtMy.WINDO;
+		if (kv->KmtYour.WINDO < kv->WinSize)
+			kv->WinSize = kv->KmtYour.WINDO;
+		if (kv->WinSize < 1)
+			kv->WinSize = 1;
+	}
+	kv->Streaming =
+		(kv->KmtMy.WHATAMI & (KMT_WMI_FLAG | KMT_WMI_STREAM)) == (KMT_WMI_FLAG | KMT_WMI_STREAM) &&
+		(kv->KmtYour.WHATAMI & (KMT_WMI_FLAG | KMT_WMI_STREAM)) == (KMT_WMI_FLAG | KMT_WMI_STREAM);
+
+	if (kv->WinSize > 1 && kv->Win == NULL) {
+		kv->Win = malloc(sizeof(KmtWinSlot) * KMT_WINSLOT);
+		if (kv->Win == NULL)
+			kv->WinSize = 1;
+	}
+	if (kv->Win != NULL) {
+		int i;
+		for (i = 0 ; i < KMT_WINSLOT ; i++)
+			kv->Win[i].Used = FALSE;
+	}
+}
+
 static void KmtParseInit(PKmtVar kv, BOOL AckFlag)
 {
-	int i, NParam, off;
+	int i, k, NParam, off;
 	int maxlen = 0;
 	BYTE b, n;
+	BYTE ChkReq = kv->ChkType;
 
 	if (kv->PktInLen == 0) {  /* Long Packet */
 		NParam = kv->PktInLongPacketLen - kv->KmtMy.CHKT;
@@ -504,11 +616,22 @@ static void KmtParseInit(PKmtVar kv, BOOL AckFlag)
 		off = HEADNUM;
 	}
 
+	kv->KmtYour.WINDO = 1;
+	kv->KmtYour.WHATAMI = 0;
+	kv->ChkType = DefCHKT;
+
+	/* k ̓p[^̔ԍ, CAPAS oCĝƂ i Ƃ */
+	k = 0;
 	for (i=1 ; i <= NParam ; i++)
 	{
 		b = kv->PktIn[i + off];
 		n = KmtNum(b);
-		switch (i) {
+		if (k == 10 && (KmtNum(kv->PktIn[i - 1 + off]) & 1)) {
+			/* CAPAS ̑ (ŉʃrbgĂƎ̃oCg CAPAS) */
+			continue;
+		}
+		k++;
+		switch (k) {
 		  case 1:
 			  if ((MinMAXL<=n) && (n<=MaxMAXL))
 				  kv->KmtYour.MAXL = n;
@@ -566,15 +689,15 @@ static void KmtParseInit(PKmtVar kv, BOOL AckFlag)
 			  kv->KmtYour.CHKT = b - 0x30;
 			  if (AckFlag)
 			  {
-				  if (kv->KmtYour.CHKT!=kv->KmtMy.CHKT)
+				  if (kv->KmtYour.CHKT!=ChkReq)
 					  kv->KmtYour.CHKT = DefCHKT;
 			  }
 			  else
 				  if ((kv->KmtYour.CHKT<1) ||
-					  (kv->KmtYour.CHKT>2))
+					  (kv->KmtYour.CHKT>3))
 					  kv->KmtYour.CHKT = DefCHKT;
 
-			  kv->KmtMy.CHKT = kv->KmtYour.CHKT;
+			  kv->ChkType = kv->KmtYour.CHKT;
 			  break;
 
 		  case 9:
@@ -600,7 +723,9 @@ static void KmtParseInit(PKmtVar kv, BOOL AckFlag)
 			  break;
 
 		  case 11:  /* WINDO */
-			  // TBD
+			  if (n > KMT_WINMAX)
+				  n = KMT_WINMAX;
+			  kv->KmtYour.WINDO = n;
 			  break;
 
 		  case 12:  /* LENX1 */
@@ -610,30 +735,46 @@ static void KmtParseInit(PKmtVar kv, BOOL AckFlag)
 		  case 13:  /* LENX2 */
 			  maxlen += n;
 			  break;
+
+		  case 18:  /* WHATAMI */
+			  kv->KmtYour.WHATAMI = n;
+			  break;
 		}
 	}
 
 	/* Long Packet ̏ꍇAMAXLX XVB*/
 	if (kv->KmtYour.CAPAS & KMT_CAP_LONGPKT) {
+		// LENX1, LENX2 ȗꂽƂ 500
+		if (maxlen == 0)
+			maxlen = 500;
 		kv->KmtYour.MAXLX = maxlen;
 
 		// ̑Mobt@TCY𒴂Ȃ
-		if (kv->KmtYour.MAXL > KMT_DATAMAX)
-			kv->KmtYour.MAXL = KMT_DATAMAX;
+		if (kv->KmtYour.MAXLX > KMT_DATAMAX)
+			kv->KmtYour.MAXLX = KMT_DATAMAX;
 	} else {
 		/* Capabilities Ă̂ɁALEN=0 ̏ꍇ́AMAXL  DefMAXL ̂܂܂ƂB
 		 * TODO: {̓G[ƂׂH
 		 */
 
 	}
+
+	/* Send-Init  ACK 󂯂ubN`FbNɐ؂ւ */
+	if (AckFlag)
+		kv->KmtMy.CHKT = kv->ChkType;
+
+	KmtSetWindow(kv);
 }
 
 static void KmtSendAck(PFileVarProto fv, PKmtVar kv, PComVar cv)
 {
 	if (kv->PktIn[3]=='S') /* Send-Init packet */
 	{
+		/* Send-Init Ƃ ACK  type 1 ŁAACK 𑗂ĂubN`FbNɐ؂ւ */
+		kv->KmtMy.CHKT = DefCHKT;
 		KmtParseInit(kv,FALSE);
 		KmtSendInitPkt(fv,kv,cv,'Y');
+		kv->KmtMy.CHKT = kv->ChkType;
 	}
 	else {
 		KmtMakePacket(fv,kv,KmtNum(kv->PktIn[2]),(BYTE)'Y',0);
@@ -646,6 +787,9 @@ static void KmtDecode(PFileVarProto fv, PKmtVar kv, PCHAR Buff, int *BuffLen)
 	int i, j, DataLen, BuffPtr, off;
 	BYTE b, b2;
 	BOOL CTLflag,BINflag,REPTflag,OutFlag;
+	BYTE FileBuff[512];
+	int FileBuffLen = 0;
+	TFileIO *fileio = fv->file;
 
 	BuffPtr = 0;
 
@@ -693,8 +837,11 @@ static void KmtDecode(PFileVarProto fv, PKmtVar kv, PCHAR Buff, int *BuffLen)
 			for (j = 1 ; j <= kv->RepeatCount ; j++)
 			{
 				if (Buff==NULL) { /* write to file */
-					TFileIO *fileio = fv->file;
-					fileio->WriteFile(fileio,&b,1);
+					FileBuff[FileBuffLen++] = b;
+					if (FileBuffLen == sizeof(FileBuff)) {
+						fileio->WriteFile(fileio,FileBuff,FileBuffLen);
+						FileBuffLen = 0;
+					}
 				} else /* write to buffer */
 					if (BuffPtr < *BuffLen)
 					{
@@ -711,6 +858,9 @@ static void KmtDecode(PFileVarProto fv, PKmtVar kv, PCHAR Buff, int *BuffLen)
 		}
 	}
 
+	if (FileBuffLen > 0)
+		fileio->WriteFile(fileio,FileBuff,FileBuffLen);
+
 	if (Buff==NULL)
 		fv->InfoOp->SetDlgByteCount(fv, kv->ByteCount);
 	*BuffLen = BuffPtr;
@@ -857,12 +1007,30 @@ static void KmtRecvFileAttr(PFileVarProto fv, PKmtVar kv, PCHAR Buff, int *BuffL
 
 }
 
+/*
+ *	t@C 1byte ǂ
+ *		FileBuf ɂ܂Ƃ߂ēǂݍł
+ */
+static int KmtReadFile1Byte(PFileVarProto fv, PKmtVar kv, BYTE *b)
+{
+	if (kv->FileBufPtr >= kv->FileBufLen) {
+		TFileIO *file = fv->file;
+		kv->FileBufPtr = 0;
+		kv->FileBufLen = (int)file->ReadFile(file, kv->FileBuf, sizeof(kv->FileBuf));
+		if (kv->FileBufLen <= 0) {
+			kv->FileBufLen = 0;
+			return 0;
+		}
+	}
+	*b = kv->FileBuf[kv->FileBufPtr++];
+	return 1;
+}
+
 static BOOL KmtEncode(PFileVarProto fv, PKmtVar kv)
 {
 	BYTE b, b2, b7;
 	int Len;
 	char TempStr[4];
-	TFileIO *file = fv->file;
 
 	if ((kv->RepeatCount>0) && (strlen(kv->ByteStr)>0))
 	{
@@ -875,7 +1043,7 @@ static BOOL KmtEncode(PFileVarProto fv, PKmtVar kv)
 		b = kv->NextByte;
 		kv->NextByteFlag = FALSE;
 	}
-	else if (file->ReadFile(file,&b,1)==0)
+	else if (KmtReadFile1Byte(fv,kv,&b)==0)
 		return FALSE;
 	else
 		kv->ByteCount++;
@@ -913,7 +1081,7 @@ static BOOL KmtEncode(PFileVarProto fv, PKmtVar kv)
 	TempStr[Len] = 0;
 
 	kv->RepeatCount = 1;
-	if (file->ReadFile(file,&(kv->NextByte),1)==1)
+	if (KmtReadFile1Byte(fv,kv,&(kv->NextByte))==1)
 	{
 		kv->ByteCount++;
 		kv->NextByteFlag = TRUE;
@@ -923,7 +1091,7 @@ static BOOL KmtEncode(PFileVarProto fv, PKmtVar kv)
 		(kv->NextByte==b) && (kv->RepeatCount<94))
 	{
 		kv->RepeatCount++;
-		if (file->ReadFile(file,&(kv->NextByte),1)==0)
+		if (KmtReadFile1Byte(fv,kv,&(kv->NextByte))==0)
 			kv->NextByteFlag = FALSE;
 		else
 			kv->ByteCount++;
@@ -968,6 +1136,21 @@ static void KmtSendEOFPacket(PFileVarProto fv, PKmtVar kv, PComVar cv)
 	kv->KmtState = SendEOF;
 }
 
+/* f[^pPbg̃f[^̍ő咷 */
+static int KmtDataMax(PKmtVar kv)
+{
+	// Long Packet
+	//   [g CAPAS LA Tera Term ̐ݒ肪L
+	if (kv->KmtYour.CAPAS & KMT_CAP_LONGPKT &&
+	    kv->KmtMy.CAPAS & KMT_CAP_LONGPKT) {
+		// CommBinaryOut() ̐ 16KB ŁAKMT_PKTMAX=9056 𒴂Ȃ
+		return kv->KmtYour.MAXLX - kv->KmtMy.CHKT - 7;
+
+	} else {
+		return kv->KmtYour.MAXL - kv->KmtMy.CHKT - 2;
+	}
+}
+
 static void KmtSendNextData(PFileVarProto fv, PKmtVar kv, PComVar cv)
 {
 	int DataLen, DataLenNew, maxlen;
@@ -979,16 +1162,7 @@ static void KmtSendNextData(PFileVarProto fv, PKmtVar kv, PComVar cv)
 	DataLen = 0;
 	DataLenNew = 0;
 
-	// Long Packet
-	//   [g CAPAS LA Tera Term ̐ݒ肪L
-	if (kv->KmtYour.CAPAS & KMT_CAP_LONGPKT &&
-	    kv->KmtMy.CAPAS & KMT_CAP_LONGPKT) {
-		// CommBinaryOut() ̐ 16KB ŁAKMT_PKTMAX=4032 𒴂Ȃ
-		maxlen = kv->KmtYour.MAXLX - kv->KmtMy.CHKT - 7;
-
-	} else {
-		maxlen = kv->KmtYour.MAXL - kv->KmtMy.CHKT - 2;
-	}
+	maxlen = KmtDataMax(kv);
 
 	NextFlag = KmtEncode(fv,kv);
 	if (NextFlag) DataLenNew = DataLen + strlen(kv->ByteStr);
@@ -1007,7 +1181,10 @@ static void KmtSendNextData(PFileVarProto fv, PKmtVar kv, PComVar cv)
 		fv->InfoOp->SetDlgByteCount(fv, kv->ByteCount);
 		fv->InfoOp->SetDlgPercent(fv, kv->ByteCount, kv->FileSize, &kv->ProgStat);
 		fv->InfoOp->SetDlgTime(fv, kv->StartTime, kv->ByteCount);
-		KmtSendEOFPacket(fv,kv,cv);
+		kv->DataEOF = TRUE;
+		// EBhEgp͑f[^pPbgׂĂ ACK ҂Ă EOF 𑗂
+		if (kv->Streaming || kv->WinSize <= 1 || kv->WinLow > kv->PktNum)
+			KmtSendEOFPacket(fv,kv,cv);
 	}
 	else {
 		KmtIncPacketNum(kv);
@@ -1015,10 +1192,128 @@ static void KmtSendNextData(PFileVarProto fv, PKmtVar kv, PComVar cv)
 		KmtMakePacket(fv,kv,(BYTE)(kv->PktNum-kv->PktNumOffset),(BYTE)'D',DataLen);
 		KmtSendPacket(fv,kv,cv);
 
+		if (kv->WinSize > 1 && ! kv->Streaming) {
+			/* đ̂߂ɕێ */
+			KmtWinSlot *slot = &kv->Win[kv->PktNum % KMT_WINSLOT];
+			memcpy(slot->Buf, kv->PktOut, kv->PktOutCount);
+			slot->Len = kv->PktOutCount;
+			slot->TxSeq = ++kv->TxSeq;
+			slot->Used = TRUE;
+		}
+
 		kv->KmtState = SendData;
 	}
 }
 
+/*
+ *	XCfBOEBhE/Xg[~Oł̑M
+ *		EBhE(Xg[~Oł͑Mobt@)ɋ󂫂ԁAf[^pPbg𑗂
+ */
+static void KmtFillWindow(PFileVarProto fv, PKmtVar kv, PComVar cv)
+{
+	if (kv->WinSize <= 1 && ! kv->Streaming)
+		return;
+
+	while ((kv->KmtState == SendData) && ! kv->DataEOF &&
+	       (kv->Streaming || (kv->PktNum - kv->WinLow + 1 < kv->WinSize)) &&
+	       KmtCanSend(kv, cv, KmtDataMax(kv) + 1 + LONGPKT_HEADNUM + kv->KmtMy.CHKT)) {
+		KmtSendNextData(fv,kv,cv);
+	}
+}
+
+/* f[^M̊Jn (F ܂ A pPbg ACK 󂯂Ƃ) */
+static void KmtSendFirstData(PFileVarProto fv, PKmtVar kv, PComVar cv)
+{
+	kv->WinLow = kv->PktNum + 1;
+	kv->DataEOF = FALSE;
+	KmtSendNextData(fv,kv,cv);
+	KmtFillWindow(fv,kv,cv);
+}
+
+/* EBhEi߂āA󂢂𑗂 */
+static void KmtWinSlide(PFileVarProto fv, PKmtVar kv, PComVar cv)
+{
+	while ((kv->WinLow <= kv->PktNum) && ! kv->Win[kv->WinLow % KMT_WINSLOT].Used)
+		kv->WinLow++;
+
+	if (kv->DataEOF) {
+		if (kv->WinLow > kv->PktNum)
+			KmtSendEOFPacket(fv,kv,cv);
+	}
+	else
+		KmtFillWindow(fv,kv,cv);
+}
+
+/* EBhẼpPbgđ */
+static void KmtWinResend(PFileVarProto fv, PKmtVar kv, PComVar cv, KmtWinSlot *slot)
+{
+	KmtSendPacketBuf(fv,kv,cv,slot->Buf,slot->Len);
+	slot->TxSeq = ++kv->TxSeq;
+}
+
+/*
+ *	EBhEgp ACK
+ *		ʐMHł̓pPbg̏Ԃ͓ւȂ̂ŁAACK ꂽpPbgOɑ
+ *		ACK ĂȂpPbg͎ĂBNAK ͂ȂĂđ
+ */
+static void KmtWinAck(PFileVarProto fv, PKmtVar kv, PComVar cv, int PktNumNew)
+{
+	KmtWinSlot *slot;
+	DWORD TxSeq;
+	int i;
+
+	if (kv->Streaming)
+		return;
+	if ((PktNumNew < kv->WinLow) || (PktNumNew > kv->PktNum))
+		return;
+	slot = &kv->Win[PktNumNew % KMT_WINSLOT];
+	if (! slot->Used)
+		return;
+	slot->Used = FALSE;
+	TxSeq = slot->TxSeq;
+	for (i = kv->WinLow ; i < PktNumNew ; i++) {
+		slot = &kv->Win[i % KMT_WINSLOT];
+		if (slot->Used && (slot->TxSeq < TxSeq))
+			KmtWinResend(fv,kv,cv,slot);
+	}
+	KmtWinSlide(fv,kv,cv);
+}
+
+/*
+ *	EBhEgp NAK
+ *		NAK ꂽpPbgđ
+ *		pPbg̎̔ԍւ NAK ́A܂ł̃pPbgׂē͂Ƃ
+ */
+static void KmtWinNak(PFileVarProto fv, PKmtVar kv, PComVar cv, int PktNumNew)
+{
+	if (PktNumNew == kv->PktNum + 1) {
+		for ( ; kv->WinLow <= kv->PktNum ; kv->WinLow++)
+			kv->Win[kv->WinLow % KMT_WINSLOT].Used = FALSE;
+		KmtWinSlide(fv,kv,cv);
+	}
+	else if ((PktNumNew >= kv->WinLow) && (PktNumNew <= kv->PktNum)) {
+		KmtWinSlot *slot = &kv->Win[PktNumNew % KMT_WINSLOT];
+		if (slot->Used)
+			KmtWinResend(fv,kv,cv,slot);
+	}
+}
+
+/* EBhEgp̃^CAEg: ACK ҂ĂłÂpPbgđ */
+static void KmtWinTimeOut(PFileVarProto fv, PKmtVar kv, PComVar cv)
+{
+	if (kv->Streaming) {
+		fv->FTSetTimeOut(fv,kv->KmtYour.TIME);
+		return;
+	}
+	if (kv->WinLow <= kv->PktNum) {
+		KmtWinResend(fv,kv,cv,&kv->Win[kv->WinLow % KMT_WINSLOT]);
+	}
+	else {
+		fv->FTSetTimeOut(fv,kv->KmtYour.TIME);
+		KmtFillWindow(fv,kv,cv);
+	}
+}
+
 static void KmtSendEOTPacket(PFileVarProto fv, PKmtVar kv, PComVar cv)
 {
 	KmtIncPacketNum(kv);
@@ -1092,6 +1387,8 @@ static BOOL KmtSendNextFile(PFileVarProto fv, PKmtVar kv, PComVar cv)
 
 	kv->RepeatCount = 0;
 	kv->NextByteFlag = FALSE;
+	kv->FileBufPtr = 0;
+	kv->FileBufLen = 0;
 	kv->KmtState = SendFile;
 	return TRUE;
 }
@@ -1206,6 +1503,7 @@ static BOOL KmtInit(PFileVarProto fv, PComVar cv, PTTSet ts)
 		kv->KmtMy.QBIN = MyQBIN;
 	kv->KmtMy.CHKT = DefCHKT;
 	kv->KmtMy.REPT = MyREPT;
+	kv->ChkType = DefCHKT;
 
 	/* CAPAS: a capability of Kermit
 	 * (2012/1/22 yutaka)
@@ -1214,6 +1512,8 @@ static BOOL KmtInit(PFileVarProto fv, PComVar cv, PTTSet ts)
 	if (ts->KermitOpt & KmtOptLongPacket) {
 		kv->KmtMy.CAPAS |= KMT_CAP_LONGPKT;
 		kv->KmtMy.MAXLX = KMT_DATAMAX;
+		// pPbgł 1 ̃`FbNTł͌₷
+		kv->ChkType = LongCHKT;
 	}
 	else {
 		// Tera Term LƒʒmĂȂĂ
@@ -1223,10 +1523,35 @@ static BOOL KmtInit(PFileVarProto fv, PComVar cv, PTTSet ts)
 	if (ts->KermitOpt & KmtOptFileAttr)
 		kv->KmtMy.CAPAS |= KMT_CAP_FILATTR;
 
+	/* XCfBOEBhE */
+	kv->KmtMy.WINDO = 1;
+	if (ts->KermitOpt & KmtOptSlideWin) {
+		kv->KmtMy.CAPAS |= KMT_CAP_SLIDWIN;
+		kv->KmtMy.WINDO = (BYTE)ts->KermitWinSize;
+		if (kv->KmtMy.WINDO < 1)
+			kv->KmtMy.WINDO = 1;
+		else if (kv->KmtMy.WINDO > KMT_WINMAX)
+			kv->KmtMy.WINDO = KMT_WINMAX;
+	}
+
+	/* Xg[~O
+	 *   ̂ȂʐMH (TCP/IP, OtpCv) łg
+	 *   Xg[~O̓f[^pPbg ACK/NAK Ȃ̂ōđłȂ
+	 */
+	kv->KmtMy.WHATAMI = 0;
+	if ((ts->KermitOpt & KmtOptStreaming) &&
+	    ((cv->PortType == IdTCPIP) || (cv->PortType == IdNamedPipe))) {
+		kv->KmtMy.WHATAMI = KMT_WMI_FLAG | KMT_WMI_STREAM;
+	}
+
 	/* default your parameters */
 	kv->KmtYour = kv->KmtMy;
 	kv->KmtYour.CAPAS = 0x00;
 	kv->KmtYour.MAXLX = 0;
+	kv->KmtYour.WINDO = 1;
+	kv->KmtYour.WHATAMI = 0;
+	kv->WinSize = 1;
+	kv->Streaming = FALSE;
 
 	kv->Quote8 = FALSE;
 	kv->RepeatFlag = FALSE;
@@ -1282,9 +1607,15 @@ static void KmtTimeOutProc(PFileVarProto fv, PComVar cv)
 	case SendFile:
 		KmtSendPacket(fv,kv,cv);
 		break;
-	case SendData:
+	case SendFileAttr:
 		KmtSendPacket(fv,kv,cv);
 		break;
+	case SendData:
+		if (kv->WinSize > 1 || kv->Streaming)
+			KmtWinTimeOut(fv,kv,cv);
+		else
+			KmtSendPacket(fv,kv,cv);
+		break;
 	case SendEOF:
 		KmtSendPacket(fv,kv,cv);
 		break;
@@ -1298,7 +1629,10 @@ static void KmtTimeOutProc(PFileVarProto fv, PComVar cv)
 		KmtSendNack(fv,kv,cv,kv->NextSeq);
 		break;
 	case ReceiveData:
-		KmtSendNack(fv,kv,cv,kv->NextSeq);
+		if (kv->Streaming)
+			fv->FTSetTimeOut(fv,kv->KmtYour.TIME);
+		else
+			KmtSendNack(fv,kv,cv,kv->NextSeq);
 		break;
 	case ServerInit:
 		KmtSendPacket(fv,kv,cv);
@@ -1337,6 +1671,123 @@ static BOOL FTCreateFile(PFileVarProto fv)
 	return TRUE;
 }
 
+/*
+ *	pPbg̎cMobt@܂Ƃ߂ PktIn փRs[
+ *		MARK(SOH)  telnet ̏KvȃoCg(IAC, CR) ̎OŎ~܂A
+ *		 CommRead1Byte() 1byte
+ */
+static void KmtReadRun(PKmtVar kv, PComVar cv)
+{
+	const BYTE *start, *p, *end;
+	BOOL tel_iac, tel_cr;
+	int len;
+	int i;
+
+	if (!cv->Ready || (cv->InBuffCount <= 0) || cv->TelMode || cv->IACFlag || cv->TelCRFlag) {
+		return;
+	}
+	tel_iac = (cv->PortType == IdTCPIP) && (cv->TelFlag || cv->TelAutoDetect);
+	tel_cr = cv->TelFlag && !cv->TelBinRecv;
+
+	start = p = &cv->InBuff[cv->InPtr];
+	end = p + cv->InBuffCount;
+	if (end - p > kv->PktInCount - kv->PktInPtr) {
+		end = p + (kv->PktInCount - kv->PktInPtr);
+	}
+	while (p < end) {
+		BYTE b = *p;
+		if ((b == 1) || (tel_iac && (b == 0xFF)) || (tel_cr && (b == 0x0D))) {
+			break;
+		}
+		p++;
+	}
+
+	len = (int)(p - start);
+	if (len == 0) {
+		return;
+	}
+	memcpy(&kv->PktIn[kv->PktInPtr], start, len);
+	kv->PktInPtr += len;
+	cv->InPtr += len;
+	cv->InBuffCount -= len;
+	if (cv->InBuffCount == 0) {
+		cv->InPtr = 0;
+	}
+	if (cv->Log1Bin != NULL) {
+		for (i = 0; i < len; i++) {
+			cv->Log1Bin(start[i]);
+		}
+	}
+}
+
+static void KmtSendErrorPacket(PFileVarProto fv, PKmtVar kv, PComVar cv, const char *msg)
+{
+	KmtIncPacketNum(kv);
+	strncpy_s(&(kv->PktOut[4]),sizeof(kv->PktOut)-4,msg,_TRUNCATE);
+	KmtMakePacket(fv,kv,(BYTE)(kv->PktNum-kv->PktNumOffset),(BYTE)'E',
+		strlen(&(kv->PktOut[4])));
+	KmtSendPacket(fv,kv,cv);
+}
+
+/*
+ *	EBhEgp̃f[^pPbg̎M
+ *		EBhẼpPbg͏ԂOサĂێ ACK AĂpPbg NAK 
+ *		kv->PktNum ̓t@Cɏ񂾍Ō̃pPbgԍ
+ */
+static void KmtRecvWinData(PFileVarProto fv, PKmtVar kv, PComVar cv, int PktNumNew)
+{
+	KmtWinSlot *slot;
+	int i, Len;
+
+	if (PktNumNew <= kv->PktNum) {
+		/* ݍς, ACK ͂Ȃ */
+		KmtSendAck(fv,kv,cv);
+		return;
+	}
+	if (PktNumNew > kv->PktNum + kv->WinSize) {
+		/* EBhE̊O */
+		return;
+	}
+
+	KmtSendAck(fv,kv,cv);
+
+	/* ĂpPbg NAK  (ꂼŏɔ킩Ƃ 1 ) */
+	if (kv->WinHigh < kv->PktNum)
+		kv->WinHigh = kv->PktNum;
+	for (i = kv->WinHigh + 1 ; i < PktNumNew ; i++)
+		KmtSendNack(fv,kv,cv,KmtChar((BYTE)(i % 64)));
+	if (PktNumNew > kv->WinHigh)
+		kv->WinHigh = PktNumNew;
+
+	if (PktNumNew != kv->PktNum + 1) {
+		slot = &kv->Win[PktNumNew % KMT_WINSLOT];
+		if (! slot->Used) {
+			memcpy(slot->Buf, kv->PktIn, kv->PktInCount);
+			slot->Len = kv->PktInLen;
+			slot->LongLen = kv->PktInLongPacketLen;
+			slot->Count = kv->PktInCount;
+			slot->Used = TRUE;
+		}
+		return;
+	}
+
+	/* ԂǂɃt@Cɏ */
+	for (;;) {
+		KmtDecode(fv,kv,NULL,&Len);
+		KmtIncPacketNum(kv);
+
+		slot = &kv->Win[(kv->PktNum + 1) % KMT_WINSLOT];
+		if (! slot->Used)
+			break;
+		memcpy(kv->PktIn, slot->Buf, slot->Count);
+		kv->PktInLen = slot->Len;
+		kv->PktInLongPacketLen = slot->LongLen;
+		kv->PktInCount = slot->Count;
+		slot->Used = FALSE;
+	}
+	kv->NextSeq = KmtChar((BYTE)((kv->PktNum + 1) % 64));
+}
+
 static BOOL KmtReadPacket(PFileVarProto fv,  PComVar cv)
 {
 	BYTE b;
@@ -1411,6 +1862,11 @@ static BOOL KmtReadPacket(PFileVarProto fv,  PComVar cv)
 					}
 				}
 
+				// c͎Mobt@܂Ƃ߂Ďo
+				if (kv->PktInCount != 0 && kv->PktInPtr < kv->PktInCount) {
+					KmtReadRun(kv, cv);
+				}
+
 				// ҂obt@TCYɂȂIB
 				if (kv->PktInCount != 0 && kv->PktInPtr >= kv->PktInCount) {
 					GetPkt = TRUE;
@@ -1426,6 +1882,8 @@ static BOOL KmtReadPacket(PFileVarProto fv,  PComVar cv)
 read_end:
 	if (! GetPkt) return TRUE;
 
+	kv->PktInTotal++;
+
 	if (kv->log != NULL)
 	{
 		KmtReadLog(fv, kv, &(kv->PktIn[0]), kv->PktInCount);
@@ -1439,8 +1897,24 @@ read_end:
 	if ((kv->PktIn[3]!='Y') &&
 		(kv->PktIn[3]!='N'))
 	{
-		if (GetPkt) KmtSendAck(fv,kv,cv);
-		else KmtSendNack(fv,kv,cv,kv->PktIn[2]);
+		if (kv->KmtState == ReceiveData && kv->Streaming) {
+			/* Xg[~O̓f[^pPbg ACK Ȃ, ͉񕜂łȂ */
+			if (! GetPkt) {
+				KmtSendErrorPacket(fv,kv,cv,"Transmission error while streaming");
+				return FALSE;
+			}
+			if (kv->PktIn[3]!='D') KmtSendAck(fv,kv,cv);
+		}
+		else if (kv->KmtState == ReceiveData && kv->WinSize > 1) {
+			/* f[^pPbg KmtRecvWinData()  ACK 
+			 * ꂽpPbg SEQ ͓ĂɂȂȂ̂ŎɕKvȃpPbg NAK  */
+			if (! GetPkt) KmtSendNack(fv,kv,cv,kv->NextSeq);
+			else if (kv->PktIn[3]!='D') KmtSendAck(fv,kv,cv);
+		}
+		else {
+			if (GetPkt) KmtSendAck(fv,kv,cv);
+			else KmtSendNack(fv,kv,cv,kv->PktIn[2]);
+		}
 	}
 
 	if (! GetPkt) return TRUE;
@@ -1454,8 +1928,22 @@ read_end:
 		}
 		break;
 	case 'D':
-		if ((kv->KmtState == ReceiveData) &&
-			(PktNumNew > kv->PktNum))
+		if (kv->KmtState != ReceiveData)
+			break;
+		if (kv->Streaming) {
+			if (PktNumNew == kv->PktNum + 1)
+				KmtDecode(fv,kv,NULL,&Len);
+			else if (PktNumNew > kv->PktNum) {
+				KmtSendErrorPacket(fv,kv,cv,"Packet lost while streaming");
+				return FALSE;
+			}
+		}
+		else if (kv->WinSize > 1) {
+			KmtRecvWinData(fv,kv,cv,PktNumNew);
+			fv->InfoOp->SetDlgPacketNum(fv, kv->PktNum);
+			return TRUE;
+		}
+		else if (PktNumNew > kv->PktNum)
 			KmtDecode(fv,kv,NULL,&Len);
 		break;
 	case 'E': return FALSE;
@@ -1509,14 +1997,29 @@ read_end:
 				KmtSendPacket(fv,kv,cv);
 			else if (PktNumNew==kv->PktNum+1) {
 				if (kv->KmtYour.CAPAS & KMT_CAP_FILATTR)
-					KmtSendNextData(fv,kv,cv);
+					KmtSendFirstData(fv,kv,cv);
 				else
-					KmtSendNextData(fv,kv,cv);
+					KmtSendFirstData(fv,kv,cv);
 			}
 			break;
-		case SendData:
+		case SendFileAttr:
 			if (PktNumNew==kv->PktNum)
 				KmtSendPacket(fv,kv,cv);
+			else if (PktNumNew==kv->PktNum+1)
+				KmtSendFirstData(fv,kv,cv);
+			break;
+		case SendData:
+			if (kv->Streaming) {
+				/* M^CAEgȂ疳 */
+				if (PktNumNew!=kv->PktNum+1) {
+					KmtSendErrorPacket(fv,kv,cv,"NAK received while streaming");
+					return FALSE;
+				}
+			}
+			else if (kv->WinSize > 1)
+				KmtWinNak(fv,kv,cv,PktNumNew);
+			else if (PktNumNew==kv->PktNum)
+				KmtSendPacket(fv,kv,cv);
 			else if (PktNumNew==kv->PktNum+1)
 				KmtSendNextData(fv,kv,cv);
 			break;
@@ -1563,16 +2066,18 @@ read_end:
 				if (kv->KmtYour.CAPAS & KMT_CAP_FILATTR)
 					KmtSendNextFileAttr(fv,kv,cv);
 				else
-					KmtSendNextData(fv,kv,cv);
+					KmtSendFirstData(fv,kv,cv);
 			}
 			break;
 		case SendFileAttr:
 			if (PktNumNew==kv->PktNum) {
-				KmtSendNextData(fv,kv,cv);
+				KmtSendFirstData(fv,kv,cv);
 			}
 			break;
 		case SendData:
-			if (PktNumNew==kv->PktNum)
+			if (kv->WinSize > 1 || kv->Streaming)
+				KmtWinAck(fv,kv,cv,PktNumNew);
+			else if (PktNumNew==kv->PktNum)
 				KmtSendNextData(fv,kv,cv);
 			else if (PktNumNew+1==kv->PktNum)
 				KmtSendPacket(fv,kv,cv);
@@ -1648,14 +2153,29 @@ read_end:
 	return TRUE;
 }
 
+/*
+ *	Mς݂̃pPbgׂď
+ *		EBhEgp ACK ܂Ƃ߂ē͂
+ */
+static BOOL KmtParse(PFileVarProto fv, PComVar cv)
+{
+	PKmtVar kv = fv->data;
+	DWORD n;
+
+	do {
+		n = kv->PktInTotal;
+		if (! KmtReadPacket(fv, cv))
+			return FALSE;
+	} while (n != kv->PktInTotal);
+
+	KmtFillWindow(fv, kv, cv);
+	return TRUE;
+}
+
 static void KmtCancel(PFileVarProto fv, PComVar cv)
 {
 	PKmtVar kv = fv->data;
-	KmtIncPacketNum(kv);
-	strncpy_s(&(kv->PktOut[4]),sizeof(kv->PktOut)-4,"Cancel",_TRUNCATE);
-	KmtMakePacket(fv,kv,(BYTE)(kv->PktNum-kv->PktNumOffset),(BYTE)'E',
-		strlen(&(kv->PktOut[4])));
-	KmtSendPacket(fv,kv,cv);
+	KmtSendErrorPacket(fv,kv,cv,"Cancel");
 }
 
 static int SetOptV(PFileVarProto fv, int request, va_list ap)
@@ -1681,13 +2201,15 @@ static void Destroy(PFileVarProto fv)
 	}
 	free((void *)kv->FullName);
 	kv->FullName = NULL;
+	free(kv->Win);
+	kv->Win = NULL;
 	free(kv);
 	fv->data = NULL;
 }
 
 static const TProtoOp Op = {
 	KmtInit,
-	KmtReadPacket,
+	KmtParse,
 	KmtTimeOutProc,
 	KmtCancel,
 	SetOptV,
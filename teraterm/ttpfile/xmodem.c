@@ -208,10 +208,7 @@ static WORD XCalcCheck(PXVar xv, const BYTE *PktBuf)
 			Check = Check + (BYTE) (PktBuf[3 + i]);
 		return (Check & 0xff);
 	} else {					/* CRC */
-		Check = 0;
-		for (i = 0; i <= xv->DataLen - 1; i++)
-			Check = UpdateCRC(PktBuf[3 + i], Check);
-		return (Check);
+		return UpdateCRC16Block(0, &PktBuf[3], xv->DataLen);
 	}
 }
 
@@ -242,7 +239,7 @@ static BOOL XInit(PFileVarProto fv, PComVar cv, PTTSet ts)
 
 	xv->FullName = fv->GetNextFname(fv);
 	if (xv->XMode == IdXSend) {
-		size_t size;
+		unsigned long long size;
 		xv->FileOpen = file->OpenRead(file, xv->FullName);
 		if (xv->FileOpen == FALSE) {
 			return FALSE;
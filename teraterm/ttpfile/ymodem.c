@@ -275,10 +275,7 @@ static WORD YCalcCheck(PYVar yv, const PCHAR PktBuf, const WORD len)
 	else
 	{
 		// CRC.
-		Check = 0;
-		for (i = 0 ; i <= len - 1 ; i++)
-			Check = UpdateCRC(PktBuf[3 + i],Check);
-		return (Check);
+		return UpdateCRC16Block(0, &PktBuf[3], len);
 	}
 }
 
@@ -53,11 +53,15 @@
 
 #include "zmodem.h"
 
+/* f[^TupPbg̍ő咷 (ZedZap  8KB ܂) */
+#define ZMODEM_MAX_DATALEN 8192
+
 /* ZMODEM */
 typedef struct {
 	BYTE RxHdr[4], TxHdr[4];
 	BYTE RxType, TERM;
-	BYTE PktIn[1032], PktOut[1032];
+	BYTE PktIn[ZMODEM_MAX_DATALEN + 16];
+	BYTE PktOut[ZMODEM_MAX_DATALEN * 2 + 32];	// SoCgGXP[vĂ傫
 	int PktInPtr, PktOutPtr;
 	int PktInCount, PktOutCount;
 	int PktInLen;
@@ -66,9 +70,15 @@ typedef struct {
 	int ZMode, ZState, ZPktState;
 	int MaxDataLen, TimeOut, CanCount;
 	BOOL CtlEsc, CRC32, HexLo, Quoted, CRRecv;
+	BOOL TxCRC32;		// M CRC-32 g (M CANFC32)
 	WORD CRC;
-	LONG CRC3, Pos, LastPos, WinSize;
+	DWORD CRC3;
+	LONGLONG Pos;
+	LONGLONG LastPos;	// M ZACK ŎMς݂ƒʒmꂽʒu
+	LONGLONG LastQPos;	// Ō ZCRCQ  ZACK vʒu
+	LONG WinSize;
 	BYTE LastSent;
+	BYTE EscTable[256];	// ZDLE ŃGXP[voCg
 	int TOutInit;
 	int TOutFin;
 	TProtoLog *log;
@@ -76,8 +86,8 @@ typedef struct {
 	WORD LogState;
 
 	BOOL FileOpen;
-	LONG FileSize;
-	LONG ByteCount;
+	LONGLONG FileSize;
+	LONGLONG ByteCount;
 
 	int ProgStat;
 
@@ -359,7 +369,7 @@ static void ZShHdr(PZVar zv, BYTE HdrType)
 #endif
 }
 
-static void ZPutBin(PZVar zv, int *i, BYTE b)
+static void ZMakeEscTable(PZVar zv)
 /*
  * lrzsz ł ZDLE(CAN), DLE, XON, XOFF, @ ̒ CR, т
  * MSB GXP[vΏۂƂȂĂB
@@ -372,60 +382,126 @@ static void ZPutBin(PZVar zv, int *i, BYTE b)
  * telnet: GS GXP[v
  */
 {
-	switch (b) {
-	case 0x0D: // CR
-	case 0x8D: // CR | 0x80
-		/* if (zv->CtlEsc ||
-		   ((zv->LastSent & 0x7f) == '@')) */
-//  {
-		zv->PktOut[*i] = ZDLE;
-		(*i)++;
-		b = b ^ 0x40;
-//  }
-		break;
-	case 0x0A: // LF
-	case 0x10: // DLE
-	case 0x11: // XON
-	case 0x13: // XOFF
-	case 0x1d: // GS
-	case ZDLE: // CAN(0x18)
-	case 0x8A: // LF | 0x80
-	case 0x90: // DLE | 0x80
-	case 0x91: // XON | 0x80
-	case 0x93: // XOFF | 0x80
-	case 0x9d: // GS | 0x80
+	static const BYTE esc[] = {
+		0x0D, // CR
+		0x8D, // CR | 0x80
+		0x0A, // LF
+		0x10, // DLE
+		0x11, // XON
+		0x13, // XOFF
+		0x1d, // GS
+		ZDLE, // CAN(0x18)
+		0x8A, // LF | 0x80
+		0x90, // DLE | 0x80
+		0x91, // XON | 0x80
+		0x93, // XOFF | 0x80
+		0x9d, // GS | 0x80
+	};
+	int i;
+
+	for (i = 0; i < 256; i++) {
+		zv->EscTable[i] = zv->CtlEsc && ((i & 0x60) == 0);
+	}
+	for (i = 0; i < (int)sizeof(esc); i++) {
+		zv->EscTable[esc[i]] = TRUE;
+	}
+}
+
+static void ZPutBin(PZVar zv, int *i, BYTE b)
+{
+	if (zv->EscTable[b]) {
 		zv->PktOut[*i] = ZDLE;
 		(*i)++;
 		b = b ^ 0x40;
-		break;
-	default:
-		if (zv->CtlEsc && ((b & 0x60) == 0)) {
-			zv->PktOut[*i] = ZDLE;
-			(*i)++;
-			b = b ^ 0x40;
-		}
 	}
 	zv->LastSent = b;
 	zv->PktOut[*i] = b;
 	(*i)++;
 }
 
+/*
+ *	buf ܂Ƃ߂ăGXP[v PktOut ɒǉ
+ *	GXP[vȂ memcpy() ŃRs[
+ */
+static void ZPutBinBlock(PZVar zv, int *i, const BYTE *buf, int len)
+{
+	const BYTE *esc = zv->EscTable;
+	const BYTE *end = buf + len;
+	BYTE *out = &zv->PktOut[*i];
+
+	while (buf < end) {
+		const BYTE *run = buf;
+		while (buf < end && !esc[*buf]) {
+			buf++;
+		}
+		if (buf > run) {
+			memcpy(out, run, buf - run);
+			out += buf - run;
+		}
+		if (buf < end) {
+			*out++ = ZDLE;
+			*out++ = *buf++ ^ 0x40;
+		}
+	}
+	if (len > 0) {
+		zv->LastSent = out[-1];
+	}
+	*i = (int)(out - zv->PktOut);
+}
+
+/*
+ *	f[^TupPbg̏I[(ZDLE + frameend) CRC  PktOut ɒǉ
+ *	CRC  data  frameend vZ
+ *	crc32 ͒Oɑwb_ɍ킹 (ZBIN32 ̂Ƃ TRUE)
+ */
+static void ZPutDataEnd(PZVar zv, BYTE term, const BYTE *data, int len, BOOL crc32)
+{
+	int i;
+
+	zv->PktOut[zv->PktOutCount] = ZDLE;
+	zv->PktOutCount++;
+	zv->PktOut[zv->PktOutCount] = term;
+	zv->PktOutCount++;
+
+	if (crc32) {
+		DWORD crc = UpdateCRC32Block(0xFFFFFFFF, data, len);
+		crc = ~UpdateCRC32Block(crc, &term, 1);
+		for (i = 0; i <= 3; i++) {
+			ZPutBin(zv, &(zv->PktOutCount), (BYTE)crc);
+			crc >>= 8;
+		}
+	} else {
+		zv->CRC = UpdateCRC16Block(0, data, len);
+		zv->CRC = UpdateCRC(term, zv->CRC);
+		ZPutBin(zv, &(zv->PktOutCount), HIBYTE(zv->CRC));
+		ZPutBin(zv, &(zv->PktOutCount), LOBYTE(zv->CRC));
+	}
+}
+
 static void ZSbHdr(PZVar zv, BYTE HdrType)
 {
+	BYTE hdr[5];
 	int i;
 
+	hdr[0] = HdrType;
+	memcpy(&hdr[1], zv->TxHdr, 4);
+
 	zv->PktOut[0] = ZPAD;
 	zv->PktOut[1] = ZDLE;
-	zv->PktOut[2] = ZBIN;
+	zv->PktOut[2] = zv->TxCRC32 ? ZBIN32 : ZBIN;
 	zv->PktOutCount = 3;
-	ZPutBin(zv, &(zv->PktOutCount), HdrType);
-	zv->CRC = UpdateCRC(HdrType, 0);
-	for (i = 0; i <= 3; i++) {
-		ZPutBin(zv, &(zv->PktOutCount), zv->TxHdr[i]);
-		zv->CRC = UpdateCRC(zv->TxHdr[i], zv->CRC);
+	ZPutBinBlock(zv, &(zv->PktOutCount), hdr, sizeof(hdr));
+	if (zv->TxCRC32) {
+		DWORD crc = ~UpdateCRC32Block(0xFFFFFFFF, hdr, sizeof(hdr));
+		for (i = 0; i <= 3; i++) {
+			ZPutBin(zv, &(zv->PktOutCount), (BYTE)crc);
+			crc >>= 8;
+		}
+	} else {
+		zv->CRC = UpdateCRC16Block(0, hdr, sizeof(hdr));
+		ZPutBin(zv, &(zv->PktOutCount), HIBYTE(zv->CRC));
+		ZPutBin(zv, &(zv->PktOutCount), LOBYTE(zv->CRC));
 	}
-	ZPutBin(zv, &(zv->PktOutCount), HIBYTE(zv->CRC));
-	ZPutBin(zv, &(zv->PktOutCount), LOBYTE(zv->CRC));
 
 	zv->PktOutPtr = 0;
 	zv->Sending = TRUE;
@@ -433,18 +509,20 @@ static void ZSbHdr(PZVar zv, BYTE HdrType)
 	add_sendbuf("%s: %s ", __FUNCTION__, hdrtype_name(HdrType));
 }
 
-static void ZStoHdr(PZVar zv, LONG Pos)
+static void ZStoHdr(PZVar zv, LONGLONG Pos)
 {
-	zv->TxHdr[ZP0] = LOBYTE(LOWORD(Pos));
-	zv->TxHdr[ZP1] = HIBYTE(LOWORD(Pos));
-	zv->TxHdr[ZP2] = LOBYTE(HIWORD(Pos));
-	zv->TxHdr[ZP3] = HIBYTE(HIWORD(Pos));
+	DWORD L = (DWORD)Pos;	// wb_ɂ͉32bit
+
+	zv->TxHdr[ZP0] = LOBYTE(LOWORD(L));
+	zv->TxHdr[ZP1] = HIBYTE(LOWORD(L));
+	zv->TxHdr[ZP2] = LOBYTE(HIWORD(L));
+	zv->TxHdr[ZP3] = HIBYTE(HIWORD(L));
 }
 
 
-static LONG ZRclHdr(PZVar zv)
+static DWORD ZRclHdr(PZVar zv)
 {
-	LONG L;
+	DWORD L;
 
 	L = (BYTE) (zv->RxHdr[ZP3]);
 	L = (L << 8) + (BYTE) (zv->RxHdr[ZP2]);
@@ -452,11 +530,29 @@ static LONG ZRclHdr(PZVar zv)
 	return ((L << 8) + (BYTE) (zv->RxHdr[ZP0]));
 }
 
+/*
+ *	wb_̈ʒu(32bit)t@Cʒu(64bit)ɖ߂
+ *	4GBȏ̃t@Cł͏bitĂ̂ŁAbase ɍł߂ʒuƂ
+ */
+static LONGLONG ZRclHdrPos(PZVar zv, LONGLONG base)
+{
+	LONGLONG pos = (base & ~(LONGLONG)0xFFFFFFFF) | ZRclHdr(zv);
+
+	if (pos - base > (LONGLONG)0x80000000) {
+		if (pos >= 0x100000000LL)
+			pos -= 0x100000000LL;
+	}
+	else if (base - pos > (LONGLONG)0x80000000) {
+		pos += 0x100000000LL;
+	}
+	return pos;
+}
+
 static void ZSendRInit(PFileVarProto fv, PZVar zv)
 {
 	zv->Pos = 0;
 	ZStoHdr(zv, 0);
-	zv->TxHdr[ZF0] = /* CANFC32 | */ CANFDX | CANOVIO;
+	zv->TxHdr[ZF0] = CANFC32 | CANFDX | CANOVIO;
 	if (zv->CtlEsc)
 		zv->TxHdr[ZF0] = zv->TxHdr[ZF0] | ESCCTL;
 	ZShHdr(zv, ZRINIT);
@@ -529,19 +625,12 @@ static void ZSendInitHdr(PZVar zv)
 
 static void ZSendInitDat(PZVar zv)
 {
-	zv->CRC = 0;
-	zv->PktOutCount = 0;
-	ZPutBin(zv, &(zv->PktOutCount), 0);
-	zv->CRC = UpdateCRC(0, zv->CRC);
+	static const BYTE attn[1] = { 0 };
 
-	zv->PktOut[zv->PktOutCount] = ZDLE;
-	zv->PktOutCount++;
-	zv->PktOut[zv->PktOutCount] = ZCRCW;
-	zv->PktOutCount++;
-	zv->CRC = UpdateCRC(ZCRCW, zv->CRC);
-
-	ZPutBin(zv, &(zv->PktOutCount), HIBYTE(zv->CRC));
-	ZPutBin(zv, &(zv->PktOutCount), LOBYTE(zv->CRC));
+	zv->PktOutCount = 0;
+	ZPutBinBlock(zv, &(zv->PktOutCount), attn, sizeof(attn));
+	/* ZSINIT  hex wb_Ȃ̂ CRC-16 */
+	ZPutDataEnd(zv, ZCRCW, attn, sizeof(attn), FALSE);
 
 	zv->PktOutPtr = 0;
 	zv->Sending = TRUE;
@@ -563,9 +652,10 @@ static void ZSendFileHdr(PZVar zv)
 
 static void ZSendFileDat(PFileVarProto fv, PZVar zv)
 {
-	int i, j;
 	TFileIO *file = fv->file;
 	char *filename;
+	char buf[1024];
+	int len;
 
 	if (!zv->FileOpen) {
 		ZSendCancel(zv);
@@ -575,13 +665,8 @@ static void ZSendFileDat(PFileVarProto fv, PZVar zv)
 
 	/* file name */
 	filename = file->GetSendFilename(file, zv->FullName, FALSE, TRUE, FALSE);
-	strncpy_s(zv->PktOut, sizeof(zv->PktOut), filename, _TRUNCATE);
-	zv->PktOutCount = strlen(zv->PktOut);
-	zv->CRC = 0;
-	for (i = 0; i <= zv->PktOutCount - 1; i++)
-		zv->CRC = UpdateCRC(zv->PktOut[i], zv->CRC);
-	ZPutBin(zv, &(zv->PktOutCount), 0);
-	zv->CRC = UpdateCRC(0, zv->CRC);
+	strncpy_s(buf, sizeof(buf) - 64, filename, _TRUNCATE);	//  64byte ̓t@CTCYȂǗp
+	len = (int)strlen(buf) + 1;
 	/* file size */
 	zv->FileSize = file->GetFSize(file, zv->FullName);
 
@@ -589,26 +674,14 @@ static void ZSendFileDat(PFileVarProto fv, PZVar zv)
 	zv->FileMtime = file->GetFMtime(file, zv->FullName);
 
 	// t@C̃^CX^vƃp[~bV悤ɂB(2007.12.20 maya, yutaka)
-	_snprintf_s(&(zv->PktOut[zv->PktOutCount]),
-				sizeof(zv->PktOut) - zv->PktOutCount, _TRUNCATE,
-				"%lu %lo %o", zv->FileSize, zv->FileMtime,
+	_snprintf_s(&buf[len], sizeof(buf) - len, _TRUNCATE,
+				"%llu %lo %o", (unsigned long long)zv->FileSize, zv->FileMtime,
 				0644 | _S_IFREG);
-	j = strlen(&(zv->PktOut[zv->PktOutCount])) - 1;
-	for (i = 0; i <= j; i++) {
-		zv->CRC = UpdateCRC(zv->PktOut[zv->PktOutCount], zv->CRC);
-		zv->PktOutCount++;
-	}
+	len += (int)strlen(&buf[len]) + 1;
 
-	ZPutBin(zv, &(zv->PktOutCount), 0);
-	zv->CRC = UpdateCRC(0, zv->CRC);
-	zv->PktOut[zv->PktOutCount] = ZDLE;
-	zv->PktOutCount++;
-	zv->PktOut[zv->PktOutCount] = ZCRCW;
-	zv->PktOutCount++;
-	zv->CRC = UpdateCRC(ZCRCW, zv->CRC);
-
-	ZPutBin(zv, &(zv->PktOutCount), HIBYTE(zv->CRC));
-	ZPutBin(zv, &(zv->PktOutCount), LOBYTE(zv->CRC));
+	zv->PktOutCount = 0;
+	ZPutBinBlock(zv, &(zv->PktOutCount), (BYTE *)buf, len);
+	ZPutDataEnd(zv, ZCRCW, (BYTE *)buf, len, zv->TxCRC32);
 
 	zv->PktOutPtr = 0;
 	zv->Sending = TRUE;
@@ -621,10 +694,10 @@ static void ZSendFileDat(PFileVarProto fv, PZVar zv)
 	fv->InfoOp->SetDlgPercent(fv, zv->ByteCount, zv->FileSize, &zv->ProgStat);
 	fv->InfoOp->SetDlgTime(fv, zv->StartTime, zv->ByteCount);
 
-	add_sendbuf("%s: ZFILE: ZF0=%x ZF1=%x ZF2=%x file=%s size=%lu",
+	add_sendbuf("%s: ZFILE: ZF0=%x ZF1=%x ZF2=%x file=%s size=%llu",
 		__FUNCTION__,
 		zv->TxHdr[ZF0], zv->TxHdr[ZF1],zv->TxHdr[ZF2],
-		filename, zv->FileSize);
+		filename, (unsigned long long)zv->FileSize);
 	free(filename);
 }
 
@@ -639,6 +712,7 @@ static void ZSendDataDat(PFileVarProto fv, PZVar zv)
 {
 	int c;
 	BYTE b;
+	BYTE buf[ZMODEM_MAX_DATALEN];
 	TFileIO *file = fv->file;
 
 	if (zv->Pos >= zv->FileSize) {
@@ -649,43 +723,45 @@ static void ZSendDataDat(PFileVarProto fv, PZVar zv)
 
 	zv->ByteCount = zv->Pos;
 
-	if (zv->FileOpen && (zv->Pos < zv->FileSize))
+	c = 0;
+	if (zv->FileOpen) {
+		LONGLONG rest = zv->FileSize - zv->Pos;
 		file->Seek(file, zv->Pos);
+		c = (int)file->ReadFile(file, buf, (rest < zv->MaxDataLen) ? (size_t)rest : (size_t)zv->MaxDataLen);
+	}
+	if (c == 0) {
+		// MɃt@CZȂ
+		zv->FileSize = zv->Pos;
+	}
 
-	zv->CRC = 0;
 	zv->PktOutCount = 0;
-	do {
-		c = file->ReadFile(file, &b, 1);
-		if (c > 0) {
-			ZPutBin(zv, &(zv->PktOutCount), b);
-			zv->CRC = UpdateCRC(b, zv->CRC);
-			zv->ByteCount++;
-		}
-	} while ((c != 0) && (zv->PktOutCount <= zv->MaxDataLen - 2));
+	ZPutBinBlock(zv, &(zv->PktOutCount), buf, c);
+	zv->ByteCount += c;
 
 	fv->InfoOp->SetDlgByteCount(fv, zv->ByteCount);
 	fv->InfoOp->SetDlgPercent(fv, zv->ByteCount, zv->FileSize, &zv->ProgStat);
 	fv->InfoOp->SetDlgTime(fv, zv->StartTime, zv->ByteCount);
 	zv->Pos = zv->ByteCount;
 
-	zv->PktOut[zv->PktOutCount] = ZDLE;
-	zv->PktOutCount++;
+	/*
+	 * WinSize >= 0 ̂ƂAWinSize/4 Ƃ ZCRCQ  ZACK vȂ瑗M𑱂A
+	 * ZACK ĂȂf[^ WinSize 𒴂Ƃ ZACK ҂
+	 * WinSize < 0 ̂Ƃ ZCRCG ő(full streaming)
+	 */
 	if (zv->Pos >= zv->FileSize)
 		b = ZCRCE;
-	else if ((zv->WinSize >= 0) && (zv->Pos - zv->LastPos > zv->WinSize))
+	else if ((zv->WinSize >= 0) &&
+			 ((zv->Pos - zv->LastPos > zv->WinSize) || (zv->Pos - zv->LastQPos >= zv->WinSize / 4))) {
 		b = ZCRCQ;
+		zv->LastQPos = zv->Pos;
+	}
 	else
 		b = ZCRCG;
-	zv->PktOut[zv->PktOutCount] = b;
-	zv->PktOutCount++;
-	zv->CRC = UpdateCRC(b, zv->CRC);
-
-	ZPutBin(zv, &(zv->PktOutCount), HIBYTE(zv->CRC));
-	ZPutBin(zv, &(zv->PktOutCount), LOBYTE(zv->CRC));
+	ZPutDataEnd(zv, b, buf, c, zv->TxCRC32);
 
 	zv->PktOutPtr = 0;
 	zv->Sending = TRUE;
-	if (b == ZCRCQ)
+	if ((b == ZCRCQ) && (zv->Pos - zv->LastPos > zv->WinSize))
 		zv->ZState = Z_SendDataDat2;	/* wait response from receiver */
 	else
 		zv->ZState = Z_SendDataDat;
@@ -699,6 +775,7 @@ static BOOL ZInit(PFileVarProto fv, PComVar cv, PTTSet ts)
 	PZVar zv = fv->data;
 
 	zv->CtlEsc = ((ts->FTFlag & FT_ZESCCTL) != 0);
+	ZMakeEscTable(zv);
 	zv->MaxDataLen = ts->ZmodemDataLen;
 	zv->WinSize = ts->ZmodemWinSize;
 
@@ -728,15 +805,22 @@ static BOOL ZInit(PFileVarProto fv, PComVar cv, PTTSet ts)
 	zv->PktOutCount = 0;
 	zv->Pos = 0;
 	zv->LastPos = 0;
+	zv->LastQPos = 0;
 	zv->ZPktState = Z_PktGetPAD;
 	zv->Sending = FALSE;
 	zv->LastSent = 0;
 	zv->CanCount = 5;
 
-	if (zv->MaxDataLen <= 0)
-		zv->MaxDataLen = 1024;
+	if (zv->MaxDataLen <= 0) {
+		// ȗ: VA|[gȊO 8KB TupPbg
+		zv->MaxDataLen = (cv->PortType == IdSerial) ? 1024 : ZMODEM_MAX_DATALEN;
+	}
 	if (zv->MaxDataLen < 64)
 		zv->MaxDataLen = 64;
+	if (zv->WinSize == 0) {
+		// ȗ: VA|[gȊO ZACK ҂Ȃ(full streaming)
+		zv->WinSize = (cv->PortType == IdSerial) ? 32767 : -1;
+	}
 
 	zv->TOutInit = ts->ZmodemTimeOutInit;
 	zv->TOutFin = ts->ZmodemTimeOutFin;
@@ -744,10 +828,13 @@ static BOOL ZInit(PFileVarProto fv, PComVar cv, PTTSet ts)
 	/* Time out & Max block size */
 	if (cv->PortType == IdTCPIP) {
 		zv->TimeOut = ts->ZmodemTimeOutTCPIP;
-		Max = 1024;
+		Max = ZMODEM_MAX_DATALEN;
 	} else {
 		zv->TimeOut = ts->ZmodemTimeOutNormal;
-		if (ts->Baud <= 110) {
+		if (cv->PortType != IdSerial) {
+			Max = ZMODEM_MAX_DATALEN;
+		}
+		else if (ts->Baud <= 110) {
 			Max = 64;
 		}
 		else if (ts->Baud <= 300) {
@@ -759,9 +846,12 @@ static BOOL ZInit(PFileVarProto fv, PComVar cv, PTTSet ts)
 		else if (ts->Baud <= 2400) {
 			Max = 512;
 		}
-		else {
+		else if (ts->Baud <= 9600) {
 			Max = 1024;
 		}
+		else {
+			Max = ZMODEM_MAX_DATALEN;
+		}
 	}
 	if (zv->MaxDataLen > Max)
 		zv->MaxDataLen = Max;
@@ -821,14 +911,10 @@ static BOOL ZCheckHdr(PFileVarProto fv, PZVar zv)
 	BOOL Ok;
 
 	if (zv->CRC32) {
-		zv->CRC3 = 0xFFFFFFFF;
-		for (i = 0; i <= 8; i++)
-			zv->CRC3 = UpdateCRC32(zv->PktIn[i], zv->CRC3);
+		zv->CRC3 = UpdateCRC32Block(0xFFFFFFFF, zv->PktIn, 9);
 		Ok = zv->CRC3 == 0xDEBB20E3;
 	} else {
-		zv->CRC = 0;
-		for (i = 0; i <= 6; i++)
-			zv->CRC = UpdateCRC(zv->PktIn[i], zv->CRC);
+		zv->CRC = UpdateCRC16Block(0, zv->PktIn, 7);
 		Ok = zv->CRC == 0;
 	}
 
@@ -880,18 +966,23 @@ static void ZParseRInit(PFileVarProto fv, PZVar zv)
 	/* file open */
 	zv->FileOpen = file->OpenRead(file, zv->FullName);
 
+	zv->TxCRC32 = (zv->RxHdr[ZF0] & CANFC32) != 0;
+
 	if (zv->CtlEsc) {
 		if ((zv->RxHdr[ZF0] & ESCCTL) == 0) {
 			zv->ZState = Z_SendInitHdr;
 			ZSendInitHdr(zv);
 			return;
 		}
-	} else
+	} else {
 		zv->CtlEsc = (zv->RxHdr[ZF0] & ESCCTL) != 0;
+		ZMakeEscTable(zv);
+	}
 
+	/* M̃obt@TCY, 0 ̂Ƃ͐Ȃ */
 	Max = (zv->RxHdr[ZP1] << 8) + zv->RxHdr[ZP0];
 	if (Max <= 0)
-		Max = 1024;
+		Max = ZMODEM_MAX_DATALEN;
 	if (zv->MaxDataLen > Max)
 		zv->MaxDataLen = Max;
 
@@ -905,6 +996,7 @@ static BOOL ZParseSInit(PZVar zv)
 		return FALSE;
 	zv->ZState = Z_RecvInit2;
 	zv->CtlEsc = zv->CtlEsc || ((zv->RxHdr[ZF0] & ESCCTL) != 0);
+	ZMakeEscTable(zv);
 	return TRUE;
 }
 
@@ -931,16 +1023,18 @@ static void ZParseHdr(PFileVarProto fv, PZVar zv, PComVar cv)
 		case Z_SendInitDat:
 			ZSendFileHdr(zv);
 			break;
-		case Z_SendDataDat2:
-			zv->LastPos = ZRclHdr(zv);
-			if (zv->Pos == zv->LastPos)
-				ZSendDataDat(fv, zv);
-			else {
-				zv->Pos = zv->LastPos;
-				ZSendDataHdr(zv);
-			}
+		case Z_SendDataHdr:
+		case Z_SendDataDat:
+		case Z_SendDataDat2: {
+			/* ZCRCQ ւ̉, đ ZRPOS ŗv */
+			LONGLONG pos = ZRclHdrPos(zv, zv->Pos);
+			if ((pos > zv->LastPos) && (pos <= zv->Pos))
+				zv->LastPos = pos;
+			if ((zv->ZState == Z_SendDataDat2) && (zv->Pos - zv->LastPos <= zv->WinSize))
+				zv->ZState = Z_SendDataDat;		/* M̃f[^Ȃ玟𑗂 */
 			break;
 		}
+		}
 		break;
 	case ZFILE:
 		zv->ZPktState = Z_PktGetData;
@@ -957,8 +1051,9 @@ static void ZParseHdr(PFileVarProto fv, PZVar zv, PComVar cv)
 			zv->FileOpen = FALSE;
 		}
 		ZStoHdr(zv, 0);
+		zv->RxHdr[ZF0] = zv->TxCRC32 ? CANFC32 : 0;
 		if (zv->CtlEsc)
-			zv->RxHdr[ZF0] = ESCCTL;
+			zv->RxHdr[ZF0] |= ESCCTL;
 		zv->ZState = Z_SendInit;
 		ZParseRInit(fv, zv);
 		break;
@@ -1000,15 +1095,16 @@ static void ZParseHdr(PFileVarProto fv, PZVar zv, PComVar cv)
 		case Z_SendDataDat:
 		case Z_SendDataDat2:
 		case Z_SendEOF:
-			zv->Pos = ZRclHdr(zv);
+			zv->Pos = ZRclHdrPos(zv, zv->Pos);
 			zv->LastPos = zv->Pos;
-			add_recvbuf(" pos=%ld", zv->Pos);
+			zv->LastQPos = zv->Pos;
+			add_recvbuf(" pos=%lld", zv->Pos);
 			ZSendDataHdr(zv);
 			break;
 		}
 		break;
 	case ZDATA:
-		if (zv->Pos != ZRclHdr(zv)) {
+		if (zv->Pos != ZRclHdrPos(zv, zv->Pos)) {
 			ZSendRPOS(fv, zv);
 			return;
 		} else {
@@ -1017,7 +1113,7 @@ static void ZParseHdr(PFileVarProto fv, PZVar zv, PComVar cv)
 		}
 		break;
 	case ZEOF:
-		if (zv->Pos != ZRclHdr(zv)) {
+		if (zv->Pos != ZRclHdrPos(zv, zv->Pos)) {
 			ZSendRPOS(fv, zv);
 			return;
 		} else {
@@ -1242,6 +1338,89 @@ static void ZCheckData(PFileVarProto fv, PZVar zv)
 	}
 }
 
+/*
+ *	ZRead1Byte() ŏoCg
+ *		XON/XOFF ͎̂ĂAtelnet  IAC  CR  CommRead1Byte() ŏ
+ */
+static BOOL ZIsSpecial(BYTE b, BOOL tel_iac, BOOL tel_cr)
+{
+	return ((b & 0x7F) == 0x11) || ((b & 0x7F) == 0x13) || (tel_iac && (b == 0xFF)) || (tel_cr && (b == 0x0D));
+}
+
+/*
+ *	f[^TupPbg̎M
+ *		Mobt@̃f[^ ZDLE ̃GXP[v߂Ȃ܂Ƃ߂ PktIn փRs[
+ *		frameend(ZDLE + ZCRCx)AXON/XOFFAtelnet ̏KvȃoCg̎OŎ~܂A
+ *		 ZRead1Byte() 1byte
+ *		ZMODEM.LOG ĂƂ͏Ȃ
+ */
+static void ZReadDataRun(PZVar zv, PComVar cv)
+{
+	const BYTE *start, *p, *end;
+	BYTE *out, *out_end;
+	BOOL tel_iac, tel_cr;
+	int len;
+	int i;
+
+	if ((zv->ZPktState != Z_PktGetData) || zv->Quoted || (zv->ZState == Z_RecvFIN) || (zv->log != NULL)) {
+		return;
+	}
+	if (!cv->Ready || (cv->InBuffCount <= 0) || cv->TelMode || cv->IACFlag || cv->TelCRFlag) {
+		return;
+	}
+	tel_iac = (cv->PortType == IdTCPIP) && (cv->TelFlag || cv->TelAutoDetect);
+	tel_cr = cv->TelFlag && !cv->TelBinRecv;
+
+	start = p = &cv->InBuff[cv->InPtr];
+	end = p + cv->InBuffCount;
+	out = &zv->PktIn[zv->PktInPtr];
+	out_end = &zv->PktIn[ZMODEM_MAX_DATALEN];
+	while ((p < end) && (out < out_end)) {
+		BYTE b = *p;
+		if (ZIsSpecial(b, tel_iac, tel_cr)) {
+			break;
+		}
+		if (b == ZDLE) {
+			BYTE q;
+			if (p + 1 >= end) {
+				break;
+			}
+			q = p[1];
+			if (ZIsSpecial(q, tel_iac, tel_cr) || (q == ZDLE) || ((q >= ZCRCE) && (q <= ZCRCW))) {
+				break;
+			}
+			if (q == ZRUB0)
+				b = 0x7F;
+			else if (q == ZRUB1)
+				b = 0xFF;
+			else
+				b = q ^ 0x40;
+			p += 2;
+		}
+		else {
+			p++;
+		}
+		*out++ = b;
+	}
+
+	len = (int)(p - start);
+	if (len == 0) {
+		return;
+	}
+	cv->InPtr += len;
+	cv->InBuffCount -= len;
+	if (cv->InBuffCount == 0) {
+		cv->InPtr = 0;
+	}
+	if (cv->Log1Bin != NULL) {
+		for (i = 0; i < len; i++) {
+			cv->Log1Bin(start[i]);
+		}
+	}
+	zv->PktInPtr = (int)(out - zv->PktIn);
+	zv->CanCount = 5;
+}
+
 static BOOL ZParse(PFileVarProto fv, PComVar cv)
 {
 	PZVar zv = fv->data;
@@ -1264,6 +1443,7 @@ static BOOL ZParse(PFileVarProto fv, PComVar cv)
 				return TRUE;
 		}
 
+		ZReadDataRun(zv, cv);
 		c = ZRead1Byte(fv, zv, cv, &b);
 		while (c > 0) {
 			if (zv->ZState == Z_RecvFIN) {
@@ -1420,17 +1600,24 @@ static BOOL ZParse(PFileVarProto fv, PComVar cv)
 						}
 						zv->Quoted = FALSE;
 					}
-					if (zv->CRC32)
-						zv->CRC3 = UpdateCRC32(b, zv->CRC3);
-					else
-						zv->CRC = UpdateCRC(b, zv->CRC);
 					if (zv->ZPktState == Z_PktGetData) {
-						if (zv->PktInPtr < 1024) {
+						if (zv->PktInPtr < ZMODEM_MAX_DATALEN) {
 							zv->PktIn[zv->PktInPtr] = b;
 							zv->PktInPtr++;
 						} else
 							zv->ZPktState = Z_PktGetPAD;
 					}
+					else if (zv->ZPktState == Z_PktGetCRC) {
+						/* frameend, f[^ frameend  CRC ܂Ƃ߂ČvZ */
+						if (zv->CRC32) {
+							zv->CRC3 = UpdateCRC32Block(0xFFFFFFFF, zv->PktIn, zv->PktInPtr);
+							zv->CRC3 = UpdateCRC32Block(zv->CRC3, &b, 1);
+						}
+						else {
+							zv->CRC = UpdateCRC16Block(0, zv->PktIn, zv->PktInPtr);
+							zv->CRC = UpdateCRC(b, zv->CRC);
+						}
+					}
 				}
 				break;
 			case Z_PktGetCRC:
@@ -1453,7 +1640,7 @@ static BOOL ZParse(PFileVarProto fv, PComVar cv)
 						zv->Quoted = FALSE;
 					}
 					if (zv->CRC32)
-						zv->CRC3 = UpdateCRC32(b, zv->CRC3);
+						zv->CRC3 = UpdateCRC32Block(zv->CRC3, &b, 1);
 					else
 						zv->CRC = UpdateCRC(b, zv->CRC);
 					zv->PktInCount--;
@@ -1462,6 +1649,7 @@ static BOOL ZParse(PFileVarProto fv, PComVar cv)
 				}
 				break;
 			}
+			ZReadDataRun(zv, cv);
 			c = ZRead1Byte(fv, zv, cv, &b);
 		}
 
@@ -67,6 +67,7 @@
 #include "dllutil.h"
 #include "asprintf.h"
 #include "win32helper.h"
+#include "../ttpfile/ftlib.h"
 
 #define TTERMCOMMAND "TTERMPRO"
 #define CYGTERMCOMMAND "cyglaunch -o"
@@ -690,42 +691,17 @@ static unsigned int checksum8(int n, unsigned char c[])
 	return (value & 0xFF);
 }
 
-// CRC-16-CCITT
+// CRC-16-CCITT (x^{16}+x^{12}+x^5+1, Et])
+//   vZ ttpfile/ftlib.c ̃e[ug
 static unsigned int crc16(int n, unsigned char c[])
 {
-#define CRC16POLY1  0x1021U  /* x^{16}+x^{12}+x^5+1 */
-#define CRC16POLY2  0x8408U  /* Et] */
-
-	int i, j;
-	unsigned long r;
-
-	r = 0xFFFFU;
-	for (i = 0; i < n; i++) {
-		r ^= c[i];
-		for (j = 0; j < CHAR_BIT; j++)
-			if (r & 1) r = (r >> 1) ^ CRC16POLY2;
-			else       r >>= 1;
-	}
-	return r ^ 0xFFFFU;
+	return UpdateCRC16RBlock(0xFFFFU, c, n) ^ 0xFFFFU;
 }
 
+// CRC-32 (0x04C11DB7, Et])
 static unsigned long crc32(int n, unsigned char c[])
 {
-#define CRC32POLY1 0x04C11DB7UL
-	/* x^{32}+x^{26}+x^{23}+x^{22}+x^{16}+x^{12}+x^{11}+
-	   x^{10}+x^8+x^7+x^5+x^4+x^2+x^1+1 */
-#define CRC32POLY2 0xEDB88320UL  /* Et] */
-	int i, j;
-	unsigned long r;
-
-	r = 0xFFFFFFFFUL;
-	for (i = 0; i < n; i++) {
-		r ^= c[i];
-		for (j = 0; j < CHAR_BIT; j++)
-			if (r & 1) r = (r >> 1) ^ CRC32POLY2;
-			else       r >>= 1;
-	}
-	return r ^ 0xFFFFFFFFUL;
+	return UpdateCRC32Block(0xFFFFFFFFUL, c, n) ^ 0xFFFFFFFFUL;
 }
 
 // `FbNTASYEʃ[`
@@ -5832,6 +5808,44 @@ static WORD TTLScpSend(void)
 	return SendCmnd(CmdScpSend, 0);
 }
 
+// SYNOPSIS:
+//   scpsendstatus <percent> <rate> <eta>
+//     percent = Mς݂̊(%), rate = ]x(KB/s), eta = cb(-1 = s)
+//     result = 1: M, 0: MĂȂ(l͍ŌɑMt@Ĉ), -1: 擾łȂ
+static WORD TTLScpSendStatus(void)
+{
+	WORD Err;
+	TVarId percent, rate, eta;
+	char Str[MaxStrLen];
+	int sending, tmp_percent, tmp_rate, tmp_eta;
+
+	Err = 0;
+	GetIntVar(&percent, &Err);
+	GetIntVar(&rate, &Err);
+	GetIntVar(&eta, &Err);
+	if ((Err == 0) && (GetFirstChar() != 0))
+		Err = ErrSyntax;
+	if ((Err == 0) && (!Linked))
+		Err = ErrLinkFirst;
+	if (Err != 0) return Err;
+
+	memset(Str, 0, sizeof(Str));
+	Err = GetTTParam(CmdGetScpStatus, Str, sizeof(Str));
+	if (Err == 0) {
+		if (sscanf_s(Str, "%d %d %d %d", &sending, &tmp_percent, &tmp_rate, &tmp_eta) == 4) {
+			SetIntVal(percent, tmp_percent);
+			SetIntVal(rate, tmp_rate);
+			SetIntVal(eta, tmp_eta);
+			SetResult(sending ? 1 : 0);
+		}
+		else {
+			SetResult(-1);
+		}
+	}
+
+	return Err;
+}
+
 // SYNOPSIS:
 //   scprecv "foo.txt"
 //   scprecv "src/foo.txt" "c:\foo.txt"
@@ -5864,6 +5878,78 @@ static WORD TTLScpRecv(void)
 	return SendCmnd(CmdScpRcv, 0);
 }
 
+// SYNOPSIS:
+//   sftpget "src/foo.txt"
+//   sftpget "src/foo.txt" "c:\foo.txt"
+//   sftpput "c:\usr\sample.chm"
+//   sftpput "c:\usr\sample.chm" "doc/sample.chm"
+static WORD TTLSftpTransfer(char Cmd)
+{
+	TStrVal Str;
+	TStrVal Str2;
+	WORD Err;
+
+	Err = 0;
+	GetStrVal(Str,&Err);
+
+	if ((Err==0) &&
+	    ((strlen(Str)==0)))
+		Err = ErrSyntax;
+	if (Err!=0) return Err;
+
+	GetStrVal(Str2,&Err);
+	if (Err) {
+		Str2[0] = '\0';
+		Err = 0;
+	}
+
+	if (GetFirstChar() != 0)
+		Err = ErrSyntax;
+	if (Err!=0) return Err;
+
+	SetFile(Str);
+	SetSecondFile(Str2);
+	return SendCmnd(Cmd, 0);
+}
+
+// SYNOPSIS:
+//   sftpstatus <pending> <done> <failed>
+//     pending = IĂȂ]̐, done = , failed = s
+//     result = 1: ], 0: ׂďI, -1: 擾łȂ
+static WORD TTLSftpStatus(void)
+{
+	WORD Err;
+	TVarId pending, done, failed;
+	char Str[MaxStrLen];
+	int tmp_pending, tmp_done, tmp_failed;
+
+	Err = 0;
+	GetIntVar(&pending, &Err);
+	GetIntVar(&done, &Err);
+	GetIntVar(&failed, &Err);
+	if ((Err == 0) && (GetFirstChar() != 0))
+		Err = ErrSyntax;
+	if ((Err == 0) && (!Linked))
+		Err = ErrLinkFirst;
+	if (Err != 0) return Err;
+
+	memset(Str, 0, sizeof(Str));
+	Err = GetTTParam(CmdGetSftpStatus, Str, sizeof(Str));
+	if (Err == 0) {
+		if (sscanf_s(Str, "%d %d %d", &tmp_pending, &tmp_done, &tmp_failed) == 3) {
+			SetIntVal(pending, tmp_pending);
+			SetIntVal(done, tmp_done);
+			SetIntVal(failed, tmp_failed);
+			SetResult(tmp_pending > 0 ? 1 : 0);
+		}
+		else {
+			SetResult(-1);
+		}
+	}
+
+	return Err;
+}
+
 #if defined(OUTPUTDEBUGSTRING_ENABLE)
 static WORD TTLOutputDebugstring(void)
 {
@@ -6241,6 +6327,14 @@ static int ExecCmnd(void)
 			Err = TTLScpSend(); break;      // add 'scpsend' (2008.1.1 yutaka)
 		case RsvScpRecv:
 			Err = TTLScpRecv(); break;      // add 'scprecv' (2008.1.4 yutaka)
+		case RsvScpSendStatus:
+			Err = TTLScpSendStatus(); break;
+		case RsvSftpGet:
+			Err = TTLSftpTransfer(CmdSftpGet); break;
+		case RsvSftpPut:
+			Err = TTLSftpTransfer(CmdSftpPut); break;
+		case RsvSftpStatus:
+			Err = TTLSftpStatus(); break;
 		case RsvSend:
 			Err = TTLSend(); break;
 		case RsvSendText:
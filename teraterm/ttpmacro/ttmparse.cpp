@@ -349,6 +349,7 @@ BOOL CheckReservedWord(PCHAR Str, LPWORD WordId)
 	case 's':
 		if (_stricmp(Str,"scprecv")==0) *WordId = RsvScpRecv;      // add 'scprecv' (2008.1.1 yutaka)
 		else if (_stricmp(Str,"scpsend")==0) *WordId = RsvScpSend;      // add 'scpsend' (2008.1.1 yutaka)
+		else if (_stricmp(Str,"scpsendstatus")==0) *WordId = RsvScpSendStatus;
 		else if (_stricmp(Str,"send")==0) *WordId = RsvSend;
 		else if (_stricmp(Str,"sendbreak")==0) *WordId = RsvSendBreak;
 		else if (_stricmp(Str,"sendbroadcast")==0) *WordId = RsvSendBroadcast;
@@ -356,6 +357,9 @@ BOOL CheckReservedWord(PCHAR Str, LPWORD WordId)
 		else if (_stricmp(Str,"sendlnmulticast")==0) *WordId = RsvSendlnMulticast;
 		else if (_stricmp(Str,"sendmulticast")==0) *WordId = RsvSendMulticast;
 		else if (_stricmp(Str,"sendtext")==0) *WordId = RsvSendText;
+		else if (_stricmp(Str,"sftpget")==0) *WordId = RsvSftpGet;
+		else if (_stricmp(Str,"sftpput")==0) *WordId = RsvSftpPut;
+		else if (_stricmp(Str,"sftpstatus")==0) *WordId = RsvSftpStatus;
 		else if (_stricmp(Str,"sendbinary")==0) *WordId = RsvSendBinary;
 		else if (_stricmp(Str,"setfileattr")==0) *WordId = RsvSetFileAttr;
 		else if (_stricmp(Str,"setmulticastname")==0) *WordId = RsvSetMulticastName;
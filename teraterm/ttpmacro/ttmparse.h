@@ -296,6 +296,10 @@ typedef enum {
 #define RsvDelPassword2 221
 #define RsvIsPassword2  222
 #define RsvGetTTPos     223
+#define RsvSftpGet      224
+#define RsvSftpPut      225
+#define RsvScpSendStatus 226
+#define RsvSftpStatus   227
 
 #define RsvOperator     1000
 #define RsvBNot         1001
@@ -781,6 +781,16 @@ void PASCAL _ReadIniFile(const wchar_t *FName, PTTSet ts)
 	ts->ScrollBuffSize =
 		GetPrivateProfileInt(Section, "ScrollBuffSize", 100, FName);
 
+	/* Compressed scroll buffer size */
+	ts->ScrollBuffColdSize =
+		GetPrivateProfileInt(Section, "ScrollBuffColdSize", 0, FName);
+	if (ts->ScrollBuffColdSize < 0)
+		ts->ScrollBuffColdSize = 0;
+	ts->ScrollBuffColdMemory =
+		GetPrivateProfileInt(Section, "ScrollBuffColdMemory", 0, FName);
+	if (ts->ScrollBuffColdMemory < 0)
+		ts->ScrollBuffColdMemory = 0;
+
 	/* VT Color */
 	GetPrivateProfileColor2(Section, "VTColor", "0,0,0,255,255,255", FName, ts->VTColor);
 
@@ -1233,10 +1243,19 @@ void PASCAL _ReadIniFile(const wchar_t *FName, PTTSet ts)
 	/* Kermit log  -- special option */
 	if (GetOnOff(Section, "KmtLog", FName, FALSE))
 		ts->LogFlag |= LOG_KMT;
-	if (GetOnOff(Section, "KmtLongPacket", FName, FALSE))
+	if (GetOnOff(Section, "KmtLongPacket", FName, TRUE))
 		ts->KermitOpt |= KmtOptLongPacket;
 	if (GetOnOff(Section, "KmtFileAttr", FName, FALSE))
 		ts->KermitOpt |= KmtOptFileAttr;
+	if (GetOnOff(Section, "KmtSlideWindow", FName, TRUE))
+		ts->KermitOpt |= KmtOptSlideWin;
+	if (GetOnOff(Section, "KmtStreaming", FName, TRUE))
+		ts->KermitOpt |= KmtOptStreaming;
+	ts->KermitWinSize = (WORD)GetPrivateProfileInt(Section, "KmtWindowSize", 31, FName);
+	if (ts->KermitWinSize < 1)
+		ts->KermitWinSize = 1;
+	else if (ts->KermitWinSize > 31)
+		ts->KermitWinSize = 31;
 
 	/* Maximum scroll buffer size  -- special option */
 	ts->ScrollBuffMax =
@@ -1303,6 +1322,12 @@ void PASCAL _ReadIniFile(const wchar_t *FName, PTTSet ts)
 	ts->ScrollThreshold =
 		GetPrivateProfileInt(Section, "ScrollThreshold", 12, FName);
 
+	/* Render frame rate -- special option */
+	ts->RenderFrameRate =
+		GetPrivateProfileInt(Section, "RenderFrameRate", 0, FName);
+	if (ts->RenderFrameRate > 1000)
+		ts->RenderFrameRate = 1000;
+
 	ts->MouseWheelScrollLine =
 		GetPrivateProfileInt(Section, "MouseWheelScrollLine", 3, FName);
 
@@ -1432,10 +1457,10 @@ void PASCAL _ReadIniFile(const wchar_t *FName, PTTSet ts)
 
 	/* ZMODEM data subpacket length for sending -- special */
 	ts->ZmodemDataLen =
-		GetPrivateProfileInt(Section, "ZmodemDataLen", 1024, FName);
+		GetPrivateProfileInt(Section, "ZmodemDataLen", 0, FName);
 	/* ZMODEM window size for sending -- special */
 	ts->ZmodemWinSize =
-		GetPrivateProfileInt(Section, "ZmodemWinSize", 32767, FName);
+		GetPrivateProfileInt(Section, "ZmodemWinSize", 0, FName);
 
 	/* ZMODEM ESCCTL flag  -- special option */
 	if (GetOnOff(Section, "ZmodemEscCtl", FName, FALSE))
@@ -2288,6 +2313,10 @@ void PASCAL _WriteIniFile(const wchar_t *FName, PTTSet ts)
 	/* Scroll buffer size */
 	WriteInt(Section, "ScrollBuffSize", FName, ts->ScrollBuffSize);
 
+	/* Compressed scroll buffer size */
+	WriteInt(Section, "ScrollBuffColdSize", FName, ts->ScrollBuffColdSize);
+	WriteInt(Section, "ScrollBuffColdMemory", FName, ts->ScrollBuffColdMemory);
+
 	/* VT Color */
 	for (i = 0; i <= 1; i++) {
 		TmpColor[0][i * 3] = GetRValue(ts->VTColor[i]);
@@ -2700,6 +2729,9 @@ void PASCAL _WriteIniFile(const wchar_t *FName, PTTSet ts)
 	WriteOnOff(Section, "KmtLog", FName, (WORD) (ts->LogFlag & LOG_KMT));
 	WriteOnOff(Section, "KmtLongPacket", FName, (WORD) (ts->KermitOpt & KmtOptLongPacket));
 	WriteOnOff(Section, "KmtFileAttr", FName, (WORD) (ts->KermitOpt & KmtOptFileAttr));
+	WriteOnOff(Section, "KmtSlideWindow", FName, (WORD) (ts->KermitOpt & KmtOptSlideWin));
+	WriteOnOff(Section, "KmtStreaming", FName, (WORD) (ts->KermitOpt & KmtOptStreaming));
+	WriteInt(Section, "KmtWindowSize", FName, ts->KermitWinSize);
 
 	/* Maximum scroll buffer size  -- special option */
 	WriteInt(Section, "MaxBuffSize", FName, ts->ScrollBuffMax);
@@ -2748,6 +2780,9 @@ void PASCAL _WriteIniFile(const wchar_t *FName, PTTSet ts)
 	/* Scroll threshold -- special option */
 	WriteInt(Section, "ScrollThreshold", FName, ts->ScrollThreshold);
 
+	/* Render frame rate -- special option */
+	WriteInt(Section, "RenderFrameRate", FName, ts->RenderFrameRate);
+
 	WriteInt(Section, "MouseWheelScrollLine", FName, ts->MouseWheelScrollLine);
 
 	// Select on activate -- special option
@@ -0,0 +1,333 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *	CRC vZ̃x`}[N
+ *		ftlib.c ̃e[u(slicing-by-8) CRC  1bit vZ
+ *		QƎƏƍA1byte/ubNPʂ̑xv
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+#if !defined(_WIN32)
+#include <time.h>
+#endif
+
+#include "ftlib.h"
+
+#define MiB  (1024.0 * 1024.0)
+
+#define DEFAULT_SIZE	1024
+#define DEFAULT_TOTAL	(256 * 1024 * 1024)
+#define VERIFY_COUNT	20000
+#define VERIFY_MAX_LEN	1024	// _Ȓ̏
+#define VERIFY_FULL		4		// ŌɃobt@Ŝŏƍ
+
+static double Now(void)
+{
+#if defined(_WIN32)
+	LARGE_INTEGER freq, count;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+	return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+// QƎ
+
+// XMODEM/YMODEM/ZMODEM CRC-16 ( 0x1021, MSB first)
+static WORD RefCRC16(WORD crc, const BYTE *buf, size_t len)
+{
+	size_t i;
+	int bit;
+
+	for (i = 0; i < len; i++) {
+		crc ^= (WORD)(buf[i] << 8);
+		for (bit = 0; bit < 8; bit++) {
+			crc = (crc & 0x8000) ? (WORD)((crc << 1) ^ 0x1021) : (WORD)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+// }N crc16 (X.25,  0x1021 rbg], LSB first)
+static WORD RefCRC16R(WORD crc, const BYTE *buf, size_t len)
+{
+	size_t i;
+	int bit;
+
+	for (i = 0; i < len; i++) {
+		crc ^= buf[i];
+		for (bit = 0; bit < 8; bit++) {
+			crc = (crc & 1) ? (WORD)((crc >> 1) ^ 0x8408) : (WORD)(crc >> 1);
+		}
+	}
+	return crc;
+}
+
+// CRC-32 ( 0xedb88320)
+static DWORD RefCRC32(DWORD crc, const BYTE *buf, size_t len)
+{
+	size_t i;
+	int bit;
+
+	for (i = 0; i < len; i++) {
+		crc ^= buf[i];
+		for (bit = 0; bit < 8; bit++) {
+			crc = (crc & 1) ? ((crc >> 1) ^ 0xedb88320UL) : (crc >> 1);
+		}
+	}
+	return crc;
+}
+
+static int Errors;
+
+static void Check(const char *name, DWORD expect, DWORD result, size_t offset, size_t len)
+{
+	if (expect != result) {
+		if (Errors < 10) {
+			printf("NG %-16s offset=%u len=%u expect=%08x result=%08x\n",
+				   name, (unsigned)offset, (unsigned)len, (unsigned)expect, (unsigned)result);
+		}
+		Errors++;
+	}
+}
+
+static void CheckVectors(void)
+{
+	static const BYTE check[] = "123456789";
+	size_t len = sizeof(check) - 1;
+
+	Check("crc16/xmodem", 0x31c3, UpdateCRC16Block(0, check, len), 0, len);
+	Check("crc16/x.25", 0x906e, UpdateCRC16RBlock(0xffff, check, len) ^ 0xffff, 0, len);
+	Check("crc32", 0xcbf43926UL, UpdateCRC32Block(0xffffffffUL, check, len) ^ 0xffffffffUL, 0, len);
+}
+
+// _ȈʒuAŎQƎƏƍ
+//	擪̃ACg 8byte ̒[̗ʂ offset  0..15
+//	QƎ͒x̂ŁA͍ŏ 64 0..63AŌ̐񂪃obt@ŚA
+//	̑ VERIFY_MAX_LEN ɂ (RAND_MAX 傫łbŏI)
+static void Verify(const BYTE *buf, size_t size)
+{
+	size_t max_len = size - 16 < VERIFY_MAX_LEN ? size - 16 : VERIFY_MAX_LEN;
+	int i;
+
+	for (i = 0; i < VERIFY_COUNT; i++) {
+		size_t offset = (size_t)(rand() % 16);
+		size_t len;
+		if (i < 64) {
+			len = (size_t)i;
+		}
+		else if (i >= VERIFY_COUNT - VERIFY_FULL) {
+			len = size - offset;
+		}
+		else {
+			len = (size_t)rand() % max_len;
+		}
+		const BYTE *p = buf + offset;
+		WORD crc16 = (WORD)rand();
+		DWORD crc32 = ((DWORD)rand() << 16) ^ (DWORD)rand();
+		WORD c16;
+		DWORD c32;
+		size_t n;
+
+		Check("crc16", RefCRC16(crc16, p, len), UpdateCRC16Block(crc16, p, len), offset, len);
+		Check("crc16r", RefCRC16R(crc16, p, len), UpdateCRC16RBlock(crc16, p, len), offset, len);
+		Check("crc32", RefCRC32(crc32, p, len), UpdateCRC32Block(crc32, p, len), offset, len);
+
+		// 1byte̊֐Ƃv邱
+		c16 = crc16;
+		c32 = crc32;
+		for (n = 0; n < len; n++) {
+			c16 = UpdateCRC(p[n], c16);
+			c32 = (DWORD)UpdateCRC32(p[n], (LONG)c32);
+		}
+		Check("crc16/byte", RefCRC16(crc16, p, len), c16, offset, len);
+		Check("crc32/byte", RefCRC32(crc32, p, len), c32, offset, len);
+	}
+}
+
+typedef enum {
+	CRC16_REF,
+	CRC16_BYTE,
+	CRC16_BLOCK,
+	CRC16R_BLOCK,
+	CRC32_REF,
+	CRC32_BYTE,
+	CRC32_BLOCK,
+} Mode;
+
+static const char *ModeName(Mode mode)
+{
+	switch (mode) {
+	case CRC16_REF:		return "crc16  bitwise";
+	case CRC16_BYTE:	return "crc16  byte";
+	case CRC16_BLOCK:	return "crc16  block";
+	case CRC16R_BLOCK:	return "crc16r block";
+	case CRC32_REF:		return "crc32  bitwise";
+	case CRC32_BYTE:	return "crc32  byte";
+	case CRC32_BLOCK:	return "crc32  block";
+	}
+	return "";
+}
+
+static void Bench(Mode mode, const BYTE *buf, size_t size, size_t total)
+{
+	size_t count = total / size;
+	size_t i, n;
+	DWORD crc = 0;
+	double start, sec, mb;
+
+	// bitwise ͒x̂ 1/16
+	if (mode == CRC16_REF || mode == CRC32_REF) {
+		count /= 16;
+	}
+	if (count == 0) {
+		count = 1;
+	}
+
+	start = Now();
+	for (i = 0; i < count; i++) {
+		switch (mode) {
+		case CRC16_REF:
+			crc = RefCRC16((WORD)crc, buf, size);
+			break;
+		case CRC16_BYTE: {
+			WORD c = (WORD)crc;
+			for (n = 0; n < size; n++) {
+				c = UpdateCRC(buf[n], c);
+			}
+			crc = c;
+			break;
+		}
+		case CRC16_BLOCK:
+			crc = UpdateCRC16Block((WORD)crc, buf, size);
+			break;
+		case CRC16R_BLOCK:
+			crc = UpdateCRC16RBlock((WORD)crc, buf, size);
+			break;
+		case CRC32_REF:
+			crc = RefCRC32(crc, buf, size);
+			break;
+		case CRC32_BYTE: {
+			LONG c = (LONG)crc;
+			for (n = 0; n < size; n++) {
+				c = UpdateCRC32(buf[n], c);
+			}
+			crc = (DWORD)c;
+			break;
+		}
+		case CRC32_BLOCK:
+			crc = UpdateCRC32Block(crc, buf, size);
+			break;
+		}
+	}
+	sec = Now() - start;
+	mb = (double)count * (double)size / MiB;
+
+	printf("%-16s %8.1f %10.1f %8.3f   %08x\n",
+		   ModeName(mode), mb, mb / sec, sec * 1e9 / ((double)count * (double)size), (unsigned)crc);
+}
+
+static void Usage(void)
+{
+	printf(
+		"bench_crc [options]\n"
+		"  -s size   1ɌvZoCg (default %d)\n"
+		"  -n MB     1[h̃f[^ (default %d)\n"
+		"  -v        ƍ̂ݍs\n",
+		DEFAULT_SIZE, DEFAULT_TOTAL / (1024 * 1024));
+}
+
+int main(int argc, char *argv[])
+{
+	size_t size = DEFAULT_SIZE;
+	size_t total = DEFAULT_TOTAL;
+	int verify_only = 0;
+	size_t buf_size;
+	BYTE *buf;
+	size_t i;
+	int mode;
+
+	for (i = 1; i < (size_t)argc; i++) {
+		if (strcmp(argv[i], "-s") == 0 && i + 1 < (size_t)argc) {
+			size = (size_t)strtoul(argv[++i], NULL, 0);
+		}
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < (size_t)argc) {
+			total = (size_t)strtoul(argv[++i], NULL, 0) * 1024 * 1024;
+		}
+		else if (strcmp(argv[i], "-v") == 0) {
+			verify_only = 1;
+		}
+		else {
+			Usage();
+			return 1;
+		}
+	}
+	if (size == 0) {
+		Usage();
+		return 1;
+	}
+
+	buf_size = size < 65536 ? 65536 : size;
+	buf = (BYTE *)malloc(buf_size + 16);
+	if (buf == NULL) {
+		return 1;
+	}
+	srand(1);
+	for (i = 0; i < buf_size + 16; i++) {
+		buf[i] = (BYTE)rand();
+	}
+
+	CheckVectors();
+	Verify(buf, buf_size);
+	if (Errors != 0) {
+		printf("verify: %d errors\n", Errors);
+		free(buf);
+		return 1;
+	}
+	printf("verify: ok\n");
+	if (verify_only) {
+		free(buf);
+		return 0;
+	}
+
+	printf("\n%-16s %8s %10s %8s   %s\n", "mode", "MB", "MB/s", "ns/byte", "crc");
+	for (mode = CRC16_REF; mode <= CRC32_BLOCK; mode++) {
+		Bench((Mode)mode, buf, size, total);
+	}
+
+	free(buf);
+	return 0;
+}
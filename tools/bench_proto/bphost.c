@@ -0,0 +1,460 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *	B-Plus ̃zXg for tools/bench_proto
+ *
+ *	B-Plus ̓zXg(CompuServe)]wvgRŁA
+ *	bplus.c ̓NCAgĂB
+ *	NCAg̃Abv[h󂯂ŏ̃zXgŎB
+ *		ENQ -> DLE + +  -> '+' pPbg(]p[^)̌
+ *		-> 'T' 'U'(Abv[hw) -> 'N'(f[^)... -> 'T' 'C'(I)
+ *	EBhE͎gȂ(bplus.c  1pPbg ACK ҂)
+ */
+
+#include <stdarg.h>
+
+#include "tttypes.h"
+#include "ttcommon.h"
+#include "ftlib.h"
+
+#include "bphost.h"
+
+#define DLE	0x10
+#define ETX	0x03
+#define ENQ	0x05
+#define NAK	0x15
+
+#define BPH_TIMEOUT		10
+#define BPH_RETRY_MAX	10
+#define BPH_BS			16		// ubNTCY 16 x 128 byte
+
+enum {
+	BPH_WaitPlus,		// ENQ ւ̉(DLE +)҂
+	BPH_WaitParam,		// '+' pPbg҂
+	BPH_WaitTAck,		// 'T' 'U'  ACK ҂
+	BPH_RecvData,
+	BPH_Done,
+	BPH_Failure,
+};
+
+enum {
+	BPH_PktGetDLE,
+	BPH_PktDLESeen,
+	BPH_PktGetData,
+	BPH_PktGetCheck,
+};
+
+typedef struct {
+	int State;
+	int PktState;
+	BYTE PktIn[4200];
+	int PktInCount;
+	BOOL Quoted;
+	WORD CheckCalc;
+	WORD Check;
+	int CheckCount;
+	BYTE CM;			// 0:checksum 1:CRC
+	BYTE LastSeq;		// ŌɊpPbg̔ԍ
+	BYTE PktOut[64];	// đp(zXgpPbg͒Z)
+	int PktOutLen;
+	BYTE SendBuf[8192];	// M҂
+	int SendLen;
+	int Retry;
+	BOOL FileOpen;
+	char *FullName;
+} TBPHost;
+typedef TBPHost *PBPHost;
+
+static void BPHUpdateCheck(PBPHost hv, WORD *check, BYTE b)
+{
+	WORD w;
+
+	if (hv->CM == 1) {
+		*check = UpdateCRC(b, *check);
+		return;
+	}
+	w = (WORD)(*check << 1);
+	if (w > 0xFF)
+		w = (w & 0xFF) + 1;
+	w = w + b;
+	if (w > 0xFF)
+		w = (w & 0xFF) + 1;
+	*check = w;
+}
+
+static void BPHFlush(PComVar cv, PBPHost hv)
+{
+	int n;
+
+	if (hv->SendLen == 0)
+		return;
+	n = CommBinaryOut(cv, (PCHAR)hv->SendBuf, hv->SendLen);
+	hv->SendLen -= n;
+	memmove(hv->SendBuf, &hv->SendBuf[n], hv->SendLen);
+}
+
+static void BPHWrite(PComVar cv, PBPHost hv, const BYTE *b, int len)
+{
+	if (hv->SendLen + len <= (int)sizeof(hv->SendBuf)) {
+		memcpy(&hv->SendBuf[hv->SendLen], b, len);
+		hv->SendLen += len;
+	}
+	BPHFlush(cv, hv);
+}
+
+// 䕶ׂ͂ăNH[g
+static void BPHPut1Byte(BYTE *buf, int *ptr, BYTE b)
+{
+	if (b <= 0x1f) {
+		buf[(*ptr)++] = DLE;
+		b = b + 0x40;
+	}
+	else if (b >= 0x80 && b <= 0x9f) {
+		buf[(*ptr)++] = DLE;
+		b = b - 0x20;
+	}
+	buf[(*ptr)++] = b;
+}
+
+static void BPHSendPacket(PFileVarProto fv, PComVar cv, PBPHost hv, BYTE type, const BYTE *data, int len)
+{
+	BYTE seq = (BYTE)((hv->LastSeq + 1) % 10 + 0x30);
+	WORD check = (hv->CM == 1) ? 0xFFFF : 0;
+	int i, n = 0;
+
+	hv->PktOut[n++] = DLE;
+	hv->PktOut[n++] = 'B';
+	hv->PktOut[n++] = seq;
+	hv->PktOut[n++] = type;
+	BPHUpdateCheck(hv, &check, seq);
+	BPHUpdateCheck(hv, &check, type);
+	for (i = 0; i < len; i++) {
+		BPHPut1Byte(hv->PktOut, &n, data[i]);
+		BPHUpdateCheck(hv, &check, data[i]);
+	}
+	hv->PktOut[n++] = ETX;
+	BPHUpdateCheck(hv, &check, ETX);
+	if (hv->CM == 1) {
+		BPHPut1Byte(hv->PktOut, &n, HIBYTE(check));
+	}
+	BPHPut1Byte(hv->PktOut, &n, LOBYTE(check));
+	hv->PktOutLen = n;
+	BPHWrite(cv, hv, hv->PktOut, n);
+	hv->Retry = 0;
+	fv->FTSetTimeOut(fv, BPH_TIMEOUT);
+}
+
+static void BPHSendAck(PComVar cv, PBPHost hv)
+{
+	BYTE ack[2];
+	ack[0] = DLE;
+	ack[1] = (BYTE)(hv->LastSeq + 0x30);
+	BPHWrite(cv, hv, ack, 2);
+}
+
+static void BPHSendParam(PFileVarProto fv, PComVar cv, PBPHost hv)
+{
+	BYTE param[18];
+
+	memset(param, 0, sizeof(param));
+	param[0] = 0;		// WS
+	param[1] = 0;		// WR
+	param[2] = BPH_BS;	// BS
+	param[3] = 1;		// CM (CRC)
+	param[4] = 1;		// DQ
+	param[5] = 0;		// TL
+	// Q1-8 = 0 (NH[g̓NCAgɔC), DR, UR, FI = 0
+	BPHSendPacket(fv, cv, hv, '+', param, sizeof(param));
+	// '+' pPbgɂ ACK ł͂Ȃ NCAg '+' pPbgԂ
+	hv->LastSeq = (hv->LastSeq + 1) % 10;
+	hv->State = BPH_WaitParam;
+}
+
+static void BPHSendUpload(PFileVarProto fv, PComVar cv, PBPHost hv)
+{
+	static const BYTE upload[] = "UBupload.bin";
+	BPHSendPacket(fv, cv, hv, 'T', upload, sizeof(upload) - 1);
+	hv->State = BPH_WaitTAck;
+}
+
+// NCAg̃pPbg
+static void BPHParsePacket(PFileVarProto fv, PComVar cv, PBPHost hv)
+{
+	TFileIO *file = fv->file;
+	BYTE seq = (BYTE)(hv->PktIn[0] - 0x30);
+	BYTE type = hv->PktIn[1];
+
+	if (hv->Check != hv->CheckCalc || seq > 9) {
+		BPHWrite(cv, hv, (const BYTE *)"\025", 1);	// NAK
+		return;
+	}
+	if (seq == hv->LastSeq) {
+		// ACK ꂽ
+		BPHSendAck(cv, hv);
+		return;
+	}
+	if (seq != (hv->LastSeq + 1) % 10) {
+		BPHWrite(cv, hv, (const BYTE *)"\025", 1);
+		return;
+	}
+
+	switch (type) {
+	case '+':
+		if (hv->State != BPH_WaitParam)
+			break;
+		hv->LastSeq = seq;
+		BPHSendAck(cv, hv);
+		if (hv->PktInCount > 5) {
+			hv->CM = hv->PktIn[5];
+		}
+		BPHSendUpload(fv, cv, hv);
+		return;
+	case 'N':
+		if (hv->State == BPH_WaitTAck) {
+			// 'T'  ACK ꂽAf[^Ă
+			hv->State = BPH_RecvData;
+		}
+		if (hv->State != BPH_RecvData)
+			break;
+		hv->LastSeq = seq;
+		file->WriteFile(file, &hv->PktIn[2], hv->PktInCount - 2);
+		BPHSendAck(cv, hv);
+		fv->FTSetTimeOut(fv, BPH_TIMEOUT);
+		return;
+	case 'T':
+		if (hv->State != BPH_RecvData || hv->PktInCount < 3 || hv->PktIn[2] != 'C')
+			break;
+		hv->LastSeq = seq;
+		BPHSendAck(cv, hv);
+		file->Close(file);
+		hv->FileOpen = FALSE;
+		fv->Success = TRUE;
+		hv->State = BPH_Done;
+		return;
+	case 'F':
+		hv->State = BPH_Failure;
+		return;
+	}
+	hv->State = BPH_Failure;
+}
+
+static void BPHParseAck(PFileVarProto fv, PComVar cv, PBPHost hv, BYTE seq)
+{
+	if (hv->State != BPH_WaitTAck || seq != (hv->LastSeq + 1) % 10)
+		return;
+	hv->LastSeq = seq;
+	hv->State = BPH_RecvData;
+	fv->FTSetTimeOut(fv, BPH_TIMEOUT);
+	(void)cv;
+}
+
+static BOOL BPHInit(PFileVarProto fv, PComVar cv, PTTSet ts)
+{
+	PBPHost hv = fv->data;
+	TFileIO *file = fv->file;
+
+	(void)ts;
+	hv->FullName = fv->GetNextFname(fv);
+	if (hv->FullName == NULL || !file->OpenWrite(file, hv->FullName)) {
+		return FALSE;
+	}
+	hv->FileOpen = TRUE;
+	hv->State = BPH_WaitPlus;
+	hv->PktState = BPH_PktGetDLE;
+	hv->LastSeq = 0;
+	hv->CM = 0;
+	BPHWrite(cv, hv, (const BYTE *)"\005", 1);
+	fv->FTSetTimeOut(fv, BPH_TIMEOUT);
+	return TRUE;
+}
+
+static BOOL BPHParse(PFileVarProto fv, PComVar cv)
+{
+	PBPHost hv = fv->data;
+	BYTE b;
+
+	BPHFlush(cv, hv);
+	while (hv->State != BPH_Done && hv->State != BPH_Failure &&
+		   hv->SendLen == 0 && CommRead1Byte(cv, &b) == 1) {
+		switch (hv->PktState) {
+		case BPH_PktGetDLE:
+			if (b == DLE) {
+				hv->PktState = BPH_PktDLESeen;
+			}
+			else if (b == ENQ) {
+				BPHSendAck(cv, hv);
+			}
+			else if (b == NAK && hv->PktOutLen > 0 && hv->State != BPH_RecvData) {
+				BPHWrite(cv, hv, hv->PktOut, hv->PktOutLen);
+			}
+			break;
+		case BPH_PktDLESeen:
+			hv->PktState = BPH_PktGetDLE;
+			if (b == '+') {
+				if (hv->State == BPH_WaitPlus) {
+					BPHSendParam(fv, cv, hv);
+				}
+			}
+			else if (b == 'B') {
+				hv->PktInCount = 0;
+				hv->Quoted = FALSE;
+				hv->CheckCalc = (hv->CM == 1) ? 0xFFFF : 0;
+				hv->PktState = BPH_PktGetData;
+			}
+			else if (b >= '0' && b <= '9') {
+				BPHParseAck(fv, cv, hv, (BYTE)(b - 0x30));
+			}
+			break;
+		case BPH_PktGetData:
+			if (b == ETX) {
+				BPHUpdateCheck(hv, &hv->CheckCalc, b);
+				hv->Quoted = FALSE;
+				hv->Check = 0;
+				// '+' pPbg͌O̕ő
+				hv->CheckCount = (hv->CM == 1) ? 2 : 1;
+				hv->PktState = BPH_PktGetCheck;
+			}
+			else if (b == DLE) {
+				hv->Quoted = TRUE;
+			}
+			else if (b == ENQ) {
+				BPHSendAck(cv, hv);
+				hv->PktState = BPH_PktGetDLE;
+			}
+			else {
+				if (hv->Quoted) {
+					if (b >= 0x40 && b <= 0x5f)
+						b = b - 0x40;
+					else if (b >= 0x60 && b <= 0x7f)
+						b = b + 0x20;
+				}
+				hv->Quoted = FALSE;
+				if (hv->PktInCount < (int)sizeof(hv->PktIn)) {
+					BPHUpdateCheck(hv, &hv->CheckCalc, b);
+					hv->PktIn[hv->PktInCount++] = b;
+				}
+			}
+			break;
+		case BPH_PktGetCheck:
+			if (b == DLE) {
+				hv->Quoted = TRUE;
+				break;
+			}
+			if (hv->Quoted) {
+				if (b >= 0x40 && b <= 0x5f)
+					b = b - 0x40;
+				else if (b >= 0x60 && b <= 0x7f)
+					b = b + 0x20;
+			}
+			hv->Quoted = FALSE;
+			hv->Check = (WORD)((hv->Check << 8) + b);
+			if (--hv->CheckCount <= 0) {
+				hv->PktState = BPH_PktGetDLE;
+				if (hv->PktInCount >= 2) {
+					BPHParsePacket(fv, cv, hv);
+				}
+			}
+			break;
+		}
+	}
+
+	if (hv->State == BPH_Done || hv->State == BPH_Failure) {
+		BPHFlush(cv, hv);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static void BPHTimeOutProc(PFileVarProto fv, PComVar cv)
+{
+	PBPHost hv = fv->data;
+
+	if (++hv->Retry > BPH_RETRY_MAX) {
+		hv->State = BPH_Failure;
+		return;
+	}
+	switch (hv->State) {
+	case BPH_WaitPlus:
+		BPHWrite(cv, hv, (const BYTE *)"\005", 1);
+		break;
+	case BPH_WaitParam:
+	case BPH_WaitTAck:
+		BPHWrite(cv, hv, hv->PktOut, hv->PktOutLen);
+		break;
+	default:
+		break;
+	}
+	fv->FTSetTimeOut(fv, BPH_TIMEOUT);
+}
+
+static void BPHCancel(PFileVarProto fv, PComVar cv)
+{
+	PBPHost hv = fv->data;
+	(void)cv;
+	hv->State = BPH_Failure;
+}
+
+static int BPHSetOptV(PFileVarProto fv, int request, va_list ap)
+{
+	(void)fv;
+	(void)request;
+	(void)ap;
+	return 0;
+}
+
+static void BPHDestroy(PFileVarProto fv)
+{
+	PBPHost hv = fv->data;
+	if (hv->FileOpen) {
+		fv->file->Close(fv->file);
+	}
+	free(hv->FullName);
+	free(hv);
+	fv->data = NULL;
+}
+
+static const TProtoOp Op = {
+	BPHInit,
+	BPHParse,
+	BPHTimeOutProc,
+	BPHCancel,
+	BPHSetOptV,
+	BPHDestroy,
+};
+
+BOOL BPHostCreate(PFileVarProto fv)
+{
+	PBPHost hv = (PBPHost)calloc(1, sizeof(TBPHost));
+	if (hv == NULL) {
+		return FALSE;
+	}
+	fv->data = hv;
+	fv->ProtoOp = &Op;
+	return TRUE;
+}
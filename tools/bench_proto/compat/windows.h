@@ -0,0 +1,189 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *	Windows ȊOŃrhƂ windows.h
+ *		teraterm/ttpfile ̃vgR(tttypes.h, ttcommon.h, filesys_proto.h)
+ *		gp^ƃ}NACRT ֐`
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <wchar.h>
+#include <time.h>
+#include <sys/stat.h>
+
+typedef unsigned char BYTE;
+typedef BYTE *LPBYTE;
+typedef unsigned short WORD;
+typedef WORD *LPWORD;
+typedef uint32_t DWORD;
+typedef DWORD *LPDWORD;
+typedef int32_t LONG;
+typedef LONG *PLONG;
+typedef uint32_t ULONG;
+typedef uint64_t DWORD64;
+typedef int64_t LONGLONG;
+typedef uint64_t ULONGLONG;
+typedef int BOOL;
+typedef BOOL *PBOOL;
+typedef int INT;
+typedef unsigned int UINT;
+typedef char CHAR;
+typedef char *PCHAR;
+typedef char *LPSTR;
+typedef const char *LPCSTR;
+typedef wchar_t WCHAR;
+typedef wchar_t *LPWSTR;
+typedef const wchar_t *LPCWSTR;
+typedef void *LPVOID;
+typedef const void *LPCVOID;
+typedef void *HANDLE;
+typedef HANDLE HWND;
+typedef HANDLE HMENU;
+typedef HANDLE HICON;
+typedef HANDLE HFONT;
+typedef HANDLE HINSTANCE;
+typedef HANDLE HMODULE;
+typedef HANDLE HDC;
+typedef HANDLE HBITMAP;
+typedef HANDLE HBRUSH;
+typedef HANDLE HGLOBAL;
+typedef HANDLE HKEY;
+typedef uintptr_t UINT_PTR;
+typedef intptr_t INT_PTR;
+typedef uintptr_t WPARAM;
+typedef intptr_t LPARAM;
+typedef intptr_t LRESULT;
+typedef DWORD COLORREF;
+typedef struct { LONG x, y; } POINT;
+typedef struct { LONG left, top, right, bottom; } RECT;
+typedef struct { LONG cx, cy; } SIZE;
+typedef LRESULT (*WNDPROC)(HWND, UINT, WPARAM, LPARAM);
+
+#define LF_FACESIZE	32
+typedef struct {
+	LONG lfHeight, lfWidth, lfEscapement, lfOrientation, lfWeight;
+	BYTE lfItalic, lfUnderline, lfStrikeOut, lfCharSet;
+	BYTE lfOutPrecision, lfClipPrecision, lfQuality, lfPitchAndFamily;
+	CHAR lfFaceName[LF_FACESIZE];
+} LOGFONTA, *PLOGFONTA;
+typedef struct {
+	LONG lfHeight, lfWidth, lfEscapement, lfOrientation, lfWeight;
+	BYTE lfItalic, lfUnderline, lfStrikeOut, lfCharSet;
+	BYTE lfOutPrecision, lfClipPrecision, lfQuality, lfPitchAndFamily;
+	WCHAR lfFaceName[LF_FACESIZE];
+} LOGFONTW, *PLOGFONTW;
+typedef LOGFONTA LOGFONT, *PLOGFONT, *LPLOGFONT;
+
+#define TRUE	1
+#define FALSE	0
+#define MAX_PATH	260
+#define WINAPI
+#define CALLBACK
+#define PASCAL
+#define __declspec(x)
+#define __cdecl
+#define __stdcall
+
+#define WM_USER	0x0400
+#define MB_ICONEXCLAMATION	0x00000030
+
+#define LOBYTE(w)	((BYTE)((w) & 0xff))
+#define HIBYTE(w)	((BYTE)(((w) >> 8) & 0xff))
+#define LOWORD(l)	((WORD)((l) & 0xffff))
+#define HIWORD(l)	((WORD)(((l) >> 16) & 0xffff))
+
+#if !defined(__cplusplus)
+#define max(a, b)	(((a) > (b)) ? (a) : (b))
+#define min(a, b)	(((a) < (b)) ? (a) : (b))
+#endif
+
+#define _countof(a)	(sizeof(a) / sizeof((a)[0]))
+#define _strdup		strdup
+#define _wcsdup		wcsdup
+#define _atoi64		atoll
+#define _S_IFREG	S_IFREG
+#define _TRUNCATE	((size_t)-1)
+
+// _TRUNCATE w肵Ƃ̓삾
+#define _snprintf_s(buf, size, count, ...)	snprintf((buf), (size), __VA_ARGS__)
+#define _vsnprintf_s(buf, size, count, fmt, ap)	vsnprintf((buf), (size), (fmt), (ap))
+#define sscanf_s	sscanf
+#define localtime_s(tm, t)	localtime_r((t), (tm))
+
+static inline int strncpy_s(char *dest, size_t size, const char *src, size_t count)
+{
+	snprintf(dest, size, "%s", src);
+	(void)count;
+	return 0;
+}
+
+static inline int strncat_s(char *dest, size_t size, const char *src, size_t count)
+{
+	size_t len = strlen(dest);
+	if (len < size) {
+		snprintf(dest + len, size - len, "%s", src);
+	}
+	(void)count;
+	return 0;
+}
+
+static inline int memmove_s(void *dest, size_t size, const void *src, size_t count)
+{
+	if (count > size) {
+		return -1;
+	}
+	memmove(dest, src, count);
+	return 0;
+}
+
+static inline int ctime_s(char *buf, size_t size, const time_t *t)
+{
+	char tmp[26];
+	snprintf(buf, size, "%s", ctime_r(t, tmp));
+	return 0;
+}
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// nullcomm.c
+DWORD GetTickCount(void);
+int MessageBox(HWND hWnd, const char *text, const char *caption, UINT type);
+
+#if defined(__cplusplus)
+}
+#endif
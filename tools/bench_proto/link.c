@@ -0,0 +1,259 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *	zԂœ̃f for tools/bench_proto
+ *
+ *	Mf[^̓t[ɕAшŌ܂鎞ɉ֏o
+ *	x̌ɎM֓͂Bf[^̏ƃrbgB
+ *	̓t[̒̔Cӂ̈ʒuCӂ̒ (VÃI[o[Ȃ)B
+ *	t[ۂƎƁAM̋؂ƃvgR̃pPbgv邽
+ *	ZMODEM ̃TupPbĝ悤ɈʒuȂpPbgۂƏA
+ *	ۂ̉ł͋NȂołȂɂȂ
+ *	 seed 猈܂̂œł͓ʂɂȂ
+ */
+
+#include <math.h>
+
+#include "link.h"
+
+#define LINK_NEVER	1e30
+
+// xorshift64*
+static unsigned long long LinkRand(Link *link)
+{
+	unsigned long long x = link->rand_state;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	link->rand_state = x;
+	return x * 0x2545F4914F6CDD1DULL;
+}
+
+// (0, 1]
+static double LinkRandDouble(Link *link)
+{
+	return (double)((LinkRand(link) >> 11) + 1) / 9007199254740992.0;
+}
+
+// ̃rbg܂ł̃rbg (􉽕z)
+static unsigned long long LinkNextError(Link *link)
+{
+	double skip;
+
+	if (link->param.BitError <= 0) {
+		return ~0ULL;
+	}
+	if (link->param.BitError >= 1) {
+		return 0;
+	}
+	skip = log(LinkRandDouble(link)) / log(1.0 - link->param.BitError);
+	if (skip >= 1e18) {
+		return ~0ULL;
+	}
+	return (unsigned long long)skip;
+}
+
+void LinkInit(Link *link, const LinkParam *param, unsigned long long seed)
+{
+	memset(link, 0, sizeof(*link));
+	link->param = *param;
+	if (link->param.FrameSize <= 0) {
+		link->param.FrameSize = 1024;
+	}
+	link->rand_state = seed * 2 + 1;
+	link->error_skip = LinkNextError(link);
+}
+
+void LinkFree(Link *link)
+{
+	LinkFrame *f = link->head;
+	while (f != NULL) {
+		LinkFrame *next = f->next;
+		free(f);
+		f = next;
+	}
+	link->head = NULL;
+	link->tail = NULL;
+}
+
+// ܂ɏoĂȂoCg
+static double LinkBacklog(const Link *link, double now)
+{
+	if (link->param.Bandwidth <= 0 || link->wire_free <= now) {
+		return 0;
+	}
+	return (link->wire_free - now) * link->param.Bandwidth;
+}
+
+static void LinkAddErrors(Link *link, BYTE *data, int len)
+{
+	unsigned long long bits = (unsigned long long)len * 8;
+	unsigned long long pos = 0;
+
+	while (link->error_skip < bits - pos) {
+		pos += link->error_skip;
+		data[pos / 8] ^= (BYTE)(1 << (pos % 8));
+		link->stat.BitErrors++;
+		pos++;
+		link->error_skip = LinkNextError(link);
+	}
+	link->error_skip -= bits - pos;
+}
+
+/**
+ *	M
+ *	@return	󂯕toCg
+ *			Mobt@t̂Ƃ͈ꕔ܂ 0
+ */
+int LinkPut(Link *link, double now, const BYTE *data, int len)
+{
+	int accept = len;
+	int ptr = 0;
+
+	if (link->param.SendBuffer > 0) {
+		double room = link->param.SendBuffer - LinkBacklog(link, now);
+		if (room < 1) {
+			return 0;
+		}
+		if (accept > room) {
+			accept = (int)room;
+		}
+	}
+
+	while (ptr < accept) {
+		int n = accept - ptr;
+		double start = link->wire_free > now ? link->wire_free : now;
+		LinkFrame *f;
+		int lost_start = 0;
+		int lost_len = 0;
+
+		if (n > link->param.FrameSize) {
+			n = link->param.FrameSize;
+		}
+		link->wire_free = start;
+		if (link->param.Bandwidth > 0) {
+			link->wire_free += n / link->param.Bandwidth;
+		}
+		link->stat.Bytes += n;
+		link->stat.Frames++;
+
+		if (link->param.Drop > 0 && LinkRandDouble(link) <= link->param.Drop) {
+			link->stat.Dropped++;
+			lost_start = (int)(LinkRand(link) % (unsigned)n);
+			lost_len = 1 + (int)(LinkRand(link) % (unsigned)(n - lost_start));
+			if (lost_len == n) {
+				ptr += n;
+				continue;
+			}
+		}
+
+		f = (LinkFrame *)malloc(sizeof(LinkFrame) + n - lost_len);
+		if (f == NULL) {
+			break;
+		}
+		f->next = NULL;
+		f->arrival = link->wire_free + link->param.Latency;
+		f->len = n - lost_len;
+		f->ptr = 0;
+		memcpy(f->data, data + ptr, lost_start);
+		memcpy(f->data + lost_start, data + ptr + lost_start + lost_len, n - lost_start - lost_len);
+		LinkAddErrors(link, f->data, f->len);
+		if (link->tail == NULL) {
+			link->head = f;
+		}
+		else {
+			link->tail->next = f;
+		}
+		link->tail = f;
+		ptr += n;
+	}
+	return ptr;
+}
+
+/**
+ *	now ܂łɓ͂f[^M
+ *	@return	MoCg
+ */
+int LinkGet(Link *link, double now, BYTE *buf, int len)
+{
+	int count = 0;
+
+	while (link->head != NULL && count < len) {
+		LinkFrame *f = link->head;
+		int n;
+
+		if (f->arrival > now) {
+			break;
+		}
+		n = f->len - f->ptr;
+		if (n > len - count) {
+			n = len - count;
+		}
+		memcpy(buf + count, f->data + f->ptr, n);
+		f->ptr += n;
+		count += n;
+		if (f->ptr == f->len) {
+			link->head = f->next;
+			if (link->head == NULL) {
+				link->tail = NULL;
+			}
+			free(f);
+		}
+	}
+	return count;
+}
+
+/**
+ *	ɏԂς鎞
+ *	@param	want_send	Młɑ҂Ăf[^
+ *						Mobt@󂭎Ώۂɂ
+ */
+double LinkNextEvent(const Link *link, double now, BOOL want_send)
+{
+	double next = LINK_NEVER;
+
+	if (link->head != NULL) {
+		next = link->head->arrival;
+	}
+	if (want_send && link->param.SendBuffer > 0 && link->param.Bandwidth > 0) {
+		double t = link->wire_free - link->param.SendBuffer / 2 / link->param.Bandwidth;
+		if (t < now) {
+			t = now;
+		}
+		if (t < next) {
+			next = t;
+		}
+	}
+	return next;
+}
+
+BOOL LinkIdle(const Link *link)
+{
+	return link->head == NULL;
+}
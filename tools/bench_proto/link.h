@@ -0,0 +1,82 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* zԂœ̃f for tools/bench_proto */
+
+#pragma once
+
+#include <windows.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	double Bandwidth;	// byte/s, 0 ̂Ƃ
+	double Latency;		// Г̒x(b)
+	double BitError;	// rbg藦
+	double Drop;		// t[̈ꕔm
+	int FrameSize;		// Mf[^̒̃t[ɕ
+	int SendBuffer;		// ɏoĂȂf[^̃oCg܂Ŏ󂯕t(\Pbg̑Mobt@)
+} LinkParam;
+
+typedef struct {
+	unsigned long long Bytes;		// MoCg(ꂽ܂)
+	unsigned long long Frames;
+	unsigned long long Dropped;		// ꕔt[
+	unsigned long long BitErrors;	// ]rbg
+} LinkStat;
+
+typedef struct LinkFrame_ {
+	struct LinkFrame_ *next;
+	double arrival;		// Mɓ͂
+	int len;
+	int ptr;			// MɓnoCg
+	BYTE data[1];
+} LinkFrame;
+
+typedef struct {
+	LinkParam param;
+	LinkStat stat;
+	LinkFrame *head;
+	LinkFrame *tail;
+	double wire_free;	// 󂭎
+	unsigned long long rand_state;
+	unsigned long long error_skip;	// Ƀrbg𔽓]܂ł̃rbg
+} Link;
+
+void LinkInit(Link *link, const LinkParam *param, unsigned long long seed);
+void LinkFree(Link *link);
+int LinkPut(Link *link, double now, const BYTE *data, int len);
+int LinkGet(Link *link, double now, BYTE *buf, int len);
+double LinkNextEvent(const Link *link, double now, BOOL want_send);
+BOOL LinkIdle(const Link *link);
+
+#ifdef __cplusplus
+}
+#endif
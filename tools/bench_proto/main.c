@@ -0,0 +1,992 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *	t@C]vgR̃[vobNƃx`}[N
+ *		teraterm/ttpfile ̑MƎMzԂ̉(link.c)ŐڑA
+ *		шAxArbgAt[̏^ē]B
+ *		Mt@CƍA]xAđʁACPU Ԃ\
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+
+#include "tttypes.h"
+#include "ttcommon.h"
+#include "filesys_proto.h"
+#include "filesys_posix.h"
+#include "filesys_buffered.h"
+#include "xmodem.h"
+#include "ymodem.h"
+#include "zmodem.h"
+#include "bplus.h"
+#include "quickvan.h"
+#include "kermit.h"
+
+#include "link.h"
+#include "nullcomm.h"
+#include "bphost.h"
+
+#define DEFAULT_SIZE		(1024 * 1024)
+#define DEFAULT_BANDWIDTH	1000000.0
+#define DEFAULT_TIME_LIMIT	3600.0
+#define LINK_NEVER			1e30
+#define CPMEOF				0x1A
+
+typedef enum {
+	PORT_SERIAL,
+	PORT_TCP,
+	PORT_TELNET,
+} PortKind;
+
+typedef struct {
+	const char *Name;
+	BOOL (*Create)(PFileVarProto fv);		// M
+	BOOL (*CreatePeer)(PFileVarProto fv);	// M
+	int ModeReq;
+	int SendMode;
+	int RecvMode;
+	int OptReq;			// -1 ̂ƂȂ
+	int Opt;
+	int Opt2Req;
+	int Opt2;
+	WORD KermitOpt;
+	BOOL Padding;		// Ō̃ubN CPMEOF Ŗ߂
+	BOOL NoRecovery;	// 肩񕜂Ȃ(G[̂ł͎Ȃ)
+	BOOL WeakCheck;		// 6bit `FbNTȂ̂ŌƂ(G[̂ł͎Ȃ)
+} ProtoInfo;
+
+static const ProtoInfo Protocols[] = {
+	{ "xmodem", XCreate, XCreate, XMODEM_MODE, IdXSend, IdXReceive,
+	  XMODEM_OPT, XoptCheck, XMODEM_TEXT_FLAG, 0, 0, TRUE, FALSE, FALSE },
+	{ "xmodem-crc", XCreate, XCreate, XMODEM_MODE, IdXSend, IdXReceive,
+	  XMODEM_OPT, XoptCRC, XMODEM_TEXT_FLAG, 0, 0, TRUE, FALSE, FALSE },
+	{ "xmodem-1k", XCreate, XCreate, XMODEM_MODE, IdXSend, IdXReceive,
+	  XMODEM_OPT, Xopt1kCRC, XMODEM_TEXT_FLAG, 0, 0, TRUE, FALSE, FALSE },
+	{ "ymodem", YCreate, YCreate, YMODEM_MODE, IdYSend, IdYReceive,
+	  YMODEM_OPT, Yopt1K, -1, 0, 0, FALSE, FALSE, FALSE },
+	{ "ymodem-g", YCreate, YCreate, YMODEM_MODE, IdYSend, IdYReceive,
+	  YMODEM_OPT, YoptG, -1, 0, 0, FALSE, TRUE, FALSE },
+	{ "zmodem", ZCreate, ZCreate, ZMODEM_MODE, IdZSend, IdZReceive,
+	  ZMODEM_BINFLAG, TRUE, -1, 0, 0, FALSE, FALSE, FALSE },
+	{ "kermit", KmtCreate, KmtCreate, KMT_MODE, IdKmtSend, IdKmtReceive,
+	  -1, 0, -1, 0, KmtOptLongPacket | KmtOptFileAttr | KmtOptSlideWin | KmtOptStreaming, FALSE, FALSE, FALSE },
+	{ "kermit-classic", KmtCreate, KmtCreate, KMT_MODE, IdKmtSend, IdKmtReceive,
+	  -1, 0, -1, 0, 0, FALSE, FALSE, TRUE },
+	{ "bplus", BPCreate, BPHostCreate, BPLUS_MODE, IdBPSend, IdBPReceive,
+	  -1, 0, -1, 0, 0, FALSE, FALSE, FALSE },
+	{ "quickvan", QVCreate, QVCreate, QUICKVAN_MODE, IdQVSend, IdQVReceive,
+	  -1, 0, -1, 0, 0, FALSE, FALSE, FALSE },
+};
+
+typedef struct {
+	LinkParam Link;
+	PortKind Port;
+	unsigned long long Seed;
+	double TimeLimit;
+	int ZmodemWinSize;		// 0 ̂Ƃ zmodem.c ̊l
+} RunParam;
+
+typedef struct {
+	BOOL Ok;
+	const char *Error;
+	double Time;			// z(b)
+	unsigned long long Tx;	// M -> M̃oCg
+	unsigned long long Rx;	// M -> M̃oCg
+	unsigned long long Dropped;
+	unsigned long long BitErrors;
+	int TimeOuts;
+	double CpuSend;			// vgȐ(b)
+	double CpuRecv;
+} Result;
+
+/*
+ *	M/M
+ *		fv ͐擪ɒuAR[obN fv  Side 𓾂
+ */
+typedef struct {
+	TFileVarProto fv;
+	TComVar cv;
+	TTTSet ts;
+	char *FileName;		// Mt@C(XMODEM ̎M͎Mt@C)
+	char *RecvDir;
+	BOOL FileSent;
+	BOOL Active;
+	double Deadline;	// ^CAEg鎞, 0 ̂ƂȂ
+	double DoneTime;
+	int TimeOuts;
+	double Cpu;
+} Side;
+
+static double Now;
+static BOOL Verbose;
+
+static double CpuTime(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// fv ̃T[rX
+
+static char *GetNextFname(PFileVarProto fv)
+{
+	Side *s = (Side *)fv;
+	if (s->FileSent || s->FileName == NULL) {
+		return NULL;
+	}
+	s->FileSent = TRUE;
+	return strdup(s->FileName);
+}
+
+static char *GetRecievePath(PFileVarProto fv)
+{
+	Side *s = (Side *)fv;
+	return strdup(s->RecvDir);
+}
+
+static void FTSetTimeOut(PFileVarProto fv, int T)
+{
+	Side *s = (Side *)fv;
+	s->Deadline = (T == 0) ? 0 : Now + T;
+}
+
+static void SetDialogCation(PFileVarProto fv, const char *key, const wchar_t *default_caption)
+{
+	(void)fv;
+	(void)key;
+	(void)default_caption;
+}
+
+// \͂Ȃ
+static void InitDlgProgress(PFileVarProto fv, int *CurProgStat) { (void)fv; *CurProgStat = 0; }
+static void SetDlgTime(PFileVarProto fv, DWORD elapsed, unsigned long long bytes) { (void)fv; (void)elapsed; (void)bytes; }
+static void SetDlgPacketNum(PFileVarProto fv, LONG Num) { (void)fv; (void)Num; }
+static void SetDlgByteCount(PFileVarProto fv, unsigned long long Num) { (void)fv; (void)Num; }
+static void SetDlgPercent(PFileVarProto fv, unsigned long long a, unsigned long long b, int *p) { (void)fv; (void)a; (void)b; (void)p; }
+static void SetDlgProtoText(PFileVarProto fv, const char *text) { (void)fv; (void)text; }
+static void SetDlgProtoFileName(PFileVarProto fv, const char *text) { (void)fv; (void)text; }
+
+static const TInfoOp InfoOp = {
+	InitDlgProgress,
+	SetDlgTime,
+	SetDlgPacketNum,
+	SetDlgByteCount,
+	SetDlgPercent,
+	SetDlgProtoText,
+	SetDlgProtoFileName,
+};
+
+static int SetOpt(PFileVarProto fv, int request, ...)
+{
+	va_list ap;
+	int r;
+	va_start(ap, request);
+	r = fv->ProtoOp->SetOptV(fv, request, ap);
+	va_end(ap);
+	return r;
+}
+
+// ttset.c ̊l
+static void SetDefaultTTSet(PTTSet ts, const RunParam *rp, const ProtoInfo *p)
+{
+	memset(ts, 0, sizeof(*ts));
+	ts->Baud = rp->Link.Bandwidth > 0 ? (DWORD)(rp->Link.Bandwidth * 10) : 921600;
+	ts->DataBit = IdDataBit8;
+	ts->XmodemTimeOutInit = 10;
+	ts->XmodemTimeOutInitCRC = 3;
+	ts->XmodemTimeOutShort = 10;
+	ts->XmodemTimeOutLong = 20;
+	ts->XmodemTimeOutVLong = 60;
+	ts->YmodemTimeOutInit = 10;
+	ts->YmodemTimeOutInitCRC = 3;
+	ts->YmodemTimeOutShort = 10;
+	ts->YmodemTimeOutLong = 20;
+	ts->YmodemTimeOutVLong = 60;
+	ts->ZmodemTimeOutNormal = 10;
+	ts->ZmodemTimeOutTCPIP = 0;
+	ts->ZmodemTimeOutInit = 10;
+	ts->ZmodemTimeOutFin = 3;
+	ts->ZmodemDataLen = 0;
+	ts->ZmodemWinSize = rp->ZmodemWinSize;
+	ts->QVWinSize = 8;
+	ts->KermitOpt = p->KermitOpt;
+	ts->KermitWinSize = 31;
+	// zXg̃R}h͑Ȃ
+	ts->XModemRcvCommand[0] = 0;
+	ts->YModemRcvCommand[0] = 0;
+	ts->ZModemRcvCommand[0] = 0;
+}
+
+static BOOL SetupSide(Side *s, const ProtoInfo *p, BOOL send, const RunParam *rp)
+{
+	PFileVarProto fv = &s->fv;
+	PComVar cv = &s->cv;
+
+	fv->OverWrite = TRUE;
+	fv->NoMsg = !Verbose;
+	fv->file = FilesysCreateBuffered(FilesysCreatePosix(), 0);
+	fv->GetNextFname = GetNextFname;
+	fv->GetRecievePath = GetRecievePath;
+	fv->FTSetTimeOut = FTSetTimeOut;
+	fv->SetDialogCation = SetDialogCation;
+	fv->InfoOp = &InfoOp;
+
+	cv->Ready = TRUE;
+	cv->Open = TRUE;
+	cv->PortType = (rp->Port == PORT_SERIAL) ? IdSerial : IdTCPIP;
+	cv->TelFlag = (rp->Port == PORT_TELNET);
+	cv->InBuffMax = InBuffSizeMax;
+	cv->InBuff = (BYTE *)malloc(cv->InBuffMax);
+	if (cv->InBuff == NULL) {
+		return FALSE;
+	}
+	cv->ts = &s->ts;
+	SetDefaultTTSet(&s->ts, rp, p);
+
+	if (!(send ? p->Create(fv) : p->CreatePeer(fv))) {
+		return FALSE;
+	}
+	SetOpt(fv, p->ModeReq, send ? p->SendMode : p->RecvMode);
+	if (p->OptReq >= 0) {
+		SetOpt(fv, p->OptReq, p->Opt);
+	}
+	if (p->Opt2Req >= 0) {
+		SetOpt(fv, p->Opt2Req, p->Opt2);
+	}
+	s->Active = TRUE;
+	return TRUE;
+}
+
+static void FreeSide(Side *s)
+{
+	if (s->fv.ProtoOp != NULL) {
+		s->fv.ProtoOp->Destroy(&s->fv);
+	}
+	if (s->fv.file != NULL) {
+		s->fv.file->FileSysDestroy(s->fv.file);
+	}
+	free(s->cv.InBuff);
+}
+
+// vgȐ(CPU Ԃv)
+
+static BOOL CallInit(Side *s)
+{
+	double t = CpuTime();
+	BOOL r = s->fv.ProtoOp->Init(&s->fv, &s->cv, &s->ts);
+	s->Cpu += CpuTime() - t;
+	return r;
+}
+
+static BOOL CallParse(Side *s)
+{
+	double t = CpuTime();
+	BOOL r = s->fv.ProtoOp->Parse(&s->fv, &s->cv);
+	s->Cpu += CpuTime() - t;
+	return r;
+}
+
+static void CallTimeOut(Side *s)
+{
+	double t = CpuTime();
+	s->TimeOuts++;
+	s->fv.ProtoOp->TimeOutProc(&s->fv, &s->cv);
+	s->Cpu += CpuTime() - t;
+}
+
+// CommSend() 
+static int Transmit(Side *s, Link *link)
+{
+	PComVar cv = &s->cv;
+	int n;
+
+	if (cv->OutBuffCount == 0) {
+		return 0;
+	}
+	n = LinkPut(link, Now, &cv->OutBuff[cv->OutPtr], cv->OutBuffCount);
+	cv->OutPtr += n;
+	cv->OutBuffCount -= n;
+	if (cv->OutBuffCount == 0) {
+		cv->OutPtr = 0;
+	}
+	return n;
+}
+
+// CommReceive() 
+static int Receive(Side *s, Link *link)
+{
+	PComVar cv = &s->cv;
+	int room;
+
+	if (!s->Active) {
+		// ]̏Iɓ͎͂̂̂Ă
+		static BYTE discard[4096];
+		int n, total = 0;
+		cv->InBuffCount = 0;
+		cv->InPtr = 0;
+		while ((n = LinkGet(link, Now, discard, sizeof(discard))) > 0) {
+			total += n;
+		}
+		return total;
+	}
+
+	if (cv->InBuffCount == 0) {
+		cv->InPtr = 0;
+	}
+	else if (cv->InPtr > 0 && cv->InBuffMax - (cv->InPtr + cv->InBuffCount) < 4096) {
+		memmove(cv->InBuff, &cv->InBuff[cv->InPtr], cv->InBuffCount);
+		cv->InPtr = 0;
+	}
+	room = cv->InBuffMax - (cv->InPtr + cv->InBuffCount);
+	if (room <= 0) {
+		return 0;
+	}
+	room = LinkGet(link, Now, &cv->InBuff[cv->InPtr + cv->InBuffCount], room);
+	cv->InBuffCount += room;
+	return room;
+}
+
+static BOOL ParseSide(Side *s)
+{
+	int in = s->cv.InBuffCount;
+	int out = s->cv.OutBuffCount;
+	double deadline = s->Deadline;
+
+	if (!s->Active) {
+		return FALSE;
+	}
+	if (!CallParse(s)) {
+		s->Active = FALSE;
+		s->Deadline = 0;
+		s->DoneTime = Now;
+		return TRUE;
+	}
+	return in != s->cv.InBuffCount || out != s->cv.OutBuffCount || deadline != s->Deadline;
+}
+
+static double SideNextEvent(const Side *s, const Link *out, double next)
+{
+	double t = LinkNextEvent(out, Now, s->cv.OutBuffCount > 0);
+	if (t < next) {
+		next = t;
+	}
+	if (s->Active && s->Deadline != 0 && s->Deadline < next) {
+		next = s->Deadline;
+	}
+	return next;
+}
+
+// Mt@Cƍ
+static const char *Compare(const char *src, const char *dst, BOOL padding)
+{
+	FILE *a = fopen(src, "rb");
+	FILE *b = fopen(dst, "rb");
+	const char *error = NULL;
+	static BYTE ba[65536], bb[65536];
+	static char msg[64];
+	size_t na, nb, i;
+	unsigned long long offset = 0;
+	unsigned long long extra = 0;
+
+	if (a == NULL || b == NULL) {
+		error = "no file";
+		goto end;
+	}
+	for (;;) {
+		na = fread(ba, 1, sizeof(ba), a);
+		nb = fread(bb, 1, na == 0 ? sizeof(bb) : na, b);
+		if (na == 0) {
+			break;
+		}
+		for (i = 0; i < nb && ba[i] == bb[i]; i++) {
+		}
+		if (i < na) {
+			snprintf(msg, sizeof(msg), "mismatch at %llu", offset + i);
+			error = msg;
+			goto end;
+		}
+		offset += na;
+	}
+	// XMODEM ͍Ō̃ubN̎c CPMEOF Ŗ߂
+	while (nb > 0) {
+		for (i = 0; i < nb; i++) {
+			if (!padding || bb[i] != CPMEOF) {
+				error = "size mismatch";
+				goto end;
+			}
+		}
+		extra += nb;
+		nb = fread(bb, 1, sizeof(bb), b);
+	}
+	if (extra >= 1024) {
+		error = "size mismatch";
+	}
+end:
+	if (a != NULL) {
+		fclose(a);
+	}
+	if (b != NULL) {
+		fclose(b);
+	}
+	return error;
+}
+
+static char *PathJoin(const char *dir, const char *name)
+{
+	size_t len = strlen(dir) + strlen(name) + 1;
+	char *path = (char *)malloc(len);
+	snprintf(path, len, "%s%s", dir, name);
+	return path;
+}
+
+/**
+ *	MtH_̃t@CT
+ *		Mt@C̓vgRɂĕς(Quick-VAN ͑啶Ȃ)
+ *	@return	t@C1̂Ƃ̃t@C
+ */
+static char *FindReceived(const char *recv_dir)
+{
+	DIR *dir = opendir(recv_dir);
+	struct dirent *e;
+	char *found = NULL;
+	int count = 0;
+
+	if (dir == NULL) {
+		return NULL;
+	}
+	while ((e = readdir(dir)) != NULL) {
+		if (e->d_name[0] == '.') {
+			continue;
+		}
+		if (count++ == 0) {
+			found = PathJoin(recv_dir, e->d_name);
+		}
+	}
+	closedir(dir);
+	if (count != 1) {
+		free(found);
+		return NULL;
+	}
+	return found;
+}
+
+static void ClearDir(const char *recv_dir)
+{
+	DIR *dir = opendir(recv_dir);
+	struct dirent *e;
+
+	if (dir == NULL) {
+		return;
+	}
+	while ((e = readdir(dir)) != NULL) {
+		if (e->d_name[0] != '.') {
+			char *path = PathJoin(recv_dir, e->d_name);
+			remove(path);
+			free(path);
+		}
+	}
+	closedir(dir);
+}
+
+static const char *BaseName(const char *path)
+{
+	const char *p = strrchr(path, '/');
+	return p != NULL ? p + 1 : path;
+}
+
+/**
+ *	1]
+ */
+static void Run(const ProtoInfo *p, const RunParam *rp, const char *src, const char *recv_dir, Result *r)
+{
+	Side *snd = (Side *)calloc(1, sizeof(Side));
+	Side *rcv = (Side *)calloc(1, sizeof(Side));
+	Link up, down;
+	char *dst = PathJoin(recv_dir, BaseName(src));
+
+	memset(r, 0, sizeof(*r));
+	ClearDir(recv_dir);
+	Now = 0;
+	NullCommSetTime(Now);
+	LinkInit(&up, &rp->Link, rp->Seed);
+	LinkInit(&down, &rp->Link, rp->Seed + 1);
+
+	snd->FileName = strdup(src);
+	snd->RecvDir = strdup(recv_dir);
+	rcv->FileName = strdup(dst);
+	rcv->RecvDir = strdup(recv_dir);
+
+	if (!SetupSide(snd, p, TRUE, rp) || !SetupSide(rcv, p, FALSE, rp)) {
+		r->Error = "create";
+		goto end;
+	}
+	if (!CallInit(rcv) || !CallInit(snd)) {
+		r->Error = "init";
+		goto end;
+	}
+
+	while (snd->Active || rcv->Active) {
+		BOOL progress = FALSE;
+		double next;
+
+		progress |= ParseSide(snd);
+		progress |= ParseSide(rcv);
+		progress |= Transmit(snd, &up) > 0;
+		progress |= Transmit(rcv, &down) > 0;
+		progress |= Receive(rcv, &up) > 0;
+		progress |= Receive(snd, &down) > 0;
+		if (progress) {
+			continue;
+		}
+
+		// NȂȂ玟̎ۂ̎܂Ői߂
+		next = SideNextEvent(snd, &up, LINK_NEVER);
+		next = SideNextEvent(rcv, &down, next);
+		if (next >= LINK_NEVER) {
+			r->Error = "stalled";
+			break;
+		}
+		if (next > rp->TimeLimit) {
+			r->Error = "time limit";
+			break;
+		}
+		if (next > Now) {
+			Now = next;
+			NullCommSetTime(Now);
+		}
+		if (snd->Active && snd->Deadline != 0 && snd->Deadline <= Now) {
+			snd->Deadline = 0;
+			CallTimeOut(snd);
+		}
+		if (rcv->Active && rcv->Deadline != 0 && rcv->Deadline <= Now) {
+			rcv->Deadline = 0;
+			CallTimeOut(rcv);
+		}
+	}
+	r->Time = snd->DoneTime > rcv->DoneTime ? snd->DoneTime : rcv->DoneTime;
+	if (r->Error != NULL) {
+		r->Time = Now;
+	}
+
+	if (r->Error == NULL && (!snd->fv.Success || !rcv->fv.Success)) {
+		r->Error = "failed";
+	}
+
+end:
+	r->Tx = up.stat.Bytes;
+	r->Rx = down.stat.Bytes;
+	r->Dropped = up.stat.Dropped + down.stat.Dropped;
+	r->BitErrors = up.stat.BitErrors + down.stat.BitErrors;
+	r->TimeOuts = snd->TimeOuts + rcv->TimeOuts;
+	r->CpuSend = snd->Cpu;
+	r->CpuRecv = rcv->Cpu;
+
+	FreeSide(snd);
+	FreeSide(rcv);
+	LinkFree(&up);
+	LinkFree(&down);
+
+	if (r->Error == NULL) {
+		char *received = FindReceived(recv_dir);
+		r->Error = (received == NULL) ? "no file" : Compare(src, received, p->Padding);
+		free(received);
+	}
+	r->Ok = (r->Error == NULL);
+	ClearDir(recv_dir);
+
+	free(snd->FileName);
+	free(snd->RecvDir);
+	free(rcv->FileName);
+	free(rcv->RecvDir);
+	free(snd);
+	free(rcv);
+	free(dst);
+}
+
+static const char *PortName(PortKind port)
+{
+	switch (port) {
+	case PORT_SERIAL:	return "serial";
+	case PORT_TCP:		return "tcp";
+	case PORT_TELNET:	return "telnet";
+	}
+	return "";
+}
+
+static void PrintLink(const RunParam *rp)
+{
+	printf("link: %s", PortName(rp->Port));
+	if (rp->Link.Bandwidth > 0) {
+		printf(" %.0f byte/s", rp->Link.Bandwidth);
+	}
+	else {
+		printf(" unlimited");
+	}
+	printf(", latency %.0f ms", rp->Link.Latency * 1000);
+	if (rp->Link.BitError > 0) {
+		printf(", ber %g", rp->Link.BitError);
+	}
+	if (rp->Link.Drop > 0) {
+		printf(", drop %g", rp->Link.Drop);
+	}
+	printf("\n");
+}
+
+static void PrintHeader(void)
+{
+	printf("%-15s %9s %10s %6s %10s %9s %8s %5s %9s %9s  %s\n",
+		   "protocol", "sec", "KB/s", "eff%", "tx KB", "rx KB", "resent%", "tmo", "cpu snd", "cpu rcv", "result");
+}
+
+static BOOL RunAndPrint(const ProtoInfo *p, const RunParam *rp, const char *src, const char *recv_dir, unsigned long long size)
+{
+	Result r, ref;
+	double kbs = 0, eff = 0;
+	char resent[16] = "-";
+
+	Run(p, rp, src, recv_dir, &r);
+
+	// ̂Ȃł̑MʂƂ̍đʂƂ
+	if (rp->Link.BitError > 0 || rp->Link.Drop > 0) {
+		RunParam clean = *rp;
+		clean.Link.BitError = 0;
+		clean.Link.Drop = 0;
+		Run(p, &clean, src, recv_dir, &ref);
+		if (ref.Ok) {
+			double d = (double)r.Tx - (double)ref.Tx;
+			snprintf(resent, sizeof(resent), "%.1f", d > 0 ? d * 100 / (double)ref.Tx : 0.0);
+		}
+	}
+
+	if (r.Ok && r.Time > 0) {
+		kbs = (double)size / r.Time / 1024;
+		if (rp->Link.Bandwidth > 0) {
+			eff = (double)size / r.Time / rp->Link.Bandwidth * 100;
+		}
+	}
+	printf("%-15s %9.2f %10.1f %6.1f %10.1f %9.1f %8s %5d %9.3f %9.3f  %s\n",
+		   p->Name, r.Time, kbs, eff, (double)r.Tx / 1024, (double)r.Rx / 1024, resent,
+		   r.TimeOuts, r.CpuSend, r.CpuRecv, r.Ok ? "ok" : r.Error);
+	fflush(stdout);
+	return r.Ok;
+}
+
+// ̃t@C
+static BOOL MakeFile(const char *path, unsigned long long size, unsigned long long seed)
+{
+	FILE *fp = fopen(path, "wb");
+	unsigned long long x = seed * 2 + 1;
+	BYTE buf[4096];
+
+	if (fp == NULL) {
+		return FALSE;
+	}
+	while (size > 0) {
+		size_t n = size < sizeof(buf) ? (size_t)size : sizeof(buf);
+		size_t i;
+		for (i = 0; i < n; i++) {
+			x ^= x >> 12;
+			x ^= x << 25;
+			x ^= x >> 27;
+			buf[i] = (BYTE)((x * 0x2545F4914F6CDD1DULL) >> 56);
+		}
+		fwrite(buf, 1, n, fp);
+		size -= n;
+	}
+	fclose(fp);
+	return TRUE;
+}
+
+static const ProtoInfo *FindProto(const char *name)
+{
+	size_t i;
+	for (i = 0; i < _countof(Protocols); i++) {
+		if (strcmp(Protocols[i].Name, name) == 0) {
+			return &Protocols[i];
+		}
+	}
+	return NULL;
+}
+
+/*
+ *	AeXg
+ *		SvgR̉œ]
+ */
+static int Regression(const RunParam *base, const char *src, const char *recv_dir, unsigned long long size)
+{
+	static const struct {
+		PortKind Port;
+		double Bandwidth;
+		double Latency;
+		double BitError;
+		double Drop;
+	} Cond[] = {
+		{ PORT_SERIAL, 11520, 0, 0, 0 },			// 115200bps
+		{ PORT_SERIAL, 1000000, 0.1, 0, 0 },		// x̑傫
+		{ PORT_SERIAL, 1000000, 0.01, 1e-6, 0.005 },	// ̂
+		{ PORT_TCP, 10000000, 0.05, 0, 0 },
+		{ PORT_TELNET, 10000000, 0.05, 0, 0 },
+	};
+	// ZMODEM ͊lȊÕEBhE
+	static const struct {
+		const char *Name;
+		int WinSize;
+	} ZWin[] = {
+		{ "zmodem-w32k", 32767 },
+		{ "zmodem-stream", -1 },
+	};
+	size_t c, i;
+	int errors = 0;
+
+	for (c = 0; c < _countof(Cond); c++) {
+		RunParam rp = *base;
+		BOOL noisy = Cond[c].BitError > 0 || Cond[c].Drop > 0;
+
+		rp.Port = Cond[c].Port;
+		rp.Link.Bandwidth = Cond[c].Bandwidth;
+		rp.Link.Latency = Cond[c].Latency;
+		rp.Link.BitError = Cond[c].BitError;
+		rp.Link.Drop = Cond[c].Drop;
+
+		if (c > 0) {
+			printf("\n");
+		}
+		PrintLink(&rp);
+		PrintHeader();
+		for (i = 0; i < _countof(Protocols); i++) {
+			if (noisy && (Protocols[i].NoRecovery || Protocols[i].WeakCheck)) {
+				continue;
+			}
+			if (!RunAndPrint(&Protocols[i], &rp, src, recv_dir, size)) {
+				errors++;
+			}
+		}
+		for (i = 0; i < _countof(ZWin); i++) {
+			ProtoInfo z = *FindProto("zmodem");
+			RunParam zrp = rp;
+
+			z.Name = ZWin[i].Name;
+			zrp.ZmodemWinSize = ZWin[i].WinSize;
+			if (!RunAndPrint(&z, &zrp, src, recv_dir, size)) {
+				errors++;
+			}
+		}
+	}
+	printf("\nregression: %s (%d errors)\n", errors == 0 ? "ok" : "NG", errors);
+	return errors;
+}
+
+static void Usage(void)
+{
+	size_t i;
+
+	printf(
+		"bench_proto [options] [protocol ...]\n"
+		"  -s size     file size in bytes (default %d)\n"
+		"  -f file     file to send (default random data)\n"
+		"  -b byte/s   link bandwidth, 0 = unlimited (default %.0f)\n"
+		"  -l ms       one-way latency (default 0)\n"
+		"  -e ber      bit error rate (default 0)\n"
+		"  -d rate     rate of frames losing a burst of bytes (default 0)\n"
+		"  -m size     frame size (default 1024)\n"
+		"  -w size     send buffer, 0 = unlimited (default 65536)\n"
+		"  -t port     serial, tcp, telnet (default serial)\n"
+		"  -r seed     random seed (default 1)\n"
+		"  -T sec      give up after this virtual time (default %.0f)\n"
+		"  -W size     ZMODEM window, 0 = auto, -1 = streaming (default 0)\n"
+		"  -a          regression: all protocols x built-in link conditions\n"
+		"  -v          show protocol error messages\n"
+		"protocol:\n ",
+		DEFAULT_SIZE, DEFAULT_BANDWIDTH, DEFAULT_TIME_LIMIT);
+	for (i = 0; i < _countof(Protocols); i++) {
+		printf(" %s", Protocols[i].Name);
+	}
+	printf("\n");
+}
+
+int main(int argc, char *argv[])
+{
+	RunParam rp;
+	unsigned long long size = DEFAULT_SIZE;
+	const char *file = NULL;
+	const ProtoInfo *list[_countof(Protocols)];
+	size_t count = 0;
+	BOOL regression = FALSE;
+	char work[] = "/tmp/bench_proto.XXXXXX";
+	char *src, *recv_dir;
+	int errors = 0;
+	int i;
+
+	memset(&rp, 0, sizeof(rp));
+	rp.Link.Bandwidth = DEFAULT_BANDWIDTH;
+	rp.Link.FrameSize = 1024;
+	rp.Link.SendBuffer = 65536;
+	rp.Port = PORT_SERIAL;
+	rp.Seed = 1;
+	rp.TimeLimit = DEFAULT_TIME_LIMIT;
+
+	for (i = 1; i < argc; i++) {
+		const char *arg = argv[i];
+		const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+		if (arg[0] != '-') {
+			const ProtoInfo *p = FindProto(arg);
+			if (p == NULL || count >= _countof(list)) {
+				Usage();
+				return 1;
+			}
+			list[count++] = p;
+			continue;
+		}
+		if (strcmp(arg, "-a") == 0) {
+			regression = TRUE;
+			continue;
+		}
+		if (strcmp(arg, "-v") == 0) {
+			Verbose = TRUE;
+			continue;
+		}
+		if (val == NULL) {
+			Usage();
+			return 1;
+		}
+		i++;
+		if (strcmp(arg, "-s") == 0) {
+			size = strtoull(val, NULL, 0);
+		}
+		else if (strcmp(arg, "-f") == 0) {
+			file = val;
+		}
+		else if (strcmp(arg, "-b") == 0) {
+			rp.Link.Bandwidth = atof(val);
+		}
+		else if (strcmp(arg, "-l") == 0) {
+			rp.Link.Latency = atof(val) / 1000;
+		}
+		else if (strcmp(arg, "-e") == 0) {
+			rp.Link.BitError = atof(val);
+		}
+		else if (strcmp(arg, "-d") == 0) {
+			rp.Link.Drop = atof(val);
+		}
+		else if (strcmp(arg, "-m") == 0) {
+			rp.Link.FrameSize = atoi(val);
+		}
+		else if (strcmp(arg, "-w") == 0) {
+			rp.Link.SendBuffer = atoi(val);
+		}
+		else if (strcmp(arg, "-t") == 0) {
+			if (strcmp(val, "serial") == 0) {
+				rp.Port = PORT_SERIAL;
+			}
+			else if (strcmp(val, "tcp") == 0) {
+				rp.Port = PORT_TCP;
+			}
+			else if (strcmp(val, "telnet") == 0) {
+				rp.Port = PORT_TELNET;
+			}
+			else {
+				Usage();
+				return 1;
+			}
+		}
+		else if (strcmp(arg, "-r") == 0) {
+			rp.Seed = strtoull(val, NULL, 0);
+		}
+		else if (strcmp(arg, "-T") == 0) {
+			rp.TimeLimit = atof(val);
+		}
+		else if (strcmp(arg, "-W") == 0) {
+			rp.ZmodemWinSize = atoi(val);
+		}
+		else {
+			Usage();
+			return 1;
+		}
+	}
+	if (count == 0) {
+		for (count = 0; count < _countof(Protocols); count++) {
+			list[count] = &Protocols[count];
+		}
+	}
+	NullCommSetMessage(Verbose);
+
+	if (mkdtemp(work) == NULL) {
+		perror("mkdtemp");
+		return 1;
+	}
+	recv_dir = PathJoin(work, "/recv/");
+	mkdir(recv_dir, 0700);
+	if (file != NULL) {
+		struct stat st;
+		if (stat(file, &st) != 0) {
+			perror(file);
+			return 1;
+		}
+		src = strdup(file);
+		size = (unsigned long long)st.st_size;
+	}
+	else {
+		src = PathJoin(work, "/data.bin");
+		if (!MakeFile(src, size, rp.Seed)) {
+			perror(src);
+			return 1;
+		}
+	}
+	printf("file: %s, %llu bytes\n", file != NULL ? file : "random", size);
+
+	if (regression) {
+		errors = Regression(&rp, src, recv_dir, size);
+	}
+	else {
+		size_t n;
+		PrintLink(&rp);
+		PrintHeader();
+		for (n = 0; n < count; n++) {
+			if (!RunAndPrint(list[n], &rp, src, recv_dir, size)) {
+				errors++;
+			}
+		}
+	}
+
+	if (file == NULL) {
+		remove(src);
+	}
+	rmdir(recv_dir);
+	rmdir(work);
+	free(src);
+	free(recv_dir);
+	return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *	TComVar ̑M֐Ȃ for tools/bench_proto
+ *		CommRead1Byte() Ȃǂ ttpcmn/ttcmn.c Ɠ
+ *		(telnet  IAC, CR NUL ̏܂)
+ *		GetTickCount() ͉f̉zԂ
+ */
+
+#include <windows.h>
+
+#include "tttypes.h"
+#include "ttcommon.h"
+#include "ttlib.h"
+#include "protolog.h"
+
+#include "nullcomm.h"
+
+static double Now;
+static BOOL ShowMessage;
+
+void NullCommSetTime(double now)
+{
+	Now = now;
+}
+
+void NullCommSetMessage(BOOL show)
+{
+	ShowMessage = show;
+}
+
+DWORD GetTickCount(void)
+{
+	return (DWORD)(Now * 1000);
+}
+
+int MessageBox(HWND hWnd, const char *text, const char *caption, UINT type)
+{
+	(void)hWnd;
+	(void)type;
+	if (ShowMessage) {
+		fprintf(stderr, "%s: %s\n", caption, text);
+	}
+	return 0;
+}
+
+int TTMessageBoxW(HWND hWnd, const TTMessageBoxInfoW *info, const wchar_t *UILanguageFile, ...)
+{
+	(void)hWnd;
+	(void)UILanguageFile;
+	if (ShowMessage) {
+		fprintf(stderr, "%ls: %ls\n", info->title_default, info->message_default);
+	}
+	return 0;
+}
+
+int PASCAL CommReadRawByte(PComVar cv, LPBYTE b)
+{
+	if ( ! cv->Ready ) {
+		return 0;
+	}
+
+	if ( cv->InBuffCount>0 ) {
+		*b = cv->InBuff[cv->InPtr];
+		cv->InPtr++;
+		cv->InBuffCount--;
+		if ( cv->InBuffCount==0 ) {
+			cv->InPtr = 0;
+		}
+		return 1;
+	}
+	else {
+		cv->InPtr = 0;
+		return 0;
+	}
+}
+
+void PASCAL CommInsert1Byte(PComVar cv, BYTE b)
+{
+	if ( ! cv->Ready ) {
+		return;
+	}
+
+	if (cv->InPtr == 0) {
+		if (cv->InBuffCount >= cv->InBuffMax) {
+			return;
+		}
+		memmove(&(cv->InBuff[1]),&(cv->InBuff[0]),cv->InBuffCount);
+	}
+	else {
+		cv->InPtr--;
+	}
+	cv->InBuff[cv->InPtr] = b;
+	cv->InBuffCount++;
+}
+
+int PASCAL CommRead1Byte(PComVar cv, LPBYTE b)
+{
+	int c;
+
+	if ( ! cv->Ready ) {
+		return 0;
+	}
+
+	if ( cv->TelMode ) {
+		c = 0;
+	}
+	else {
+		c = CommReadRawByte(cv,b);
+	}
+
+	if ((c==1) && cv->TelCRFlag) {
+		cv->TelCRFlag = FALSE;
+		if (*b==0) {
+			c = 0;
+		}
+	}
+
+	if ( c==1 ) {
+		if ( cv->IACFlag ) {
+			cv->IACFlag = FALSE;
+			if ( *b != 0xFF ) {
+				// telnet ̃R}h͈Ȃ
+				cv->TelMode = TRUE;
+				CommInsert1Byte(cv,*b);
+				c = 0;
+			}
+		}
+		else if ((cv->PortType==IdTCPIP) && (*b==0xFF)) {
+			if (cv->TelFlag) {
+				cv->IACFlag = TRUE;
+				c = 0;
+			}
+		}
+		else if (cv->TelFlag && ! cv->TelBinRecv && (*b==0x0D)) {
+			cv->TelCRFlag = TRUE;
+		}
+	}
+
+	if ((c == 1) && (cv->Log1Bin != NULL)) {
+		cv->Log1Bin(*b);
+	}
+
+	return c;
+}
+
+int PASCAL CommRawOut(PComVar cv, PCHAR B, int C)
+{
+	int a;
+
+	if ( ! cv->Ready ) {
+		return C;
+	}
+
+	if (C > OutBuffSize - cv->OutBuffCount) {
+		a = OutBuffSize - cv->OutBuffCount;
+	}
+	else {
+		a = C;
+	}
+	if ( cv->OutPtr > 0 ) {
+		memmove(&(cv->OutBuff[0]),&(cv->OutBuff[cv->OutPtr]),cv->OutBuffCount);
+		cv->OutPtr = 0;
+	}
+	memcpy(&(cv->OutBuff[cv->OutBuffCount]),B,a);
+	cv->OutBuffCount = cv->OutBuffCount + a;
+	return a;
+}
+
+int PASCAL CommBinaryOut(PComVar cv, const char *B, int C)
+{
+	int a, i, Len;
+	char d[3];
+
+	if ( ! cv->Ready ) {
+		return C;
+	}
+
+	i = 0;
+	a = 1;
+	while ((a>0) && (i<C)) {
+		Len = 0;
+
+		d[Len] = B[i];
+		Len++;
+
+		if ( cv->TelFlag && (B[i]=='\x0d') && ! cv->TelBinSend ) {
+			d[Len++] = '\x00';
+		}
+		else if ( cv->TelFlag && (B[i]=='\xff') ) {
+			d[Len++] = '\xff';
+		}
+
+		if ( OutBuffSize - cv->OutBuffCount - Len >= 0 ) {
+			CommRawOut(cv, d, Len);
+			a = 1;
+		}
+		else {
+			a = 0;
+		}
+
+		i += a;
+	}
+	return i;
+}
+
+// O͎Ȃ
+static BOOL LogOpen(TProtoLog *pv, const char *file) { (void)pv; (void)file; return TRUE; }
+static BOOL LogOpenW(TProtoLog *pv, const wchar_t *file) { (void)pv; (void)file; return TRUE; }
+static void LogClose(TProtoLog *pv) { (void)pv; }
+static void LogSetFolderW(TProtoLog *pv, const wchar_t *folder) { (void)pv; (void)folder; }
+static size_t LogWriteRaw(TProtoLog *pv, const void *data, size_t len) { (void)pv; (void)data; return len; }
+static size_t LogWriteStr(TProtoLog *pv, const char *str) { (void)pv; return strlen(str); }
+static void LogDumpByte(TProtoLog *pv, BYTE b) { (void)pv; (void)b; }
+static void LogDumpFlush(TProtoLog *pv) { (void)pv; }
+static void LogDestroy(TProtoLog *pv) { free(pv); }
+
+TProtoLog *ProtoLogCreate(void)
+{
+	TProtoLog *pv = (TProtoLog *)calloc(1, sizeof(TProtoLog));
+	if (pv == NULL) {
+		return NULL;
+	}
+	pv->Open = LogOpen;
+	pv->OpenA = LogOpen;
+	pv->OpenW = LogOpenW;
+	pv->OpenU8 = LogOpen;
+	pv->Close = LogClose;
+	pv->SetFolderW = LogSetFolderW;
+	pv->WriteRaw = LogWriteRaw;
+	pv->WriteStr = LogWriteStr;
+	pv->DumpByte = LogDumpByte;
+	pv->DumpFlush = LogDumpFlush;
+	pv->Destory = LogDestroy;
+	return pv;
+}
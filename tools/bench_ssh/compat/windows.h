@@ -0,0 +1,178 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *	Windows ȊOŃrhƂ windows.h
+ *		ttxssh.h (tttypes.h, ttplugin.h Ȃ)  ttxssh ̈Í/pPbg
+ *		gp^ƃ}N`
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <time.h>
+
+typedef unsigned char BYTE;
+typedef BYTE *LPBYTE;
+typedef unsigned short WORD;
+typedef uint32_t DWORD;
+typedef DWORD *LPDWORD;
+typedef int32_t LONG;
+typedef uint32_t ULONG;
+typedef uint64_t DWORD64;
+typedef int64_t LONGLONG;
+typedef uint64_t ULONGLONG;
+typedef int BOOL;
+typedef BOOL *PBOOL;
+typedef int INT;
+typedef unsigned int UINT;
+typedef char CHAR;
+typedef char *PCHAR;
+typedef char *LPSTR;
+typedef const char *LPCSTR;
+typedef wchar_t WCHAR;
+typedef wchar_t *LPWSTR;
+typedef const wchar_t *LPCWSTR;
+typedef void *LPVOID;
+typedef const void *LPCVOID;
+typedef void *HANDLE;
+typedef HANDLE HWND;
+typedef HANDLE HMENU;
+typedef HANDLE HICON;
+typedef HANDLE HFONT;
+typedef HANDLE HINSTANCE;
+typedef HANDLE HMODULE;
+typedef HANDLE HDC;
+typedef HANDLE HBITMAP;
+typedef HANDLE HBRUSH;
+typedef HANDLE HGLOBAL;
+typedef HANDLE HKEY;
+typedef uintptr_t UINT_PTR;
+typedef intptr_t INT_PTR;
+typedef uintptr_t WPARAM;
+typedef intptr_t LPARAM;
+typedef intptr_t LRESULT;
+typedef DWORD COLORREF;
+typedef uintptr_t SOCKET;
+typedef struct { LONG x, y; } POINT;
+typedef struct { LONG left, top, right, bottom; } RECT;
+typedef struct { LONG cx, cy; } SIZE;
+typedef LRESULT (*WNDPROC)(HWND, UINT, WPARAM, LPARAM);
+
+#define LF_FACESIZE	32
+typedef struct {
+	LONG lfHeight, lfWidth, lfEscapement, lfOrientation, lfWeight;
+	BYTE lfItalic, lfUnderline, lfStrikeOut, lfCharSet;
+	BYTE lfOutPrecision, lfClipPrecision, lfQuality, lfPitchAndFamily;
+	CHAR lfFaceName[LF_FACESIZE];
+} LOGFONTA, *PLOGFONTA;
+typedef struct {
+	LONG lfHeight, lfWidth, lfEscapement, lfOrientation, lfWeight;
+	BYTE lfItalic, lfUnderline, lfStrikeOut, lfCharSet;
+	BYTE lfOutPrecision, lfClipPrecision, lfQuality, lfPitchAndFamily;
+	WCHAR lfFaceName[LF_FACESIZE];
+} LOGFONTW, *PLOGFONTW;
+typedef LOGFONTA LOGFONT, *PLOGFONT, *LPLOGFONT;
+
+typedef struct { WORD wVersion; } WSADATA, *LPWSADATA;
+typedef struct { DWORD Internal; } OVERLAPPED, *LPOVERLAPPED;
+typedef struct { DWORD nLength; } SECURITY_ATTRIBUTES, *LPSECURITY_ATTRIBUTES;
+
+// ssh.h scp_t
+struct __stat64 {
+	int64_t st_size;
+	int64_t st_mtime;
+	int st_mode;
+};
+
+#define TRUE	1
+#define FALSE	0
+#define MAX_PATH	260
+#define WINAPI
+#define CALLBACK
+#define PASCAL
+#define __declspec(x)
+#define __cdecl
+#define __stdcall
+
+#define WM_USER	0x0400
+#define FD_READ	0x01
+#define INVALID_SOCKET	((SOCKET)~0)
+#define SOCKET_ERROR	(-1)
+
+#define LOBYTE(w)	((BYTE)((w) & 0xff))
+#define HIBYTE(w)	((BYTE)(((w) >> 8) & 0xff))
+#define MAKELPARAM(l, h)	((LPARAM)(DWORD)(((WORD)(l)) | ((DWORD)((WORD)(h))) << 16))
+
+#if !defined(__cplusplus)
+#define max(a, b)	(((a) > (b)) ? (a) : (b))
+#define min(a, b)	(((a) < (b)) ? (a) : (b))
+#endif
+
+#define _countof(a)	(sizeof(a) / sizeof((a)[0]))
+#define _snprintf	snprintf
+#define _strdup		strdup
+#define _wcsdup		wcsdup
+#define _TRUNCATE	((size_t)-1)
+#define SecureZeroMemory(p, n)	memset((p), 0, (n))
+
+// _TRUNCATE w肵Ƃ̓삾
+#define _snprintf_s(buf, size, count, ...)	snprintf((buf), (size), __VA_ARGS__)
+
+static inline int strncpy_s(char *dest, size_t size, const char *src, size_t count)
+{
+	snprintf(dest, size, "%s", src);
+	(void)count;
+	return 0;
+}
+
+static inline int strncat_s(char *dest, size_t size, const char *src, size_t count)
+{
+	size_t len = strlen(dest);
+	if (len < size) {
+		snprintf(dest + len, size - len, "%s", src);
+	}
+	(void)count;
+	return 0;
+}
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// headless.c
+BOOL PostMessage(HWND hWnd, UINT Msg, WPARAM wParam, LPARAM lParam);
+
+#if defined(__cplusplus)
+}
+#endif
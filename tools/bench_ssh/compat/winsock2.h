@@ -0,0 +1,10 @@
+/*
+ *	Windows ȊOŃrhƂ winsock2.h
+ *		\Pbg͎gpȂ (SOCKET Ȃǂ windows.h Œ`Ă)
+ *		htonl() Ȃǂ̃oCgI[_[ϊ libc ̂̂g
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <arpa/inet.h>
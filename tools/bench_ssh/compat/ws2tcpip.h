@@ -0,0 +1,8 @@
+/*
+ *	Windows ȊOŃrhƂ ws2tcpip.h
+ *		\Pbg͎gpȂ (SOCKET Ȃǂ windows.h Œ`Ă)
+ */
+
+#pragma once
+
+#include <windows.h>
@@ -0,0 +1,8 @@
+/*
+ *	Windows ȊOŃrhƂ wspiapi.h
+ *		\Pbg͎gpȂ (SOCKET Ȃǂ windows.h Œ`Ă)
+ */
+
+#pragma once
+
+#include <windows.h>
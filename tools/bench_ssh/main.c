@@ -0,0 +1,707 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *	SSH Í/pPbg̃x`}[N
+ *		ttxssh ̑MpPbg\z(begin_send_packet(), SSH2_packet_build())
+ *		M(PKT_recv(), SSH2_packet_open())ŉA
+ *		cipher/MAC/k̑gݍ킹Ƃ̑xv
+ */
+
+#include <stdarg.h>
+#if !defined(_WIN32)
+#include <time.h>
+#endif
+
+#include "ttxssh.h"
+#include "packet.h"
+#include "nullssh.h"
+
+#include <openssl/opensslv.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/provider.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define CYCLE_COUNT_ENABLE	1
+#else
+#define CYCLE_COUNT_ENABLE	0
+#endif
+
+#define MiB  (1024.0 * 1024.0)
+
+#define DEFAULT_CIPHER	SSH2_CIPHER_AES128_CTR
+#define DEFAULT_MAC		HMAC_SHA2_256_EtM
+#define SOURCE_LEN		(4 * 1024 * 1024)
+#define BATCH_BYTES		(1024 * 1024)
+
+// allocation counter
+//	glibc ̂Ƃ malloc() 肵Đ
+static unsigned long long AllocCount;
+#if defined(__GLIBC__)
+#define ALLOC_COUNT_ENABLE	1
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t nmemb, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+	AllocCount++;
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+	AllocCount++;
+	return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	AllocCount++;
+	return __libc_realloc(ptr, size);
+}
+#else
+#define ALLOC_COUNT_ENABLE	0
+#endif
+
+typedef struct {
+	const struct ssh2cipher *cipher;
+	const struct SSH2Mac *mac;		// AEAD ̂Ƃ <implicit>
+	compression_type comp;
+} Case;
+
+typedef struct {
+	size_t size;		// 1pPbg̃`lf[^
+	size_t total;		// 1P[X̃`lf[^
+	int level;			// kx
+	BOOL verify;
+} Options;
+
+typedef struct {
+	double sec;
+	unsigned long long cycles;
+	unsigned long long allocs;
+} Meter;
+
+static unsigned char *Source;
+
+static void Usage(void)
+{
+	printf(
+		"usage: bench_ssh [options]\n"
+		"  -c list     ciphers (comma separated, 'all')\n"
+		"  -m list     MACs (comma separated, 'all'), ignored for AEAD ciphers\n"
+		"  -z list     compression (none, zlib, zlib@openssh.com, 'all') default none\n"
+		"  -s size     channel data bytes per packet (default 32768)\n"
+		"  -n MB       channel data per case (default 32)\n"
+		"  -l level    zlib compression level (default 6)\n"
+		"  -r          random (incompressible) data instead of terminal output\n"
+		"  -V          compare received data with sent data\n"
+		"  -v level    ttxssh log level (default 0)\n"
+		"  -L          list algorithms\n"
+		"  without -c and -m, every cipher is measured with %s and\n"
+		"  every MAC is measured with %s\n",
+		get_ssh2_mac_name_by_id(DEFAULT_MAC), get_cipher_name(DEFAULT_CIPHER));
+}
+
+static double Now(void)
+{
+#if defined(_WIN32)
+	LARGE_INTEGER freq, count;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+	return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+static unsigned long long Cycles(void)
+{
+#if CYCLE_COUNT_ENABLE
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+static void MeterStart(Meter *m, double *sec, unsigned long long *cycles, unsigned long long *allocs)
+{
+	(void)m;
+	*allocs = AllocCount;
+	*cycles = Cycles();
+	*sec = Now();
+}
+
+static void MeterStop(Meter *m, double sec, unsigned long long cycles, unsigned long long allocs)
+{
+	m->sec += Now() - sec;
+	m->cycles += Cycles() - cycles;
+	m->allocs += AllocCount - allocs;
+}
+
+/*
+ *	[o͂炵f[^ (rhO, ls -l)
+ */
+static void MakeSource(BOOL random)
+{
+	size_t len = 0;
+	unsigned int seed = 1;
+	int n = 0;
+
+	Source = (unsigned char *)malloc(SOURCE_LEN);
+	if (random) {
+		while (len < SOURCE_LEN) {
+			seed = seed * 1103515245 + 12345;
+			Source[len++] = (unsigned char)(seed >> 16);
+		}
+		return;
+	}
+	while (len < SOURCE_LEN) {
+		char line[160];
+		int r;
+		seed = seed * 1103515245 + 12345;
+		if (n % 3 == 0) {
+			r = _snprintf_s(line, sizeof(line), _TRUNCATE,
+			                "gcc -O2 -Wall -c -o obj/module%04u.o src/module%04u.c -Iinclude\r\n",
+			                seed % 10000, seed % 10000);
+		}
+		else {
+			r = _snprintf_s(line, sizeof(line), _TRUNCATE,
+			                "-rw-r--r-- 1 user group %8u Oct %2u %02u:%02u file_%05u.txt\r\n",
+			                seed % 1000000, 1 + (seed >> 8) % 28, (seed >> 12) % 24, (seed >> 4) % 60, n);
+		}
+		if (r < 0 || r >= (int)sizeof(line)) {
+			r = (int)strlen(line);
+		}
+		if (len + r > SOURCE_LEN) {
+			r = (int)(SOURCE_LEN - len);
+		}
+		memcpy(Source + len, line, r);
+		len += r;
+		n++;
+	}
+}
+
+/*
+ *	IƓԂ̃ZbV
+ *		ssh.c  choose_SSH2_key_maxlength(), kex_derive_keys(), ssh2_send_newkeys() 
+ *		MƎMɓĝŁAMpPbĝ܂܎Mł
+ */
+static PTInstVar SessionCreate(const Case *c, int level)
+{
+	PTInstVar pvar = (PTInstVar)calloc(1, sizeof(TInstVar));
+	int mode;
+
+	pvar->protocol_major = 2;
+	pvar->protocol_minor = 0;
+	pvar->socket = INVALID_SOCKET;
+	pvar->Precv = NullSSHRecv;
+	CRYPT_init(pvar);
+	PKT_init(pvar);
+	pvar->pkt_state.seen_server_ID = TRUE;
+
+	for (mode = 0; mode < MODE_MAX; mode++) {
+		SSHKeys *keys = &pvar->ssh2_keys[mode];
+		const EVP_MD *md = get_ssh2_mac_EVP_MD(c->mac);
+		int bits = get_ssh2_mac_truncatebits(c->mac);
+		int i;
+
+		pvar->ciphers[mode] = c->cipher;
+		pvar->macs[mode] = c->mac;
+
+		keys->mac.md = md;
+		keys->mac.key_len = keys->mac.mac_len = EVP_MD_size(md);
+		if (bits != 0) {
+			keys->mac.mac_len = bits / 8;
+		}
+		keys->mac.etm = get_ssh2_mac_etm(c->mac);
+		keys->enc.key_len = get_cipher_key_len(c->cipher);
+		keys->enc.block_size = get_cipher_block_size(c->cipher);
+		keys->enc.iv_len = get_cipher_iv_len(c->cipher);
+		keys->enc.auth_len = get_cipher_auth_len(c->cipher);
+
+		// kex_derive_keys() ̑ɌŒl
+		keys->enc.iv = (u_char *)malloc(EVP_MAX_MD_SIZE);
+		keys->enc.key = (u_char *)malloc(EVP_MAX_MD_SIZE);
+		keys->mac.key = (u_char *)malloc(EVP_MAX_MD_SIZE);
+		for (i = 0; i < EVP_MAX_MD_SIZE; i++) {
+			keys->enc.iv[i] = (u_char)(0xA0 + i);
+			keys->enc.key[i] = (u_char)(0xC0 + i * 3);
+			keys->mac.key[i] = (u_char)(0xE0 + i * 7);
+		}
+	}
+
+	CRYPT_start_encryption(pvar, 1, 1);
+	if (pvar->fatal_error || pvar->cc[MODE_OUT] == NULL || pvar->cc[MODE_IN] == NULL) {
+		return pvar;
+	}
+
+	for (mode = 0; mode < MODE_MAX; mode++) {
+		pvar->ssh2_keys[mode].mac.enabled = 1;
+		pvar->ssh2_keys[mode].comp.enabled = 1;
+	}
+
+	pvar->ctos_compression = c->comp;
+	pvar->stoc_compression = c->comp;
+	pvar->userauth_success = TRUE;
+	if (c->comp != COMP_NOCOMP) {
+		pvar->ssh_state.compression_level = level;
+		if (deflateInit(&pvar->ssh_state.compress_stream, level) != Z_OK ||
+		    inflateInit(&pvar->ssh_state.decompress_stream) != Z_OK) {
+			notify_fatal_error(pvar, "zlib initialize error", TRUE);
+		}
+	}
+
+	return pvar;
+}
+
+static void SessionDestroy(PTInstVar pvar, const Case *c)
+{
+	int mode;
+
+	for (mode = 0; mode < MODE_MAX; mode++) {
+		if (pvar->cc[mode] != NULL) {
+			cipher_free_SSH2(pvar->cc[mode]);
+			free(pvar->cc[mode]);
+		}
+		free(pvar->ssh2_keys[mode].enc.iv);
+		free(pvar->ssh2_keys[mode].enc.key);
+		free(pvar->ssh2_keys[mode].mac.key);
+	}
+	if (c->comp != COMP_NOCOMP) {
+		deflateEnd(&pvar->ssh_state.compress_stream);
+		inflateEnd(&pvar->ssh_state.decompress_stream);
+	}
+	buffer_free(pvar->decomp_buffer);
+	buf_destroy(&pvar->ssh_state.outbuf, &pvar->ssh_state.outbuflen);
+	PKT_end(pvar);
+	free(pvar);
+}
+
+static void PrintRate(const Meter *m, double bytes, unsigned long long packets)
+{
+	printf(" %9.1f", bytes / MiB / m->sec);
+	if (CYCLE_COUNT_ENABLE) {
+		printf(" %6.2f", (double)m->cycles / bytes);
+	}
+	else {
+		printf(" %6s", "-");
+	}
+	if (ALLOC_COUNT_ENABLE) {
+		printf(" %6.2f", (double)m->allocs / (double)packets);
+	}
+	else {
+		printf(" %6s", "-");
+	}
+}
+
+static BOOL Bench(const Case *c, const Options *opt)
+{
+	PTInstVar pvar;
+	Meter send = { 0 };
+	Meter recv = { 0 };
+	size_t batch = BATCH_BYTES / opt->size;
+	size_t wire_size;
+	char *wire;
+	size_t src_pos = 0;
+	size_t sent = 0;
+	unsigned long long packets = 0;
+	unsigned long long wire_total = 0;
+	NullSSHStat stat;
+	char appbuf[1024];
+	BOOL ok = TRUE;
+
+	printf("%-29s %-30s %-16s", get_cipher_string(c->cipher), get_ssh2_mac_name(c->mac), get_ssh2_comp_name(c->comp));
+	fflush(stdout);
+
+	pvar = SessionCreate(c, opt->level);
+	if (pvar->fatal_error || pvar->cc[MODE_OUT] == NULL) {
+		printf(" not available\n");
+		SessionDestroy(pvar, c);
+		return TRUE;
+	}
+
+	if (batch == 0) {
+		batch = 1;
+	}
+	// pfBO, MAC, kłȂƂ̑
+	wire_size = batch * (opt->size + 256 + opt->size / 64);
+	wire = (char *)malloc(wire_size);
+	NullSSHClearStat();
+
+	while (sent < opt->total) {
+		size_t wire_len = 0;
+		size_t batch_start;
+		size_t i;
+		double sec;
+		unsigned long long cycles, allocs;
+
+		if (src_pos + batch * opt->size > SOURCE_LEN) {
+			src_pos = 0;
+		}
+		batch_start = src_pos;
+
+		// M: begin_send_packet() ... finish_send_packet()  send() ȊO
+		MeterStart(&send, &sec, &cycles, &allocs);
+		for (i = 0; i < batch; i++) {
+			unsigned char *outmsg = begin_send_packet(pvar, SSH2_MSG_CHANNEL_DATA, 4 + 4 + (int)opt->size);
+			unsigned char *data;
+			unsigned int len;
+			buffer_t *msg = NULL;
+
+			set_uint32(outmsg, 0);
+			set_uint32(outmsg + 4, opt->size);
+			memcpy(outmsg + 8, Source + src_pos, opt->size);
+			src_pos += opt->size;
+
+			data = SSH2_packet_build(pvar, pvar->ssh_state.outgoing_packet_len, &len, &msg);
+			if (data == NULL || wire_len + len > wire_size) {
+				ok = FALSE;
+				buffer_free(msg);
+				break;
+			}
+			memcpy(wire + wire_len, data, len);
+			wire_len += len;
+			buffer_free(msg);
+			pvar->ssh_state.sender_sequence_number++;
+		}
+		MeterStop(&send, sec, cycles, allocs);
+		if (!ok || pvar->fatal_error) {
+			ok = FALSE;
+			break;
+		}
+
+		// M: PKT_recv()  SSH2_handle_packet() ܂
+		NullSSHSetRecvData(wire, wire_len);
+		NullSSHSetExpectData(opt->verify ? Source + batch_start : NULL, batch * opt->size);
+		MeterStart(&recv, &sec, &cycles, &allocs);
+		PKT_recv(pvar, appbuf, sizeof(appbuf));
+		MeterStop(&recv, sec, cycles, allocs);
+
+		NullSSHGetStat(&stat);
+		if (pvar->fatal_error || stat.packets != packets + batch) {
+			ok = FALSE;
+			break;
+		}
+
+		packets += batch;
+		sent += batch * opt->size;
+		wire_total += wire_len;
+	}
+
+	NullSSHGetStat(&stat);
+	if (ok && stat.mismatches != 0) {
+		ok = FALSE;
+	}
+	if (ok) {
+		PrintRate(&send, (double)sent, packets);
+		PrintRate(&recv, (double)sent, packets);
+		printf(" %6.3f\n", (double)wire_total / (double)sent);
+	}
+	else {
+		printf(" FAILED (packets %llu/%llu, mismatches %llu)\n",
+		       stat.packets, packets + batch, stat.mismatches);
+	}
+
+	free(wire);
+	SessionDestroy(pvar, c);
+	return ok;
+}
+
+/*
+ *	get_cipher_name()  chacha20-poly1305 \p "(SSH2)" t̂Ŏ菜ĒT
+ */
+static const struct ssh2cipher *CipherById(int id)
+{
+	char name[64];
+	char *p;
+
+	strncpy_s(name, sizeof(name), get_cipher_name(id), _TRUNCATE);
+	p = strchr(name, '(');
+	if (p != NULL) {
+		*p = 0;
+	}
+	return get_cipher_by_name(name);
+}
+
+/*
+ *	"all" ܂̓J}؂̖Oꗗ
+ */
+static int ParseCipherList(const char *arg, const struct ssh2cipher **list, int max_count)
+{
+	int count = 0;
+	int id;
+
+	for (id = SSH2_CIPHER_3DES_CBC; id <= SSH_CIPHER_MAX && count < max_count; id++) {
+		const struct ssh2cipher *cipher = CipherById(id);
+		if (cipher == NULL || get_cipher_id(cipher) != id) {
+			continue;
+		}
+		if (arg == NULL || strcmp(arg, "all") == 0) {
+			list[count++] = cipher;
+		}
+	}
+	if (arg == NULL || strcmp(arg, "all") == 0) {
+		return count;
+	}
+
+	for (;;) {
+		const char *end = strchr(arg, ',');
+		size_t len = end != NULL ? (size_t)(end - arg) : strlen(arg);
+		char name[64];
+		const struct ssh2cipher *cipher;
+
+		if (len >= sizeof(name)) {
+			len = sizeof(name) - 1;
+		}
+		memcpy(name, arg, len);
+		name[len] = 0;
+		cipher = get_cipher_by_name(name);
+		if (cipher == NULL || get_cipher_id(cipher) < SSH2_CIPHER_3DES_CBC) {
+			fprintf(stderr, "unknown cipher '%s'\n", name);
+			return -1;
+		}
+		if (count < max_count) {
+			list[count++] = cipher;
+		}
+		if (end == NULL) {
+			break;
+		}
+		arg = end + 1;
+	}
+	return count;
+}
+
+static int ParseMacList(const char *arg, const struct SSH2Mac **list, int max_count)
+{
+	int count = 0;
+	int id;
+
+	for (id = HMAC_NONE + 1; id < HMAC_IMPLICIT && count < max_count; id++) {
+		const struct SSH2Mac *mac = get_ssh2_mac((SSH2MacId)id);
+		const char *name;
+		size_t len;
+		const char *p;
+
+		if (mac == NULL) {
+			continue;
+		}
+		if (arg == NULL || strcmp(arg, "all") == 0) {
+			list[count++] = mac;
+			continue;
+		}
+		name = get_ssh2_mac_name(mac);
+		len = strlen(name);
+		for (p = arg; (p = strstr(p, name)) != NULL; p += len) {
+			if ((p == arg || p[-1] == ',') && (p[len] == ',' || p[len] == 0)) {
+				list[count++] = mac;
+				break;
+			}
+		}
+	}
+	return count;
+}
+
+static int ParseCompList(const char *arg, compression_type *list, int max_count)
+{
+	static const compression_type types[] = { COMP_NOCOMP, COMP_ZLIB, COMP_DELAYED };
+	int count = 0;
+	size_t i;
+
+	if (arg == NULL) {
+		list[count++] = COMP_NOCOMP;
+		return count;
+	}
+	for (i = 0; i < _countof(types) && count < max_count; i++) {
+		const char *name = get_ssh2_comp_name(types[i]);
+		size_t len = strlen(name);
+		const char *p;
+		if (strcmp(arg, "all") == 0) {
+			list[count++] = types[i];
+			continue;
+		}
+		for (p = arg; (p = strstr(p, name)) != NULL; p += len) {
+			if ((p == arg || p[-1] == ',') && (p[len] == ',' || p[len] == 0)) {
+				list[count++] = types[i];
+				break;
+			}
+		}
+	}
+	return count;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *cipher_arg = NULL;
+	const char *mac_arg = NULL;
+	const char *comp_arg = NULL;
+	const struct ssh2cipher *ciphers[SSH_CIPHER_MAX + 1];
+	const struct SSH2Mac *macs[HMAC_MAX + 1];
+	compression_type comps[4];
+	int cipher_count, mac_count, comp_count;
+	Options opt;
+	BOOL random = FALSE;
+	BOOL list = FALSE;
+	int failed = 0;
+	int i, j, k;
+
+	opt.size = 32768;
+	opt.total = (size_t)(32 * MiB);
+	opt.level = 6;
+	opt.verify = FALSE;
+
+	for (i = 1; i < argc; i++) {
+		const char *arg = argv[i];
+		if (strcmp(arg, "-c") == 0 && i + 1 < argc) {
+			cipher_arg = argv[++i];
+		}
+		else if (strcmp(arg, "-m") == 0 && i + 1 < argc) {
+			mac_arg = argv[++i];
+		}
+		else if (strcmp(arg, "-z") == 0 && i + 1 < argc) {
+			comp_arg = argv[++i];
+		}
+		else if (strcmp(arg, "-s") == 0 && i + 1 < argc) {
+			opt.size = (size_t)atoi(argv[++i]);
+		}
+		else if (strcmp(arg, "-n") == 0 && i + 1 < argc) {
+			opt.total = (size_t)(atof(argv[++i]) * MiB);
+		}
+		else if (strcmp(arg, "-l") == 0 && i + 1 < argc) {
+			opt.level = atoi(argv[++i]);
+		}
+		else if (strcmp(arg, "-r") == 0) {
+			random = TRUE;
+		}
+		else if (strcmp(arg, "-V") == 0) {
+			opt.verify = TRUE;
+		}
+		else if (strcmp(arg, "-v") == 0 && i + 1 < argc) {
+			NullSSHSetLogLevel(atoi(argv[++i]));
+		}
+		else if (strcmp(arg, "-L") == 0) {
+			list = TRUE;
+		}
+		else {
+			Usage();
+			return strcmp(arg, "-h") == 0 ? 0 : 1;
+		}
+	}
+	if (opt.size == 0 || opt.size > BATCH_BYTES || opt.total == 0 || opt.level < 1 || opt.level > 9) {
+		Usage();
+		return 1;
+	}
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	// blowfish, cast128, arcfour  legacy provider ɂ
+	OSSL_PROVIDER_load(NULL, "legacy");
+	OSSL_PROVIDER_load(NULL, "default");
+#endif
+
+	if (list) {
+		cipher_count = ParseCipherList("all", ciphers, _countof(ciphers));
+		mac_count = ParseMacList("all", macs, _countof(macs));
+		for (i = 0; i < cipher_count; i++) {
+			printf("cipher %s%s\n", get_cipher_string(ciphers[i]), get_cipher_auth_len(ciphers[i]) > 0 ? " (AEAD)" : "");
+		}
+		for (i = 0; i < mac_count; i++) {
+			printf("mac    %s\n", get_ssh2_mac_name(macs[i]));
+		}
+		printf("comp   none\ncomp   zlib\ncomp   zlib@openssh.com\n");
+		return 0;
+	}
+
+	cipher_count = ParseCipherList(cipher_arg, ciphers, _countof(ciphers));
+	mac_count = ParseMacList(mac_arg, macs, _countof(macs));
+	comp_count = ParseCompList(comp_arg, comps, _countof(comps));
+	if (cipher_count <= 0 || mac_count <= 0 || comp_count <= 0) {
+		fprintf(stderr, "no algorithm selected\n");
+		return 1;
+	}
+
+	MakeSource(random);
+
+	printf("%-29s %-30s %-16s %9s %6s %6s %9s %6s %6s %6s\n",
+	       "cipher", "mac", "comp",
+	       "send MB/s", "cyc/B", "alloc", "recv MB/s", "cyc/B", "alloc", "wire");
+
+	for (k = 0; k < comp_count; k++) {
+		if (cipher_arg == NULL && mac_arg == NULL) {
+			// e cipher  DEFAULT_MAC ŁAe MAC  DEFAULT_CIPHER 
+			const struct ssh2cipher *def_cipher = CipherById(DEFAULT_CIPHER);
+			const struct SSH2Mac *def_mac = get_ssh2_mac(DEFAULT_MAC);
+			for (i = 0; i < cipher_count; i++) {
+				Case c;
+				c.cipher = ciphers[i];
+				c.mac = get_cipher_auth_len(ciphers[i]) > 0 ? get_ssh2_mac(HMAC_IMPLICIT) : def_mac;
+				c.comp = comps[k];
+				failed += !Bench(&c, &opt);
+			}
+			for (j = 0; j < mac_count; j++) {
+				Case c;
+				if (macs[j] == def_mac) {
+					continue;
+				}
+				c.cipher = def_cipher;
+				c.mac = macs[j];
+				c.comp = comps[k];
+				failed += !Bench(&c, &opt);
+			}
+			continue;
+		}
+		for (i = 0; i < cipher_count; i++) {
+			if (get_cipher_auth_len(ciphers[i]) > 0) {
+				Case c;
+				c.cipher = ciphers[i];
+				c.mac = get_ssh2_mac(HMAC_IMPLICIT);
+				c.comp = comps[k];
+				failed += !Bench(&c, &opt);
+				continue;
+			}
+			for (j = 0; j < mac_count; j++) {
+				Case c;
+				c.cipher = ciphers[i];
+				c.mac = macs[j];
+				c.comp = comps[k];
+				failed += !Bench(&c, &opt);
+			}
+		}
+	}
+
+	free(Source);
+	return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,298 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* null SSH session for tools/bench_ssh */
+
+#include <stdarg.h>
+
+#include "ttxssh.h"
+#include "packet.h"
+#include "codeconv.h"
+
+#include "nullssh.h"
+
+static int LogLevelMax = 0;
+
+static const char *RecvData;
+static size_t RecvLen;
+static size_t RecvPos;
+
+static const unsigned char *ExpectData;
+static size_t ExpectLen;
+static size_t ExpectPos;
+
+static NullSSHStat Stat;
+
+void NullSSHSetLogLevel(int level)
+{
+	LogLevelMax = level;
+}
+
+void NullSSHSetRecvData(const char *data, size_t len)
+{
+	RecvData = data;
+	RecvLen = len;
+	RecvPos = 0;
+}
+
+void NullSSHSetExpectData(const unsigned char *data, size_t len)
+{
+	ExpectData = data;
+	ExpectLen = len;
+	ExpectPos = 0;
+}
+
+void NullSSHGetStat(NullSSHStat *stat)
+{
+	*stat = Stat;
+}
+
+void NullSSHClearStat(void)
+{
+	memset(&Stat, 0, sizeof(Stat));
+}
+
+/*
+ *	pvar->Precv
+ *		NullSSHSetRecvData() ̃f[^ԂAȂȂ 0 (ؒf)
+ */
+int PASCAL NullSSHRecv(SOCKET s, char *buf, int len, int flags)
+{
+	size_t left = RecvLen - RecvPos;
+	(void)s;
+	(void)flags;
+	if ((size_t)len > left) {
+		len = (int)left;
+	}
+	memcpy(buf, RecvData + RecvPos, len);
+	RecvPos += len;
+	return len;
+}
+
+//
+// ssh.c
+//
+
+BOOL SSH_handle_server_ID(PTInstVar pvar, char *ID, int ID_len)
+{
+	(void)pvar;
+	(void)ID;
+	(void)ID_len;
+	return TRUE;
+}
+
+void SSH2_send_kexinit(PTInstVar pvar)
+{
+	(void)pvar;
+}
+
+void SSH1_handle_packet(PTInstVar pvar, char *data, unsigned int len, unsigned int padding)
+{
+	(void)data;
+	(void)len;
+	(void)padding;
+	notify_fatal_error(pvar, "SSH1 is not supported", TRUE);
+}
+
+/*
+ *	ssh.c  SSH2_handle_packet() Ɠ SSH2_packet_open() ŕ
+ *	SSH2_MSG_CHANNEL_DATA ̃f[^𐔂
+ */
+void SSH2_handle_packet(PTInstVar pvar, char *data, unsigned int len, unsigned int aadlen, unsigned int authlen)
+{
+	unsigned char *payload;
+	unsigned int datalen;
+
+	if (!SSH2_packet_open(pvar, data, len, aadlen, authlen)) {
+		return;
+	}
+	pvar->ssh_state.receiver_sequence_number++;
+
+	payload = pvar->ssh_state.payload;
+	if (pvar->ssh_state.payloadlen < 1 + 4 + 4 || payload[-1] != SSH2_MSG_CHANNEL_DATA) {
+		notify_fatal_error(pvar, "unexpected message", TRUE);
+		return;
+	}
+	datalen = get_uint32_MSBfirst(payload + 4);
+	if ((long)datalen > pvar->ssh_state.payloadlen - 1 - 4 - 4) {
+		notify_fatal_error(pvar, "truncated channel data", TRUE);
+		return;
+	}
+
+	if (ExpectData != NULL) {
+		if (ExpectPos + datalen > ExpectLen ||
+		    memcmp(ExpectData + ExpectPos, payload + 8, datalen) != 0) {
+			Stat.mismatches++;
+		}
+		ExpectPos += datalen;
+	}
+
+	Stat.packets++;
+	Stat.bytes += datalen;
+}
+
+int SSH_extract_payload(PTInstVar pvar, unsigned char *dest, int len)
+{
+	(void)pvar;
+	(void)dest;
+	(void)len;
+	return 0;
+}
+
+// KEX ͍sȂ̂ŎgpȂ (cipher.c, mac.c, comp.c  myproposal XVQƂ)
+void normalize_generic_order(char *buf, char default_strings[], int default_strings_len)
+{
+	(void)buf;
+	(void)default_strings;
+	(void)default_strings_len;
+}
+
+void choose_SSH2_proposal(char *server_proposal, char *my_proposal, char *dest, int dest_len)
+{
+	(void)server_proposal;
+	(void)my_proposal;
+	if (dest_len > 0) {
+		dest[0] = '\0';
+	}
+}
+
+//
+// kex.c
+//
+
+char *myproposal[PROPOSAL_MAX];
+
+//
+// ttxssh.c
+//
+
+void notify_fatal_error(PTInstVar pvar, char *msg, BOOL send_disconnect)
+{
+	(void)send_disconnect;
+	if (!pvar->fatal_error) {
+		fprintf(stderr, "fatal error: %s\n", msg);
+	}
+	pvar->fatal_error = TRUE;
+}
+
+void notify_nonfatal_error(PTInstVar pvar, char *msg)
+{
+	(void)pvar;
+	fprintf(stderr, "error: %s\n", msg);
+}
+
+void logputs(int level, char *msg)
+{
+	if (level <= LogLevelMax) {
+		fprintf(stderr, "%s\n", msg);
+	}
+}
+
+void logprintf(int level, const char *fmt, ...)
+{
+	va_list ap;
+	if (level > LogLevelMax) {
+		return;
+	}
+	va_start(ap, fmt);
+	vfprintf(stderr, fmt, ap);
+	va_end(ap);
+	fputc('\n', stderr);
+}
+
+void logprintf_hexdump(int level, const char *data, int len, const char *fmt, ...)
+{
+	va_list ap;
+	int i;
+	if (level > LogLevelMax) {
+		return;
+	}
+	va_start(ap, fmt);
+	vfprintf(stderr, fmt, ap);
+	va_end(ap);
+	for (i = 0; i < len; i++) {
+		fprintf(stderr, "%s%02x", (i % 16) == 0 ? "\n  " : " ", (unsigned char)data[i]);
+	}
+	fputc('\n', stderr);
+}
+
+//
+// util.c
+//
+
+void UTIL_get_lang_msg(const char *key, PTInstVar pvar, const char *def)
+{
+	(void)key;
+	strncpy_s(pvar->UIMsg, sizeof(pvar->UIMsg), def, _TRUNCATE);
+}
+
+void UTIL_get_lang_msgU8(const char *key, PTInstVar pvar, const char *def)
+{
+	UTIL_get_lang_msg(key, pvar, def);
+}
+
+void UTIL_get_lang_msgW(const char *key, PTInstVar pvar, const wchar_t *def, wchar_t *UIMsg)
+{
+	(void)key;
+	(void)pvar;
+	wcsncpy(UIMsg, def, MAX_UIMSG - 1);
+	UIMsg[MAX_UIMSG - 1] = 0;
+}
+
+//
+// common
+//
+
+void OutputDebugPrintf(const char *fmt, ...)
+{
+	va_list ap;
+	va_start(ap, fmt);
+	vfprintf(stderr, fmt, ap);
+	va_end(ap);
+}
+
+wchar_t *ToWcharA(const char *strA)
+{
+	size_t len = strlen(strA) + 1;
+	wchar_t *strW = (wchar_t *)malloc(sizeof(wchar_t) * len);
+	if (strW != NULL) {
+		mbstowcs(strW, strA, len);
+	}
+	return strW;
+}
+
+#if !defined(_WIN32)
+BOOL PostMessage(HWND hWnd, UINT Msg, WPARAM wParam, LPARAM lParam)
+{
+	(void)hWnd;
+	(void)Msg;
+	(void)wParam;
+	(void)lParam;
+	return TRUE;
+}
+#endif
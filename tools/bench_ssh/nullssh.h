@@ -0,0 +1,59 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *	null SSH session
+ *		ttxssh ̈Í/pPbg(crypt.c, cipher.c, mac.c, packet.c, pkt.c)
+ *		\PbgƃEBhEȂœ߂̍ŏ ssh.c, util.c ̑
+ *		Mf[^̓̃obt@ PKT_recv() ɓn
+ */
+
+#pragma once
+
+#include "ttxssh.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	unsigned long long packets;		// M SSH2_MSG_CHANNEL_DATA ̐
+	unsigned long long bytes;		// M`lf[^̃oCg
+	unsigned long long mismatches;	// Mf[^ƈvȂ
+} NullSSHStat;
+
+void NullSSHSetLogLevel(int level);
+void NullSSHSetRecvData(const char *data, size_t len);
+void NullSSHSetExpectData(const unsigned char *data, size_t len);
+void NullSSHGetStat(NullSSHStat *stat);
+void NullSSHClearStat(void);
+int PASCAL NullSSHRecv(SOCKET s, char *buf, int len, int flags);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,8 @@
+/*
+ *	Windows ȊOŃrhƂ crtdbg.h
+ *		foOq[v͎gpȂ
+ */
+
+#pragma once
+
+#define _CrtCheckMemory()	1
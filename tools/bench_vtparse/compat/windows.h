@@ -0,0 +1,248 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *	Windows ȊOŃrhƂ windows.h
+ *		ttcore(vtterm.c, buffer.c, charset.cpp Ȃ)gp^ƃ}N
+ *		֐ nullwin.c ŎĂ
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdarg.h>
+#include <limits.h>
+#include <locale.h>
+#include <wchar.h>
+#include <time.h>
+
+typedef unsigned char BYTE;
+typedef BYTE *LPBYTE;
+typedef unsigned short WORD;
+typedef WORD *LPWORD;
+typedef uint32_t DWORD;
+typedef DWORD *LPDWORD;
+typedef int32_t LONG;
+typedef LONG *PLONG;
+typedef uint32_t ULONG;
+typedef int64_t LONGLONG;
+typedef uint64_t ULONGLONG;
+typedef int BOOL;
+typedef BOOL *PBOOL;
+typedef int INT;
+typedef unsigned int UINT;
+typedef char CHAR;
+typedef char *PCHAR;
+typedef char *LPSTR;
+typedef const char *LPCSTR;
+typedef wchar_t WCHAR;
+typedef wchar_t *LPWSTR;
+typedef const wchar_t *LPCWSTR;
+typedef void *LPVOID;
+typedef const void *LPCVOID;
+typedef void *HANDLE;
+typedef HANDLE HWND;
+typedef HANDLE HMENU;
+typedef HANDLE HICON;
+typedef HANDLE HFONT;
+typedef HANDLE HINSTANCE;
+typedef HANDLE HMODULE;
+typedef HANDLE HDC;
+typedef HANDLE HBITMAP;
+typedef HANDLE HBRUSH;
+typedef HANDLE HGLOBAL;
+typedef HANDLE HKEY;
+typedef uintptr_t UINT_PTR;
+typedef intptr_t INT_PTR;
+typedef uintptr_t WPARAM;
+typedef intptr_t LPARAM;
+typedef intptr_t LRESULT;
+typedef DWORD COLORREF;
+typedef struct { LONG x, y; } POINT;
+typedef struct { LONG left, top, right, bottom; } RECT;
+typedef struct { LONG cx, cy; } SIZE;
+typedef LRESULT (*WNDPROC)(HWND, UINT, WPARAM, LPARAM);
+typedef void (*TIMERPROC)(HWND, UINT, UINT_PTR, DWORD);
+
+typedef union {
+	struct {
+		DWORD LowPart;
+		LONG HighPart;
+	} u;
+	LONGLONG QuadPart;
+} LARGE_INTEGER;
+
+typedef struct {
+	DWORD dwAllocationGranularity;
+} SYSTEM_INFO;
+
+typedef struct {
+	LARGE_INTEGER FileOffset;
+	LARGE_INTEGER BeyondFinalZero;
+} FILE_ZERO_DATA_INFORMATION;
+
+#define LF_FACESIZE	32
+typedef struct {
+	LONG lfHeight, lfWidth, lfEscapement, lfOrientation, lfWeight;
+	BYTE lfItalic, lfUnderline, lfStrikeOut, lfCharSet;
+	BYTE lfOutPrecision, lfClipPrecision, lfQuality, lfPitchAndFamily;
+	CHAR lfFaceName[LF_FACESIZE];
+} LOGFONTA, *PLOGFONTA;
+typedef struct {
+	LONG lfHeight, lfWidth, lfEscapement, lfOrientation, lfWeight;
+	BYTE lfItalic, lfUnderline, lfStrikeOut, lfCharSet;
+	BYTE lfOutPrecision, lfClipPrecision, lfQuality, lfPitchAndFamily;
+	WCHAR lfFaceName[LF_FACESIZE];
+} LOGFONTW, *PLOGFONTW;
+typedef LOGFONTA LOGFONT, *PLOGFONT, *LPLOGFONT;
+
+#define TRUE	1
+#define FALSE	0
+#define MAX_PATH	260
+#define WINAPI
+#define CALLBACK
+#define PASCAL
+#define __declspec(x)
+#define __cdecl
+#define __stdcall
+
+#define CP_ACP	0
+#define CP_UTF8	65001
+#define MB_ERR_INVALID_CHARS	0x00000008
+#define ERROR_INSUFFICIENT_BUFFER	122
+#define WM_USER	0x0400
+#define SW_SHOWNORMAL	1
+#define MB_ICONEXCLAMATION	0x00000030
+
+#define INVALID_HANDLE_VALUE	((HANDLE)(intptr_t)-1)
+#define GENERIC_READ	0x80000000
+#define GENERIC_WRITE	0x40000000
+#define CREATE_ALWAYS	2
+#define FILE_ATTRIBUTE_TEMPORARY	0x00000100
+#define FILE_FLAG_DELETE_ON_CLOSE	0x04000000
+#define FILE_BEGIN	0
+#define PAGE_READONLY	0x02
+#define FILE_MAP_READ	0x0004
+
+#define LOBYTE(w)	((BYTE)((w) & 0xff))
+#define HIBYTE(w)	((BYTE)(((w) >> 8) & 0xff))
+#define LOWORD(l)	((WORD)((l) & 0xffff))
+#define HIWORD(l)	((WORD)(((l) >> 16) & 0xffff))
+#define MAKELONG(l, h)	((LONG)(((WORD)(l)) | ((DWORD)((WORD)(h))) << 16))
+#define RGB(r, g, b)	((COLORREF)(((BYTE)(r) | ((WORD)((BYTE)(g)) << 8)) | (((DWORD)(BYTE)(b)) << 16)))
+#define GetRValue(rgb)	(LOBYTE(rgb))
+#define GetGValue(rgb)	(LOBYTE(((WORD)(rgb)) >> 8))
+#define GetBValue(rgb)	(LOBYTE((rgb) >> 16))
+
+#if !defined(__cplusplus)
+#define max(a, b)	(((a) > (b)) ? (a) : (b))
+#define min(a, b)	(((a) < (b)) ? (a) : (b))
+#endif
+
+#define _countof(a)	(sizeof(a) / sizeof((a)[0]))
+#define _snprintf	snprintf
+#define _strdup		strdup
+#define _wcsdup		wcsdup
+#define _strnicmp	strncasecmp
+#define _stricmp	strcasecmp
+#define _TRUNCATE	((size_t)-1)
+
+// _TRUNCATE w肵Ƃ̓삾
+#define _snprintf_s(buf, size, count, ...)	snprintf((buf), (size), __VA_ARGS__)
+#define _vsnprintf_s(buf, size, count, fmt, ap)	vsnprintf((buf), (size), (fmt), (ap))
+#define sscanf_s	sscanf
+
+// C locale gp
+typedef void *_locale_t;
+#define _create_locale(category, locale)	((_locale_t)1)
+#define _free_locale(locale)
+#define _snprintf_s_l(buf, size, count, fmt, locale, ...)	snprintf((buf), (size), (fmt), ##__VA_ARGS__)
+
+static inline int strncpy_s(char *dest, size_t size, const char *src, size_t count)
+{
+	snprintf(dest, size, "%s", src);
+	(void)count;
+	return 0;
+}
+
+static inline int strncat_s(char *dest, size_t size, const char *src, size_t count)
+{
+	size_t len = strlen(dest);
+	if (len < size) {
+		snprintf(dest + len, size - len, "%s", src);
+	}
+	(void)count;
+	return 0;
+}
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// nullwin.c
+DWORD GetTickCount(void);
+void Sleep(DWORD ms);
+BOOL MessageBeep(UINT type);
+int MessageBox(HWND hWnd, const char *text, const char *caption, UINT type);
+BOOL IsDBCSLeadByte(BYTE c);
+BOOL InvalidateRect(HWND hWnd, const RECT *rect, BOOL erase);
+BOOL UpdateWindow(HWND hWnd);
+void PostQuitMessage(int code);
+UINT_PTR SetTimer(HWND hWnd, UINT_PTR id, UINT elapse, TIMERPROC func);
+BOOL KillTimer(HWND hWnd, UINT_PTR id);
+HINSTANCE ShellExecuteW(HWND hWnd, const wchar_t *op, const wchar_t *file, const wchar_t *param,
+						const wchar_t *dir, INT show);
+void GetSystemInfo(SYSTEM_INFO *info);
+DWORD GetTempPathW(DWORD len, wchar_t *buf);
+UINT GetTempFileNameW(const wchar_t *path, const wchar_t *prefix, UINT unique, wchar_t *name);
+HANDLE CreateFileW(const wchar_t *name, DWORD access, DWORD share, void *sa, DWORD disposition,
+				   DWORD flags, HANDLE temp);
+BOOL DeleteFileW(const wchar_t *name);
+BOOL CloseHandle(HANDLE h);
+BOOL WriteFile(HANDLE h, const void *buf, DWORD len, DWORD *written, void *overlapped);
+BOOL SetFilePointerEx(HANDLE h, LARGE_INTEGER distance, LARGE_INTEGER *new_pos, DWORD method);
+BOOL DeviceIoControl(HANDLE h, DWORD code, void *in, DWORD in_size, void *out, DWORD out_size,
+					 DWORD *returned, void *overlapped);
+HANDLE CreateFileMappingW(HANDLE h, void *sa, DWORD protect, DWORD size_high, DWORD size_low,
+						  const wchar_t *name);
+void *MapViewOfFile(HANDLE map, DWORD access, DWORD offset_high, DWORD offset_low, size_t size);
+BOOL UnmapViewOfFile(const void *addr);
+UINT GetACP(void);
+DWORD GetLastError(void);
+int MultiByteToWideChar(UINT code_page, DWORD flags, const char *mb_ptr, int mb_len, wchar_t *w_ptr, int w_len);
+int WideCharToMultiByte(UINT code_page, DWORD flags, const wchar_t *w_ptr, int w_len, char *mb_ptr, int mb_len,
+						const char *default_char, BOOL *used_default_char);
+
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,357 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *	bench_vtparse
+ *		L^Mf[^ ttcore(VTParse(), null display backend) ɗ
+ *		X[vbgv
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <windows.h>
+
+#include "tttypes_charset.h"
+#include "tttypes.h"
+#include "nulldisp.h"
+
+#define MiB  (1024.0 * 1024.0)
+
+// allocation counter
+//	glibc ̂Ƃ malloc() 肵Đ
+static unsigned long long AllocCount;
+#if defined(__GLIBC__)
+#define ALLOC_COUNT_ENABLE	1
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t nmemb, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+	AllocCount++;
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+	AllocCount++;
+	return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	AllocCount++;
+	return __libc_realloc(ptr, size);
+}
+}
+#else
+#define ALLOC_COUNT_ENABLE	0
+#endif
+
+typedef struct {
+	char *name;
+	BYTE *data;
+	size_t len;
+} Input;
+
+static const struct {
+	const char *name;
+	WORD code;
+} CodeList[] = {
+	{ "utf8", IdUTF8 },
+	{ "sjis", IdSJIS },
+	{ "eucjp", IdEUC },
+	{ "jis", IdJIS },
+	{ "iso8859-1", IdISO8859_1 },
+	{ "koi8", IdKOI8 },
+};
+
+static void Usage(void)
+{
+	printf(
+		"usage: bench_vtparse [options] [file ...]\n"
+		"  -k code     kanji code (utf8, sjis, eucjp, jis, iso8859-1, koi8) default utf8\n"
+		"  -r count    repeat count (default: at least 64MB per input)\n"
+		"  -s size     receive chunk size (default 65536 = InBuffSizeMin)\n"
+		"  -g COLSxROWS terminal size (default 80x24)\n"
+		"  -b          also run byte-at-a-time parser for comparison\n"
+		"  file        recorded byte stream (vttest dump, ls --color -R, htop capture, ...)\n"
+		"              without file, synthetic streams are used\n");
+}
+
+static BYTE *ReadAll(const char *fname, size_t *len)
+{
+	FILE *fp = fopen(fname, "rb");
+	BYTE *buf = NULL;
+	size_t size = 0;
+	size_t cap = 0;
+	if (fp == NULL) {
+		return NULL;
+	}
+	for (;;) {
+		size_t r;
+		if (size == cap) {
+			BYTE *p;
+			cap = (cap == 0) ? 64 * 1024 : cap * 2;
+			p = (BYTE *)realloc(buf, cap);
+			if (p == NULL) {
+				free(buf);
+				fclose(fp);
+				return NULL;
+			}
+			buf = p;
+		}
+		r = fread(buf + size, 1, cap - size, fp);
+		if (r == 0) {
+			break;
+		}
+		size += r;
+	}
+	fclose(fp);
+	*len = size;
+	return buf;
+}
+
+/**
+ *	 pattern  len byte ȏɂȂ܂ŌJԂobt@
+ */
+static BYTE *Repeat(const char *pattern, size_t len, size_t *out_len)
+{
+	size_t plen = strlen(pattern);
+	size_t count = (len + plen - 1) / plen;
+	BYTE *buf = (BYTE *)malloc(plen * count);
+	size_t i;
+	for (i = 0; i < count; i++) {
+		memcpy(buf + plen * i, pattern, plen);
+	}
+	*out_len = plen * count;
+	return buf;
+}
+
+static void AddInput(Input **list, int *count, const char *name, BYTE *data, size_t len)
+{
+	Input *p = (Input *)realloc(*list, sizeof(Input) * (*count + 1));
+	if (p == NULL) {
+		return;
+	}
+	p[*count].name = _strdup(name);
+	p[*count].data = data;
+	p[*count].len = len;
+	*list = p;
+	(*count)++;
+}
+
+/**
+ *	t@Cw肳ȂƂ̓
+ */
+static void AddSyntheticInputs(Input **list, int *count, BOOL utf8)
+{
+	const size_t size = 4 * 1024 * 1024;
+	size_t len;
+	BYTE *data;
+
+	// rhO
+	data = Repeat(
+		"2026-10-17 12:34:56.789 [INFO] [ 42%] Building C object teraterm/CMakeFiles/teraterm.dir/vtterm.c.obj\r\n"
+		"2026-10-17 12:34:56.790 [INFO] cc -O2 -Wall -c buffer.c -o buffer.o -DUNICODE -D_UNICODE -I../common\r\n",
+		size, &len);
+	AddInput(list, count, "build-log", data, len);
+
+	// ls --color 
+	data = Repeat(
+		"\x1b[0m\x1b[01;34mcommon\x1b[0m  \x1b[01;32mbuild.sh\x1b[0m  README.md  "
+		"\x1b[01;31mlibs.tar.gz\x1b[0m  \x1b[01;36mlink\x1b[0m  vtterm.c  buffer.c\r\n",
+		size, &len);
+	AddInput(list, count, "ls-color", data, len);
+
+	// htop  (J[\ړ + SGR)
+	data = Repeat(
+		"\x1b[2;1H\x1b[30;42m  PID USER      PRI  NI  VIRT   RES   SHR S CPU% MEM%   TIME+  Command\x1b[K"
+		"\x1b[3;1H\x1b[0m 1234 root       20   0 12.3G  1.2G 45678 S 12.5  3.4  1:23.45 "
+		"\x1b[1mttermpro\x1b[0m\x1b[K\x1b[24;1H\x1b[30;46mF1\x1b[0mHelp  ",
+		size, &len);
+	AddInput(list, count, "htop", data, len);
+
+	if (!utf8) {
+		return;
+	}
+
+	// { UTF-8
+	data = Repeat(
+		"\xe3\x83\x93\xe3\x83\xab\xe3\x83\x89\xe3\x83\xad\xe3\x82\xb0\xe3\x81\xae"
+		"\xe8\xa1\xa8\xe7\xa4\xba\xe3\x83\x86\xe3\x82\xb9\xe3\x83\x88 "
+		"Tera Term \xe7\xab\xaf\xe6\x9c\xab\xe3\x82\xa8\xe3\x83\x9f\xe3\x83\xa5"
+		"\xe3\x83\xac\xe3\x83\xbc\xe3\x82\xbf\r\n",
+		size, &len);
+	AddInput(list, count, "cjk-utf8", data, len);
+
+	// , G
+	data = Repeat(
+		"e\xcc\x81 a\xcc\x88 \xe0\xa4\x95\xe0\xa5\x8d\xe0\xa4\xb7 "
+		"\xf0\x9f\x91\xa8\xe2\x80\x8d\xf0\x9f\x91\xa9\xe2\x80\x8d\xf0\x9f\x91\xa7 "
+		"\xe2\x9d\xa4\xef\xb8\x8f \xf0\x9f\x91\x8d\xf0\x9f\x8f\xbd\r\n",
+		size, &len);
+	AddInput(list, count, "combining", data, len);
+}
+
+static void Bench(const Input *in, WORD kanji_code, int cols, int rows, size_t chunk, int repeat, BOOL bytewise)
+{
+	NullDispStat stat;
+	unsigned long long alloc_start;
+	double sec;
+	double total;
+	int r;
+
+	NullDispInit(cols, rows, kanji_code);
+	NullDispSetBytewise(bytewise);
+
+	alloc_start = AllocCount;
+	auto start = std::chrono::steady_clock::now();
+	for (r = 0; r < repeat; r++) {
+		size_t pos = 0;
+		while (pos < in->len) {
+			size_t len = in->len - pos;
+			if (len > chunk) {
+				len = chunk;
+			}
+			NullDispParse(in->data + pos, len);
+			pos += len;
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+	sec = std::chrono::duration<double>(end - start).count();
+
+	NullDispGetStat(&stat);
+	total = (double)stat.bytes;
+	printf("%-16s %-5s %10.1f %9.1f %8.3f",
+		   in->name, bytewise ? "byte" : "run",
+		   total / MiB, total / MiB / sec, sec * 1e9 / total);
+	if (ALLOC_COUNT_ENABLE) {
+		printf(" %10.2f", (double)(AllocCount - alloc_start) / (total / MiB));
+	}
+	else {
+		printf(" %10s", "-");
+	}
+	printf(" %12llu %12llu\n", stat.draws, stat.scrolls);
+
+	NullDispFinish();
+}
+
+int main(int argc, char *argv[])
+{
+	WORD kanji_code = IdUTF8;
+	int repeat = 0;
+	size_t chunk = InBuffSizeMin;
+	int cols = 80;
+	int rows = 24;
+	BOOL bytewise = FALSE;
+	Input *inputs = NULL;
+	int input_count = 0;
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		const char *arg = argv[i];
+		if (strcmp(arg, "-k") == 0 && i + 1 < argc) {
+			const char *name = argv[++i];
+			size_t j;
+			for (j = 0; j < _countof(CodeList); j++) {
+				if (strcmp(name, CodeList[j].name) == 0) {
+					kanji_code = CodeList[j].code;
+					break;
+				}
+			}
+			if (j == _countof(CodeList)) {
+				fprintf(stderr, "unknown kanji code '%s'\n", name);
+				return 1;
+			}
+		}
+		else if (strcmp(arg, "-r") == 0 && i + 1 < argc) {
+			repeat = atoi(argv[++i]);
+		}
+		else if (strcmp(arg, "-s") == 0 && i + 1 < argc) {
+			chunk = (size_t)atoi(argv[++i]);
+		}
+		else if (strcmp(arg, "-g") == 0 && i + 1 < argc) {
+			if (sscanf(argv[++i], "%dx%d", &cols, &rows) != 2) {
+				Usage();
+				return 1;
+			}
+		}
+		else if (strcmp(arg, "-b") == 0) {
+			bytewise = TRUE;
+		}
+		else if (arg[0] == '-') {
+			Usage();
+			return arg[1] == 'h' ? 0 : 1;
+		}
+		else {
+			size_t len;
+			BYTE *data = ReadAll(arg, &len);
+			if (data == NULL || len == 0) {
+				fprintf(stderr, "can not read '%s'\n", arg);
+				free(data);
+				return 1;
+			}
+			AddInput(&inputs, &input_count, arg, data, len);
+		}
+	}
+	if (chunk == 0 || cols < 2 || rows < 1) {
+		Usage();
+		return 1;
+	}
+	if (input_count == 0) {
+		AddSyntheticInputs(&inputs, &input_count, kanji_code == IdUTF8);
+	}
+
+	printf("%-16s %-5s %10s %9s %8s %10s %12s %12s\n",
+		   "input", "mode", "MB", "MB/s", "ns/byte", "allocs/MB", "draws", "scrolls");
+	for (i = 0; i < input_count; i++) {
+		const Input *in = &inputs[i];
+		int r = repeat;
+		if (r <= 0) {
+			r = (int)(64 * MiB / in->len);
+			if (r < 1) {
+				r = 1;
+			}
+		}
+		Bench(in, kanji_code, cols, rows, chunk, r, FALSE);
+		if (bytewise) {
+			Bench(in, kanji_code, cols, rows, chunk, r, TRUE);
+		}
+	}
+
+	for (i = 0; i < input_count; i++) {
+		free(inputs[i].name);
+		free(inputs[i].data);
+	}
+	free(inputs);
+	return 0;
+}
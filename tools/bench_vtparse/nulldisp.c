@@ -0,0 +1,611 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *	null display backend
+ *		vtdisp.c ̑
+ *		XN[ʒǔvZ vtdisp.c ƓŁA
+ *		EBhEւ̕`AXN[͍s킸ɐ
+ */
+
+#include <windows.h>
+#include <string.h>
+
+#include "teraterm.h"
+#include "tttypes.h"
+#include "ttwinman.h"
+#include "buffer.h"
+#include "vtterm.h"
+#include "vtdisp.h"
+#include "makeoutputstring.h"
+#include "nullwin.h"
+#include "nulldisp.h"
+
+int WinWidth, WinHeight;
+HFONT VTFont[AttrFontMask+1];
+int FontHeight, FontWidth, ScreenWidth, ScreenHeight;
+BOOL AdjustSize, DontChangeSize = FALSE;
+int CursorX, CursorY;
+int WinOrgX, WinOrgY, NewOrgX, NewOrgY;
+int NumOfLines, NumOfColumns;
+int PageStart, BuffEnd;
+TCharAttr DefCharAttr = {
+	AttrDefault,
+	AttrDefault,
+	AttrDefault,
+	AttrDefaultFG,
+	AttrDefaultBG
+};
+
+BOOL IMEstat;
+BOOL IMECompositionState;
+
+static int ScrollCount = 0;
+static int dScroll = 0;
+static int SRegionTop;
+static int SRegionBottom;
+
+static BOOL CaretEnabled = TRUE;
+static int CaretStatus;
+
+static NullDispStat Stat;
+
+void NullDispInit(int cols, int rows, WORD kanji_code)
+{
+	memset(&Stat, 0, sizeof(Stat));
+
+	NullWinInit(kanji_code);
+	ts.TerminalWidth = cols;
+	ts.TerminalHeight = rows;
+
+	InitBuffer(TRUE);
+	InitDisp();
+
+	cv.StateEcho = MakeOutputStringCreate();
+	cv.StateSend = MakeOutputStringCreate();
+
+	ResetTerminal();
+	BuffChangeWinSize(NumOfColumns, NumOfLines);
+}
+
+void NullDispFinish(void)
+{
+	EndTerm();
+	FreeBuffer();
+	EndDisp();
+
+	MakeOutputStringDestroy(cv.StateEcho);
+	MakeOutputStringDestroy(cv.StateSend);
+	cv.StateEcho = NULL;
+	cv.StateSend = NULL;
+
+	NullWinFinish();
+}
+
+/**
+ *	1byte]̕@ɂ
+ *		oCiO擾ƓԂɂ
+ *		VTParse()  ParsePrintableRun() gpȂ
+ */
+void NullDispSetBytewise(BOOL bytewise)
+{
+	NullWinSetBinaryLog(bytewise);
+}
+
+/**
+ *	Mf[^
+ *		Mobt@(cv.InBuff)ɓāAɂȂ܂ VTParse() Ă
+ *		(OnIdle() Ɠ)
+ */
+void NullDispParse(const BYTE *ptr, size_t len)
+{
+	while (len > 0) {
+		size_t n = len;
+		if (n > (size_t)cv.InBuffMax) {
+			n = (size_t)cv.InBuffMax;
+		}
+		memcpy(cv.InBuff, ptr, n);
+		cv.InPtr = 0;
+		cv.InBuffCount = (int)n;
+		while (cv.InBuffCount > 0) {
+			VTParse();
+		}
+		Stat.bytes += n;
+		ptr += n;
+		len -= n;
+	}
+}
+
+void NullDispGetStat(NullDispStat *stat)
+{
+	*stat = Stat;
+}
+
+void InitDisp(void)
+{
+	// `悵Ȃ̂ŌŒl
+	FontWidth = 8;
+	FontHeight = 16;
+
+	ScrollCount = 0;
+	dScroll = 0;
+	CaretEnabled = TRUE;
+	CaretStatus = 0;
+}
+
+void EndDisp(void)
+{
+}
+
+void DispReset(void)
+{
+	/* Cursor */
+	CursorX = 0;
+	CursorY = 0;
+
+	/* Scroll status */
+	ScrollCount = 0;
+	dScroll = 0;
+
+	DispEnableCaret(TRUE); // enable caret
+}
+
+void DispConvWinToScreen(int Xw, int Yw, int *Xs, int *Ys, PBOOL Right)
+{
+	*Xs = Xw / FontWidth + WinOrgX;
+	*Ys = Yw / FontHeight + WinOrgY;
+	if (Right != NULL) {
+		*Right = (Xw % FontWidth) >= FontWidth / 2;
+	}
+}
+
+void DispConvScreenToWin(int Xs, int Ys, int *Xw, int *Yw)
+{
+	if (Xw != NULL) {
+		*Xw = (Xs - WinOrgX) * FontWidth;
+	}
+	if (Yw != NULL) {
+		*Yw = (Ys - WinOrgY) * FontHeight;
+	}
+}
+
+void ChangeFont(void)
+{
+}
+
+void ResetIME(void)
+{
+}
+
+void ChangeCaret(void)
+{
+}
+
+void CaretKillFocus(BOOL show)
+{
+	(void)show;
+}
+
+void UpdateCaretPosition(BOOL enforce)
+{
+	(void)enforce;
+}
+
+void CaretOn(void)
+{
+	CaretStatus = 0;
+}
+
+void CaretOff(void)
+{
+	CaretStatus = 1;
+}
+
+void DispDestroyCaret(void)
+{
+}
+
+BOOL IsCaretOn(void)
+{
+	return CaretStatus == 0;
+}
+
+void DispEnableCaret(BOOL On)
+{
+	if (!On) {
+		CaretOff();
+	}
+	CaretEnabled = On;
+}
+
+BOOL IsCaretEnabled(void)
+{
+	return CaretEnabled;
+}
+
+void DispSetCaretWidth(BOOL DW)
+{
+	(void)DW;
+}
+
+void DispChangeWinSize(int Nx, int Ny)
+{
+	WinWidth = Nx;
+	WinHeight = Ny;
+
+	ScreenWidth = WinWidth * FontWidth;
+	ScreenHeight = WinHeight * FontHeight;
+
+	AdjustScrollBar();
+}
+
+void DispClearWin(void)
+{
+	WinOrgX = 0;
+	WinOrgY = 0;
+	NewOrgX = 0;
+	NewOrgY = 0;
+}
+
+void DispChangeBackground(void)
+{
+}
+
+void DispChangeWin(void)
+{
+}
+
+void DispInitDC(void)
+{
+}
+
+void DispReleaseDC(void)
+{
+}
+
+void DispSetupDC(TCharAttr Attr, BOOL Reverse)
+{
+	(void)Attr;
+	(void)Reverse;
+}
+
+/**
+ *	`̑ɐāA*X 𕶎̕i߂
+ */
+static void DrawStr(const char *WidthInfo, int Count, int *X)
+{
+	int cell = 0;
+	int i;
+	for (i = 0; i < Count; i++) {
+		cell += WidthInfo[i];
+	}
+	Stat.draws++;
+	Stat.cells += cell;
+	*X += cell * FontWidth;
+}
+
+void DispStrA(const char *Buff, const char *WidthInfo, int Count, int Y, int* X)
+{
+	(void)Buff;
+	(void)Y;
+	DrawStr(WidthInfo, Count, X);
+}
+
+void DispStrW(const wchar_t *StrW, const char *WidthInfo, int Count, int Y, int* X)
+{
+	(void)StrW;
+	(void)Y;
+	DrawStr(WidthInfo, Count, X);
+}
+
+BOOL DispDeleteLines(int Count, int YEnd)
+{
+	if (YEnd + 1 - WinOrgY <= WinHeight) {
+		Stat.scrolls += Count;
+		return TRUE;
+	}
+	return FALSE;
+}
+
+BOOL DispInsertLines(int Count, int YEnd)
+{
+	(void)YEnd;
+	if (CursorY >= WinOrgY) {
+		Stat.scrolls += Count;
+		return TRUE;
+	}
+	return FALSE;
+}
+
+BOOL IsLineVisible(int* X, int* Y)
+{
+	if ((dScroll != 0) &&
+		(*Y >= SRegionTop) &&
+		(*Y <= SRegionBottom)) {
+		*Y = *Y + dScroll;
+		if ((*Y < SRegionTop) || (*Y > SRegionBottom)) {
+			return FALSE;
+		}
+	}
+
+	if ((*Y < WinOrgY) ||
+		(*Y >= WinOrgY + WinHeight)) {
+		return FALSE;
+	}
+
+	/* screen coordinate -> window coordinate */
+	*X = (*X - WinOrgX) * FontWidth;
+	*Y = (*Y - WinOrgY) * FontHeight;
+	return TRUE;
+}
+
+//-------------- scrolling functions --------------------
+
+void AdjustScrollBar(void)
+{
+	WinOrgX = 0;
+	WinOrgY = BuffEnd - WinHeight - PageStart;
+	if (WinOrgY < -PageStart) {
+		WinOrgY = -PageStart;
+	}
+	NewOrgX = WinOrgX;
+	NewOrgY = WinOrgY;
+}
+
+void DispScrollToCursor(int CurX, int CurY)
+{
+	if (CurX < NewOrgX) {
+		NewOrgX = CurX;
+	}
+	else if (CurX >= NewOrgX + WinWidth) {
+		NewOrgX = CurX + 1 - WinWidth;
+	}
+
+	if (CurY < NewOrgY) {
+		NewOrgY = CurY;
+	}
+	else if (CurY >= NewOrgY + WinHeight) {
+		NewOrgY = CurY + 1 - WinHeight;
+	}
+}
+
+void DispScrollNLines(int Top, int Bottom, int Direction)
+{
+	if (((dScroll * Direction < 0) || (dScroll * Direction > 0)) &&
+		(((SRegionTop != Top) || (SRegionBottom != Bottom)))) {
+		DispUpdateScroll();
+	}
+	SRegionTop = Top;
+	SRegionBottom = Bottom;
+	dScroll = dScroll + Direction;
+	if (Direction > 0) {
+		DispCountScroll(Direction);
+	}
+	else {
+		DispCountScroll(-Direction);
+	}
+}
+
+void DispCountScroll(int n)
+{
+	ScrollCount = ScrollCount + n;
+	if (ScrollCount >= ts.ScrollThreshold) {
+		DispUpdateScroll();
+	}
+}
+
+void DispUpdateScroll(void)
+{
+	ScrollCount = 0;
+
+	/* Update partial scroll */
+	if (dScroll != 0) {
+		Stat.scrolls += (dScroll > 0) ? dScroll : -dScroll;
+		dScroll = 0;
+	}
+
+	/* Update normal scroll */
+	if (NewOrgX < 0) {
+		NewOrgX = 0;
+	}
+	if (NewOrgX > NumOfColumns - WinWidth) {
+		NewOrgX = NumOfColumns - WinWidth;
+	}
+	if (NewOrgY < -PageStart) {
+		NewOrgY = -PageStart;
+	}
+	if (NewOrgY > BuffEnd - WinHeight - PageStart) {
+		NewOrgY = BuffEnd - WinHeight - PageStart;
+	}
+
+	if (NewOrgY != WinOrgY) {
+		Stat.scrolls += (NewOrgY > WinOrgY) ? NewOrgY - WinOrgY : WinOrgY - NewOrgY;
+	}
+
+	WinOrgX = NewOrgX;
+	WinOrgY = NewOrgY;
+}
+
+void DispUpdateScrollBar(void)
+{
+}
+
+BOOL DispUpdateScrollPos(void)
+{
+	BOOL Changed;
+
+	ScrollCount = 0;
+
+	if (NewOrgX < 0) {
+		NewOrgX = 0;
+	}
+	if (NewOrgX > NumOfColumns - WinWidth) {
+		NewOrgX = NumOfColumns - WinWidth;
+	}
+	if (NewOrgY < -PageStart) {
+		NewOrgY = -PageStart;
+	}
+	if (NewOrgY > BuffEnd - WinHeight - PageStart) {
+		NewOrgY = BuffEnd - WinHeight - PageStart;
+	}
+
+	Changed = (NewOrgX != WinOrgX) || (NewOrgY != WinOrgY);
+
+	WinOrgX = NewOrgX;
+	WinOrgY = NewOrgY;
+
+	return Changed;
+}
+
+void DispScrollHomePos(void)
+{
+	NewOrgX = 0;
+	NewOrgY = 0;
+	DispUpdateScroll();
+}
+
+void DispAutoScroll(POINT p)
+{
+	(void)p;
+}
+
+void DispHScroll(int Func, int Pos)
+{
+	(void)Func;
+	(void)Pos;
+}
+
+void DispVScroll(int Func, int Pos)
+{
+	(void)Func;
+	(void)Pos;
+}
+
+void DispRestoreWinSize(void)
+{
+}
+
+void DispSetWinPos(void)
+{
+}
+
+void DispSetActive(BOOL ActiveFlag)
+{
+	(void)ActiveFlag;
+}
+
+int TCharAttrCmp(TCharAttr a, TCharAttr b)
+{
+	if (a.Attr == b.Attr &&
+		a.Attr2 == b.Attr2 &&
+		a.Fore == b.Fore &&
+		a.Back == b.Back) {
+		return 0;
+	}
+	else {
+		return 1;
+	}
+}
+
+void DispSetColor(unsigned int num, COLORREF color)
+{
+	(void)num;
+	(void)color;
+}
+
+void DispResetColor(unsigned int num)
+{
+	(void)num;
+}
+
+COLORREF DispGetColor(unsigned int num)
+{
+	(void)num;
+	return 0;
+}
+
+void DispSetCurCharAttr(const TCharAttr *Attr)
+{
+	(void)Attr;
+}
+
+void DispMoveWindow(int x, int y)
+{
+	(void)x;
+	(void)y;
+}
+
+void DispShowWindow(int mode)
+{
+	(void)mode;
+}
+
+void DispResizeWin(int w, int h)
+{
+	(void)w;
+	(void)h;
+}
+
+BOOL DispWindowIconified(void)
+{
+	return FALSE;
+}
+
+void DispGetWindowPos(int *x, int *y, BOOL client)
+{
+	(void)client;
+	*x = 0;
+	*y = 0;
+}
+
+void DispGetWindowSize(int *width, int *height, BOOL client)
+{
+	(void)client;
+	*width = ScreenWidth;
+	*height = ScreenHeight;
+}
+
+void DispGetRootWinSize(int *x, int *y, BOOL inPixels)
+{
+	if (inPixels) {
+		*x = ScreenWidth;
+		*y = ScreenHeight;
+	}
+	else {
+		*x = NumOfColumns;
+		*y = NumOfLines;
+	}
+}
+
+int DispFindClosestColor(int red, int green, int blue)
+{
+	(void)red;
+	(void)green;
+	(void)blue;
+	return 0;
+}
@@ -0,0 +1,956 @@
+/*
+ * (C) 2026- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ *	ttcore EBhEȂœ߂ stub
+ *		ttwinman.c, ttcmn.c, keyboard.c, filesys*.cpp, teraprn.cpp Ȃǂ̑
+ *		ʐMAOAAIME ͉Ȃ
+ */
+
+#include <windows.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "teraterm.h"
+#include "tttypes.h"
+#include "ttwinman.h"
+#include "ttcommon.h"
+#include "commlib.h"
+#include "keyboard.h"
+#include "ttlib.h"
+#include "filesys.h"
+#include "teraprn.h"
+#include "teraprnfile.h"
+#include "telnet.h"
+#include "ttime.h"
+#include "clipboar.h"
+#include "ttdde.h"
+#include "ttplug.h"
+#include "asprintf.h"
+#include "buffsearch.h"
+#include "makeoutputstring.h"
+#include "nullwin.h"
+
+// ttwinman.c
+HWND HVTWin = NULL;
+TTTSet ts;
+TComVar cv;
+BOOL KeybEnabled = TRUE;
+
+// keyboard.c
+BOOL AutoRepeatMode;
+BOOL AppliKeyMode, AppliCursorMode, AppliEscapeMode;
+BOOL Send8BitMode;
+
+// ttdde.c
+BOOL DDELog = FALSE;
+
+static BOOL BinaryLog;
+
+/**
+ *	ts, cv 
+ *		ts  installer/release/TERATERM.INI ǂݍ񂾂Ƃ̒l
+ */
+void NullWinInit(WORD kanji_code)
+{
+	memset(&ts, 0, sizeof(ts));
+	ts.KanjiCode = kanji_code;
+	ts.KanjiCodeSend = kanji_code;
+	ts.KanjiIn = IdKanjiInB;
+	ts.KanjiOut = IdKanjiOutB;
+	ts.TerminalID = IdVT100;
+	ts.CRReceive = IdCR;
+	ts.CRSend = IdCR;
+	ts.Beep = IdBeepOn;
+	ts.TermFlag = TF_ACCEPT8BITCTRL | TF_CTRLINKANJI | TF_ENABLESLINE | TF_ALTSCR |
+				  TF_LOCKTUID | TF_REMOTECLEARSBUFF;
+	ts.ColorFlag = CF_XTERM256 | CF_BOLDCOLOR | CF_BLINKCOLOR | CF_URLCOLOR | CF_UNDERLINE |
+				   CF_ANSICOLOR;
+	ts.WindowFlag = WF_WINDOWCHANGE | WF_WINDOWREPORT;
+	ts.ISO2022Flag = ISO2022_SHIFT_ALL;
+	ts.TabStopFlag = TABF_ALL;
+	ts.EnableScrollBuff = TRUE;
+	ts.ScrollBuffSize = 10000;
+	ts.ScrollBuffMax = 500000;
+	ts.ScrollThreshold = 12;
+	ts.MaxOSCBufferSize = 4096;
+	ts.UnicodeDecSpMapping = 3;
+	strncpy_s(ts.TerminalUID, sizeof(ts.TerminalUID), "FFFFFFFF", _TRUNCATE);
+
+	memset(&cv, 0, sizeof(cv));
+	cv.InBuffMax = InBuffSizeMin;
+	cv.InBuff = (BYTE *)malloc(cv.InBuffMax);
+	cv.PortType = IdFile;
+	cv.Ready = TRUE;
+
+	BinaryLog = FALSE;
+}
+
+void NullWinFinish(void)
+{
+	free(cv.InBuff);
+	cv.InBuff = NULL;
+	cv.InBuffMax = 0;
+	cv.Ready = FALSE;
+}
+
+/**
+ *	oCiO擾ɂ
+ *		t@Cւ̏o͍sȂ
+ */
+void NullWinSetBinaryLog(BOOL enable)
+{
+	BinaryLog = enable;
+}
+
+//-------------- ttcmn.c --------------------
+
+int WINAPI CommRead1Byte(PComVar cv, LPBYTE b)
+{
+	if (!cv->Ready || cv->InBuffCount == 0) {
+		return 0;
+	}
+	*b = cv->InBuff[cv->InPtr];
+	cv->InPtr++;
+	cv->InBuffCount--;
+	if (cv->InBuffCount == 0) {
+		cv->InPtr = 0;
+	}
+	return 1;
+}
+
+void WINAPI CommInsert1Byte(PComVar cv, BYTE b)
+{
+	if (!cv->Ready) {
+		return;
+	}
+
+	if (cv->InPtr == 0) {
+		if (cv->InBuffCount >= cv->InBuffMax) {
+			return;
+		}
+		memmove(&(cv->InBuff[1]), &(cv->InBuff[0]), cv->InBuffCount);
+	}
+	else {
+		cv->InPtr--;
+	}
+	cv->InBuff[cv->InPtr] = b;
+	cv->InBuffCount++;
+}
+
+// [͎̉̂Ă
+int WINAPI CommBinaryOut(PComVar cv, const char *B, int C)
+{
+	(void)cv;
+	(void)B;
+	return C;
+}
+
+int WINAPI CommTextOutW(PComVar cv, const wchar_t *B, int C)
+{
+	(void)cv;
+	(void)B;
+	return C;
+}
+
+int WINAPI CommTextEchoW(PComVar cv, const wchar_t *B, int C)
+{
+	(void)cv;
+	(void)B;
+	return C;
+}
+
+void CommResetSerial(PTTSet ts, PComVar cv, BOOL ClearBuffer)
+{
+	(void)ts;
+	(void)cv;
+	(void)ClearBuffer;
+}
+
+void WINAPI NotifyMessageW(PComVar cv, const wchar_t *message, const wchar_t *title, DWORD flag)
+{
+	(void)cv;
+	(void)message;
+	(void)title;
+	(void)flag;
+}
+
+//-------------- keyboard.c --------------------
+
+void ClearUserKey()
+{
+}
+
+void DefineUserKey(int NewKeyId, PCHAR NewKeyStr, int NewKeyLen)
+{
+	(void)NewKeyId;
+	(void)NewKeyStr;
+	(void)NewKeyLen;
+}
+
+BOOL ShiftKey()
+{
+	return FALSE;
+}
+
+BOOL ControlKey()
+{
+	return FALSE;
+}
+
+BOOL AltKey()
+{
+	return FALSE;
+}
+
+//-------------- ttwinman.c, ttime.c, telnet.c, ttplug.c --------------------
+
+void ChangeTitle(void)
+{
+}
+
+BOOL CanUseIME(void)
+{
+	return FALSE;
+}
+
+BOOL GetIMEOpenStatus(HWND hWnd)
+{
+	(void)hWnd;
+	return FALSE;
+}
+
+void SetIMEOpenStatus(HWND hWnd, BOOL stat)
+{
+	(void)hWnd;
+	(void)stat;
+}
+
+void TelChangeEcho(void)
+{
+}
+
+void TelInformWinSize(int nx, int ny)
+{
+	(void)nx;
+	(void)ny;
+}
+
+void PASCAL TTXSetWinSize(int rows, int cols)
+{
+	(void)rows;
+	(void)cols;
+}
+
+//-------------- filesys*.cpp, ttdde.c, clipboar.c --------------------
+
+BOOL BPStartReceive(BOOL macro, BOOL autostart)
+{
+	(void)macro;
+	(void)autostart;
+	return FALSE;
+}
+
+BOOL ZMODEMStartReceive(BOOL macro, BOOL autostart)
+{
+	(void)macro;
+	(void)autostart;
+	return FALSE;
+}
+
+BOOL ZMODEMStartSend(const wchar_t *fiename, WORD ParamBinaryFlag, BOOL autostart)
+{
+	(void)fiename;
+	(void)ParamBinaryFlag;
+	(void)autostart;
+	return FALSE;
+}
+
+/**
+ *	BinaryLog ̂ƂAOobt@ɂ͏ɗ]T
+ *	(VTParse() 1byte)
+ */
+BOOL FLogIsOpend(void)
+{
+	return BinaryLog;
+}
+
+BOOL FLogIsOpendText(void)
+{
+	return FALSE;
+}
+
+int FLogGetFreeCount(void)
+{
+	return FILESYS_LOG_FREE_SPACE;
+}
+
+void FLogPutUTF32(unsigned int u32)
+{
+	(void)u32;
+}
+
+void DDEPut1(BYTE b)
+{
+	(void)b;
+}
+
+int DDEGetCount(void)
+{
+	return 0;
+}
+
+BOOL CBSetTextW(HWND hWnd, const wchar_t *str_w, size_t str_len)
+{
+	(void)hWnd;
+	(void)str_w;
+	(void)str_len;
+	return FALSE;
+}
+
+void CBStartPasteB64(HWND HWin, PCHAR header, PCHAR footer)
+{
+	(void)HWin;
+	(void)header;
+	(void)footer;
+}
+
+//-------------- teraprn.cpp, teraprnfile.cpp --------------------
+
+int VTPrintInit(int PrnFlag)
+{
+	(void)PrnFlag;
+	return 0;
+}
+
+void PrnSetupDC(TCharAttr Attr, BOOL reverse)
+{
+	(void)Attr;
+	(void)reverse;
+}
+
+void PrnOutTextA(const char *Buff, const char *WidthInfo, int Count, void *data)
+{
+	(void)Buff;
+	(void)WidthInfo;
+	(void)Count;
+	(void)data;
+}
+
+void PrnOutTextW(const wchar_t *StrW, const char *WidthInfo, int Count, void *data)
+{
+	(void)StrW;
+	(void)WidthInfo;
+	(void)Count;
+	(void)data;
+}
+
+void PrnNewLine()
+{
+}
+
+void VTPrintEnd()
+{
+}
+
+PrintFile *OpenPrnFile(void)
+{
+	return NULL;
+}
+
+void ClosePrnFile(PrintFile *handle, void (*finish_callback)(PrintFile *handle))
+{
+	(void)handle;
+	(void)finish_callback;
+}
+
+void WriteToPrnFileUTF32(PrintFile *handle, unsigned int u32, BOOL Write)
+{
+	(void)handle;
+	(void)u32;
+	(void)Write;
+}
+
+void WriteToPrnFile(PrintFile *handle, BYTE b, BOOL Write)
+{
+	(void)handle;
+	(void)b;
+	(void)Write;
+}
+
+void PrnFinish(PrintFile *handle)
+{
+	(void)handle;
+}
+
+//-------------- buffsearch.c --------------------
+
+BuffTextRow *BuffTextRowAlloc(int len, BOOL need_x)
+{
+	size_t size = sizeof(BuffTextRow) + sizeof(wchar_t) * len;
+	BuffTextRow *row;
+
+	if (need_x) {
+		size += sizeof(WORD) * len;
+	}
+	row = (BuffTextRow *)malloc(size);
+	if (row == NULL) {
+		return NULL;
+	}
+	row->ref = 1;
+	row->len = len;
+	row->cells = 0;
+	row->text = (wchar_t *)(row + 1);
+	row->x = need_x ? (WORD *)(row->text + len) : NULL;
+	return row;
+}
+
+// XbhȂ̂ŎQƃJEg͔rȂ
+void BuffTextRowAddRef(BuffTextRow *row)
+{
+	row->ref++;
+}
+
+void BuffTextRowRelease(BuffTextRow *row)
+{
+	if (row != NULL && --row->ref == 0) {
+		free(row);
+	}
+}
+
+BuffSearch *BuffSearchStart(const wchar_t *pattern, DWORD options,
+							HWND hWnd, UINT msg, wchar_t **error)
+{
+	(void)pattern;
+	(void)options;
+	(void)hWnd;
+	(void)msg;
+	if (error != NULL) {
+		*error = NULL;
+	}
+	return NULL;
+}
+
+void BuffSearchEnd(BuffSearch *s)
+{
+	(void)s;
+}
+
+BOOL BuffSearchWantRows(BuffSearch *s)
+{
+	(void)s;
+	return FALSE;
+}
+
+void BuffSearchAddRows(BuffSearch *s, BuffTextRow **rows, int count, LONGLONG first_line, BOOL last)
+{
+	int i;
+	(void)s;
+	(void)first_line;
+	(void)last;
+	for (i = 0; i < count; i++) {
+		BuffTextRowRelease(rows[i]);
+	}
+	free(rows);
+}
+
+int BuffSearchGetCount(BuffSearch *s, BOOL *done)
+{
+	(void)s;
+	if (done != NULL) {
+		*done = TRUE;
+	}
+	return 0;
+}
+
+BOOL BuffSearchGetMatch(BuffSearch *s, int index, BuffSearchMatch *match)
+{
+	(void)s;
+	(void)index;
+	(void)match;
+	return FALSE;
+}
+
+//-------------- ttlib.c, ttlib_static_cpp.cpp, i18n.c, asprintf.cpp --------------------
+
+void OutputDebugPrintf(const char *fmt, ...)
+{
+	(void)fmt;
+}
+
+size_t GetI18nStrWW(const char *section, const char *key, const wchar_t *def, const wchar_t *iniFile, wchar_t **buf)
+{
+	(void)section;
+	(void)key;
+	(void)iniFile;
+	*buf = _wcsdup(def != NULL ? def : L"");
+	return wcslen(*buf) + 1;
+}
+
+BYTE ConvHexChar(BYTE b)
+{
+	if ((b>='0') && (b<='9')) {
+		return (b - 0x30);
+	}
+	else if ((b>='A') && (b<='F')) {
+		return (b - 0x37);
+	}
+	else if ((b>='a') && (b<='f')) {
+		return (b - 0x57);
+	}
+	else {
+		return 0;
+	}
+}
+
+// OSC 52 ̃Nbv{[h݂͍sȂ̂ŁAfR[hȂ
+int b64decode(PCHAR dst, int dsize, PCHAR src)
+{
+	(void)src;
+	if (dst == NULL || dsize == 0) {
+		return -1;
+	}
+	dst[0] = 0;
+	return 0;
+}
+
+int __ismbblead(BYTE b, int code_page)
+{
+	if (code_page == CP_ACP) {
+		code_page = (int)GetACP();
+	}
+	switch (code_page) {
+		case 932:
+			// { shift jis
+			if (((0x81 <= b) && (b <= 0x9f)) || ((0xe0 <= b) && (b <= 0xfc))) {
+				return TRUE;
+			}
+			return FALSE;
+		case 949:
+		case 936:
+		case 950:
+			if ((0xA1 <= b) && (b <= 0xFE)) {
+				return TRUE;
+			}
+			return FALSE;
+		default:
+			break;
+	}
+	return FALSE;
+}
+
+int aswprintf(wchar_t **strp, const wchar_t *fmt, ...)
+{
+	size_t size = 128;
+	for (;;) {
+		va_list ap;
+		int len;
+		wchar_t *p = (wchar_t *)malloc(sizeof(wchar_t) * size);
+		if (p == NULL) {
+			*strp = NULL;
+			return -1;
+		}
+		va_start(ap, fmt);
+		len = vswprintf(p, size, fmt, ap);
+		va_end(ap);
+		if (len >= 0 && (size_t)len < size) {
+			*strp = p;
+			return len;
+		}
+		free(p);
+		size *= 2;
+	}
+}
+
+void awcscat(wchar_t **dest, const wchar_t *add)
+{
+	size_t dest_len = (*dest != NULL) ? wcslen(*dest) : 0;
+	size_t add_len = wcslen(add);
+	wchar_t *p = (wchar_t *)realloc(*dest, sizeof(wchar_t) * (dest_len + add_len + 1));
+	if (p == NULL) {
+		return;
+	}
+	wmemcpy(p + dest_len, add, add_len + 1);
+	*dest = p;
+}
+
+void awcscats(wchar_t **dest, const wchar_t *add, ...)
+{
+	va_list ap;
+	va_start(ap, add);
+	while (add != NULL) {
+		awcscat(dest, add);
+		add = va_arg(ap, const wchar_t *);
+	}
+	va_end(ap);
+}
+
+#if !defined(_WIN32)
+//-------------- Win32 API --------------------
+
+static DWORD LastError;
+
+DWORD GetTickCount(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (DWORD)(t.tv_sec * 1000 + t.tv_nsec / 1000000);
+}
+
+void Sleep(DWORD ms)
+{
+	(void)ms;
+}
+
+BOOL MessageBeep(UINT type)
+{
+	(void)type;
+	return TRUE;
+}
+
+int MessageBox(HWND hWnd, const char *text, const char *caption, UINT type)
+{
+	(void)hWnd;
+	(void)text;
+	(void)caption;
+	(void)type;
+	return 0;
+}
+
+BOOL IsDBCSLeadByte(BYTE c)
+{
+	return __ismbblead(c, CP_ACP);
+}
+
+BOOL InvalidateRect(HWND hWnd, const RECT *rect, BOOL erase)
+{
+	(void)hWnd;
+	(void)rect;
+	(void)erase;
+	return TRUE;
+}
+
+BOOL UpdateWindow(HWND hWnd)
+{
+	(void)hWnd;
+	return TRUE;
+}
+
+void PostQuitMessage(int code)
+{
+	(void)code;
+}
+
+UINT_PTR SetTimer(HWND hWnd, UINT_PTR id, UINT elapse, TIMERPROC func)
+{
+	(void)hWnd;
+	(void)elapse;
+	(void)func;
+	return id;
+}
+
+BOOL KillTimer(HWND hWnd, UINT_PTR id)
+{
+	(void)hWnd;
+	(void)id;
+	return TRUE;
+}
+
+HINSTANCE ShellExecuteW(HWND hWnd, const wchar_t *op, const wchar_t *file, const wchar_t *param,
+						const wchar_t *dir, INT show)
+{
+	(void)hWnd;
+	(void)op;
+	(void)file;
+	(void)param;
+	(void)dir;
+	(void)show;
+	return NULL;
+}
+
+/*
+ *	ꎞt@C͍Ȃ
+ *	(kXN[obt@̓ubNɒu܂܂ɂ)
+ */
+void GetSystemInfo(SYSTEM_INFO *info)
+{
+	info->dwAllocationGranularity = 64 * 1024;
+}
+
+DWORD GetTempPathW(DWORD len, wchar_t *buf)
+{
+	(void)len;
+	(void)buf;
+	return 0;
+}
+
+UINT GetTempFileNameW(const wchar_t *path, const wchar_t *prefix, UINT unique, wchar_t *name)
+{
+	(void)path;
+	(void)prefix;
+	(void)unique;
+	(void)name;
+	return 0;
+}
+
+HANDLE CreateFileW(const wchar_t *name, DWORD access, DWORD share, void *sa, DWORD disposition,
+				   DWORD flags, HANDLE temp)
+{
+	(void)name;
+	(void)access;
+	(void)share;
+	(void)sa;
+	(void)disposition;
+	(void)flags;
+	(void)temp;
+	return INVALID_HANDLE_VALUE;
+}
+
+BOOL DeleteFileW(const wchar_t *name)
+{
+	(void)name;
+	return FALSE;
+}
+
+BOOL CloseHandle(HANDLE h)
+{
+	(void)h;
+	return TRUE;
+}
+
+BOOL WriteFile(HANDLE h, const void *buf, DWORD len, DWORD *written, void *overlapped)
+{
+	(void)h;
+	(void)buf;
+	(void)len;
+	(void)overlapped;
+	*written = 0;
+	return FALSE;
+}
+
+BOOL SetFilePointerEx(HANDLE h, LARGE_INTEGER distance, LARGE_INTEGER *new_pos, DWORD method)
+{
+	(void)h;
+	(void)distance;
+	(void)new_pos;
+	(void)method;
+	return FALSE;
+}
+
+BOOL DeviceIoControl(HANDLE h, DWORD code, void *in, DWORD in_size, void *out, DWORD out_size,
+					 DWORD *returned, void *overlapped)
+{
+	(void)h;
+	(void)code;
+	(void)in;
+	(void)in_size;
+	(void)out;
+	(void)out_size;
+	(void)overlapped;
+	*returned = 0;
+	return FALSE;
+}
+
+HANDLE CreateFileMappingW(HANDLE h, void *sa, DWORD protect, DWORD size_high, DWORD size_low,
+						  const wchar_t *name)
+{
+	(void)h;
+	(void)sa;
+	(void)protect;
+	(void)size_high;
+	(void)size_low;
+	(void)name;
+	return NULL;
+}
+
+void *MapViewOfFile(HANDLE map, DWORD access, DWORD offset_high, DWORD offset_low, size_t size)
+{
+	(void)map;
+	(void)access;
+	(void)offset_high;
+	(void)offset_low;
+	(void)size;
+	return NULL;
+}
+
+BOOL UnmapViewOfFile(const void *addr)
+{
+	(void)addr;
+	return TRUE;
+}
+
+/*
+ *	R[hy[Wϊ
+ *		ANSI R[hy[W UTF-8 Ƃ
+ *		wchar_t ɂ UTF-16  (Linux ł wchar_t  32bit)
+ */
+UINT GetACP(void)
+{
+	return CP_UTF8;
+}
+
+DWORD GetLastError(void)
+{
+	return LastError;
+}
+
+int MultiByteToWideChar(UINT code_page, DWORD flags, const char *mb_ptr, int mb_len, wchar_t *w_ptr, int w_len)
+{
+	const BYTE *p = (const BYTE *)mb_ptr;
+	const BYTE *end;
+	int out = 0;
+
+	if (code_page == CP_ACP) {
+		code_page = GetACP();
+	}
+	if (code_page != CP_UTF8) {
+		return 0;
+	}
+	if (mb_len < 0) {
+		mb_len = (int)strlen(mb_ptr) + 1;
+	}
+	end = p + mb_len;
+	while (p < end) {
+		unsigned int u32;
+		int n;
+		int i;
+		if (*p < 0x80) {
+			u32 = *p;
+			n = 1;
+		}
+		else if ((*p & 0xe0) == 0xc0) {
+			u32 = *p & 0x1f;
+			n = 2;
+		}
+		else if ((*p & 0xf0) == 0xe0) {
+			u32 = *p & 0x0f;
+			n = 3;
+		}
+		else if ((*p & 0xf8) == 0xf0) {
+			u32 = *p & 0x07;
+			n = 4;
+		}
+		else {
+			u32 = 0xfffd;
+			n = 0;
+		}
+		for (i = 1; i < n; i++) {
+			if (p + i >= end || (p[i] & 0xc0) != 0x80) {
+				u32 = 0xfffd;
+				n = i;
+				break;
+			}
+			u32 = (u32 << 6) | (p[i] & 0x3f);
+		}
+		if (u32 == 0xfffd && (flags & MB_ERR_INVALID_CHARS)) {
+			return 0;
+		}
+		p += (n == 0) ? 1 : n;
+
+		if (w_len != 0) {
+			if (out + ((u32 >= 0x10000) ? 2 : 1) > w_len) {
+				LastError = ERROR_INSUFFICIENT_BUFFER;
+				return 0;
+			}
+			if (u32 >= 0x10000) {
+				w_ptr[out] = (wchar_t)(0xd800 + ((u32 - 0x10000) >> 10));
+				w_ptr[out + 1] = (wchar_t)(0xdc00 + ((u32 - 0x10000) & 0x3ff));
+			}
+			else {
+				w_ptr[out] = (wchar_t)u32;
+			}
+		}
+		out += (u32 >= 0x10000) ? 2 : 1;
+	}
+	return out;
+}
+
+int WideCharToMultiByte(UINT code_page, DWORD flags, const wchar_t *w_ptr, int w_len, char *mb_ptr, int mb_len,
+						const char *default_char, BOOL *used_default_char)
+{
+	int out = 0;
+	int i;
+
+	(void)flags;
+	(void)default_char;
+	if (used_default_char != NULL) {
+		*used_default_char = FALSE;
+	}
+	if (code_page == CP_ACP) {
+		code_page = GetACP();
+	}
+	if (code_page != CP_UTF8) {
+		return 0;
+	}
+	if (w_len < 0) {
+		w_len = (int)wcslen(w_ptr) + 1;
+	}
+	for (i = 0; i < w_len; i++) {
+		unsigned int u32 = (unsigned int)w_ptr[i];
+		char buf[4];
+		int n;
+		if (u32 >= 0xd800 && u32 < 0xdc00 && i + 1 < w_len &&
+			(unsigned int)w_ptr[i + 1] >= 0xdc00 && (unsigned int)w_ptr[i + 1] < 0xe000) {
+			u32 = 0x10000 + ((u32 - 0xd800) << 10) + ((unsigned int)w_ptr[i + 1] - 0xdc00);
+			i++;
+		}
+		if (u32 < 0x80) {
+			buf[0] = (char)u32;
+			n = 1;
+		}
+		else if (u32 < 0x800) {
+			buf[0] = (char)(0xc0 | (u32 >> 6));
+			buf[1] = (char)(0x80 | (u32 & 0x3f));
+			n = 2;
+		}
+		else if (u32 < 0x10000) {
+			buf[0] = (char)(0xe0 | (u32 >> 12));
+			buf[1] = (char)(0x80 | ((u32 >> 6) & 0x3f));
+			buf[2] = (char)(0x80 | (u32 & 0x3f));
+			n = 3;
+		}
+		else {
+			buf[0] = (char)(0xf0 | (u32 >> 18));
+			buf[1] = (char)(0x80 | ((u32 >> 12) & 0x3f));
+			buf[2] = (char)(0x80 | ((u32 >> 6) & 0x3f));
+			buf[3] = (char)(0x80 | (u32 & 0x3f));
+			n = 4;
+		}
+		if (mb_len != 0) {
+			if (out + n > mb_len) {
+				LastError = ERROR_INSUFFICIENT_BUFFER;
+				return 0;
+			}
+			memcpy(mb_ptr + out, buf, n);
+		}
+		out += n;
+	}
+	return out;
+}
+#endif
@@ -21,8 +21,10 @@
 #define CHACHA_POLY_AEAD_H
 
 #include <sys/types.h>
+#if !defined(TTXSSH_HEADLESS)
 typedef unsigned int u_int32_t;
 typedef unsigned long long u_int64_t;
+#endif
 
 #include "poly1305.h"
 
@@ -33,10 +33,12 @@
 
 #include "cipher-ctr.h"
 
+// Cu CTR [hg
 struct ssh_aes_ctr_ctx
 {
-	AES_KEY		aes_ctx;
+	EVP_CIPHER_CTX	*evp;
 	unsigned char	aes_counter[AES_BLOCK_SIZE];
+	int		keyed;
 };
 
 #define DES_BLOCK_SIZE sizeof(DES_cblock)
@@ -74,6 +76,55 @@ ssh_ctr_inc(unsigned char *ctr, unsigned int len)
 			return;
 }
 
+// xɐL[Xg[̃ubN
+#define CTR_BATCH_BLOCKS	32
+#define CTR_MAX_BLOCK_SIZE	16
+
+// counter Í out ɏo͂
+typedef void (*ssh_ctr_block_func)(const void *key, const unsigned char *counter, unsigned char *out);
+
+/*
+ * CTR [ḧÍ/
+ * CTR_BATCH_BLOCKS ubÑL[Xg[܂Ƃ߂ĐĂA8byte  XOR 
+ * (Ō̒[ubÑL[Xg[̎ĉ͎Ă)
+ */
+static void
+ssh_ctr_crypt(ssh_ctr_block_func encrypt, const void *key, unsigned char *counter, unsigned int block_size,
+              unsigned char *dest, const unsigned char *src, size_t len)
+{
+	unsigned char ks[CTR_BATCH_BLOCKS * CTR_MAX_BLOCK_SIZE];
+
+	while (len > 0) {
+		size_t blocks = (len + block_size - 1) / block_size;
+		size_t n, i;
+
+		if (blocks > CTR_BATCH_BLOCKS)
+			blocks = CTR_BATCH_BLOCKS;
+		for (i = 0; i < blocks; i++) {
+			encrypt(key, counter, ks + i * block_size);
+			ssh_ctr_inc(counter, block_size);
+		}
+
+		n = blocks * block_size;
+		if (n > len)
+			n = len;
+		for (i = 0; i + sizeof(DWORD64) <= n; i += sizeof(DWORD64)) {
+			DWORD64 s, k;
+			memcpy(&s, src + i, sizeof(s));
+			memcpy(&k, ks + i, sizeof(k));
+			s ^= k;
+			memcpy(dest + i, &s, sizeof(s));
+		}
+		for (; i < n; i++)
+			dest[i] = src[i] ^ ks[i];
+
+		dest += n;
+		src += n;
+		len -= n;
+	}
+	SecureZeroMemory(ks, sizeof(ks));
+}
+
 //============================================================================
 // AES
 //============================================================================
@@ -81,21 +132,21 @@ static int
 ssh_aes_ctr(EVP_CIPHER_CTX *ctx, unsigned char *dest, const unsigned char *src, size_t len)
 {
 	struct ssh_aes_ctr_ctx *c;
-	unsigned int n = 0;
-	unsigned char buf[AES_BLOCK_SIZE];
+	int outl;
 
 	if (len == 0)
 		return (1);
-	if ((c = EVP_CIPHER_CTX_get_app_data(ctx)) == NULL)
+	if ((c = EVP_CIPHER_CTX_get_app_data(ctx)) == NULL || !c->keyed)
 		return (0);
 
-	while ((len--) > 0) {
-		if (n == 0) {
-			AES_encrypt(c->aes_counter, buf, &c->aes_ctx);
-			ssh_ctr_inc(c->aes_counter, AES_BLOCK_SIZE);
-		}
-		*(dest++) = *(src++) ^ buf[n];
-		n = (n + 1) % AES_BLOCK_SIZE;
+	// AES-NI ȂǂgCu̎ŁAubN܂Ƃ߂ď
+	while (len > 0) {
+		int n = len > 0x40000000 ? 0x40000000 : (int)len;
+		if (!EVP_EncryptUpdate(c->evp, dest, &outl, src, n))
+			return (0);
+		dest += n;
+		src += n;
+		len -= n;
 	}
 	return (1);
 }
@@ -106,13 +157,40 @@ ssh_aes_ctr_init(EVP_CIPHER_CTX *ctx, const unsigned char *key, const unsigned c
 	struct ssh_aes_ctr_ctx *c;
 
 	if ((c = EVP_CIPHER_CTX_get_app_data(ctx)) == NULL) {
-		c = malloc(sizeof(*c));
+		c = calloc(1, sizeof(*c));
+		if (c == NULL)
+			return (0);
+		c->evp = EVP_CIPHER_CTX_new();
+		if (c->evp == NULL) {
+			free(c);
+			return (0);
+		}
 		EVP_CIPHER_CTX_set_app_data(ctx, c);
 	}
-	if (key != NULL)
-		AES_set_encrypt_key(key, EVP_CIPHER_CTX_key_length(ctx) * 8, &c->aes_ctx);
 	if (iv != NULL)
 		memcpy(c->aes_counter, iv, AES_BLOCK_SIZE);
+	if (key != NULL) {
+		// ͍ŏ (key == NULL ) ĂяǒŐݒ肳̂ŁAnꂽ_őI
+		const EVP_CIPHER *type;
+		switch (EVP_CIPHER_CTX_key_length(ctx)) {
+		case 24:
+			type = EVP_aes_192_ctr();
+			break;
+		case 32:
+			type = EVP_aes_256_ctr();
+			break;
+		default:
+			type = EVP_aes_128_ctr();
+			break;
+		}
+		if (!EVP_EncryptInit_ex(c->evp, type, NULL, key, c->aes_counter))
+			return (0);
+		c->keyed = 1;
+	}
+	else if (iv != NULL && c->keyed) {
+		if (!EVP_EncryptInit_ex(c->evp, NULL, NULL, NULL, iv))
+			return (0);
+	}
 	return (1);
 }
 
@@ -122,6 +200,7 @@ ssh_aes_ctr_cleanup(EVP_CIPHER_CTX *ctx)
 	struct ssh_aes_ctr_ctx *c;
 
 	if((c = EVP_CIPHER_CTX_get_app_data(ctx)) != NULL) {
+		EVP_CIPHER_CTX_free(c->evp);
 		SecureZeroMemory(c, sizeof(*c));
 		free(c);
 		EVP_CIPHER_CTX_set_app_data(ctx, NULL);
@@ -170,27 +249,28 @@ evp_aes_128_ctr(void)
 //============================================================================
 // Triple-DES
 //============================================================================
+static void
+ssh_des3_ctr_block(const void *key, const unsigned char *counter, unsigned char *out)
+{
+	const struct ssh_des3_ctr_ctx *c = key;
+	DES_LONG buf[2];
+
+	memcpy(buf, counter, DES_BLOCK_SIZE);
+	DES_encrypt3(buf, (DES_key_schedule *)&c->des3_ctx[0], (DES_key_schedule *)&c->des3_ctx[1], (DES_key_schedule *)&c->des3_ctx[2]);
+	memcpy(out, buf, DES_BLOCK_SIZE);
+}
+
 static int
 ssh_des3_ctr(EVP_CIPHER_CTX *ctx, unsigned char *dest, const unsigned char *src, size_t len)
 {
 	struct ssh_des3_ctr_ctx *c;
-	unsigned int n = 0;
-	unsigned char buf[DES_BLOCK_SIZE];
 
 	if (len == 0)
 		return (1);
 	if ((c = EVP_CIPHER_CTX_get_app_data(ctx)) == NULL)
 		return (0);
 
-	while ((len--) > 0) {
-		if (n == 0) {
-			memcpy(buf, (unsigned char *)(c->des3_counter), DES_BLOCK_SIZE);
-			DES_encrypt3((DES_LONG *)buf, &c->des3_ctx[0], &c->des3_ctx[1], &c->des3_ctx[2]);
-			ssh_ctr_inc(c->des3_counter, DES_BLOCK_SIZE);
-		}
-		*(dest++) = *(src++) ^ buf[n];
-		n = (n + 1) % DES_BLOCK_SIZE;
-	}
+	ssh_ctr_crypt(ssh_des3_ctr_block, c, c->des3_counter, DES_BLOCK_SIZE, dest, src, len);
 	return (1);
 }
 
@@ -268,44 +348,36 @@ evp_des3_ctr(void)
 //============================================================================
 // Blowfish
 //============================================================================
+static void
+ssh_bf_ctr_block(const void *key, const unsigned char *counter, unsigned char *out)
+{
+	const struct ssh_blowfish_ctr_ctx *c = key;
+	BF_LONG tmp[2];
+
+	tmp[0] = ((BF_LONG)counter[0] << 24) | ((BF_LONG)counter[1] << 16) | ((BF_LONG)counter[2] << 8) | counter[3];
+	tmp[1] = ((BF_LONG)counter[4] << 24) | ((BF_LONG)counter[5] << 16) | ((BF_LONG)counter[6] << 8) | counter[7];
+	BF_encrypt(tmp, &c->blowfish_ctx);
+	out[0] = (unsigned char)(tmp[0] >> 24);
+	out[1] = (unsigned char)(tmp[0] >> 16);
+	out[2] = (unsigned char)(tmp[0] >> 8);
+	out[3] = (unsigned char)tmp[0];
+	out[4] = (unsigned char)(tmp[1] >> 24);
+	out[5] = (unsigned char)(tmp[1] >> 16);
+	out[6] = (unsigned char)(tmp[1] >> 8);
+	out[7] = (unsigned char)tmp[1];
+}
+
 static int
 ssh_bf_ctr(EVP_CIPHER_CTX *ctx, unsigned char *dest, const unsigned char *src, size_t len)
 {
 	struct ssh_blowfish_ctr_ctx *c;
-	unsigned int n = 0;
-	unsigned char buf[BF_BLOCK];
-	int i, j;
-	BF_LONG tmp[(BF_BLOCK + 3) / 4];
-	unsigned char *p;
 
 	if (len == 0)
 		return (1);
 	if ((c = EVP_CIPHER_CTX_get_app_data(ctx)) == NULL)
 		return (0);
 
-	while ((len--) > 0) {
-		if (n == 0) {
-			for (i = j = 0, p = c->blowfish_counter; i < BF_BLOCK; i += 4, j++) {
-				tmp[j]  = ((BF_LONG)*p++) << 24;
-				tmp[j] |= ((BF_LONG)*p++) << 16;
-				tmp[j] |= ((BF_LONG)*p++) << 8;
-				tmp[j] |= ((BF_LONG)*p++);
-			}
-
-			BF_encrypt(tmp, &c->blowfish_ctx);
-
-			for (i = j = 0, p = buf; i < BF_BLOCK; i += 4, j++) {
-				*p++ = (unsigned char)(tmp[j] >> 24);
-				*p++ = (unsigned char)(tmp[j] >> 16);
-				*p++ = (unsigned char)(tmp[j] >> 8);
-				*p++ = (unsigned char)tmp[j];
-			}
-
-			ssh_ctr_inc(c->blowfish_counter, BF_BLOCK);
-		}
-		*(dest++) = *(src++) ^ buf[n];
-		n = (n + 1) % BF_BLOCK;
-	}
+	ssh_ctr_crypt(ssh_bf_ctr_block, c, c->blowfish_counter, BF_BLOCK, dest, src, len);
 	return (1);
 }
 
@@ -381,44 +453,36 @@ evp_bf_ctr(void)
 //============================================================================
 // CAST-128
 //============================================================================
+static void
+ssh_cast5_ctr_block(const void *key, const unsigned char *counter, unsigned char *out)
+{
+	const struct ssh_cast5_ctr_ctx *c = key;
+	CAST_LONG tmp[2];
+
+	tmp[0] = ((CAST_LONG)counter[0] << 24) | ((CAST_LONG)counter[1] << 16) | ((CAST_LONG)counter[2] << 8) | counter[3];
+	tmp[1] = ((CAST_LONG)counter[4] << 24) | ((CAST_LONG)counter[5] << 16) | ((CAST_LONG)counter[6] << 8) | counter[7];
+	CAST_encrypt(tmp, &c->cast5_ctx);
+	out[0] = (unsigned char)(tmp[0] >> 24);
+	out[1] = (unsigned char)(tmp[0] >> 16);
+	out[2] = (unsigned char)(tmp[0] >> 8);
+	out[3] = (unsigned char)tmp[0];
+	out[4] = (unsigned char)(tmp[1] >> 24);
+	out[5] = (unsigned char)(tmp[1] >> 16);
+	out[6] = (unsigned char)(tmp[1] >> 8);
+	out[7] = (unsigned char)tmp[1];
+}
+
 static int
 ssh_cast5_ctr(EVP_CIPHER_CTX *ctx, unsigned char *dest, const unsigned char *src, size_t len)
 {
 	struct ssh_cast5_ctr_ctx *c;
-	unsigned int n = 0;
-	unsigned char buf[CAST_BLOCK];
-	int i, j;
-	CAST_LONG tmp[(CAST_BLOCK + 3) / 4];
-	unsigned char *p;
 
 	if (len == 0)
 		return (1);
 	if ((c = EVP_CIPHER_CTX_get_app_data(ctx)) == NULL)
 		return (0);
 
-	while ((len--) > 0) {
-		if (n == 0) {
-			for (i = j = 0, p = c->cast5_counter; i < CAST_BLOCK; i += 4, j++) {
-				tmp[j]  = ((CAST_LONG)*p++) << 24;
-				tmp[j] |= ((CAST_LONG)*p++) << 16;
-				tmp[j] |= ((CAST_LONG)*p++) << 8;
-				tmp[j] |= ((CAST_LONG)*p++);
-			}
-
-			CAST_encrypt(tmp, &c->cast5_ctx);
-
-			for (i = j = 0, p = buf; i < CAST_BLOCK; i += 4, j++) {
-				*p++ = (unsigned char)(tmp[j] >> 24);
-				*p++ = (unsigned char)(tmp[j] >> 16);
-				*p++ = (unsigned char)(tmp[j] >> 8);
-				*p++ = (unsigned char)tmp[j];
-			}
-
-			ssh_ctr_inc(c->cast5_counter, CAST_BLOCK);
-		}
-		*(dest++) = *(src++) ^ buf[n];
-		n = (n + 1) % CAST_BLOCK;
-	}
+	ssh_ctr_crypt(ssh_cast5_ctr_block, c, c->cast5_counter, CAST_BLOCK, dest, src, len);
 	return (1);
 }
 
@@ -494,26 +558,25 @@ evp_cast5_ctr(void)
 //============================================================================
 // Camellia
 //============================================================================
+static void
+ssh_camellia_ctr_block(const void *key, const unsigned char *counter, unsigned char *out)
+{
+	const struct ssh_camellia_ctr_ctx *c = key;
+
+	Camellia_encrypt(counter, out, &c->camellia_ctx);
+}
+
 static int
 ssh_camellia_ctr(EVP_CIPHER_CTX *ctx, unsigned char *dest, const unsigned char *src, size_t len)
 {
 	struct ssh_camellia_ctr_ctx *c;
-	unsigned int n = 0;
-	unsigned char buf[CAMELLIA_BLOCK_SIZE];
 
 	if (len == 0)
 		return (1);
 	if ((c = EVP_CIPHER_CTX_get_app_data(ctx)) == NULL)
 		return (0);
 
-	while ((len--) > 0) {
-		if (n == 0) {
-			Camellia_encrypt(c->camellia_counter, buf, &c->camellia_ctx);
-			ssh_ctr_inc(c->camellia_counter, CAMELLIA_BLOCK_SIZE);
-		}
-		*(dest++) = *(src++) ^ buf[n];
-		n = (n + 1) % CAMELLIA_BLOCK_SIZE;
-	}
+	ssh_ctr_crypt(ssh_camellia_ctr_block, c, c->camellia_counter, CAMELLIA_BLOCK_SIZE, dest, src, len);
 	return (1);
 }
 
@@ -269,14 +269,13 @@ err:
 	return FALSE;
 }
 
+// Mobt@ł̂܂ܕ
 BOOL CRYPT_decrypt_aead(PTInstVar pvar, unsigned char *data, unsigned int bytes, unsigned int aadlen, unsigned int authlen)
 {
-	unsigned char *newbuff = NULL;
 	unsigned int block_size = pvar->ssh2_keys[MODE_IN].enc.block_size;
 	unsigned char lastiv[1];
 	char tmp[80];
 	struct sshcipher_ctx *cc = pvar->cc[MODE_IN];
-	unsigned int newbuff_len = bytes;
 
 	if (bytes == 0)
 		return TRUE;
@@ -292,21 +291,11 @@ BOOL CRYPT_decrypt_aead(PTInstVar pvar, unsigned char *data, unsigned int bytes,
 
 	if (cc->cipher->id == SSH2_CIPHER_CHACHAPOLY) {
 		// chacha20-poly1305 ł aadlen ÍĂ
-		newbuff_len += aadlen;
-	}
-	if (newbuff_len > encbufflen) {
-		if ((newbuff = realloc(encbuff, newbuff_len)) == NULL)
-			goto err;
-		encbuff = newbuff;
-		encbufflen = newbuff_len;
-	}
-
-	if (cc->cipher->id == SSH2_CIPHER_CHACHAPOLY) {
+		// F؃f[^(AEAD tag)؂Ă畜̂ŁA͂Əo͂ł悢
 		if (chachapoly_crypt(cc->cp_ctx, pvar->ssh_state.receiver_sequence_number,
-		                     encbuff, data, bytes, aadlen, authlen, 0) != 0) {
+		                     data, data, bytes, aadlen, authlen, 0) != 0) {
 			goto err;
 		}
-		memcpy(data, encbuff, aadlen + bytes);
 		return TRUE;
 	}
 
@@ -320,11 +309,9 @@ BOOL CRYPT_decrypt_aead(PTInstVar pvar, unsigned char *data, unsigned int bytes,
 		goto err;
 
 	// AES-GCM ł aadlen ÍȂ̂ŁA̐悾
-	if (EVP_Cipher(cc->evp, encbuff, data+aadlen, bytes) < 0)
+	if (EVP_Cipher(cc->evp, data+aadlen, data+aadlen, bytes) < 0)
 		goto err;
 
-	memcpy(data+aadlen, encbuff, bytes);
-
 	if (EVP_Cipher(cc->evp, NULL, NULL, 0) < 0)
 		goto err;
 
@@ -378,9 +365,9 @@ static void crypt_SSH2_encrypt(PTInstVar pvar, unsigned char *buf, unsigned int
 	}
 }
 
+// EVP_Cipher() ͓͂Əo͂obt@ł悢̂ŁAMobt@ł̂܂ܕ
 static void crypt_SSH2_decrypt(PTInstVar pvar, unsigned char *buf, unsigned int bytes)
 {
-	unsigned char *newbuff;
 	int block_size = pvar->ssh2_keys[MODE_IN].enc.block_size;
 	char tmp[80];
 
@@ -397,20 +384,11 @@ static void crypt_SSH2_decrypt(PTInstVar pvar, unsigned char *buf, unsigned int
 		return;
 	}
 
-	if (bytes > encbufflen) {
-		if ((newbuff = malloc(bytes)) == NULL)
-			return;
-		encbuff = newbuff;
-		encbufflen = bytes;
-	}
-
-	if (EVP_Cipher(pvar->cc[MODE_IN]->evp, encbuff, buf, bytes) == 0) {
+	if (EVP_Cipher(pvar->cc[MODE_IN]->evp, buf, buf, bytes) == 0) {
 		UTIL_get_lang_msg("MSG_DECRYPT_ERROR2", pvar, "%s decrypt error(2)");
 		_snprintf_s(tmp, sizeof(tmp), _TRUNCATE, pvar->UIMsg,
 		            get_cipher_name(pvar->crypt_state.receiver_cipher));
 		notify_fatal_error(pvar, tmp, TRUE);
-	} else {
-		memcpy(buf, encbuff, bytes);
 	}
 }
 
@@ -820,7 +798,7 @@ unsigned int CRYPT_get_encrypted_session_key_len(PTInstVar pvar)
 	int host_key_bits;
 	int server_key_bytes;
 	int host_key_bytes;
-	BIGNUM *n;
+	const BIGNUM *n;
 
 	// OpenSSL 1.1.0łRSA\̂̃o[ɒڃANZXłȂ߁A
 	// RSA_get0_key֐Ŏ擾KvB
@@ -849,7 +827,7 @@ int CRYPT_choose_session_key(PTInstVar pvar,
 	int host_key_bytes;
 	int encrypted_key_bytes;
 	int bit_delta;
-	BIGNUM *server_n, *host_n;
+	const BIGNUM *server_n, *host_n;
 
 	// OpenSSL 1.1.0łRSA\̂̃o[ɒڃANZXłȂ߁A
 	// RSA_get0_key֐Ŏ擾KvB
@@ -962,7 +940,7 @@ int CRYPT_generate_RSA_challenge_response(PTInstVar pvar,
 	char *session_buf;
 	char decrypted_challenge[48];
 	int decrypted_challenge_len;
-	BIGNUM *server_n, *host_n;
+	const BIGNUM *server_n, *host_n;
 
 	// OpenSSL 1.1.0łRSA\̂̃o[ɒڃANZXłȂ߁A
 	// RSA_get0_key֐Ŏ擾KvB
@@ -1171,7 +1149,7 @@ void CRYPT_get_cipher_info(PTInstVar pvar, char *dest, int len)
 
 void CRYPT_get_server_key_info(PTInstVar pvar, char *dest, int len)
 {
-	BIGNUM *server_n, *host_n;
+	const BIGNUM *server_n, *host_n;
 
 	// OpenSSL 1.1.0łRSA\̂̃o[ɒڃANZXłȂ߁A
 	// RSA_get0_key֐Ŏ擾KvB
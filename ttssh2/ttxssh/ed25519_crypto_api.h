@@ -33,7 +33,11 @@
 #include <stdlib.h>
 
 #include "openssl/opensslv.h"	// for LIBRESSL_VERSION_NUMBER
-#ifndef LIBRESSL_VERSION_NUMBER
+#if defined(TTXSSH_HEADLESS)
+  // tools/bench_ssh (Linux) ł libc  stdint.h, arc4random_buf() g
+  #include <stdint.h>
+  #include <sys/types.h>
+#elif !defined(LIBRESSL_VERSION_NUMBER)
   #include "arc4random.h"
 #else
   #if defined(__MINGW32__) || (_MSC_VER >= 1600)
@@ -47,6 +51,7 @@
   #include "compat/stdlib.h"
 #endif
 
+#if !defined(TTXSSH_HEADLESS)
 typedef unsigned char u_int8_t;
 typedef unsigned short int u_int16_t;
 typedef unsigned int u_int32_t;
@@ -57,6 +62,7 @@ typedef u_int8_t uint8_t;
 typedef u_int16_t uint16_t;
 typedef u_int32_t uint32_t;
 typedef u_int64_t uint64_t;
+#endif
 
 typedef int crypto_int32;
 typedef unsigned int crypto_uint32;
@@ -46,6 +46,8 @@ See LICENSE.TXT for the license.
 #define WM_SOCK_GOTNAME (WM_APP+9997)
 
 #define CHANNEL_READ_BUF_SIZE 8192
+// SSH2 ł͑̍őpPbgTCY܂ł܂Ƃ߂ēǂ ()
+#define CHANNEL_READ_BUF_MAX (256 * 1024)
 
 static LRESULT CALLBACK accept_wnd_proc(HWND wnd, UINT msg, WPARAM wParam,
                                         LPARAM lParam);
@@ -666,7 +668,9 @@ static void accept_local_connection(PTInstVar pvar, int request_num, int listeni
 		channel->status |= FWD_BOTH_CONNECTED;
 
 	}
-	logprintf(150, "%s: channel info: %s", __FUNCTION__, dump_fwdchannel(channel));
+	if (LogLevel(pvar, 150)) {
+		logprintf(150, "%s: channel info: %s", __FUNCTION__, dump_fwdchannel(channel));
+	}
 }
 
 static void write_local_connection_buffer(PTInstVar pvar, int channel_num)
@@ -674,11 +678,11 @@ static void write_local_connection_buffer(PTInstVar pvar, int channel_num)
 	FWDChannel *channel = pvar->fwd_state.channels + channel_num;
 
 	if (channel->writebuf.datalen == 0) {
-		logprintf(LOG_LEVEL_VERBOSE, "%s: write buffer is empty. channel: %d", __FUNCTION__, channel_num);
+		logprintf(LOG_LEVEL_SSHDUMP, "%s: write buffer is empty. channel: %d", __FUNCTION__, channel_num);
 		return;
 	}
 
-	logprintf(LOG_LEVEL_VERBOSE, "%s: remained data length: %d, channel: %d", __FUNCTION__,
+	logprintf(LOG_LEVEL_SSHDUMP, "%s: remained data length: %d, channel: %d", __FUNCTION__,
 	          channel->writebuf.datalen, channel_num);
 
 	if ((channel->status & FWD_BOTH_CONNECTED) == FWD_BOTH_CONNECTED) {
@@ -704,14 +708,17 @@ static void read_local_connection(PTInstVar pvar, int channel_num)
 {
 	FWDChannel *channel = pvar->fwd_state.channels + channel_num;
 
-	logprintf(LOG_LEVEL_VERBOSE, "%s: channel=%d", __FUNCTION__, channel_num);
+	// ȉ̎MƂ̃O͗ʂ̂ŁALOG_LEVEL_SSHDUMP ŏo͂
+	logprintf(LOG_LEVEL_SSHDUMP, "%s: channel=%d", __FUNCTION__, channel_num);
 
 	if ((channel->status & FWD_BOTH_CONNECTED) != FWD_BOTH_CONNECTED) {
 		return;
 	}
 
 	while (channel->local_socket != INVALID_SOCKET) {
-		char buf[CHANNEL_READ_BUF_SIZE];
+		char stack_buf[CHANNEL_READ_BUF_SIZE];
+		char *buf = stack_buf;
+		int buflen = sizeof(stack_buf);
 		int amount;
 		int err = ERROR_SUCCESS;
 
@@ -724,10 +731,21 @@ static void read_local_connection(PTInstVar pvar, int channel_num)
 					__FUNCTION__, channel_num);
 				return;
 			}
+
+			// 1pPbgɓ镪܂Ƃ߂ēǂ
+			if (c != NULL && c->remote_maxpacket > CHANNEL_READ_BUF_SIZE) {
+				if (pvar->fwd_state.read_buf == NULL) {
+					pvar->fwd_state.read_buf = malloc(CHANNEL_READ_BUF_MAX);
+				}
+				if (pvar->fwd_state.read_buf != NULL) {
+					buf = pvar->fwd_state.read_buf;
+					buflen = (int)min(c->remote_maxpacket, (unsigned int)CHANNEL_READ_BUF_MAX);
+				}
+			}
 		}
 
 		// M(mubLO[h)
-		amount = recv(channel->local_socket, buf, sizeof(buf), 0);
+		amount = recv(channel->local_socket, buf, buflen, 0);
 
 		if (amount > 0) {
 			// Mf[^
@@ -735,9 +753,9 @@ static void read_local_connection(PTInstVar pvar, int channel_num)
 			FwdFilterResult action = FWD_FILTER_RETAIN;
 
 #if 1
-			logprintf(LOG_LEVEL_VERBOSE, "%s: recv()=%d", __FUNCTION__, amount);
+			logprintf(LOG_LEVEL_SSHDUMP, "%s: recv()=%d", __FUNCTION__, amount);
 #else
-			logprintf_hexdump(LOG_LEVEL_VERBOSE, buf, amount, "%s: recv()=%d", __FUNCTION__, amount);
+			logprintf_hexdump(LOG_LEVEL_SSHDUMP, buf, amount, "%s: recv()=%d", __FUNCTION__, amount);
 #endif
 
 			if (channel->filter != NULL) {
@@ -761,7 +779,7 @@ static void read_local_connection(PTInstVar pvar, int channel_num)
 			}
 		} else if (amount == 0 || (err = WSAGetLastError()) == WSAEWOULDBLOCK) {
 			// Mf[^Ȃ
-			logprintf(LOG_LEVEL_VERBOSE, "%s: recv()=%d err=%s(%d)", __FUNCTION__, amount,
+			logprintf(LOG_LEVEL_SSHDUMP, "%s: recv()=%d err=%s(%d)", __FUNCTION__, amount,
 					  err == WSAEWOULDBLOCK ? "WSAEWOULDBLOCK" : "-", err);
 			return;
 		} else {
@@ -822,7 +840,7 @@ void FWD_suspend_resume_local_connection(PTInstVar pvar, Channel_t* c, int notif
 
 	if (notify) {
 		// recvĊJ邩f
-		if (c->bufchain_amount <= FWD_LOW_WATER_MARK) {
+		if (c->bufchain.len <= FWD_LOW_WATER_MARK) {
 			// ̂ōĊJ
 			c->bufchain_recv_suspended = FALSE;
 
@@ -837,7 +855,7 @@ void FWD_suspend_resume_local_connection(PTInstVar pvar, Channel_t* c, int notif
 
 	} else {
 		// recv~邩f
-		if (c->bufchain_amount >= FWD_HIGH_WATER_MARK) {
+		if (c->bufchain.len >= FWD_HIGH_WATER_MARK) {
 			// 𒴂̂Œ~
 			c->bufchain_recv_suspended = TRUE;
 			changed = 1;
@@ -845,10 +863,10 @@ void FWD_suspend_resume_local_connection(PTInstVar pvar, Channel_t* c, int notif
 	}
 
 	logprintf(LOG_LEVEL_NOTICE,
-		"%s: Local channel#%d recv has been `%s' for flow control(buffer size %lu, recv %s).",
+		"%s: Local channel#%d recv has been `%s' for flow control(buffer size %u, recv %s).",
 		__FUNCTION__, channel_num,
 		c->bufchain_recv_suspended ? "disabled" : "enabled",
-		c->bufchain_amount,
+		c->bufchain.len,
 		changed ? "changed" : ""
 		);
 
@@ -969,6 +987,8 @@ static LRESULT CALLBACK accept_wnd_proc(HWND wnd, UINT msg, WPARAM wParam,
 					return TRUE;
 				}
 			} else {
+				// ̃`l̒ʒmƍ킹āA܂Ƃ߂ SSH T[o֑
+				SSH_sendq_begin(pvar);
 				switch (LOWORD(lParam)) {
 				case FD_CONNECT:
 					connected_local_connection(pvar, channel_num);
@@ -984,6 +1004,7 @@ static LRESULT CALLBACK accept_wnd_proc(HWND wnd, UINT msg, WPARAM wParam,
 					write_local_connection_buffer(pvar, channel_num);
 					break;
 				}
+				SSH_sendq_end(pvar);
 			}
 			return TRUE;
 		}
@@ -1851,6 +1872,16 @@ error:
 #endif
 }
 
+// T[oMA܂[J̃\Pbg֑ĂȂf[^
+int FWD_get_pending_size(PTInstVar pvar, uint32 local_channel_num)
+{
+	if (local_channel_num >= (uint32)pvar->fwd_state.num_channels
+	 || pvar->fwd_state.channels[local_channel_num].status == 0) {
+		return 0;
+	}
+	return pvar->fwd_state.channels[local_channel_num].writebuf.datalen;
+}
+
 void FWD_received_data(PTInstVar pvar, uint32 local_channel_num,
                        unsigned char *data, int length)
 {
@@ -1913,6 +1944,7 @@ void FWD_init(PTInstVar pvar)
 	pvar->fwd_state.X11_auth_data = NULL;
 	pvar->fwd_state.accept_wnd = NULL;
 	pvar->fwd_state.in_interactive_mode = FALSE;
+	pvar->fwd_state.read_buf = NULL;
 }
 
 void FWD_end(PTInstVar pvar)
@@ -1952,6 +1984,9 @@ void FWD_end(PTInstVar pvar)
 	if (pvar->fwd_state.accept_wnd != NULL) {
 		DestroyWindow(pvar->fwd_state.accept_wnd);
 	}
+
+	free(pvar->fwd_state.read_buf);
+	pvar->fwd_state.read_buf = NULL;
 }
 
 BOOL FWD_agent_forward_confirm(PTInstVar pvar)
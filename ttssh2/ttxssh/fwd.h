@@ -36,7 +36,7 @@ See LICENSE.TXT for the license.
 #define __FWD_H
 
 // |[g]ɂt[臒l
-// Kp Channel_t.bufchain_amount
+// Kp Channel_t.bufchain.len
 #define FWD_HIGH_WATER_MARK (1 * 1024 * 1024)  // 1MB
 #define FWD_LOW_WATER_MARK (0)  // 0MB
 
@@ -140,6 +140,7 @@ typedef struct {
   FWDChannel *channels;
   struct _X11AuthData *X11_auth_data;
   BOOL in_interactive_mode;
+  char *read_buf;                 /* read_local_connection() ̎Mobt@ */
 } FWDState;
 
 void FWD_init(PTInstVar pvar);
@@ -167,6 +168,7 @@ void FWD_channel_output_eof(PTInstVar pvar, uint32 local_channel_num);
 void FWD_end(PTInstVar pvar);
 void FWD_free_channel(PTInstVar pvar, uint32 local_channel_num);
 int FWD_check_local_channel_num(PTInstVar pvar, int local_num);
+int FWD_get_pending_size(PTInstVar pvar, uint32 local_channel_num);
 int FWD_agent_open(PTInstVar pvar, uint32 remote_channel_num);
 BOOL FWD_agent_forward_confirm(PTInstVar pvar);
 void FWD_suspend_resume_local_connection(PTInstVar pvar, Channel_t* c, int notify);
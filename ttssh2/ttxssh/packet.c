@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 1998-2001, Robert O'Callahan
+ * (C) 2004- TeraTerm Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * SSH2 oCipPbgvgR (RFC 4253 6.)
+ *   MpPbg̍\zƎMpPbg̕
+ *   EBhEA\PbggȂ̂ tools/bench_ssh gp
+ */
+
+#include "ttxssh.h"
+#include "util.h"
+#include "packet.h"
+
+static unsigned int get_predecryption_amount(PTInstVar pvar)
+{
+	static int small_block_decryption_sizes[] = { 5, 5, 6, 6, 8 };
+
+	if (SSHv1(pvar)) {
+		return 0;
+	} else {
+		unsigned int block_size = CRYPT_get_decryption_block_size(pvar);
+
+		if (block_size < 5) {
+			return small_block_decryption_sizes[block_size];
+		} else {
+			return block_size;
+		}
+	}
+}
+
+/* Create a packet to be sent. The SSH protocol packet type is in 'type';
+   'len' contains the length of the packet payload, in bytes (this
+   does not include the space for any of the packet headers or padding,
+   or for the packet type byte).
+   Returns a pointer to the payload data area, a region of length 'len',
+   to be filled by the caller. */
+unsigned char *begin_send_packet(PTInstVar pvar, int type, int len)
+{
+	unsigned char *buf;
+
+	pvar->ssh_state.outgoing_packet_len = len + 1;
+	pvar->ssh_state.outgoing_packet_type = type;
+
+	if (pvar->ssh_state.compressing) {
+		buf_ensure_size(&pvar->ssh_state.precompress_outbuf,
+		                &pvar->ssh_state.precompress_outbuflen, 1 + len);
+		buf = pvar->ssh_state.precompress_outbuf;
+	} else {
+		/* For SSHv2,
+		   Encrypted_length is 4(packetlength) + 1(paddinglength) + 1(packettype)
+		   + len(payload) + 4(minpadding), rounded up to nearest block_size
+		   We only need a reasonable upper bound for the buffer size */
+		buf_ensure_size(&pvar->ssh_state.outbuf,
+		                &pvar->ssh_state.outbuflen,
+		                (int)(len + 30 + CRYPT_get_sender_MAC_size(pvar) +
+		                CRYPT_get_encryption_block_size(pvar)));
+		buf = pvar->ssh_state.outbuf + 12;
+	}
+
+	buf[0] = (unsigned char) type;
+	return buf + 1;
+}
+
+/*
+ * MpPbg̍\z (SSH2)
+ *   begin_send_packet() ŗpӂyC[hkA
+ *   pfBO̕tAÍAMAC ̌vZs
+ *
+ * :
+ *   len - yC[h (ssh_state.outgoing_packet_len, bZ[W^Cv܂)
+ *   length - Mf[^̒Ԃ
+ *   compressed - kƂ͑Mf[^̃obt@ԂAM buffer_free() 邱
+ * ߂l:
+ *   Mf[^̐擪AG[̂Ƃ NULL
+ */
+unsigned char *SSH2_packet_build(PTInstVar pvar, unsigned int len, unsigned int *length, buffer_t **compressed)
+{
+	unsigned char *data;
+	unsigned int data_length;
+	buffer_t *msg = NULL;
+	unsigned int block_size = CRYPT_get_encryption_block_size(pvar);
+	unsigned int packet_length;
+	unsigned int encryption_size;
+	unsigned int padding_size;
+	BOOL ret;
+	struct Mac *mac = &pvar->ssh2_keys[MODE_OUT].mac;
+	struct Enc *enc = &pvar->ssh2_keys[MODE_OUT].enc;
+	unsigned int aadlen = 0, maclen = 0, authlen = 0;
+
+	/*
+	 f[^\
+	 pvar->ssh_state.outbuf:
+	 offset: 0 1 2 3 4 5 6 7 8 9 10 11 12 ...         EOD
+	         <--ignore---> ^^^^^^^^    <---- payload --->
+	                       packet length
+
+	                                ^^padding_size
+
+	                       <---------------------------->
+	                          SSH2 sending data on TCP
+
+	 NOTE:
+	   payload = type(1) + raw-data
+	   len = ssh_state.outgoing_packet_len = payload size
+	 */
+	// pPbgkL̏ꍇApPbgkĂ瑗MpPbg\zB(2005.7.9 yutaka)
+	// support of "Compression delayed" (2006.6.23 maya)
+	if ((pvar->ctos_compression == COMP_ZLIB ||
+	     pvar->ctos_compression == COMP_DELAYED && pvar->userauth_success) &&
+	    pvar->ssh2_keys[MODE_OUT].comp.enabled) {
+		// ̃obt@ packet-length(4) + padding(1) + payload(any) B
+		msg = buffer_init();
+		if (msg == NULL) {
+			// TODO: error check
+			logprintf(LOG_LEVEL_ERROR, "%s: buffer_init returns NULL.", __FUNCTION__);
+			return NULL;
+		}
+
+		// kΏۂ̓wb_yC[ĥ݁B
+		buffer_append(msg, "\0\0\0\0\0", 5);  // 5 = packet-length(4) + padding(1)
+		if (buffer_compress(&pvar->ssh_state.compress_stream, pvar->ssh_state.outbuf + 12, len, msg) == -1) {
+			UTIL_get_lang_msg("MSG_SSH_COMP_ERROR", pvar,
+			                  "An error occurred while compressing packet data.\n"
+			                  "The connection will close.");
+			notify_fatal_error(pvar, pvar->UIMsg, TRUE);
+			buffer_free(msg);
+			return NULL;
+		}
+		data = buffer_ptr(msg);
+		len = buffer_len(msg) - 5;  // 'len' is overwritten.
+
+	} else {
+		// k
+		data = pvar->ssh_state.outbuf + 7;
+	}
+
+	// MpPbg\z(input parameter: data, len)
+	if (block_size < 8) {
+		block_size = 8;
+	}
+
+	if (enc) {
+		authlen = enc->auth_len;
+	}
+
+	if (mac && mac->etm || authlen > 0) {
+		// ÍΏۂł͂ȂAMAC ̑ΏۂƂȂpPbg̒
+		// ܂ chacha20-poly1305 ňÍpPbg̒
+		// cf. PKT_recv ̃Rg
+		aadlen = 4;
+	}
+
+	packet_length = 1 + len; // pfBÕTCY + yC[h
+	encryption_size = 4 + packet_length - aadlen; // pPbg̃TCY + packet_length - addlen
+	padding_size = block_size - (encryption_size % block_size);
+	if (padding_size < 4)
+		padding_size += block_size;
+	packet_length += padding_size;
+	encryption_size += padding_size;
+	set_uint32(data, packet_length);
+	data[4] = (unsigned char) padding_size;
+	if (msg) {
+		// pPbgk̏ꍇAobt@gB(2011.6.10 yutaka)
+		buffer_append_space(msg, padding_size + EVP_MAX_MD_SIZE);
+		// realloc()ƁA|C^ς\̂ŁAēx蒼B
+		data = buffer_ptr(msg);
+	}
+
+	CRYPT_set_random_data(pvar, data + 5 + len, padding_size);
+
+	if (authlen > 0) {
+		// pPbgÍ MAC ̌vZ
+		CRYPT_encrypt_aead(pvar, data, encryption_size, aadlen, authlen);
+		maclen = authlen;
+	}
+	else if (aadlen) {
+		// pPbgÍiaadlen낾j
+		CRYPT_encrypt(pvar, data + aadlen, encryption_size);
+
+		// EtM ł͈Í MAC vZ
+		ret = CRYPT_build_sender_MAC(pvar, pvar->ssh_state.sender_sequence_number,
+		                             data, aadlen + encryption_size, data + aadlen + encryption_size);
+		if (ret) {
+			maclen = CRYPT_get_sender_MAC_size(pvar);
+		}
+	}
+	else {
+		// E&M ł͈ÍO MAC vZ
+		ret = CRYPT_build_sender_MAC(pvar, pvar->ssh_state.sender_sequence_number,
+		                             data, encryption_size, data + encryption_size);
+		if (ret) {
+			maclen = CRYPT_get_sender_MAC_size(pvar);
+		}
+
+		// pPbgÍ
+		CRYPT_encrypt(pvar, data, encryption_size);
+	}
+
+	data_length = encryption_size + aadlen + maclen;
+
+	logprintf(150,
+	          "%s: built packet info: "
+	          "aadlen:%d, enclen:%d, padlen:%d, datalen:%d, maclen:%d, "
+	          "Encrypt Mode:%s, MAC mode:%s",
+	          __FUNCTION__,
+	          aadlen, encryption_size, padding_size, data_length, maclen,
+	          authlen ? "AEAD" : "not AEAD", aadlen ? "EtM" : "E&M");
+
+	*compressed = msg;
+	*length = data_length;
+	return data;
+}
+
+/*
+ * MpPbg̕ (SSH2)
+ * Ef[^
+ * EMAC ̌
+ * Epadding 菜
+ * EkĂΓWJ
+ * Ƃ ssh_state.payload bZ[W^Cv̎w
+ *
+ * :
+ *   data - ssh pPbg̐擪w|C^
+ *   len - pPbg (擪̃pPbg̈(4oCg)l)
+ *   aadlen - ÍĂȂF؂̑ΏۂƂȂĂf[^̒
+ *            chacha20-poly1305 ł͈ÍpPbg̒
+ *   authlen - F؃f[^(AEAD tag)
+ */
+BOOL SSH2_packet_open(PTInstVar pvar, char *data, unsigned int len, unsigned int aadlen, unsigned int authlen)
+{
+	unsigned int padding;
+
+	if (authlen > 0) {
+		if (!CRYPT_decrypt_aead(pvar, data, len, aadlen, authlen)) {
+			UTIL_get_lang_msg("MSG_SSH_CORRUPTDATA_ERROR", pvar, "Detected corrupted data; connection terminating.");
+			notify_fatal_error(pvar, pvar->UIMsg, TRUE);
+			return FALSE;
+		}
+	}
+	else if (aadlen > 0) {
+		// EtM ̏ꍇ͐ MAC ̌؂s
+		if (!CRYPT_verify_receiver_MAC(pvar, pvar->ssh_state.receiver_sequence_number, data, len + 4, data + len + 4)) {
+			UTIL_get_lang_msg("MSG_SSH_CORRUPTDATA_ERROR", pvar, "Detected corrupted data; connection terminating.");
+			notify_fatal_error(pvar, pvar->UIMsg, TRUE);
+			return FALSE;
+		}
+
+		// pPbg(擪4oCg)͈ÍĂȂ̂ŁAXLbvĕB
+		CRYPT_decrypt(pvar, data + 4, len);
+	}
+	else {
+		// E&M ł͐擪OĂB
+		// Oꂽ擾B
+		unsigned int already_decrypted = get_predecryption_amount(pvar);
+
+		// OꂽXLbvāAc̕𕜍B
+		CRYPT_decrypt(pvar, data + already_decrypted, (4 + len) - already_decrypted);
+
+		// E&M ł͕ MAC ̌؂sB
+		if (!CRYPT_verify_receiver_MAC(pvar, pvar->ssh_state.receiver_sequence_number, data, len + 4, data + len + 4)) {
+			UTIL_get_lang_msg("MSG_SSH_CORRUPTDATA_ERROR", pvar, "Detected corrupted data; connection terminating.");
+			notify_fatal_error(pvar, pvar->UIMsg, TRUE);
+			return FALSE;
+		}
+	}
+
+	// pfBO̎擾
+	padding = (unsigned int) data[4];
+
+	// pPbg(4oCg) ƃpfBO(1oCg)XLbv SSH yC[h̐擪
+	pvar->ssh_state.payload = data + 4 + 1;
+
+	// pfBO(1oCg)ƃpfBOۂ̃yC[h
+	pvar->ssh_state.payloadlen = len - 1 - padding;
+
+	pvar->ssh_state.payload_grabbed = 0;
+
+	// data compression
+	if (pvar->ssh2_keys[MODE_IN].comp.enabled &&
+	   (pvar->stoc_compression == COMP_ZLIB ||
+	    pvar->stoc_compression == COMP_DELAYED && pvar->userauth_success)) {
+
+		if (pvar->decomp_buffer == NULL) {
+			pvar->decomp_buffer = buffer_init();
+			if (pvar->decomp_buffer == NULL)
+				return FALSE;
+		}
+		// xmۂobt@͎g񂷂̂ŏYꂸɁB
+		buffer_clear(pvar->decomp_buffer);
+
+		// packet sizepadding菜yC[ĥ݂WJB
+		buffer_decompress(&pvar->ssh_state.decompress_stream,
+		                  pvar->ssh_state.payload,
+		                  pvar->ssh_state.payloadlen,
+		                  pvar->decomp_buffer);
+
+		// |C^̍XVB
+		pvar->ssh_state.payload = buffer_ptr(pvar->decomp_buffer);
+		pvar->ssh_state.payload++;
+		pvar->ssh_state.payloadlen = buffer_len(pvar->decomp_buffer);
+	} else {
+		pvar->ssh_state.payload++;
+	}
+
+	return TRUE;
+}
+
+unsigned int SSH_get_min_packet_size(PTInstVar pvar)
+{
+	if (SSHv1(pvar)) {
+		return 12;
+	} else {
+		return max(16, CRYPT_get_decryption_block_size(pvar));
+	}
+}
+
+/* data is guaranteed to be at least SSH_get_min_packet_size bytes long
+   at least 5 bytes must be decrypted */
+void SSH_predecrypt_packet(PTInstVar pvar, char *data)
+{
+	if (SSHv2(pvar)) {
+		CRYPT_decrypt(pvar, data, get_predecryption_amount(pvar));
+	}
+}
+
+unsigned int SSH_get_clear_MAC_size(PTInstVar pvar)
+{
+	if (SSHv1(pvar)) {
+		return 0;
+	} else {
+		return CRYPT_get_receiver_MAC_size(pvar);
+	}
+}
+
+unsigned int SSH_get_authdata_size(PTInstVar pvar, int direction)
+{
+	if (SSHv1(pvar)) {
+		return 0;
+	}
+	else {
+		struct Mac *mac = &pvar->ssh2_keys[direction].mac;
+		struct Enc *enc = &pvar->ssh2_keys[direction].enc;
+
+		if (enc && enc->auth_len > 0) {
+			// AEAD
+			return enc->auth_len;
+		}
+		else if (mac && mac->enabled) {
+			return mac->mac_len;
+		}
+		else {
+			return 0;
+		}
+	}
+}
@@ -50,24 +50,40 @@ void PKT_init(PTInstVar pvar)
 
 /* Read some data, leave no more than up_to_amount bytes in the buffer,
    return the number of bytes read or -1 on error or blocking. */
+/*
+ * Mobt@ datastart  datalen oCg̃f[^B
+ * MpPbg̓obt@ł̂܂ܕAMAC ̌؂sA
+ * ssh_state.payload ̓obt@wB
+ * ς݂̗͎̈M̂тɋl߂ɁAɋ󂫂ȂƂ
+ * ̃f[^(ĂMr̃pPbg 1)擪ɈړB
+ */
 static int recv_data(PTInstVar pvar, unsigned long up_to_amount)
 {
 	int amount_read;
+	char *tail;
 
-	/* Shuffle data to the start of the buffer */
-	if (pvar->pkt_state.datastart != 0) {
-		memmove(pvar->pkt_state.buf,
-		        pvar->pkt_state.buf + pvar->pkt_state.datastart,
-		        pvar->pkt_state.datalen);
+	if (pvar->pkt_state.datalen == 0) {
 		pvar->pkt_state.datastart = 0;
 	}
 
-	buf_ensure_size(&pvar->pkt_state.buf, &pvar->pkt_state.buflen, up_to_amount);
+	if (pvar->pkt_state.datastart + up_to_amount > pvar->pkt_state.buflen) {
+		/* Leave room for one more read so that shuffling is rare */
+		buf_ensure_size(&pvar->pkt_state.buf, &pvar->pkt_state.buflen, up_to_amount + READAMOUNT);
+
+		if (pvar->pkt_state.datastart + up_to_amount > pvar->pkt_state.buflen) {
+			/* Shuffle data to the start of the buffer */
+			memmove(pvar->pkt_state.buf,
+			        pvar->pkt_state.buf + pvar->pkt_state.datastart,
+			        pvar->pkt_state.datalen);
+			pvar->pkt_state.datastart = 0;
+		}
+	}
 
 	_ASSERT(pvar->pkt_state.buf != NULL);
 
+	tail = pvar->pkt_state.buf + pvar->pkt_state.datastart + pvar->pkt_state.datalen;
 	amount_read = (pvar->Precv) (pvar->socket,
-	                             pvar->pkt_state.buf + pvar->pkt_state.datalen,
+	                             tail,
 	                             up_to_amount - pvar->pkt_state.datalen,
 	                             0);
 
@@ -77,7 +93,7 @@ static int recv_data(PTInstVar pvar, unsigned long up_to_amount)
 			int i;
 
 			for (i = 0; i < amount_read; i++) {
-				if (pvar->pkt_state.buf[pvar->pkt_state.datalen + i] == '\n') {
+				if (tail[i] == '\n') {
 					pvar->pkt_state.seen_newline = 1;
 				}
 			}
@@ -150,16 +166,17 @@ int PKT_recv(PTInstVar pvar, char *buf, int buflen)
 			 * We're looking for the initial ID string and either we've seen the
 			 * terminating newline, or we've exceeded the limit at which we should see a newline.
 			 */
+			char *id = pvar->pkt_state.buf + pvar->pkt_state.datastart;
 			unsigned int i;
 
-			for (i = 0; pvar->pkt_state.buf[i] != '\n' && i < pvar->pkt_state.datalen; i++) {
+			for (i = 0; id[i] != '\n' && i < pvar->pkt_state.datalen; i++) {
 			}
-			if (pvar->pkt_state.buf[i] == '\n') {
+			if (id[i] == '\n') {
 				i++;
 			}
 
 			// SSHT[õo[W`FbNs
-			if (SSH_handle_server_ID(pvar, pvar->pkt_state.buf, i)) {
+			if (SSH_handle_server_ID(pvar, id, i)) {
 				pvar->pkt_state.seen_server_ID = 1;
 
 				if (SSHv2(pvar)) {
@@ -13,9 +13,13 @@
 #include <stdio.h>
 #include <sys/types.h>
 typedef unsigned char u_char;
+#if defined(TTXSSH_HEADLESS)
+#include <stdint.h>
+#else
 typedef unsigned char uint8_t;
 typedef unsigned int uint32_t;
 typedef unsigned long long uint64_t;
+#endif
 
 #define POLY1305_KEYLEN		32
 #define POLY1305_TAGLEN		16
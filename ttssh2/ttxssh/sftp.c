@@ -29,6 +29,8 @@
 #include "ttxssh.h"
 #include "util.h"
 #include "resource.h"
+#include "codeconv.h"
+#include "ttlib_types.h"
 
 #include <openssl/bn.h>
 #include <openssl/evp.h>
@@ -137,7 +139,11 @@ static const struct CMD cmds[] = {
 
 
 static PTInstVar g_pvar;
-static Channel_t *g_channel;
+
+// get/put ̓]v̐ (sftpstatus }NR}hp)
+static int g_sftp_jobs_pending;		// o^āA܂IĂȂ
+static int g_sftp_jobs_done;		// 
+static int g_sftp_jobs_failed;		// s, `lē]Ȃ
 
 static void sftp_console_message(PTInstVar pvar, Channel_t *c, char *fmt, ...)
 {
@@ -148,7 +154,9 @@ static void sftp_console_message(PTInstVar pvar, Channel_t *c, char *fmt, ...)
 	_vsnprintf_s(tmp, sizeof(tmp), _TRUNCATE, fmt, arg);
 	va_end(arg);
 
-	SendMessage(c->sftp.console_window, WM_USER_CONSOLE, 0, (LPARAM)tmp);
+	if (c != NULL && c->sftp.console_window != NULL && IsWindow(c->sftp.console_window)) {
+		SendMessage(c->sftp.console_window, WM_USER_CONSOLE, 0, (LPARAM)tmp);
+	}
 	logputs(LOG_LEVEL_VERBOSE, tmp);
 }
 
@@ -190,42 +198,87 @@ static void sftp_buffer_free(buffer_t *message)
 static void sftp_send_msg(PTInstVar pvar, Channel_t *c, buffer_t *msg)
 {
 	char *p;
-	int len;
+	unsigned int len, n;
 
 	len = buffer_len(msg);
 	p = buffer_ptr(msg);
 	// ŏɃbZ[WTCYi[B
 	set_uint32(p, len - 4);
 	// yC[h̑MB
-	SSH2_send_channel_data(pvar, c, p, len, 0);
+	// SSH2_FXP_WRITE ͍ő SFTP_MAX_XFER_LENGTH ɂȂ̂ŁAT[o̍őpPbgTCYŕB
+	while (len > 0) {
+		n = len;
+		if (c->remote_maxpacket > 0 && n > c->remote_maxpacket) {
+			n = c->remote_maxpacket;
+		}
+		SSH2_send_channel_data(pvar, c, p, n, 0);
+		p += n;
+		len -= n;
+	}
 }
 
-// T[oMSFTPpPbgobt@Ɋi[B
-static void sftp_get_msg(PTInstVar pvar, Channel_t *c, unsigned char *data, unsigned int buflen, buffer_t **message)
+// T[oMf[^ sftp.recv ɗ߂B
+// SFTPpPbg̓`l̃pPbgɍ킹ĕē͂ƂA
+// 1̃`lpPbgɕē͂ƂB
+static BOOL sftp_recv_append(Channel_t *c, unsigned char *data, unsigned int buflen)
 {
-	buffer_t *msg = *message;
-	int msg_len;
+	unsigned char *p;
+	unsigned int size;
+
+	if (c->sftp.recv.start + c->sftp.recv.len + buflen > c->sftp.recv.size) {
+		// oς݂̃f[^l߂B
+		if (c->sftp.recv.start > 0) {
+			memmove(c->sftp.recv.buf, c->sftp.recv.buf + c->sftp.recv.start, c->sftp.recv.len);
+			c->sftp.recv.start = 0;
+		}
+		if (c->sftp.recv.len + buflen > c->sftp.recv.size) {
+			size = max(c->sftp.recv.size * 2, c->sftp.recv.len + buflen);
+			p = realloc(c->sftp.recv.buf, size);
+			if (p == NULL) {
+				return FALSE;
+			}
+			c->sftp.recv.buf = p;
+			c->sftp.recv.size = size;
+		}
+	}
+	memcpy(c->sftp.recv.buf + c->sftp.recv.start + c->sftp.recv.len, data, buflen);
+	c->sftp.recv.len += buflen;
+	return TRUE;
+}
 
-	// obt@mۂAf[^ׂĕ荞ށBȍ~ buffer_t ^ʂđ삷B
-	// ق OpenSSH ̃R[hƂ̐eaǂȂ邽߁B
-	buffer_clear(msg);
-	buffer_append(msg, data, buflen);
-	buffer_rewind(msg);
+// ߂f[^ASFTPpPbg1oăobt@Ɋi[B
+// ߂l: 1=o 0=܂ĂȂ -1=G[
+static int sftp_get_msg(PTInstVar pvar, Channel_t *c, buffer_t *msg)
+{
+	unsigned char *p = c->sftp.recv.buf + c->sftp.recv.start;
+	unsigned int msg_len;
 
-	msg_len = buffer_get_int(msg);
+	if (c->sftp.recv.len < 4) {
+		return 0;
+	}
+	msg_len = get_uint32(p);
 	if (msg_len > SFTP_MAX_MSG_LENGTH) {
-		// TODO:
 		sftp_syslog(pvar, "Received message too long %u", msg_len);
-		goto error;
+		return -1;
 	}
-	if (msg_len + 4 != buflen) {
-		// TODO:
-		sftp_syslog(pvar, "Buffer length %u is invalid", buflen);
-		goto error;
+	if (c->sftp.recv.len < msg_len + 4) {
+		return 0;
 	}
 
-error:
-	return;
+	// ȍ~ buffer_t ^ʂđ삷B
+	// ق OpenSSH ̃R[hƂ̐eaǂȂ邽߁B
+	buffer_clear(msg);
+	buffer_append(msg, p, msg_len + 4);
+	buffer_rewind(msg);
+	buffer_get_int(msg);
+
+	c->sftp.recv.start += msg_len + 4;
+	c->sftp.recv.len -= msg_len + 4;
+	if (c->sftp.recv.len == 0) {
+		c->sftp.recv.start = 0;
+	}
+
+	return 1;
 }
 
 static void sftp_send_string_request(PTInstVar pvar, Channel_t *c, unsigned int id, unsigned int code,
@@ -250,10 +303,14 @@ void sftp_do_init(PTInstVar pvar, Channel_t *c)
 	buffer_t *msg;
 
 	// SFTPǗ\̂̏
-	memset(&c->sftp, 0, sizeof(c->sftp));
+	// `l쐬Ƀ[NAĂBSSH_sftp_transfer() œo^ꂽ
+	// ]v(jobs)͂ŏȂƁB
 	c->sftp.state = SFTP_INIT;
-	c->sftp.transfer_buflen = DEFAULT_COPY_BUFLEN;
-	c->sftp.num_requests = DEFAULT_NUM_REQUESTS;
+	c->sftp.transfer_buflen = pvar->settings.SftpBufferSize * 1024;
+	if (c->sftp.transfer_buflen > SFTP_MAX_XFER_LENGTH) {
+		c->sftp.transfer_buflen = SFTP_MAX_XFER_LENGTH;
+	}
+	c->sftp.num_requests = pvar->settings.SftpRequests;
 	c->sftp.exts = 0;
 	c->sftp.limit_kbps = 0;
 
@@ -407,6 +464,550 @@ error:
 	return (filename);
 }
 
+/*
+ * get/put
+ *
+ * based on do_download()/do_upload()#sftp-client.c(OpenSSH 6.0)
+ * SSH2_FXP_READ/SSH2_FXP_WRITE v҂ num_requests ܂őĂA
+ * Ԃ邽тɎ̗v[B͗vɕԂƂ͌Ȃ̂ŁA
+ * vƂɃItZbgoĂA[Jt@Ĉ̈ʒu֏ށB
+ */
+static void sftp_start_next_job(PTInstVar pvar, Channel_t *c);
+
+static FILE *sftp_fopen(const char *filenameU8, const wchar_t *mode)
+{
+	wchar_t *filenameW = ToWcharU8(filenameU8);
+	FILE *fp = NULL;
+	_wfopen_s(&fp, filenameW, mode);
+	free(filenameW);
+	return fp;
+}
+
+static void sftp_remove(const char *filenameU8)
+{
+	wchar_t *filenameW = ToWcharU8(filenameU8);
+	_wremove(filenameW);
+	free(filenameW);
+}
+
+static const char *sftp_basename(const char *path)
+{
+	const char *p, *name = path;
+
+	for (p = path; *p != '\0'; p++) {
+		if (*p == '/' || *p == '\\') {
+			name = p + 1;
+		}
+	}
+	return name;
+}
+
+// ]G[ʒmB
+// }NNꍇ̓R\[Ȃ̂ŁAG[_CAOŒm点B
+static void sftp_transfer_error(PTInstVar pvar, Channel_t *c, char *fmt, ...)
+{
+	char tmp[1024];
+	va_list arg;
+
+	va_start(arg, fmt);
+	_vsnprintf_s(tmp, sizeof(tmp), _TRUNCATE, fmt, arg);
+	va_end(arg);
+
+	c->sftp.xfer.failed = TRUE;
+	if (c->sftp.console_window != NULL && IsWindow(c->sftp.console_window)) {
+		sftp_console_message(pvar, c, "%s", tmp);
+	}
+	else {
+		notify_nonfatal_error(pvar, tmp);
+	}
+}
+
+static sftp_request_t *sftp_request_new(Channel_t *c, unsigned long long offset, unsigned int len)
+{
+	sftp_transfer_t *x = &c->sftp.xfer;
+	unsigned int i;
+
+	for (i = 0; i < c->sftp.num_requests; i++) {
+		sftp_request_t *r = &x->requests[i];
+		if (!r->used) {
+			r->used = TRUE;
+			r->id = c->sftp.msg_id++;
+			r->offset = offset;
+			r->len = len;
+			x->outstanding++;
+			if (x->outstanding > x->max_outstanding) {
+				x->max_outstanding = x->outstanding;
+			}
+			return r;
+		}
+	}
+	return NULL;
+}
+
+static sftp_request_t *sftp_request_lookup(Channel_t *c, unsigned int id)
+{
+	sftp_transfer_t *x = &c->sftp.xfer;
+	unsigned int i;
+
+	for (i = 0; i < c->sftp.num_requests; i++) {
+		sftp_request_t *r = &x->requests[i];
+		if (r->used && r->id == id) {
+			return r;
+		}
+	}
+	return NULL;
+}
+
+static void sftp_request_done(Channel_t *c, sftp_request_t *r)
+{
+	r->used = FALSE;
+	c->sftp.xfer.outstanding--;
+}
+
+// SSH2_FXP_READ/SSH2_FXP_WRITE v𑗂B
+static void sftp_send_data_request(PTInstVar pvar, Channel_t *c, unsigned int code, sftp_request_t *r,
+                                   unsigned char *data)
+{
+	sftp_transfer_t *x = &c->sftp.xfer;
+	buffer_t *msg;
+
+	sftp_buffer_alloc(&msg);
+	buffer_put_char(msg, code);
+	buffer_put_int(msg, r->id);
+	buffer_put_string(msg, x->handle, x->handle_len);
+	buffer_put_int(msg, (unsigned int)(r->offset >> 32));
+	buffer_put_int(msg, (unsigned int)r->offset);
+	if (code == SSH2_FXP_READ) {
+		buffer_put_int(msg, r->len);
+	}
+	else {
+		buffer_put_string(msg, (char *)data, r->len);
+	}
+	sftp_send_msg(pvar, c, msg);
+	sftp_buffer_free(msg);
+}
+
+// Mf[^AvItZbg̈ʒu֏ށB
+static void sftp_transfer_write(PTInstVar pvar, Channel_t *c, unsigned long long offset,
+                                const char *data, unsigned int len)
+{
+	sftp_transfer_t *x = &c->sftp.xfer;
+
+	if (offset != x->filepos) {
+		// ɗṽf[^ɓ͂
+		x->reordered++;
+		if (_fseeki64(x->localfp, (__int64)offset, SEEK_SET) != 0) {
+			sftp_transfer_error(pvar, c, "Couldn't seek local file \"%s\"", x->job->localfile);
+			return;
+		}
+	}
+	if (fwrite(data, 1, len, x->localfp) != len) {
+		sftp_transfer_error(pvar, c, "Couldn't write to local file \"%s\"", x->job->localfile);
+		return;
+	}
+	x->filepos = offset + len;
+	x->bytes += len;
+}
+
+// ]IāA̓]vɐiށB
+static void sftp_transfer_finish(PTInstVar pvar, Channel_t *c)
+{
+	sftp_transfer_t *x = &c->sftp.xfer;
+	sftp_job_t *job = x->job;
+	DWORD elapsed;
+
+	if (x->localfp != NULL) {
+		fclose(x->localfp);
+		x->localfp = NULL;
+		// MɎsƂ́A[Jɍt@C̎c[폜B
+		if (job->dir == FROMREMOTE && x->failed) {
+			sftp_remove(job->localfile);
+		}
+	}
+
+	if (!x->failed) {
+		elapsed = GetTickCount() - x->start_tick;
+		sftp_console_message(pvar, c, "%s %s -> %s: %llu bytes in %lu ms (%llu KB/s)",
+		                     job->dir == FROMREMOTE ? "Fetched" : "Uploaded",
+		                     job->dir == FROMREMOTE ? job->remotefile : job->localfile,
+		                     job->dir == FROMREMOTE ? job->localfile : job->remotefile,
+		                     x->bytes, elapsed, x->bytes * 1000 / 1024 / (elapsed > 0 ? elapsed : 1));
+	}
+	sftp_syslog(pvar, "SFTP transfer %s: buflen=%u requests=%u max_outstanding=%u reordered=%u short_reads=%u",
+	            x->failed ? "failed" : "done", c->sftp.transfer_buflen, c->sftp.num_requests,
+	            x->max_outstanding, x->reordered, x->short_reads);
+	g_sftp_jobs_pending--;
+	if (x->failed) {
+		g_sftp_jobs_failed++;
+	}
+	else {
+		g_sftp_jobs_done++;
+	}
+
+	free(x->handle);
+	free(x->requests);
+	free(x->iobuf);
+	free(job);
+	memset(x, 0, sizeof(*x));
+
+	c->sftp.state = SFTP_REALPATH;
+	sftp_start_next_job(pvar, c);
+}
+
+static void sftp_transfer_close(PTInstVar pvar, Channel_t *c)
+{
+	sftp_transfer_t *x = &c->sftp.xfer;
+
+	x->id = c->sftp.msg_id++;
+	sftp_send_string_request(pvar, c, x->id, SSH2_FXP_CLOSE, x->handle, x->handle_len);
+	c->sftp.state = SFTP_CLOSE;
+}
+
+// ҂̗v num_requests ɂȂ܂ŗv𑗂B
+// ׂẲ烊[gt@CB
+static void sftp_transfer_fill(PTInstVar pvar, Channel_t *c)
+{
+	sftp_transfer_t *x = &c->sftp.xfer;
+	sftp_request_t *r;
+	size_t n;
+
+	while (!x->eof && !x->failed && x->outstanding < c->sftp.num_requests) {
+		if (x->job->dir == FROMREMOTE) {
+			r = sftp_request_new(c, x->offset, c->sftp.transfer_buflen);
+			sftp_send_data_request(pvar, c, SSH2_FXP_READ, r, NULL);
+		}
+		else {
+			// T[o̎MEBhE󂭂܂ł́Aȏt@Cǂݍ܂ȂB
+			if (c->bufchain.len > 0 && x->outstanding > 0) {
+				break;
+			}
+			n = fread(x->iobuf, 1, c->sftp.transfer_buflen, x->localfp);
+			if (n == 0) {
+				if (ferror(x->localfp)) {
+					sftp_transfer_error(pvar, c, "Couldn't read from local file \"%s\"", x->job->localfile);
+				}
+				x->eof = TRUE;
+				break;
+			}
+			r = sftp_request_new(c, x->offset, (unsigned int)n);
+			sftp_send_data_request(pvar, c, SSH2_FXP_WRITE, r, x->iobuf);
+		}
+		x->offset += r->len;
+	}
+
+	if (x->outstanding == 0 && (x->eof || x->failed)) {
+		sftp_transfer_close(pvar, c);
+	}
+}
+
+static void sftp_transfer_open(PTInstVar pvar, Channel_t *c)
+{
+	sftp_transfer_t *x = &c->sftp.xfer;
+	sftp_job_t *job = x->job;
+	buffer_t *msg;
+	unsigned int pflags;
+
+	if (job->dir == TOREMOTE) {
+		x->localfp = sftp_fopen(job->localfile, L"rb");
+		if (x->localfp == NULL) {
+			sftp_transfer_error(pvar, c, "Couldn't open local file \"%s\" for reading", job->localfile);
+			sftp_transfer_finish(pvar, c);
+			return;
+		}
+		pflags = SSH2_FXF_WRITE | SSH2_FXF_CREAT | SSH2_FXF_TRUNC;
+	}
+	else {
+		// [Jt@C̓[gt@CJĂB
+		pflags = SSH2_FXF_READ;
+	}
+
+	x->id = c->sftp.msg_id++;
+	sftp_buffer_alloc(&msg);
+	buffer_put_char(msg, SSH2_FXP_OPEN);
+	buffer_put_int(msg, x->id);
+	buffer_put_cstring(msg, job->remotefile);
+	buffer_put_int(msg, pflags);
+	buffer_put_int(msg, 0);  // attrs
+	sftp_send_msg(pvar, c, msg);
+	sftp_buffer_free(msg);
+	sftp_syslog(pvar, "Sent message SSH2_FXP_OPEN I:%u P:%s", x->id, job->remotefile);
+
+	c->sftp.state = SFTP_OPEN;
+}
+
+static void sftp_transfer_open_recv(PTInstVar pvar, Channel_t *c, unsigned int type, buffer_t *msg)
+{
+	sftp_transfer_t *x = &c->sftp.xfer;
+	sftp_job_t *job = x->job;
+
+	if (type == SSH2_FXP_STATUS) {
+		unsigned int status = buffer_get_int(msg);
+		sftp_transfer_error(pvar, c, "Couldn't open remote file \"%s\": %s", job->remotefile, fx2txt(status));
+		sftp_transfer_finish(pvar, c);
+		return;
+	}
+	if (type != SSH2_FXP_HANDLE) {
+		sftp_transfer_error(pvar, c, "Expected SSH2_FXP_HANDLE(%u) packet, got %u", SSH2_FXP_HANDLE, type);
+		sftp_transfer_finish(pvar, c);
+		return;
+	}
+
+	x->handle = buffer_get_string_msg(msg, &x->handle_len);
+	if (x->handle == NULL) {
+		sftp_transfer_error(pvar, c, "Couldn't get handle of remote file \"%s\"", job->remotefile);
+		sftp_transfer_finish(pvar, c);
+		return;
+	}
+	c->sftp.state = SFTP_TRANSFER;
+
+	if (job->dir == FROMREMOTE) {
+		x->localfp = sftp_fopen(job->localfile, L"wb");
+		if (x->localfp == NULL) {
+			sftp_transfer_error(pvar, c, "Couldn't open local file \"%s\" for writing", job->localfile);
+		}
+	}
+	else {
+		x->iobuf = malloc(c->sftp.transfer_buflen);
+		if (x->iobuf == NULL) {
+			sftp_transfer_error(pvar, c, "Couldn't allocate transfer buffer");
+		}
+	}
+	x->requests = calloc(c->sftp.num_requests, sizeof(sftp_request_t));
+	if (x->requests == NULL) {
+		sftp_transfer_error(pvar, c, "Couldn't allocate request table");
+	}
+
+	x->start_tick = GetTickCount();
+	sftp_transfer_fill(pvar, c);
+}
+
+static void sftp_transfer_recv(PTInstVar pvar, Channel_t *c, buffer_t *msg)
+{
+	sftp_transfer_t *x = &c->sftp.xfer;
+	sftp_job_t *job = x->job;
+	sftp_request_t *r;
+	unsigned int type, id, status, len;
+
+	type = buffer_get_char(msg);
+	id = buffer_get_int(msg);
+
+	if (c->sftp.state == SFTP_OPEN || c->sftp.state == SFTP_CLOSE) {
+		if (id != x->id) {
+			sftp_syslog(pvar, "ID mismatch (%u != %u)", id, x->id);
+			return;
+		}
+		if (c->sftp.state == SFTP_OPEN) {
+			sftp_transfer_open_recv(pvar, c, type, msg);
+			return;
+		}
+		status = (type == SSH2_FXP_STATUS) ? buffer_get_int(msg) : SSH2_FX_BAD_MESSAGE;
+		if (status != SSH2_FX_OK && !x->failed) {
+			sftp_transfer_error(pvar, c, "Couldn't close remote file \"%s\": %s", job->remotefile, fx2txt(status));
+		}
+		sftp_transfer_finish(pvar, c);
+		return;
+	}
+
+	r = sftp_request_lookup(c, id);
+	if (r == NULL) {
+		sftp_syslog(pvar, "Unexpected reply %u", id);
+		return;
+	}
+
+	if (type == SSH2_FXP_STATUS) {
+		status = buffer_get_int(msg);
+		if (job->dir == FROMREMOTE && status == SSH2_FX_EOF) {
+			x->eof = TRUE;
+		}
+		else if (job->dir == FROMREMOTE || status != SSH2_FX_OK) {
+			if (!x->failed) {
+				sftp_transfer_error(pvar, c, "Couldn't %s remote file \"%s\": %s",
+				                    job->dir == FROMREMOTE ? "read from" : "write to",
+				                    job->remotefile, fx2txt(status));
+			}
+		}
+		else {
+			x->bytes += r->len;
+		}
+		sftp_request_done(c, r);
+	}
+	else if (type == SSH2_FXP_DATA && job->dir == FROMREMOTE) {
+		len = buffer_get_int(msg);
+		if (len > r->len || len > (unsigned int)buffer_remain_len(msg)) {
+			sftp_transfer_error(pvar, c, "Received more data than asked for %u > %u", len, r->len);
+			sftp_request_done(c, r);
+		}
+		else {
+			if (!x->failed) {
+				sftp_transfer_write(pvar, c, r->offset, buffer_tail_ptr(msg), len);
+			}
+			if (len < r->len && !x->failed) {
+				// vZf[^ԂĂ̂ŁAc߂ėvB
+				x->short_reads++;
+				r->id = c->sftp.msg_id++;
+				r->offset += len;
+				r->len -= len;
+				sftp_send_data_request(pvar, c, SSH2_FXP_READ, r, NULL);
+			}
+			else {
+				sftp_request_done(c, r);
+			}
+		}
+	}
+	else {
+		sftp_transfer_error(pvar, c, "Unexpected SFTP packet %u", type);
+		sftp_request_done(c, r);
+	}
+
+	sftp_transfer_fill(pvar, c);
+}
+
+static void sftp_start_next_job(PTInstVar pvar, Channel_t *c)
+{
+	sftp_job_t *job;
+
+	if (c->sftp.state != SFTP_REALPATH || c->sftp.jobs == NULL) {
+		return;
+	}
+	job = c->sftp.jobs;
+	c->sftp.jobs = job->next;
+	job->next = NULL;
+
+	memset(&c->sftp.xfer, 0, sizeof(c->sftp.xfer));
+	c->sftp.xfer.job = job;
+	sftp_transfer_open(pvar, c);
+}
+
+/**
+ *	get/put ̓]vo^
+ *	SFTP̏ςł΂ɁAłȂΏςłAo^ɓ]B
+ *
+ *	@param localfile	[J̃t@C, UTF-8
+ *						FROMREMOTE  NULL 󕶎̂ƂA_E[htH_
+ *	@param remotefile	[g̃t@C, UTF-8
+ *						TOREMOTE  NULL 󕶎̂ƂAz[tH_
+ *						TOREMOTE  '/' ŏIƂÃtH_
+ *	@param direction	TOREMOTE	put
+ *						FROMREMOTE	get
+ *	@retval SFTP_REQUEST_OK				o^
+ *	@retval SFTP_REQUEST_BAD_ARGUMENT	t@CȂ
+ *	@retval SFTP_REQUEST_FAILED			Ȃ
+ */
+int sftp_transfer_request(PTInstVar pvar, Channel_t *c, const char *localfile, const char *remotefile,
+                          enum scp_dir direction)
+{
+	sftp_job_t *job, **p;
+	const char *fn;
+
+	job = calloc(1, sizeof(sftp_job_t));
+	if (job == NULL) {
+		return SFTP_REQUEST_FAILED;
+	}
+	job->dir = direction;
+
+	if (direction == FROMREMOTE) {
+		if (remotefile == NULL || remotefile[0] == '\0') {
+			goto error;
+		}
+		strncpy_s(job->remotefile, sizeof(job->remotefile), remotefile, _TRUNCATE);
+		if (localfile == NULL || localfile[0] == '\0') {
+			wchar_t *FileDirExpanded;
+			char *FileDirExpandedU8;
+
+			fn = sftp_basename(remotefile);
+			if (*fn == '\0') {
+				goto error;
+			}
+			FileDirExpanded = GetFileDir(pvar->ts);
+			FileDirExpandedU8 = ToU8W(FileDirExpanded);
+			_snprintf_s(job->localfile, sizeof(job->localfile), _TRUNCATE, "%s\\%s", FileDirExpandedU8, fn);
+			free(FileDirExpanded);
+			free(FileDirExpandedU8);
+		}
+		else {
+			strncpy_s(job->localfile, sizeof(job->localfile), localfile, _TRUNCATE);
+		}
+	}
+	else {
+		if (localfile == NULL || localfile[0] == '\0') {
+			goto error;
+		}
+		strncpy_s(job->localfile, sizeof(job->localfile), localfile, _TRUNCATE);
+		fn = sftp_basename(localfile);
+		if (remotefile == NULL || remotefile[0] == '\0') {
+			strncpy_s(job->remotefile, sizeof(job->remotefile), fn, _TRUNCATE);
+		}
+		else if (remotefile[strlen(remotefile) - 1] == '/') {
+			_snprintf_s(job->remotefile, sizeof(job->remotefile), _TRUNCATE, "%s%s", remotefile, fn);
+		}
+		else {
+			strncpy_s(job->remotefile, sizeof(job->remotefile), remotefile, _TRUNCATE);
+		}
+	}
+
+	for (p = &c->sftp.jobs; *p != NULL; p = &(*p)->next)
+		;
+	*p = job;
+	g_sftp_jobs_pending++;
+
+	sftp_start_next_job(pvar, c);
+	return SFTP_REQUEST_OK;
+
+error:
+	free(job);
+	return SFTP_REQUEST_BAD_ARGUMENT;
+}
+
+/**
+ *	get/put ̓]v̏ԂԂ
+ *	 ttxssh.dll ǂݍł̗݌v
+ *
+ *	@param done		
+ *	@param failed	s
+ *	@return			o^āA܂IĂȂ
+ */
+int sftp_transfer_status(int *done, int *failed)
+{
+	*done = g_sftp_jobs_done;
+	*failed = g_sftp_jobs_failed;
+	return g_sftp_jobs_pending;
+}
+
+// `l폜̌n (ssh2_channel_delete() Ă΂)
+void sftp_channel_free(Channel_t *c)
+{
+	sftp_transfer_t *x = &c->sftp.xfer;
+	sftp_job_t *job, *next;
+
+	if (x->localfp != NULL) {
+		fclose(x->localfp);
+		if (x->job->dir == FROMREMOTE) {
+			sftp_remove(x->job->localfile);
+		}
+	}
+	// IȂ]͎sƂ
+	if (x->job != NULL) {
+		g_sftp_jobs_pending--;
+		g_sftp_jobs_failed++;
+	}
+	free(x->handle);
+	free(x->requests);
+	free(x->iobuf);
+	free(x->job);
+
+	for (job = c->sftp.jobs; job != NULL; job = next) {
+		next = job->next;
+		free(job);
+		g_sftp_jobs_pending--;
+		g_sftp_jobs_failed++;
+	}
+	free(c->sftp.recv.buf);
+	if (c->sftp.console_window != NULL && IsWindow(c->sftp.console_window)) {
+		DestroyWindow(c->sftp.console_window);
+	}
+	memset(&c->sftp, 0, sizeof(c->sftp));
+}
+
 
 u_int
 sftp_proto_version(struct sftp *conn)
@@ -415,9 +1016,9 @@ sftp_proto_version(struct sftp *conn)
 } 
 
 static void
-help(void)
+help(Channel_t *c)
 {
-	sftp_console_message(g_pvar, g_channel, 
+	sftp_console_message(g_pvar, c, 
 		"Available commands:\r\n"
 	    "bye                                Quit sftp\r\n"
 	    "cd path                            Change remote directory to 'path'\r\n"
@@ -427,7 +1028,7 @@ help(void)
 	    "df [-hi] [path]                    Display statistics for current directory or\r\n"
 	    "                                   filesystem containing 'path'\r\n"
 	    "exit                               Quit sftp\r\n"
-	    "get [-Ppr] remote [local]          Download file\r\n"
+	    "get remote [local]                 Download file\r\n"
 	    "help                               Display this help text\r\n"
 	    "lcd path                           Change local directory to 'path'\r\n"
 	    "lls [ls-options [path]]            Display local directory listing\r\n"
@@ -438,7 +1039,7 @@ help(void)
 	    "lumask umask                       Set local umask to 'umask'\r\n"
 	    "mkdir path                         Create remote directory\r\n"
 	    "progress                           Toggle display of progress meter\r\n"
-	    "put [-Ppr] local [remote]          Upload file\r\n"
+	    "put local [remote]                 Upload file\r\n"
 	    "pwd                                Display remote working directory\r\n"
 	    "quit                               Quit sftp\r\n"
 	    "rename oldpath newpath             Rename remote file\r\n"
@@ -612,7 +1213,7 @@ makeargv(const char *arg, int *argcp, int sloppy, char *lastquote,
 	return argv;
 }
 
-static int parse_args(const char **cpp, int *pflag, int *rflag, int *lflag, int *iflag,
+static int parse_args(Channel_t *c, const char **cpp, int *pflag, int *rflag, int *lflag, int *iflag,
     int *hflag, int *sflag, unsigned long *n_arg, char **path1, char **path2)
 {
     const char *cmd, *cp = *cpp;
@@ -661,26 +1262,22 @@ static int parse_args(const char **cpp, int *pflag, int *rflag, int *lflag, int
 	*path1 = *path2 = NULL;
 	optidx = 1;
 	switch (cmdnum) {
-#if 0
 	case I_GET:
 	case I_PUT:
-		if ((optidx = parse_getput_flags(cmd, argv, argc,
-		    pflag, rflag)) == -1)
-			return -1;
 		/* Get first pathname (mandatory) */
 		if (argc - optidx < 1) {
-			error("You must specify at least one path after a "
+			sftp_console_message(g_pvar, c, "You must specify at least one path after a "
 			    "%s command.", cmd);
 			return -1;
 		}
-		*path1 = xstrdup(argv[optidx]);
+		/* argv is static in makeargv() and valid until the next call */
+		*path1 = argv[optidx];
 		/* Get second pathname (optional) */
 		if (argc - optidx > 1) {
-			*path2 = xstrdup(argv[optidx + 1]);
-			/* Destination is not globbed */
-			undo_glob_escape(*path2);
+			*path2 = argv[optidx + 1];
 		}
 		break;
+#if 0
 	case I_LINK:
 		if ((optidx = parse_link_flags(cmd, argv, argc, sflag)) == -1)
 			return -1;
@@ -804,6 +1401,7 @@ static LRESULT CALLBACK EditProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lPa
 	int err = 0;
 	//glob_t g;
 	int err_abort;
+	Channel_t *c;
 
 	switch (uMsg) {
 		case WM_KEYDOWN:
@@ -824,10 +1422,16 @@ static LRESULT CALLBACK EditProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lPa
 	return 0L;
 
 cmd_parsed:
+	// R\[̃`l, Ă牽Ȃ
+	c = (Channel_t *)GetWindowLongPtr(GetParent(hwnd), GWLP_USERDATA);
+	if (c == NULL) {
+		return 0L;
+	}
+
 	// R}hC
 	path1 = path2 = NULL;
 	cmd = buf;
-	cmdnum = parse_args((const char **)&cmd, &pflag, &rflag, &lflag, &iflag, &hflag,
+	cmdnum = parse_args(c, (const char **)&cmd, &pflag, &rflag, &lflag, &iflag, &hflag,
 		&sflag, &n_arg, &path1, &path2);
 
 	if (iflag != 0)
@@ -844,13 +1448,13 @@ cmd_parsed:
 		/* Unrecognized command */
 		err = -1;
 		break;
-#if 0
 	case I_GET:
-		err = process_get(conn, path1, path2, *pwd, pflag, rflag);
+		err = sftp_transfer_request(g_pvar, c, path2, path1, FROMREMOTE) == SFTP_REQUEST_OK ? 0 : -1;
 		break;
 	case I_PUT:
-		err = process_put(conn, path1, path2, *pwd, pflag, rflag);
+		err = sftp_transfer_request(g_pvar, c, path1, path2, TOREMOTE) == SFTP_REQUEST_OK ? 0 : -1;
 		break;
+#if 0
 	case I_RENAME:
 		path1 = make_absolute(path1, *pwd);
 		path2 = make_absolute(path2, *pwd);
@@ -1019,10 +1623,10 @@ cmd_parsed:
 		/* Processed below */
 		break;
 	case I_HELP:
-		help();
+		help(c);
 		break;
 	case I_VERSION:
-		printf("SFTP protocol version %u\n", sftp_proto_version(&g_channel->sftp));
+		printf("SFTP protocol version %u\n", sftp_proto_version(&c->sftp));
 		break;
 #if 0
 	case I_PROGRESS:
@@ -1078,8 +1682,23 @@ static LRESULT CALLBACK OnSftpConsoleDlgProc(HWND hDlgWnd, UINT msg, WPARAM wp,
 
 			CenterWindow(hDlgWnd, GetParent(hDlgWnd));
 
+			// R\[̃`l
+			SetWindowLongPtr(hDlgWnd, GWLP_USERDATA, lp);
+
 			return TRUE;
 
+		case WM_DESTROY:
+			// `l؂藣
+			// ȍ~̓]G[ notify_nonfatal_error() Œm点
+			{
+				Channel_t *c = (Channel_t *)GetWindowLongPtr(hDlgWnd, GWLP_USERDATA);
+				if (c != NULL && c->sftp.console_window == hDlgWnd) {
+					c->sftp.console_window = NULL;
+				}
+				SetWindowLongPtr(hDlgWnd, GWLP_USERDATA, 0);
+			}
+			return FALSE;
+
 		case WM_COMMAND:
 			switch (LOWORD(wp)) {
 				case IDOK:
@@ -1137,30 +1756,25 @@ static LRESULT CALLBACK OnSftpConsoleDlgProc(HWND hDlgWnd, UINT msg, WPARAM wp,
 }
 
 // SFTPM -Xe[g}V[-
-void sftp_response(PTInstVar pvar, Channel_t *c, unsigned char *data, unsigned int buflen)
+static void sftp_dispatch(PTInstVar pvar, Channel_t *c, buffer_t *msg)
 {
-	buffer_t *msg;
 	HWND hDlgWnd;
 
-	/*
-	 * Allocate buffer
-	 */
-	sftp_buffer_alloc(&msg);
-	sftp_get_msg(pvar, c, data, buflen, &msg);
-
 	if (c->sftp.state == SFTP_INIT) {
 		// O[oϐɕۑB
 		g_pvar = pvar;
-		g_channel = c;
 
 		sftp_do_init_recv(pvar, c, msg);
 
 		// R\[NB
-		hDlgWnd = CreateDialog(hInst, MAKEINTRESOURCE(IDD_SFTP_DIALOG), 
-				pvar->cv->HWin, (DLGPROC)OnSftpConsoleDlgProc);	
-		if (hDlgWnd != NULL) {
-			c->sftp.console_window = hDlgWnd;
-			ShowWindow(hDlgWnd, SW_SHOW);
+		// }N(sftpget/sftpput)J`lł͋NȂB
+		if (c->sftp.jobs == NULL) {
+			hDlgWnd = CreateDialogParam(hInst, MAKEINTRESOURCE(IDD_SFTP_DIALOG),
+					pvar->cv->HWin, (DLGPROC)OnSftpConsoleDlgProc, (LPARAM)c);
+			if (hDlgWnd != NULL) {
+				c->sftp.console_window = hDlgWnd;
+				ShowWindow(hDlgWnd, SW_SHOW);
+			}
 		}
 
 		sftp_do_realpath(pvar, c, ".");
@@ -1169,10 +1783,44 @@ void sftp_response(PTInstVar pvar, Channel_t *c, unsigned char *data, unsigned i
 	} else if (c->sftp.state == SFTP_CONNECTED) {
 		char *remote_path;
 		remote_path = sftp_do_realpath_recv(pvar, c, msg);
+		free(remote_path);
 
 		c->sftp.state = SFTP_REALPATH;
+		sftp_start_next_job(pvar, c);
+
+	} else if (c->sftp.state == SFTP_OPEN || c->sftp.state == SFTP_TRANSFER ||
+	           c->sftp.state == SFTP_CLOSE) {
+		sftp_transfer_recv(pvar, c, msg);
 
 	}
+}
+
+void sftp_response(PTInstVar pvar, Channel_t *c, unsigned char *data, unsigned int buflen)
+{
+	buffer_t *msg;
+	int ret;
+
+	if (!sftp_recv_append(c, data, buflen)) {
+		sftp_syslog(pvar, "Couldn't allocate receive buffer %u", c->sftp.recv.len + buflen);
+		return;
+	}
+
+	/*
+	 * Allocate buffer
+	 */
+	sftp_buffer_alloc(&msg);
+
+	while ((ret = sftp_get_msg(pvar, c, msg)) > 0) {
+		sftp_dispatch(pvar, c, msg);
+	}
+	if (ret < 0) {
+		// ȍ~̃pPbg̋؂肪Ȃ̂ŁAMς݂̃f[^͎̂ĂB
+		c->sftp.recv.start = 0;
+		c->sftp.recv.len = 0;
+		if (c->sftp.state == SFTP_TRANSFER) {
+			sftp_transfer_error(pvar, c, "Received broken SFTP packet");
+		}
+	}
 
 	/*
 	 * Free buffer
@@ -104,10 +104,24 @@
 /* Maximum packet that we are willing to send/accept */
 #define SFTP_MAX_MSG_LENGTH	(256 * 1024)
 
+/* Maximum data length of a READ/WRITE request (fits in SFTP_MAX_MSG_LENGTH) */
+#define SFTP_MAX_XFER_LENGTH	(SFTP_MAX_MSG_LENGTH - 1024)
+
 #define DEFAULT_COPY_BUFLEN 32768   /* Size of buffer for up/download */
 #define DEFAULT_NUM_REQUESTS    64  /* # concurrent outstanding requests */
+#define MAX_NUM_REQUESTS    1024
+
+/* sftp_transfer_request(), SSH_sftp_transfer() ̖߂l
+ * TTXSftpGetfile/TTXSftpPutfile ̖߂lɂȂ̂ teraterm/teraterm/scp.h ƍ킹邱 */
+#define SFTP_REQUEST_OK				1	/* ]vo^ */
+#define SFTP_REQUEST_FAILED			0	/* o^łȂ(`lJȂ, s) */
+#define SFTP_REQUEST_NOT_CONNECTED	-1	/* SSH2 ŐڑĂȂ */
+#define SFTP_REQUEST_BAD_ARGUMENT	-2	/* t@CȂ */
 
 void sftp_do_init(PTInstVar pvar, Channel_t *c);
 void sftp_response(PTInstVar pvar, Channel_t *c, unsigned char *data, unsigned int buflen);
+int sftp_transfer_request(PTInstVar pvar, Channel_t *c, const char *localfile, const char *remotefile, enum scp_dir direction);
+int sftp_transfer_status(int *done, int *failed);
+void sftp_channel_free(Channel_t *c);
 
 #endif
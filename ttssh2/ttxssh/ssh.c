@@ -62,6 +62,7 @@
 
 
 #include "ssh.h"
+#include "packet.h"
 #include "crypt.h"
 #include "fwd.h"
 #include "sftp.h"
@@ -109,10 +110,13 @@ static Channel_t channels[CHANNEL_MAX];
 
 static char ssh_ttymodes[] = "\x01\x03\x02\x1c\x03\x08\x04\x15\x05\x04";
 
-static CRITICAL_SECTION g_ssh_scp_lock;   /* SCPMpbN */
-
 static int g_scp_sending;  /* SCPM? */
 
+// SCPM̐i݋B}N scpsendstatus ŎQƂB
+static volatile LONG g_scp_send_percent;
+static volatile LONG g_scp_send_rate;  // KB/s
+static volatile LONG g_scp_send_eta = -1;  // cb (-1 = s)
+
 static void try_send_credentials(PTInstVar pvar);
 static void prep_compression(PTInstVar pvar);
 
@@ -152,8 +156,9 @@ int dh_pub_is_valid(DH *dh, BIGNUM *dh_pub);
 static void start_ssh_heartbeat_thread(PTInstVar pvar);
 void ssh2_channel_send_close(PTInstVar pvar, Channel_t *c);
 static BOOL SSH_agent_response(PTInstVar pvar, Channel_t *c, int local_channel_num, unsigned char *data, unsigned int buflen);
-static void ssh2_scp_get_packetlist(PTInstVar pvar, Channel_t *c, unsigned char **buf, unsigned int *buflen);
-static void ssh2_scp_free_packetlist(PTInstVar pvar, Channel_t *c);
+static void ssh2_scp_resume_receive(PTInstVar pvar, Channel_t *c);
+static void ssh2_scp_free_ring(Channel_t *c);
+static void ssh2_scp_free_sendbuf(Channel_t *c);
 static void get_window_pixel_size(PTInstVar pvar, int *x, int *y);
 static void do_SSH2_dispatch_setup_for_transfer(PTInstVar pvar);
 static void ssh2_prep_userauth(PTInstVar pvar);
@@ -228,12 +233,13 @@ static Channel_t *ssh2_channel_new(unsigned int window, unsigned int maxpack,
 	c->local_window_max = window;
 	c->local_consumed = 0;
 	c->local_maxpacket = maxpack;
+	c->window.floor = window;
+	c->window.peak = window;
+	c->window.adjust_tick = GetTickCount();
 	c->remote_window = 0;
 	c->remote_maxpacket = 0;
 	c->type = type;
 	c->local_num = local_num;  // alloc_channel()̕ԒlۑĂ
-	c->bufchain = NULL;
-	c->bufchain_amount = 0;
 	c->bufchain_recv_suspended = FALSE;
 	if (type == TYPE_SCP) {
 		c->scp.state = SCP_INIT;
@@ -242,7 +248,6 @@ static Channel_t *ssh2_channel_new(unsigned int window, unsigned int maxpack,
 		c->scp.localfp = NULL;
 		c->scp.filemtime = 0;
 		c->scp.fileatime = 0;
-		c->scp.pktlist_cursize = 0;
 	}
 	if (type == TYPE_AGENT) {
 		c->agent_msg = buffer_init();
@@ -253,74 +258,104 @@ static Channel_t *ssh2_channel_new(unsigned int window, unsigned int maxpack,
 	return (c);
 }
 
-// remote_window̋󂫂ȂꍇɁAȂobt@Xgi͏jւȂłB
-// Ŋmۂ ssh2_channel_retry_send_bufchain() ŉB
+// remote_window̋󂫂ȂꍇɁAȂf[^Oobt@i͏j֕ۑĂB
+// obt@͑ȂȂ{ɍLAssh2_channel_retry_send_bufchain() ő菜B
 static void ssh2_channel_add_bufchain(PTInstVar pvar, Channel_t *c, unsigned char *buf, unsigned int buflen)
 {
-	bufchain_t *p, *old;
+	bufchain_t *q = &c->bufchain;
+	unsigned int tail, first;
 
-	// allocate new buffer
-	p = malloc(sizeof(bufchain_t));
-	if (p == NULL)
-		return;
-	p->msg = buffer_init();
-	if (p == NULL) {
-		free(p);
+	if (buflen == 0)
 		return;
-	}
-	buffer_put_raw(p->msg, buf, buflen);
-	p->next = NULL;
 
-	if (c->bufchain == NULL) {
-		c->bufchain = p;
-	} else {
-		old = c->bufchain;
-		while (old->next)
-			old = old->next;
-		old->next = p;
+	if (q->len + buflen > q->size) {
+		unsigned int newsize = q->size == 0 ? BUFCHAIN_INITIAL_SIZE : q->size;
+		unsigned char *newbuf;
+
+		while (newsize < q->len + buflen) {
+			newsize *= 2;
+		}
+		newbuf = malloc(newsize);
+		if (newbuf == NULL) {
+			logprintf(LOG_LEVEL_ERROR, "%s: malloc returns NULL. (%u bytes)", __FUNCTION__, newsize);
+			return;
+		}
+
+		// ۑς݂̃f[^Vobt@̐擪ɋl߂Ĉڂ
+		first = min(q->len, q->size - q->start);
+		if (first > 0) {
+			memcpy(newbuf, q->buf + q->start, first);
+			memcpy(newbuf + first, q->buf, q->len - first);
+		}
+		free(q->buf);
+		q->buf = newbuf;
+		q->size = newsize;
+		q->start = 0;
 	}
 
-	// obt@TCY̍vXV(L^p)
-	c->bufchain_amount += buflen;
+	tail = (q->start + q->len) % q->size;
+	first = min(buflen, q->size - tail);
+	memcpy(q->buf + tail, buf, first);
+	memcpy(q->buf, buf + first, buflen - first);
+	q->len += buflen;
+
+	// obt@ɗ܂f[^ʂ̍ől(L^p)
+	if (q->len > q->peak) {
+		q->peak = q->len;
+	}
 
 	// remote_window̋󂫂Ȃ̂ŁAlocal connectioñpPbgM
 	// ~woBɒʒm~܂킯ł͂ȂB
 	FWD_suspend_resume_local_connection(pvar, c, FALSE);
 }
 
-// remote_window̋󂫂łAXgɎcĂf[^ԂɑB
-// Mł烁B
+// remote_window̋󂫂łAOobt@ɎcĂf[^擪珇ԂɑB
 static void ssh2_channel_retry_send_bufchain(PTInstVar pvar, Channel_t *c)
 {
-	bufchain_t *ch;
-	unsigned int size;
-	bufchain_t* ch_origin = c->bufchain;
+	bufchain_t *q = &c->bufchain;
+	BOOL queued = q->len > 0;
 
-	while (c->bufchain) {
+	// SSH2͑ȂB̊ɌĂ΂B
+	if (pvar->kex_status & KEX_FLAG_REKEYING) {
+		return;
+	}
+
+	SSH_sendq_begin(pvar);
+	while (q->len > 0) {
 		// 擪ɑ
-		ch = c->bufchain;
-		size = buffer_len(ch->msg);
-		if (size >= c->remote_window)
+		//   Oobt@̖Ő܂Ԃꍇ 2ɕđ
+		unsigned int size = min(q->len, q->size - q->start);
+		if (c->remote_maxpacket > 0 && size > c->remote_maxpacket)
+			size = c->remote_maxpacket;
+		if (size > c->remote_window)
+			size = c->remote_window;
+		if (size == 0)
 			break;
 
 		if (c->local_num == -1) { // shell or SCP
-			SSH2_send_channel_data(pvar, c, buffer_ptr(ch->msg), size, TRUE);
+			SSH2_send_channel_data(pvar, c, q->buf + q->start, size, TRUE);
 		} else { // port-forwarding
-			SSH_channel_send(pvar, c->local_num, -1, buffer_ptr(ch->msg), size, TRUE);
+			SSH_channel_send(pvar, c->local_num, -1, q->buf + q->start, size, TRUE);
 		}
 
-		c->bufchain = ch->next;
-
-		buffer_free(ch->msg);
-		free(ch);
+		q->start = (q->start + size) % q->size;
+		q->len -= size;
+	}
+	SSH_sendq_end(pvar);
 
-		// obt@TCY̍vXV(L^p)
-		c->bufchain_amount -= size;
+	if (q->len == 0) {
+		q->start = 0;
+		// 傫Lobt@͉
+		if (q->size > BUFCHAIN_KEEP_SIZE) {
+			free(q->buf);
+			q->buf = NULL;
+			q->size = 0;
+		}
 	}
 
-	// XXgɂȂA
+	// Xf[^𑗂肫A
 	// local connectioñpPbgʒmĊJB
-	if (ch_origin && c->bufchain == NULL) {
+	if (queued && q->len == 0) {
 		FWD_suspend_resume_local_connection(pvar, c, TRUE);
 	}
 }
@@ -329,17 +364,22 @@ static void ssh2_channel_retry_send_bufchain(PTInstVar pvar, Channel_t *c)
 // (2007.4.26 yutaka)
 static void ssh2_channel_delete(Channel_t *c)
 {
-	bufchain_t *ch, *ptr;
 	enum scp_state prev_state;
 
-	ch = c->bufchain;
-	while (ch) {
-		if (ch->msg)
-			buffer_free(ch->msg);
-		ptr = ch;
-		ch = ch->next;
-		free(ptr);
+	if (c->window.adjusts > 0) {
+		logprintf(LOG_LEVEL_VERBOSE,
+		          "%s: channel=#%d window max=%u peak=%u srtt=%ums rate=%uKB/s received=%llu adjust=%u grow=%u shrink=%u",
+		          __FUNCTION__, c->self_id, c->local_window_max, c->window.peak,
+		          c->window.srtt, c->window.rate / 1024, c->window.received,
+		          c->window.adjusts, c->window.grows, c->window.shrinks);
+	}
+
+	if (c->bufchain.peak > 0) {
+		logprintf(LOG_LEVEL_VERBOSE, "%s: channel=#%d bufchain peak=%u left=%u",
+		          __FUNCTION__, c->self_id, c->bufchain.peak, c->bufchain.len);
 	}
+	free(c->bufchain.buf);
+	memset(&c->bufchain, 0, sizeof(c->bufchain));
 
 	if (c->type == TYPE_SCP) {
 		// SCP̍Ō̏ԂۑB
@@ -367,20 +407,29 @@ static void ssh2_channel_delete(Channel_t *c)
 			c->scp.progress_window = NULL;
 		}
 		if (c->scp.thread != INVALID_HANDLE_VALUE) {
+			// f[^҂Ă ssh_scp_receive_thread I点
+			if (c->scp.ring.event != NULL) {
+				InterlockedExchange(&c->scp.ring.closing, 1);
+				SetEvent(c->scp.ring.event);
+			}
 			WaitForSingleObject(c->scp.thread, INFINITE);
 			CloseHandle(c->scp.thread);
 			c->scp.thread = INVALID_HANDLE_VALUE;
 		}
 
-		// SCPM̏ꍇ̂݁ASCPpXg̊JsB
-		// Windows9xŗCB
+		// SCPM̏ꍇ̂݁ASCPpOobt@̊JsB
 		if (c->scp.dir == FROMREMOTE) {
-			PTInstVar pvar = c->scp.pvar;
-			ssh2_scp_free_packetlist(pvar, c);
+			ssh2_scp_free_ring(c);
+		}
+		else {
+			ssh2_scp_free_sendbuf(c);
 		}
 
 		g_scp_sending = FALSE;
 	}
+	if (c->type == TYPE_SFTP) {
+		sftp_channel_free(c);
+	}
 	if (c->type == TYPE_AGENT) {
 		buffer_free(c->agent_msg);
 	}
@@ -703,23 +752,6 @@ void log_kex_key(PTInstVar pvar, const BIGNUM *secret)
 #endif
 }
 
-static unsigned int get_predecryption_amount(PTInstVar pvar)
-{
-	static int small_block_decryption_sizes[] = { 5, 5, 6, 6, 8 };
-
-	if (SSHv1(pvar)) {
-		return 0;
-	} else {
-		unsigned int block_size = CRYPT_get_decryption_block_size(pvar);
-
-		if (block_size < 5) {
-			return small_block_decryption_sizes[block_size];
-		} else {
-			return block_size;
-		}
-	}
-}
-
 /* Get up to 'limit' bytes into the payload buffer.
    'limit' is counted from the start of the payload data.
    Returns the amount of data in the payload buffer, or
@@ -1001,78 +1033,8 @@ static int prep_packet_ssh1(PTInstVar pvar, char *data, unsigned int len, unsign
 
 static int prep_packet_ssh2(PTInstVar pvar, char *data, unsigned int len, unsigned int aadlen, unsigned int authlen)
 {
-	unsigned int padding;
-
-	if (authlen > 0) {
-		if (!CRYPT_decrypt_aead(pvar, data, len, aadlen, authlen)) {
-			UTIL_get_lang_msg("MSG_SSH_CORRUPTDATA_ERROR", pvar, "Detected corrupted data; connection terminating.");
-			notify_fatal_error(pvar, pvar->UIMsg, TRUE);
-			return SSH_MSG_NONE;
-		}
-	}
-	else if (aadlen > 0) {
-		// EtM ̏ꍇ͐ MAC ̌؂s
-		if (!CRYPT_verify_receiver_MAC(pvar, pvar->ssh_state.receiver_sequence_number, data, len + 4, data + len + 4)) {
-			UTIL_get_lang_msg("MSG_SSH_CORRUPTDATA_ERROR", pvar, "Detected corrupted data; connection terminating.");
-			notify_fatal_error(pvar, pvar->UIMsg, TRUE);
-			return SSH_MSG_NONE;
-		}
-
-		// pPbg(擪4oCg)͈ÍĂȂ̂ŁAXLbvĕB
-		CRYPT_decrypt(pvar, data + 4, len);
-	}
-	else {
-		// E&M ł͐擪OĂB
-		// Oꂽ擾B
-		unsigned int already_decrypted = get_predecryption_amount(pvar);
-
-		// OꂽXLbvāAc̕𕜍B
-		CRYPT_decrypt(pvar, data + already_decrypted, (4 + len) - already_decrypted);
-
-		// E&M ł͕ MAC ̌؂sB
-		if (!CRYPT_verify_receiver_MAC(pvar, pvar->ssh_state.receiver_sequence_number, data, len + 4, data + len + 4)) {
-			UTIL_get_lang_msg("MSG_SSH_CORRUPTDATA_ERROR", pvar, "Detected corrupted data; connection terminating.");
-			notify_fatal_error(pvar, pvar->UIMsg, TRUE);
-			return SSH_MSG_NONE;
-		}
-	}
-
-	// pfBO̎擾
-	padding = (unsigned int) data[4];
-
-	// pPbg(4oCg) ƃpfBO(1oCg)XLbv SSH yC[h̐擪
-	pvar->ssh_state.payload = data + 4 + 1;
-
-	// pfBO(1oCg)ƃpfBOۂ̃yC[h
-	pvar->ssh_state.payloadlen = len - 1 - padding;
-
-	pvar->ssh_state.payload_grabbed = 0;
-
-	// data compression
-	if (pvar->ssh2_keys[MODE_IN].comp.enabled &&
-	   (pvar->stoc_compression == COMP_ZLIB ||
-	    pvar->stoc_compression == COMP_DELAYED && pvar->userauth_success)) {
-
-		if (pvar->decomp_buffer == NULL) {
-			pvar->decomp_buffer = buffer_init();
-			if (pvar->decomp_buffer == NULL)
-				return SSH_MSG_NONE;
-		}
-		// xmۂobt@͎g񂷂̂ŏYꂸɁB
-		buffer_clear(pvar->decomp_buffer);
-
-		// packet sizepadding菜yC[ĥ݂WJB
-		buffer_decompress(&pvar->ssh_state.decompress_stream,
-		                  pvar->ssh_state.payload,
-		                  pvar->ssh_state.payloadlen,
-		                  pvar->decomp_buffer);
-
-		// |C^̍XVB
-		pvar->ssh_state.payload = buffer_ptr(pvar->decomp_buffer);
-		pvar->ssh_state.payload++;
-		pvar->ssh_state.payloadlen = buffer_len(pvar->decomp_buffer);
-	} else {
-		pvar->ssh_state.payload++;
+	if (!SSH2_packet_open(pvar, data, len, aadlen, authlen)) {
+		return SSH_MSG_NONE;
 	}
 
 	if (!grab_payload_limited(pvar, 1)) {
@@ -1084,38 +1046,6 @@ static int prep_packet_ssh2(PTInstVar pvar, char *data, unsigned int len, unsign
 	return pvar->ssh_state.payload[-1];
 }
 
-/* Create a packet to be sent. The SSH protocol packet type is in 'type';
-   'len' contains the length of the packet payload, in bytes (this
-   does not include the space for any of the packet headers or padding,
-   or for the packet type byte).
-   Returns a pointer to the payload data area, a region of length 'len',
-   to be filled by the caller. */
-unsigned char *begin_send_packet(PTInstVar pvar, int type, int len)
-{
-	unsigned char *buf;
-
-	pvar->ssh_state.outgoing_packet_len = len + 1;
-
-	if (pvar->ssh_state.compressing) {
-		buf_ensure_size(&pvar->ssh_state.precompress_outbuf,
-		                &pvar->ssh_state.precompress_outbuflen, 1 + len);
-		buf = pvar->ssh_state.precompress_outbuf;
-	} else {
-		/* For SSHv2,
-		   Encrypted_length is 4(packetlength) + 1(paddinglength) + 1(packettype)
-		   + len(payload) + 4(minpadding), rounded up to nearest block_size
-		   We only need a reasonable upper bound for the buffer size */
-		buf_ensure_size(&pvar->ssh_state.outbuf,
-		                &pvar->ssh_state.outbuflen,
-		                (int)(len + 30 + CRYPT_get_sender_MAC_size(pvar) +
-		                CRYPT_get_encryption_block_size(pvar)));
-		buf = pvar->ssh_state.outbuf + 12;
-	}
-
-	buf[0] = (unsigned char) type;
-	return buf + 1;
-}
-
 
 // MgC֐̒ǉ
 //
@@ -1193,6 +1123,112 @@ error:
 	return FALSE;
 }
 
+/*
+ * ML[ (SSH2)
+ *
+ * |[gtH[fBO SCP ł́A1̃Cxg̏ŕ̃`l
+ * SSH2_MSG_CHANNEL_DATA / SSH2_MSG_CHANNEL_WINDOW_ADJUST 𑗂邱ƂB
+ * pPbgƂ send() ƃVXeR[ATCP ̃ZOgȂ̂ŁA
+ * SSH_sendq_begin()  SSH_sendq_end() ̊Ԃɍ̃pPbg͑ML[
+ * ߂āA܂Ƃ߂ 1őB
+ *   - ̎ނ̃pPbǵA܂Ă镪ƈꏏɂ (Ԃ͕ςȂ)
+ *   - SSH_sendq_end() ̎_ő̃\Pbg̒ʒm͂ĂȂ΁A
+ *     ͂Ă΁AĂꏏɑ
+ *   - ŏɗ߂Ă SendCoalesceDelay (ms) oA^C}[ő
+ *   - ܂ʂ SSH_SENDQ_MAX zA
+ * L[{[h (SSH_send)  SSH_sendq_begin() ̊OȂ̂ŁA܂Œʂ肷B
+ */
+#define SSH_SENDQ_MAX (256 * 1024)
+
+static void ssh_sendq_flush(PTInstVar pvar)
+{
+	long len = pvar->ssh_state.sendq_len;
+
+	if (pvar->ssh_state.sendq_timer != 0) {
+		KillTimer(pvar->cv->HWin, pvar->ssh_state.sendq_timer);
+		pvar->ssh_state.sendq_timer = 0;
+	}
+	if (len == 0) {
+		return;
+	}
+	pvar->ssh_state.sendq_len = 0;
+	send_packet_blocking(pvar, (char *)pvar->ssh_state.sendq, len);
+}
+
+static VOID CALLBACK ssh_sendq_timer(HWND hWnd, UINT uMsg, UINT_PTR nIDEvent, DWORD dwTime)
+{
+	PTInstVar pvar = (PTInstVar)nIDEvent;
+
+	(void)hWnd;
+	(void)uMsg;
+	(void)dwTime;
+
+	if (pvar->socket == INVALID_SOCKET) {
+		// ؒfɎcĂ^C}[
+		KillTimer(pvar->cv->HWin, pvar->ssh_state.sendq_timer);
+		pvar->ssh_state.sendq_timer = 0;
+		pvar->ssh_state.sendq_len = 0;
+		return;
+	}
+	ssh_sendq_flush(pvar);
+}
+
+static void ssh_sendq_send(PTInstVar pvar, unsigned char *data, unsigned int len)
+{
+	int type = pvar->ssh_state.outgoing_packet_type;
+	BOOL defer = pvar->ssh_state.sendq_nest > 0 && pvar->settings.SendCoalesceDelay > 0 &&
+	             (type == SSH2_MSG_CHANNEL_DATA || type == SSH2_MSG_CHANNEL_WINDOW_ADJUST);
+
+	if (pvar->ssh_state.sendq_len > 0 && pvar->ssh_state.sendq_len + (long)len > SSH_SENDQ_MAX) {
+		// 肫Ȃ̂ŁAɗ܂Ă镪𑗂
+		ssh_sendq_flush(pvar);
+	}
+	if (!defer && pvar->ssh_state.sendq_len == 0) {
+		// ܂Ă̂Ȃ΁A܂Œʂ肻̂܂ܑ
+		send_packet_blocking(pvar, (char *)data, len);
+		return;
+	}
+
+	buf_ensure_size_growing(&pvar->ssh_state.sendq, &pvar->ssh_state.sendq_size,
+	                        pvar->ssh_state.sendq_len + (long)len);
+	if (pvar->ssh_state.sendq_len == 0) {
+		pvar->ssh_state.sendq_tick = GetTickCount();
+		pvar->ssh_state.sendq_timer =
+			SetTimer(pvar->cv->HWin, (UINT_PTR)pvar, pvar->settings.SendCoalesceDelay, ssh_sendq_timer);
+	}
+	memcpy(pvar->ssh_state.sendq + pvar->ssh_state.sendq_len, data, len);
+	pvar->ssh_state.sendq_len += len;
+
+	if (!defer || pvar->ssh_state.sendq_len >= SSH_SENDQ_MAX ||
+	    GetTickCount() - pvar->ssh_state.sendq_tick >= (DWORD)pvar->settings.SendCoalesceDelay) {
+		ssh_sendq_flush(pvar);
+	}
+}
+
+//  SSH_sendq_end() ܂łɑ`l̃f[^𗭂߂BqɂłB
+void SSH_sendq_begin(PTInstVar pvar)
+{
+	pvar->ssh_state.sendq_nest++;
+}
+
+void SSH_sendq_end(PTInstVar pvar)
+{
+	// r SSH_end() / SSH_init() Ă΂Ă 0 ɂȂĂ
+	if (pvar->ssh_state.sendq_nest > 0) {
+		pvar->ssh_state.sendq_nest--;
+	}
+	if (pvar->ssh_state.sendq_nest > 0 || pvar->ssh_state.sendq_len == 0) {
+		return;
+	}
+	// ̃\Pbg̒ʒm͂Ă΁A߂Ă瑗B
+	// ͂ĂȂ΁A҂ĂȂ̂łB
+	if ((HIWORD(GetQueueStatus(QS_POSTMESSAGE)) & QS_POSTMESSAGE) &&
+	    GetTickCount() - pvar->ssh_state.sendq_tick < (DWORD)pvar->settings.SendCoalesceDelay) {
+		return;
+	}
+	ssh_sendq_flush(pvar);
+}
+
 /* if skip_compress is true, then the data has already been compressed
    into outbuf + 12 */
 void finish_send_packet_special(PTInstVar pvar, int skip_compress)
@@ -1239,135 +1275,17 @@ void finish_send_packet_special(PTInstVar pvar, int skip_compress)
 		set_uint32(data + data_length - 4, do_crc(data + 4, data_length - 8));
 		CRYPT_encrypt(pvar, data + 4, data_length - 4);
 	} else { //for SSH2(yutaka)
-		unsigned int block_size = CRYPT_get_encryption_block_size(pvar);
-		unsigned int packet_length;
-		unsigned int encryption_size;
-		unsigned int padding_size;
-		BOOL ret;
-		struct Mac *mac = &pvar->ssh2_keys[MODE_OUT].mac;
-		struct Enc *enc = &pvar->ssh2_keys[MODE_OUT].enc;
-		unsigned int aadlen = 0, maclen = 0, authlen = 0;
-
-		/*
-		 f[^\
-		 pvar->ssh_state.outbuf:
-		 offset: 0 1 2 3 4 5 6 7 8 9 10 11 12 ...         EOD
-		         <--ignore---> ^^^^^^^^    <---- payload --->
-		                       packet length
-
-		                                ^^padding_size
-
-		                       <---------------------------->
-		                          SSH2 sending data on TCP
-
-		 NOTE:
-		   payload = type(1) + raw-data
-		   len = ssh_state.outgoing_packet_len = payload size
-		 */
-		// pPbgkL̏ꍇApPbgkĂ瑗MpPbg\zB(2005.7.9 yutaka)
-		// support of "Compression delayed" (2006.6.23 maya)
-		if ((pvar->ctos_compression == COMP_ZLIB ||
-		     pvar->ctos_compression == COMP_DELAYED && pvar->userauth_success) &&
-		    pvar->ssh2_keys[MODE_OUT].comp.enabled) {
-			// ̃obt@ packet-length(4) + padding(1) + payload(any) B
-			msg = buffer_init();
-			if (msg == NULL) {
-				// TODO: error check
-				logprintf(LOG_LEVEL_ERROR, "%s: buffer_init returns NULL.", __FUNCTION__);
-				return;
-			}
-
-			// kΏۂ̓wb_yC[ĥ݁B
-			buffer_append(msg, "\0\0\0\0\0", 5);  // 5 = packet-length(4) + padding(1)
-			if (buffer_compress(&pvar->ssh_state.compress_stream, pvar->ssh_state.outbuf + 12, len, msg) == -1) {
-				UTIL_get_lang_msg("MSG_SSH_COMP_ERROR", pvar,
-				                  "An error occurred while compressing packet data.\n"
-				                  "The connection will close.");
-				notify_fatal_error(pvar, pvar->UIMsg, TRUE);
-				return;
-			}
-			data = buffer_ptr(msg);
-			len = buffer_len(msg) - 5;  // 'len' is overwritten.
-
-		} else {
-			// k
-			data = pvar->ssh_state.outbuf + 7;
-		}
-
-		// MpPbg\z(input parameter: data, len)
-		if (block_size < 8) {
-			block_size = 8;
-		}
-
-		if (enc) {
-			authlen = enc->auth_len;
-		}
-
-		if (mac && mac->etm || authlen > 0) {
-			// ÍΏۂł͂ȂAMAC ̑ΏۂƂȂpPbg̒
-			// ܂ chacha20-poly1305 ňÍpPbg̒
-			// cf. PKT_recv ̃Rg
-			aadlen = 4;
-		}
-
-		packet_length = 1 + len; // pfBÕTCY + yC[h
-		encryption_size = 4 + packet_length - aadlen; // pPbg̃TCY + packet_length - addlen
-		padding_size = block_size - (encryption_size % block_size);
-		if (padding_size < 4)
-			padding_size += block_size;
-		packet_length += padding_size;
-		encryption_size += padding_size;
-		set_uint32(data, packet_length);
-		data[4] = (unsigned char) padding_size;
-		if (msg) {
-			// pPbgk̏ꍇAobt@gB(2011.6.10 yutaka)
-			buffer_append_space(msg, padding_size + EVP_MAX_MD_SIZE);
-			// realloc()ƁA|C^ς\̂ŁAēx蒼B
-			data = buffer_ptr(msg);
-		}
-
-		CRYPT_set_random_data(pvar, data + 5 + len, padding_size);
-
-		if (authlen > 0) {
-			// pPbgÍ MAC ̌vZ
-			CRYPT_encrypt_aead(pvar, data, encryption_size, aadlen, authlen);
-			maclen = authlen;
-		}
-		else if (aadlen) {
-			// pPbgÍiaadlen낾j
-			CRYPT_encrypt(pvar, data + aadlen, encryption_size);
-
-			// EtM ł͈Í MAC vZ
-			ret = CRYPT_build_sender_MAC(pvar, pvar->ssh_state.sender_sequence_number,
-			                             data, aadlen + encryption_size, data + aadlen + encryption_size);
-			if (ret) {
-				maclen = CRYPT_get_sender_MAC_size(pvar);
-			}
-		}
-		else {
-			// E&M ł͈ÍO MAC vZ
-			ret = CRYPT_build_sender_MAC(pvar, pvar->ssh_state.sender_sequence_number,
-			                             data, encryption_size, data + encryption_size);
-			if (ret) {
-				maclen = CRYPT_get_sender_MAC_size(pvar);
-			}
-
-			// pPbgÍ
-			CRYPT_encrypt(pvar, data, encryption_size);
+		data = SSH2_packet_build(pvar, len, &data_length, &msg);
+		if (data == NULL) {
+			return;
 		}
-
-		data_length = encryption_size + aadlen + maclen;
-
-		logprintf(150,
-		          "%s: built packet info: "
-		          "aadlen:%d, enclen:%d, padlen:%d, datalen:%d, maclen:%d, "
-		          "Encrypt Mode:%s, MAC mode:%s",
-		          __FUNCTION__,
-		          aadlen, encryption_size, padding_size, data_length, maclen,
-		          authlen ? "AEAD" : "not AEAD", aadlen ? "EtM" : "E&M");
 	}
 
-	send_packet_blocking(pvar, data, data_length);
+	if (SSHv1(pvar)) {
+		send_packet_blocking(pvar, data, data_length);
+	} else {
+		ssh_sendq_send(pvar, data, data_length);
+	}
 
 	buffer_free(msg);
 
@@ -2968,6 +2886,10 @@ void SSH_init(PTInstVar pvar)
 	           &pvar->ssh_state.precompress_outbuflen);
 	buf_create(&pvar->ssh_state.postdecompress_inbuf,
 	           &pvar->ssh_state.postdecompress_inbuflen);
+	buf_create(&pvar->ssh_state.sendq, &pvar->ssh_state.sendq_size);
+	pvar->ssh_state.sendq_len = 0;
+	pvar->ssh_state.sendq_timer = 0;
+	pvar->ssh_state.sendq_nest = 0;
 	pvar->ssh_state.payload = NULL;
 	pvar->ssh_state.compressing = FALSE;
 	pvar->ssh_state.decompressing = FALSE;
@@ -3222,55 +3144,6 @@ error:
 	return (ret);
 }
 
-unsigned int SSH_get_min_packet_size(PTInstVar pvar)
-{
-	if (SSHv1(pvar)) {
-		return 12;
-	} else {
-		return max(16, CRYPT_get_decryption_block_size(pvar));
-	}
-}
-
-/* data is guaranteed to be at least SSH_get_min_packet_size bytes long
-   at least 5 bytes must be decrypted */
-void SSH_predecrypt_packet(PTInstVar pvar, char *data)
-{
-	if (SSHv2(pvar)) {
-		CRYPT_decrypt(pvar, data, get_predecryption_amount(pvar));
-	}
-}
-
-unsigned int SSH_get_clear_MAC_size(PTInstVar pvar)
-{
-	if (SSHv1(pvar)) {
-		return 0;
-	} else {
-		return CRYPT_get_receiver_MAC_size(pvar);
-	}
-}
-
-unsigned int SSH_get_authdata_size(PTInstVar pvar, int direction)
-{
-	if (SSHv1(pvar)) {
-		return 0;
-	}
-	else {
-		struct Mac *mac = &pvar->ssh2_keys[direction].mac;
-		struct Enc *enc = &pvar->ssh2_keys[direction].enc;
-
-		if (enc && enc->auth_len > 0) {
-			// AEAD
-			return enc->auth_len;
-		}
-		else if (mac && mac->enabled) {
-			return mac->mac_len;
-		}
-		else {
-			return 0;
-		}
-	}
-}
-
 void SSH_notify_user_name(PTInstVar pvar)
 {
 	try_send_user_name(pvar);
@@ -3505,6 +3378,12 @@ void SSH_end(PTInstVar pvar)
 	            &pvar->ssh_state.precompress_outbuflen);
 	buf_destroy(&pvar->ssh_state.postdecompress_inbuf,
 	            &pvar->ssh_state.postdecompress_inbuflen);
+	if (pvar->ssh_state.sendq_timer != 0) {
+		KillTimer(pvar->cv->HWin, pvar->ssh_state.sendq_timer);
+		pvar->ssh_state.sendq_timer = 0;
+	}
+	buf_destroy(&pvar->ssh_state.sendq, &pvar->ssh_state.sendq_size);
+	pvar->ssh_state.sendq_len = 0;
 	pvar->agentfwd_enable = FALSE;
 	pvar->use_subsystem = FALSE;
 	pvar->nosession = FALSE;
@@ -3618,7 +3497,7 @@ void SSH2_send_channel_data(PTInstVar pvar, Channel_t *c, unsigned char *buf, un
 	// NhXgɎcĂ悤ł΁AXg̖ɌqB
 	// ɂpPbgꂽ悤Ɍ錻ۂPB
 	// (2012.10.14 yutaka)
-	if (retry == 0 && c->bufchain) {
+	if (retry == 0 && c->bufchain.len > 0) {
 		ssh2_channel_add_bufchain(pvar, c, buf, buflen);
 		return;
 	}
@@ -4416,13 +4295,23 @@ int SSH_scp_sending_status(void)
 	return g_scp_sending;
 }
 
+// M(܂͍ŌɑM)t@C̐i݋Ԃ
+//	percent: Mς݂̊, rate: ]x(KB/s), eta: cb(-1 = s)
+int SSH_scp_sending_progress(int *percent, int *rate, int *eta)
+{
+	*percent = g_scp_send_percent;
+	*rate = g_scp_send_rate;
+	*eta = g_scp_send_eta;
+	return g_scp_sending;
+}
+
 int SSH_start_scp_receive(PTInstVar pvar, char *filename)
 {
 	return SSH_scp_transaction(pvar, filename, NULL, FROMREMOTE);
 }
 
 
-int SSH_sftp_transaction(PTInstVar pvar)
+static Channel_t *ssh2_sftp_channel_open(PTInstVar pvar)
 {
 	buffer_t *msg;
 	char *s;
@@ -4466,13 +4355,63 @@ int SSH_sftp_transaction(PTInstVar pvar)
 
 	logputs(LOG_LEVEL_VERBOSE, "SSH2_MSG_CHANNEL_OPEN was sent at SSH_sftp_transaction().");
 
-	return TRUE;
+	return c;
 
 error:
 	if (c != NULL)
 		ssh2_channel_delete(c);
 
-	return FALSE;
+	return NULL;
+}
+
+int SSH_sftp_transaction(PTInstVar pvar)
+{
+	return ssh2_sftp_channel_open(pvar) != NULL;
+}
+
+/**
+ *	SFTP get/put
+ *	JĂSFTP`l΂̃`lŁAȂΐVJē]B
+ *	]͔񓯊ɍsAɓo^]I܂ő҂B
+ *
+ *	@param localfile	t@C,UTF-8
+ *	@param remotefile	t@C,UTF-8
+ *	@param direction	TOREMOTE	put
+ *						FROMREMOTE	get
+ *	@retval SFTP_REQUEST_OK				]vo^
+ *	@retval SFTP_REQUEST_NOT_CONNECTED	SSH2 ŐڑĂȂ
+ *	@retval SFTP_REQUEST_BAD_ARGUMENT	t@CȂ
+ *	@retval SFTP_REQUEST_FAILED			`lJȂ
+ */
+int SSH_sftp_transfer(PTInstVar pvar, const char *localfile, const char *remotefile, enum scp_dir direction)
+{
+	Channel_t *c = NULL;
+	int i;
+
+	if (pvar->socket == INVALID_SOCKET || SSHv1(pvar))
+		return SFTP_REQUEST_NOT_CONNECTED;
+
+	for (i = 0 ; i < CHANNEL_MAX ; i++) {
+		if (channels[i].used && channels[i].type == TYPE_SFTP &&
+		    !(channels[i].state & SSH_CHANNEL_STATE_CLOSE_SENT)) {
+			c = &channels[i];
+			break;
+		}
+	}
+	if (c == NULL) {
+		c = ssh2_sftp_channel_open(pvar);
+		if (c == NULL)
+			return SFTP_REQUEST_FAILED;
+	}
+
+	return sftp_transfer_request(pvar, c, localfile, remotefile, direction);
+}
+
+// get/put ̓]v̏ԂԂ
+//	done: , failed: s, ߂l: ܂IĂȂ
+int SSH_sftp_transfer_status(int *done, int *failed)
+{
+	return sftp_transfer_status(done, failed);
 }
 
 
@@ -8165,6 +8104,93 @@ static BOOL handle_SSH2_channel_failure(PTInstVar pvar)
 
 
 
+// `lf[^̎ML^
+//	EBhEg؂Ԃ WINDOW_ADJUST 𑗂ĂA
+//	̃f[^M܂ł̎Ԃ RTT Ƃ
+static void ssh2_channel_window_received(Channel_t *c, unsigned int len)
+{
+	c->window.received += len;
+
+	if (c->window.stall_tick != 0) {
+		unsigned int rtt = GetTickCount() - c->window.stall_tick;
+		if (rtt == 0) {
+			rtt = 1;
+		}
+		c->window.srtt = c->window.srtt == 0 ? rtt : (c->window.srtt * 7 + rtt) / 8;
+		c->window.stall_tick = 0;
+	}
+}
+
+// MEBhȆ傫(local_window_max)𒲐
+//	EBhE̔邲Ƃ WINDOW_ADJUST 𑗂̂ŁA
+//	ш敝x(Mx x RTT) 2{ڕWɁA1ɍő 2{܂ő傫B
+//	RTT vłĂȂƂ́AEBhEg؂Ă 2{ɂB
+//	Mf[^̏xĂƂ͔ɂB
+static void ssh2_channel_tune_window(PTInstVar pvar, Channel_t *c)
+{
+	unsigned int ceiling = (unsigned int)pvar->settings.ChannelWindowMax * 1024;
+	unsigned int consumed = c->local_window_max - c->local_window;
+	unsigned int target = c->local_window_max;
+	DWORD now = GetTickCount();
+	DWORD elapsed = now - c->window.adjust_tick;
+	unsigned long long rate;
+
+	if (elapsed == 0) {
+		elapsed = 1;
+	}
+	rate = (unsigned long long)consumed * 1000 / elapsed;
+	c->window.rate = rate > 0xffffffff ? 0xffffffff : (unsigned int)rate;
+	c->window.adjust_tick = now;
+	c->window.adjusts++;
+
+	if (c->type == TYPE_SCP && c->scp.ring.buf != NULL && ceiling > c->scp.ring.window) {
+		// SCPM̓Oobt@Ɏ܂傫܂
+		ceiling = c->scp.ring.window;
+	}
+
+	if (ceiling <= c->window.floor) {
+		// Ȃ
+		c->window.behind = FALSE;
+		return;
+	}
+
+	if (c->window.behind) {
+		target = c->local_window_max / 2;
+		c->window.behind = FALSE;
+	}
+	else if (c->window.srtt > 0) {
+		unsigned long long bdp = (unsigned long long)c->window.rate * c->window.srtt / 1000;
+		if (bdp * 2 > target) {
+			target = (unsigned int)min(bdp * 2, (unsigned long long)target * 2);
+		}
+	}
+	else if (c->local_window < c->local_maxpacket) {
+		target = c->local_window_max * 2;
+	}
+
+	if (target > ceiling) {
+		target = ceiling;
+	}
+	if (target < c->window.floor) {
+		target = c->window.floor;
+	}
+
+	if (target != c->local_window_max) {
+		if (target > c->local_window_max) {
+			c->window.grows++;
+		}
+		else {
+			c->window.shrinks++;
+		}
+		logprintf(LOG_LEVEL_VERBOSE, "%s: channel=#%d window %u -> %u (rate=%uKB/s srtt=%ums)",
+		          __FUNCTION__, c->self_id, c->local_window_max, target, c->window.rate / 1024, c->window.srtt);
+		c->local_window_max = target;
+		if (target > c->window.peak) {
+			c->window.peak = target;
+		}
+	}
+}
+
 // NCAgwindow sizeT[o֒m点
 static void do_SSH2_adjust_window_size(PTInstVar pvar, Channel_t *c)
 {
@@ -8179,6 +8205,12 @@ static void do_SSH2_adjust_window_size(PTInstVar pvar, Channel_t *c)
 	if (c->local_window > c->local_window_max/2)
 		return;
 
+	ssh2_channel_tune_window(pvar, c);
+	if (c->local_window >= c->local_window_max) {
+		// EBhÊŁA܂Ȃ
+		return;
+	}
+
 	{
 		// pty open
 		msg = buffer_init();
@@ -8196,6 +8228,10 @@ static void do_SSH2_adjust_window_size(PTInstVar pvar, Channel_t *c)
 		buffer_free(msg);
 
 		logputs(LOG_LEVEL_SSHDUMP, "SSH2_MSG_CHANNEL_WINDOW_ADJUST was sent at do_SSH2_adjust_window_size().");
+		// EBhEg؂ĂÃf[^M܂ł̎(RTT)v
+		if (c->local_window < c->local_maxpacket) {
+			c->window.stall_tick = GetTickCount();
+		}
 		// NCAgwindow size𑝂₷
 		c->local_window = c->local_window_max;
 	}
@@ -8239,14 +8275,37 @@ void ssh2_channel_send_close(PTInstVar pvar, Channel_t *c)
 #define WM_SENDING_FILE (WM_USER + 1)
 #define WM_CHANNEL_CLOSE (WM_USER + 2)
 #define WM_GET_CLOSED_STATUS (WM_USER + 3)
+#define WM_SCP_RESUME (WM_USER + 4)
 
 typedef struct scp_dlg_parm {
 	Channel_t *c;
 	PTInstVar pvar;
-	char *buf;
-	size_t buflen;
 } scp_dlg_parm_t;
 
+// ssh_scp_thread ǂ݂obt@𑗐MB
+// WM_SENDING_FILE  GUI XbhĂ΂B
+static void ssh2_scp_send_block(PTInstVar pvar, Channel_t *c, int slot)
+{
+	unsigned char *buf = c->scp.send.buf[slot];
+	unsigned int len = c->scp.send.len[slot];
+	unsigned int n;
+
+	// LZŃN[Y͑Ȃ
+	if (pvar->socket != INVALID_SOCKET && !(c->state & SSH_CHANNEL_STATE_CLOSE_SENT)) {
+		// remote_maxpacket zȂ悤ɕđB
+		// remote_window Ȃ bufchain ɕۑAWINDOW_ADJUST őB
+		SSH_sendq_begin(pvar);
+		while (len > 0) {
+			n = (c->remote_maxpacket > 0) ? min(len, c->remote_maxpacket) : len;
+			SSH2_send_channel_data(pvar, c, buf, n, 0);
+			buf += n;
+			len -= n;
+		}
+		SSH_sendq_end(pvar);
+	}
+	ReleaseSemaphore(c->scp.send.free, 1, NULL);
+}
+
 static INT_PTR CALLBACK ssh_scp_dlg_proc(HWND hWnd, UINT msg, WPARAM wp, LPARAM lp)
 {
 	static int closed = 0;
@@ -8267,11 +8326,21 @@ static INT_PTR CALLBACK ssh_scp_dlg_proc(HWND hWnd, UINT msg, WPARAM wp, LPARAM
 			return TRUE;
 			break;
 
+		// SCPt@CMAssh_scp_receive_thread M̍ĊJ˗B
+		case WM_SCP_RESUME:
+			{
+			Channel_t *c = (Channel_t *)wp;
+
+			ssh2_scp_resume_receive(c->scp.pvar, c);
+			}
+			return TRUE;
+
+		// SCPt@CMAssh_scp_thread ǂ݂obt@̑M˗B
 		case WM_SENDING_FILE:
 			{
-			scp_dlg_parm_t *parm = (scp_dlg_parm_t *)wp;
+			Channel_t *c = (Channel_t *)wp;
 
-			SSH2_send_channel_data(parm->pvar, parm->c, parm->buf, parm->buflen, 0);
+			ssh2_scp_send_block(c->scp.pvar, c, (int)lp);
 			}
 			return TRUE;
 			break;
@@ -8334,23 +8403,66 @@ static int is_canceled_window(HWND hd)
 		return 0;
 }
 
+// SCPMp̐ǂ݃obt@pӂB ssh2_channel_delete() ōsB
+static BOOL ssh2_scp_alloc_sendbuf(Channel_t *c)
+{
+	int i;
+
+	for (i = 0; i < SCPSEND_BUFFERS; i++) {
+		c->scp.send.buf[i] = malloc(SCPSEND_BUFFER_SIZE);
+		if (c->scp.send.buf[i] == NULL)
+			return FALSE;
+	}
+	c->scp.send.free = CreateSemaphore(NULL, SCPSEND_BUFFERS, SCPSEND_BUFFERS, NULL);
+	if (c->scp.send.free == NULL)
+		return FALSE;
+	return TRUE;
+}
+
+static void ssh2_scp_free_sendbuf(Channel_t *c)
+{
+	int i;
+
+	for (i = 0; i < SCPSEND_BUFFERS; i++) {
+		free(c->scp.send.buf[i]);
+		c->scp.send.buf[i] = NULL;
+	}
+	if (c->scp.send.free != NULL) {
+		CloseHandle(c->scp.send.free);
+		c->scp.send.free = NULL;
+	}
+}
+
+// t@Cǂ݂ GUI Xbh֑M˗B
+//	SCPSEND_BUFFERS ̃obt@ɎgAM(Í)Ɏ̃obt@ǂݍށB
+//	Mς݂̃obt@̓Z}tH c->scp.send.free ŕԂĂB
 static unsigned __stdcall ssh_scp_thread(void *p)
 {
 	Channel_t *c = (Channel_t *)p;
 	PTInstVar pvar = c->scp.pvar;
 	long long total_size = 0;
-	char *buf = NULL;
-	size_t buflen;
-	char s[80];
+	long long remain;
 	size_t ret;
+	char s[80];
 	HWND hWnd = c->scp.progress_window;
 	scp_dlg_parm_t parm;
 	int rate, ProgStat;
 	DWORD stime;
 	int elapsed, prev_elapsed;
+	DWORD elapsed_ms;
+	int slot = 0;
+
+	g_scp_send_percent = 0;
+	g_scp_send_rate = 0;
+	g_scp_send_eta = -1;
 
-	buflen = min(c->remote_window, 8192*4); // max 32KB
-	buf = malloc(buflen);
+	if (!ssh2_scp_alloc_sendbuf(c)) {
+		logprintf(LOG_LEVEL_ERROR, "%s: can't allocate SCP send buffer", __FUNCTION__);
+		goto cancel_abort;
+	}
+
+	// obt@̑傫œǂނ̂ŁACRT̃obt@͎gȂ
+	setvbuf(c->scp.localfp, NULL, _IONBF, 0);
 
 	SetDlgItemTextU8(hWnd, IDC_FILENAME, c->scp.localfilefull);
 
@@ -8359,47 +8471,46 @@ static unsigned __stdcall ssh_scp_thread(void *p)
 	stime = GetTickCount();
 	prev_elapsed = 0;
 
-	do {
-		int readlen, count=0;
-
-		// Cancel{^ꂽEBhEB
-		if (is_canceled_window(hWnd))
-			goto cancel_abort;
-
-		// t@Cǂݍ񂾃f[^͂Ȃ炸T[o֑MB
-		readlen = max(4096, min(buflen, c->remote_window)); // min 4KB
-		ret = fread(buf, 1, readlen, c->scp.localfp);
-		if (ret == 0)
-			break;
+	for (;;) {
+		// 󂢂Ăobt@҂
+		for (;;) {
+			// Cancel{^ꂽEBhEB
+			if (is_canceled_window(hWnd))
+				goto cancel_abort;
 
-		// remote_window 񕜂܂ő҂
-		do {
 			// socket or channelN[YꂽXbhI
 			if (pvar->socket == INVALID_SOCKET || c->scp.state == SCP_CLOSING || c->used == 0)
 				goto abort;
 
-			if (ret > c->remote_window) {
-				Sleep(100);
-			}
-
-			// 100񔲂Ȃ甲Ă܂
-			count++;
-			if (count > 100) {
+			if (WaitForSingleObject(c->scp.send.free, 100) == WAIT_OBJECT_0)
 				break;
-			}
+		}
 
-		} while (ret > c->remote_window);
+		// t@Cǂݍ񂾃f[^͂Ȃ炸T[o֑MB
+		ret = fread(c->scp.send.buf[slot], 1, SCPSEND_BUFFER_SIZE, c->scp.localfp);
+		if (ret == 0) {
+			ReleaseSemaphore(c->scp.send.free, 1, NULL);
+			break;
+		}
+
+		// remote_window 肸ɑȂf[^܂ĂԂ͑҂
+		while (c->bufchain.len >= SCPSEND_BUFFER_SIZE) {
+			if (is_canceled_window(hWnd))
+				goto cancel_abort;
+			if (pvar->socket == INVALID_SOCKET || c->scp.state == SCP_CLOSING || c->used == 0)
+				goto abort;
+			Sleep(10);
+		}
 
 		// sending data
-		parm.buf = buf;
-		parm.buflen = ret;
-		parm.c = c;
-		parm.pvar = pvar;
-		SendMessage(hWnd, WM_SENDING_FILE, (WPARAM)&parm, 0);
+		c->scp.send.len[slot] = (unsigned int)ret;
+		PostMessage(hWnd, WM_SENDING_FILE, (WPARAM)c, (LPARAM)slot);
+		slot = (slot + 1) % SCPSEND_BUFFERS;
 
 		total_size += ret;
 
 		rate = (int)(100 * total_size / c->scp.filestat.st_size);
+		g_scp_send_percent = rate;
 		_snprintf_s(s, sizeof(s), _TRUNCATE, "%lld / %lld (%d%%)", total_size, c->scp.filestat.st_size, rate);
 		SendMessage(GetDlgItem(hWnd, IDC_PROGRESS), WM_SETTEXT, 0, (LPARAM)s);
 		if (ProgStat != rate) {
@@ -8407,7 +8518,16 @@ static unsigned __stdcall ssh_scp_thread(void *p)
 			SendDlgItemMessage(hWnd, IDC_PROGBAR, PBM_SETPOS, (WPARAM)ProgStat, 0);
 		}
 
-		elapsed = (GetTickCount() - stime) / 1000;
+		// ]xƎc莞
+		elapsed_ms = GetTickCount() - stime;
+		if (elapsed_ms >= 1000) {
+			long long bps = total_size * 1000 / elapsed_ms;
+			remain = c->scp.filestat.st_size - total_size;
+			g_scp_send_rate = (LONG)(bps / 1024);
+			g_scp_send_eta = (bps > 0) ? (LONG)((remain + bps - 1) / bps) : -1;
+		}
+
+		elapsed = elapsed_ms / 1000;
 		if (elapsed > prev_elapsed) {
 			if (elapsed > 2) {
 				rate = (int)(total_size / elapsed);
@@ -8427,23 +8547,25 @@ static unsigned __stdcall ssh_scp_thread(void *p)
 			SendDlgItemMessage(hWnd, IDC_PROGTIME, WM_SETTEXT, 0, (LPARAM)s);
 			prev_elapsed = elapsed;
 		}
-
-	} while (ret <= buflen);
+	}
 
 	// eof
+	for (;;) {
+		if (pvar->socket == INVALID_SOCKET || c->scp.state == SCP_CLOSING || c->used == 0)
+			goto abort;
+		if (WaitForSingleObject(c->scp.send.free, 100) == WAIT_OBJECT_0)
+			break;
+	}
 	c->scp.state = SCP_DATA;
+	g_scp_send_percent = 100;
+	g_scp_send_eta = 0;
 
-	buf[0] = '\0';
-	parm.buf = buf;
-	parm.buflen = 1;
-	parm.c = c;
-	parm.pvar = pvar;
-	SendMessage(hWnd, WM_SENDING_FILE, (WPARAM)&parm, 0);
+	c->scp.send.buf[slot][0] = '\0';
+	c->scp.send.len[slot] = 1;
+	PostMessage(hWnd, WM_SENDING_FILE, (WPARAM)c, (LPARAM)slot);
 
 	ShowWindow(hWnd, SW_HIDE);
 
-	free(buf);
-
 	return 0;
 
 cancel_abort:
@@ -8455,8 +8577,7 @@ cancel_abort:
 	SendMessage(hWnd, WM_CHANNEL_CLOSE, (WPARAM)&parm, 0);
 
 abort:
-
-	free(buf);
+	g_scp_send_eta = -1;
 
 	return 0;
 }
@@ -8520,19 +8641,24 @@ static void SSH2_scp_toremote(PTInstVar pvar, Channel_t *c, unsigned char *data,
 }
 
 
-#define WM_RECEIVING_FILE (WM_USER + 2)
+// 葤̃XbhXV head/tail ǂށB
+// ǂ񂾈ʒu܂ł̃f[^(܂͋)悤Aǂ񂾌ɃoAuB
+static unsigned int scp_ring_load(volatile LONG *p)
+{
+	LONG v = *p;
+	MemoryBarrier();
+	return (unsigned int)v;
+}
 
 static unsigned __stdcall ssh_scp_receive_thread(void *p)
 {
 	Channel_t *c = (Channel_t *)p;
 	PTInstVar pvar = c->scp.pvar;
-	long long total_size = 0;
+	scp_ring_t *ring = &c->scp.ring;
 	char s[80];
 	HWND hWnd = c->scp.progress_window;
-	MSG msg;
-	unsigned char *data;
-	unsigned int buflen;
-	int eof;
+	unsigned int head, tail, avail, buflen;
+	long long remain;
 	int rate, ProgStat;
 	DWORD stime;
 	int elapsed, prev_elapsed;
@@ -8542,77 +8668,83 @@ static unsigned __stdcall ssh_scp_receive_thread(void *p)
 
 	stime = GetTickCount();
 	prev_elapsed = 0;
+	tail = (unsigned int)ring->tail;
 
 	for (;;) {
+		// `l폜
+		if (ring->closing)
+			return 0;
+
 		// Cancel{^ꂽEBhEB
 		if (is_canceled_window(hWnd))
 			goto cancel_abort;
 
-		ssh2_scp_get_packetlist(pvar, c, &data, &buflen);
-		if (data && buflen) {
-			msg.message = WM_RECEIVING_FILE;
-
-			switch (msg.message) {
-			case WM_RECEIVING_FILE:
-				//data = (unsigned char *)msg.wParam;
-				//buflen = (unsigned int)msg.lParam;
-				eof = 0;
-
-				if (c->scp.filercvsize >= c->scp.filetotalsize) { // EOF
-					free(data);  // free!
-					goto done;
-				}
+		remain = c->scp.filetotalsize - c->scp.filercvsize;
+		if (remain <= 0) { // EOF
+			goto done;
+		}
 
-				if (c->scp.filercvsize + buflen > c->scp.filetotalsize) { // overflow (include EOF)
-					buflen = (unsigned int)(c->scp.filetotalsize - c->scp.filercvsize);
-					eof = 1;
-				}
+		// ݒP(ring->block)ɖȂƂ́At@C̍Ō܂ő܂ő҂
+		head = scp_ring_load(&ring->head);
+		avail = head - tail;
+		if (avail < ring->block && avail < remain) {
+			InterlockedExchange(&ring->waiting, 1);
+			head = scp_ring_load(&ring->head);
+			avail = head - tail;
+			if (avail < ring->block && avail < remain && !ring->closing) {
+				WaitForSingleObject(ring->event, 100);
+			}
+			InterlockedExchange(&ring->waiting, 0);
+			continue;
+		}
 
-				c->scp.filercvsize += buflen;
+		// tail ͏ block ̔{(Ō)Ȃ̂ŁAobt@̏I[܂Ȃ
+		buflen = (avail >= ring->block) ? ring->block : (unsigned int)remain;
+		if (fwrite(ring->buf + (tail & (ring->size - 1)), 1, buflen, c->scp.localfp) < buflen) { // error
+			logprintf(LOG_LEVEL_ERROR, "%s: write error at %lld bytes", __FUNCTION__, c->scp.filercvsize);
+			goto cancel_abort;
+		}
+		tail += buflen;
+		InterlockedExchange(&ring->tail, (LONG)tail);
+		c->scp.filercvsize += buflen;
 
-				if (fwrite(data, 1, buflen, c->scp.localfp) < buflen) { // error
-					// TODO:
-				}
+		// 󂫂MEBhȄłASCPM̃ubNB
+		if (ring->suspended && ring->size - (scp_ring_load(&ring->head) - tail) >= ring->window) {
+			if (InterlockedCompareExchange(&ring->suspended, 0, 1) == 1) {
+				logprintf(LOG_LEVEL_NOTICE, "%s: SCP receive resumed", __FUNCTION__);
+				PostMessage(hWnd, WM_SCP_RESUME, (WPARAM)c, 0);
+			}
+		}
 
-				free(data);  // free!
+		rate =(int)(100 * c->scp.filercvsize / c->scp.filetotalsize);
+		_snprintf_s(s, sizeof(s), _TRUNCATE, "%lld / %lld (%d%%)", c->scp.filercvsize, c->scp.filetotalsize, rate);
+		SendMessage(GetDlgItem(c->scp.progress_window, IDC_PROGRESS), WM_SETTEXT, 0, (LPARAM)s);
 
-				rate =(int)(100 * c->scp.filercvsize / c->scp.filetotalsize);
-				_snprintf_s(s, sizeof(s), _TRUNCATE, "%lld / %lld (%d%%)", c->scp.filercvsize, c->scp.filetotalsize, rate);
-				SendMessage(GetDlgItem(c->scp.progress_window, IDC_PROGRESS), WM_SETTEXT, 0, (LPARAM)s);
+		if (ProgStat != rate) {
+			ProgStat = rate;
+			SendDlgItemMessage(c->scp.progress_window, IDC_PROGBAR, PBM_SETPOS, (WPARAM)ProgStat, 0);
+		}
 
-				if (ProgStat != rate) {
-					ProgStat = rate;
-					SendDlgItemMessage(c->scp.progress_window, IDC_PROGBAR, PBM_SETPOS, (WPARAM)ProgStat, 0);
+		elapsed = (GetTickCount() - stime) / 1000;
+		if (elapsed > prev_elapsed) {
+			if (elapsed > 2) {
+				rate = (int)(c->scp.filercvsize / elapsed);
+				if (rate < 1200) {
+					_snprintf_s(s, sizeof(s), _TRUNCATE, "%d:%02d (%d %s)", elapsed / 60, elapsed % 60, rate, "Bytes/s");
 				}
-
-				elapsed = (GetTickCount() - stime) / 1000;
-				if (elapsed > prev_elapsed) {
-					if (elapsed > 2) {
-						rate = (int)(c->scp.filercvsize / elapsed);
-						if (rate < 1200) {
-							_snprintf_s(s, sizeof(s), _TRUNCATE, "%d:%02d (%d %s)", elapsed / 60, elapsed % 60, rate, "Bytes/s");
-						}
-						else if (rate < 1200000) {
-							_snprintf_s(s, sizeof(s), _TRUNCATE, "%d:%02d (%d.%02d %s)", elapsed / 60, elapsed % 60, rate / 1000, rate / 10 % 100, "KBytes/s");
-						}
-						else {
-							_snprintf_s(s, sizeof(s), _TRUNCATE, "%d:%02d (%d.%02d %s)", elapsed / 60, elapsed % 60, rate / (1000 * 1000), rate / 10000 % 100, "MBytes/s");
-						}
-					}
-					else {
-						_snprintf_s(s, sizeof(s), _TRUNCATE, "%d:%02d", elapsed / 60, elapsed % 60);
-					}
-					SendDlgItemMessage(hWnd, IDC_PROGTIME, WM_SETTEXT, 0, (LPARAM)s);
-					prev_elapsed = elapsed;
+				else if (rate < 1200000) {
+					_snprintf_s(s, sizeof(s), _TRUNCATE, "%d:%02d (%d.%02d %s)", elapsed / 60, elapsed % 60, rate / 1000, rate / 10 % 100, "KBytes/s");
+				}
+				else {
+					_snprintf_s(s, sizeof(s), _TRUNCATE, "%d:%02d (%d.%02d %s)", elapsed / 60, elapsed % 60, rate / (1000 * 1000), rate / 10000 % 100, "MBytes/s");
 				}
-
-				if (eof)
-					goto done;
-
-				break;
 			}
+			else {
+				_snprintf_s(s, sizeof(s), _TRUNCATE, "%d:%02d", elapsed / 60, elapsed % 60);
+			}
+			SendDlgItemMessage(hWnd, IDC_PROGTIME, WM_SETTEXT, 0, (LPARAM)s);
+			prev_elapsed = elapsed;
 		}
-		Sleep(0);
 	}
 
 done:
@@ -8629,6 +8761,10 @@ done:
 
 cancel_abort:
 	pvar->recv.close_request = TRUE;
+	// M~߂܂܂ close 𑗂_@Ȃ̂ŁAĊJ
+	if (InterlockedCompareExchange(&ring->suspended, 0, 1) == 1) {
+		PostMessage(hWnd, WM_SCP_RESUME, (WPARAM)c, 0);
+	}
 	return 0;
 }
 
@@ -8653,140 +8789,182 @@ static void CALLBACK do_SSH2_adjust_window_size_timer(
 		KillTimer(pvar->cv->HWin, pvar->recv.timer_id);
 		pvar->recv.timer_id = 0;
 	}
+	if (c->scp.ring.suspended) {
+		// Oobt@̋󂫂ȂBĊJ ssh_scp_receive_thread ˗
+		return;
+	}
 
 	logprintf(LOG_LEVEL_NOTICE, "%s: SCP receive, send SSH_MSG_CHANNEL_WINDOW_ADJUST", __FUNCTION__);
 	pvar->recv.suspended = FALSE;
 	do_SSH2_adjust_window_size(pvar, c);
 }
 
-// SSHT[o瑗Ăt@C̃f[^XgɂȂB
-// Xg̎o ssh_scp_receive_thread XbhōsB
-static void ssh2_scp_add_packetlist(PTInstVar pvar, Channel_t *c, unsigned char *buf, unsigned int buflen)
+// ssh_scp_receive_thread Oobt@ɋ󂫂̂ŁAMĊJB
+// WM_SCP_RESUME  GUI XbhĂ΂B
+static void ssh2_scp_resume_receive(PTInstVar pvar, Channel_t *c)
 {
-	PacketList_t *p, *old;
+	// ĊJ܂ł̊ԂɁA܂󂫂ȂȂ
+	if (!pvar->recv.suspended || c->scp.ring.suspended)
+		return;
 
-	EnterCriticalSection(&g_ssh_scp_lock);
+	// SCPM̃ubNB
+	pvar->recv.suspended = FALSE;
+	if (!pvar->recv.data_finished && pvar->recv.timer_id == 0) {
+		// M
+		pvar->recv.timer_id =
+			SetTimer(pvar->cv->HWin, (UINT_PTR)c, USER_TIMER_MINIMUM, do_SSH2_adjust_window_size_timer);
+	}
+}
 
-	// allocate new buffer
-	p = malloc(sizeof(PacketList_t));
-	if (p == NULL)
-		goto error;
-	p->buf = buf;
-	p->buflen = buflen;
-	p->next = NULL;
+// SSHT[o瑗Ăt@C̃f[^Oobt@ɏށB
+// o ssh_scp_receive_thread XbhōsB
+static void ssh2_scp_put_ring(PTInstVar pvar, Channel_t *c, unsigned char *buf, unsigned int buflen)
+{
+	scp_ring_t *ring = &c->scp.ring;
+	unsigned int head = (unsigned int)ring->head;
+	unsigned int pos, n, fill;
+	long long remain = c->scp.filetotalsize - (long long)c->scp.recv.received_size;
 
-	if (c->scp.pktlist_head == NULL) {
-		c->scp.pktlist_head = p;
-		c->scp.pktlist_tail = p;
-	}
-	else {
-		old = c->scp.pktlist_tail;
-		old->next = p;
-		c->scp.pktlist_tail = p;
+	// t@ČɑĂI[ '\0' ͏܂Ȃ
+	if (ring->buf == NULL || remain <= 0)
+		return;
+	if (buflen > remain)
+		buflen = (unsigned int)remain;
+
+	fill = head - scp_ring_load(&ring->tail);
+	if (ring->size - fill < buflen) {
+		// MEBhEzđĂȂNȂ
+		logprintf(LOG_LEVEL_ERROR, "%s: channel=#%d SCP receive buffer overflow (%u + %u bytes)",
+		          __FUNCTION__, c->self_id, fill, buflen);
+		pvar->recv.close_request = TRUE;
+		return;
 	}
 
-	// L[ɋl񂾃f[^̑TCYZB
-	c->scp.pktlist_cursize += buflen;
+	pos = head & (ring->size - 1);
+	n = min(buflen, ring->size - pos);
+	memcpy(ring->buf + pos, buf, n);
+	memcpy(ring->buf, buf + n, buflen - n);
+	head += buflen;
+	InterlockedExchange(&ring->head, (LONG)head);
+	fill += buflen;
 
-	// L[ɋl񂾃f[^̑TCY臒l𒴂ꍇA
-	// SSHT[owindows size̍XV~
-	// ɂ胊XgGgA̔剻
-	// łB
-	if (c->scp.pktlist_cursize >= SCPRCV_HIGH_WATER_MARK) {
-		logprintf(LOG_LEVEL_NOTICE,
-			"%s: enter suspend", __FUNCTION__);
-		pvar->recv.suspended = TRUE;
+	if (ring->waiting && (fill >= ring->block || buflen == remain)) {
+		SetEvent(ring->event);
 	}
 
-	logprintf(LOG_LEVEL_NOTICE,
-		"%s: channel=#%d SCP recv %u(bytes) and enqueued.%s",
-		__FUNCTION__, c->self_id, c->scp.pktlist_cursize,
-		pvar->recv.suspended ? "(suspended)" : ""
-	);
-
-error:;
-	LeaveCriticalSection(&g_ssh_scp_lock);
+	// 󂫂MEBhȄ菭ȂȂASSHT[owindow size̍XV~B
+	// ɂAT[oĂf[^͕KOobt@Ɏ܂B
+	if (ring->size - fill < ring->window) {
+		InterlockedExchange(&ring->suspended, 1);
+		fill = head - scp_ring_load(&ring->tail);
+		if (ring->size - fill >= ring->window &&
+		    InterlockedCompareExchange(&ring->suspended, 0, 1) == 1) {
+			// ̊Ԃɋ󂫂ł
+			return;
+		}
+		logprintf(LOG_LEVEL_NOTICE, "%s: channel=#%d enter suspend (%u bytes queued)",
+		          __FUNCTION__, c->self_id, fill);
+		pvar->recv.suspended = TRUE;
+		c->window.behind = TRUE;
+	}
 }
 
-static void ssh2_scp_get_packetlist(PTInstVar pvar, Channel_t *c, unsigned char **buf, unsigned int *buflen)
+// SCPMp̃Oobt@pӂB
+//	MEBhȄ 2ƏݒP 2킹傫ɂāA
+//	t@Cւ̏ݒM𑱂悤ɂB
+//	t@CŜƏݒP 1őƂ́Ȃ傫ɂB
+static BOOL ssh2_scp_alloc_ring(PTInstVar pvar, Channel_t *c)
 {
-	PacketList_t *p;
-
-	EnterCriticalSection(&g_ssh_scp_lock);
+	scp_ring_t *ring = &c->scp.ring;
+	unsigned int block = 1024 * 1024;
+	unsigned int window = (unsigned int)pvar->settings.ChannelWindowMax * 1024;
+	unsigned int size;
 
-	if (c->scp.pktlist_head == NULL) {
-		*buf = NULL;
-		*buflen = 0;
-		goto end;
+	while (block * 2 <= (unsigned int)pvar->settings.ScpRecvBlockSize * 1024 * 1024) {
+		block *= 2;
+	}
+	if (window > SCPRCV_WINDOW_LIMIT) {
+		window = SCPRCV_WINDOW_LIMIT;
+	}
+	if (window < c->local_window_max) {
+		window = c->local_window_max;
 	}
 
-	p = c->scp.pktlist_head;
-	*buf = p->buf;
-	*buflen = p->buflen;
-
-	c->scp.pktlist_head = p->next;
-
-	if (c->scp.pktlist_head == NULL)
-		c->scp.pktlist_tail = NULL;
-
-	free(p);
-
-	// L[ɋl񂾃f[^̑TCYZB
-	c->scp.pktlist_cursize -= *buflen;
-
-	// L[ɋl񂾃f[^̑TCY臒lꍇA
-	// SSHT[owindow size̍XVĊJ
-	if (c->scp.pktlist_cursize <= SCPRCV_LOW_WATER_MARK) {
-		logprintf(LOG_LEVEL_NOTICE, "%s: SCP receive resumed", __FUNCTION__);
-		// ubNĂꍇ
-		if (pvar->recv.suspended) {
-			// SCPM̃ubNB
-			pvar->recv.suspended = FALSE;
-			if (c->scp.filercvsize < c->scp.filetotalsize) {
-				// M
-				pvar->recv.timer_id =
-					SetTimer(pvar->cv->HWin, (UINT_PTR)c, USER_TIMER_MINIMUM, do_SSH2_adjust_window_size_timer);
-			}
-		}
+	for (size = block; size < window * 2 + block * 2; size *= 2)
+		;
+	// t@Ĉ߂ɑ傫mۂȂBI[ '\0' ̓Oobt@ɓȂB
+	while (size / 2 >= block * 2 && (long long)(size / 2) >= c->scp.filetotalsize + block) {
+		size /= 2;
+	}
+	ring->buf = malloc(size);
+	// mۂłȂΏBłɋEBhE͕KvB
+	while (ring->buf == NULL && size / 2 >= c->local_window_max + block * 2) {
+		size /= 2;
+		ring->buf = malloc(size);
+	}
+	if (ring->buf == NULL) {
+		return FALSE;
+	}
+	if (window > size - block * 2) {
+		window = size - block * 2;
 	}
 
-	logprintf(LOG_LEVEL_NOTICE,
-		"%s: channel=#%d SCP recv %u(bytes) and dequeued.%s",
-		__FUNCTION__, c->self_id, c->scp.pktlist_cursize,
-		pvar->recv.suspended ? "(suspended)" : ""
-	);
+	ring->event = CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (ring->event == NULL) {
+		free(ring->buf);
+		ring->buf = NULL;
+		return FALSE;
+	}
+	ring->size = size;
+	ring->block = block;
+	ring->window = window;
+	ring->head = 0;
+	ring->tail = 0;
+	ring->waiting = 0;
+	ring->suspended = 0;
+	ring->closing = 0;
 
-end:;
-	LeaveCriticalSection(&g_ssh_scp_lock);
-}
+	// block Pʂŏނ̂ŁACRT̃obt@͒ʂȂ
+	setvbuf(c->scp.localfp, NULL, _IONBF, 0);
 
-static void ssh2_scp_alloc_packetlist(PTInstVar pvar, Channel_t *c)
-{
-	c->scp.pktlist_head = NULL;
-	c->scp.pktlist_tail = NULL;
-	InitializeCriticalSection(&g_ssh_scp_lock);
-	c->scp.pktlist_cursize = 0;
 	pvar->recv.suspended = FALSE;
 	pvar->recv.timer_id = 0;
 	pvar->recv.close_request = FALSE;
+
+	logprintf(LOG_LEVEL_VERBOSE, "%s: channel=#%d ring=%uKB block=%uKB window=%uKB",
+	          __FUNCTION__, c->self_id, size / 1024, block / 1024, window / 1024);
+	return TRUE;
 }
 
-static void ssh2_scp_free_packetlist(PTInstVar pvar, Channel_t *c)
+static void ssh2_scp_free_ring(Channel_t *c)
 {
-	PacketList_t *p, *old;
-
-	p = c->scp.pktlist_head;
-	while (p) {
-		old = p;
-		p = p->next;
+	scp_ring_t *ring = &c->scp.ring;
 
-		free(old->buf);
-		free(old);
+	free(ring->buf);
+	if (ring->event != NULL) {
+		CloseHandle(ring->event);
 	}
+	memset(ring, 0, sizeof(*ring));
+}
+
+// Mt@C̑傫܂ŁAɃt@CLĂB
+// fЉh߂Ȃ̂ŁAsĂ̂܂܎MB
+static void ssh2_scp_preallocate(PTInstVar pvar, Channel_t *c)
+{
+	HANDLE h = (HANDLE)_get_osfhandle(_fileno(c->scp.localfp));
+	LARGE_INTEGER pos;
 
-	c->scp.pktlist_head = NULL;
-	c->scp.pktlist_tail = NULL;
-	DeleteCriticalSection(&g_ssh_scp_lock);
+	(void)pvar;
+	if (h == INVALID_HANDLE_VALUE || c->scp.filetotalsize <= 0)
+		return;
+
+	pos.QuadPart = c->scp.filetotalsize;
+	if (!SetFilePointerEx(h, pos, NULL, FILE_BEGIN) || !SetEndOfFile(h)) {
+		logprintf(LOG_LEVEL_NOTICE, "%s: can't preallocate %lld bytes (error=%lu)",
+		          __FUNCTION__, c->scp.filetotalsize, GetLastError());
+	}
+	pos.QuadPart = 0;
+	SetFilePointerEx(h, pos, NULL, FILE_BEGIN);
 }
 
 static BOOL SSH2_scp_fromremote(PTInstVar pvar, Channel_t *c, unsigned char *data, unsigned int buflen)
@@ -8849,7 +9027,14 @@ static BOOL SSH2_scp_fromremote(PTInstVar pvar, Channel_t *c, unsigned char *dat
 				ShowWindow(hDlgWnd, SW_SHOW);
 			}
 
-			ssh2_scp_alloc_packetlist(pvar, c);
+			if (!ssh2_scp_alloc_ring(pvar, c)) {
+				logprintf(LOG_LEVEL_ERROR, "%s: can't allocate SCP receive buffer", __FUNCTION__);
+				ssh2_channel_send_close(pvar, c);
+				return TRUE;
+			}
+			if (pvar->settings.ScpPreallocate) {
+				ssh2_scp_preallocate(pvar, c);
+			}
 			thread = (HANDLE)_beginthreadex(NULL, 0, ssh_scp_receive_thread, c, 0, &tid);
 			if (thread == 0) {
 				// TODO:
@@ -8884,13 +9069,8 @@ static BOOL SSH2_scp_fromremote(PTInstVar pvar, Channel_t *c, unsigned char *dat
 			ssh2_channel_send_close(pvar, c);
 		}
 		else {
-			unsigned char *newdata = malloc(buflen);
-			if (newdata != NULL) {
-				memcpy(newdata, data, buflen);
-
-				// ̒ suspended  TRUE ɂȂ邱Ƃ
-				ssh2_scp_add_packetlist(pvar, c, newdata, buflen);
-			}
+			// ̒ suspended  TRUE ɂȂ邱Ƃ
+			ssh2_scp_put_ring(pvar, c, data, buflen);
 
 			c->scp.recv.received_size += buflen;
 
@@ -8899,8 +9079,8 @@ static BOOL SSH2_scp_fromremote(PTInstVar pvar, Channel_t *c, unsigned char *dat
 				PTInstVar pvar = c->scp.pvar;
 				pvar->recv.data_finished = TRUE;
 				if (pvar->recv.timer_id != 0) {
-					pvar->recv.timer_id = 0;
 					KillTimer(pvar->cv->HWin, pvar->recv.timer_id);
+					pvar->recv.timer_id = 0;
 				}
 			}
 			else if (pvar->recv.suspended) {
@@ -9057,6 +9237,7 @@ static BOOL handle_SSH2_channel_data(PTInstVar pvar)
 			"len:%d local_window:%d", __FUNCTION__, str_len, c->local_window);
 		return FALSE;
 	}
+	ssh2_channel_window_received(c, str_len);
 
 	// yC[hƂăNCAg(Tera Term)֓n
 	if (c->type == TYPE_SHELL || c->type == TYPE_SUBSYSTEM_GEN) {
@@ -9066,6 +9247,10 @@ static BOOL handle_SSH2_channel_data(PTInstVar pvar)
 	} else if (c->type == TYPE_PORTFWD) {
 		//debug_print(0, data, strlen);
 		FWD_received_data(pvar, c->local_num, data, str_len);
+		if (FWD_get_pending_size(pvar, c->local_num) > 0) {
+			// ]̃\Pbg֑肫Ȃ
+			c->window.behind = TRUE;
+		}
 
 	} else if (c->type == TYPE_SCP) {  // SCP
 		SSH2_scp_response(pvar, c, data, str_len);
@@ -9145,6 +9330,7 @@ static BOOL handle_SSH2_channel_extended_data(PTInstVar pvar)
 			"len:%d local_window:%d", __FUNCTION__, strlen, c->local_window);
 		return FALSE;
 	}
+	ssh2_channel_window_received(c, strlen);
 
 	// yC[hƂăNCAg(Tera Term)֓n
 	if (c->type == TYPE_SHELL || c->type == TYPE_SUBSYSTEM_GEN) {
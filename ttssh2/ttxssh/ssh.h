@@ -389,6 +389,18 @@ typedef struct {
 	long precompress_outbuflen;
 	/* this is the length of the packet data, including the type header */
 	long outgoing_packet_len;
+	/* this is the SSH protocol packet type of the outgoing packet */
+	int outgoing_packet_type;
+
+	/* ML[ (SSH2)
+	   SSH_sendq_begin()  SSH_sendq_end() ̊Ԃɍ`l̃f[^𗭂߂āA
+	   ܂Ƃ߂ 1ő */
+	unsigned char *sendq;
+	long sendq_size;
+	long sendq_len;
+	DWORD sendq_tick;       // ŏ̃pPbg𗭂߂
+	UINT_PTR sendq_timer;
+	int sendq_nest;
 
 	/* This buffer is used by the SSH protocol processing to store decompressed
 	   packet data. User data is never streamed through here; it is decompressed
@@ -479,9 +491,12 @@ void SSH_open_channel(PTInstVar pvar, uint32 local_channel_num,
 
 int SSH_start_scp(PTInstVar pvar, char *sendfile, char *dstfile);
 int SSH_scp_sending_status(void);
+int SSH_scp_sending_progress(int *percent, int *rate, int *eta);
 int SSH_start_scp_receive(PTInstVar pvar, char *filename);
 int SSH_scp_transaction(PTInstVar pvar, const char *sendfile, const char *dstfile, enum scp_dir direction);
 int SSH_sftp_transaction(PTInstVar pvar);
+int SSH_sftp_transfer(PTInstVar pvar, const char *localfile, const char *remotefile, enum scp_dir direction);
+int SSH_sftp_transfer_status(int *done, int *failed);
 
 /* auxiliary SSH2 interfaces for pkt.c */
 unsigned int SSH_get_min_packet_size(PTInstVar pvar);
@@ -516,21 +531,46 @@ enum scp_state {
 	SCP_INIT, SCP_TIMESTAMP, SCP_FILEINFO, SCP_DATA, SCP_CLOSING,
 };
 
+// remote_window ̋󂫂đȂf[^ۑ郊Oobt@
 typedef struct bufchain {
-	buffer_t *msg;
-	struct bufchain *next;
+	unsigned char *buf;
+	unsigned int size;      // obt@̑傫
+	unsigned int start;     // 擪̃f[^̈ʒu
+	unsigned int len;       // ۑĂf[^
+	unsigned int peak;      // len ̍ől(L^p)
 } bufchain_t;
 
-typedef struct PacketList {
-	char *buf;
-	unsigned int buflen;
-	struct PacketList *next;
-} PacketList_t;
-
-// SCPMɂt[臒l
-// Kp scp_t.filercvsize
-#define SCPRCV_HIGH_WATER_MARK (1 * 1024 * 1024)  // 1MB
-#define SCPRCV_LOW_WATER_MARK (0)  // 0MB
+#define BUFCHAIN_INITIAL_SIZE (64 * 1024)
+// ɂȂƂɁA傫obt@͉
+#define BUFCHAIN_KEEP_SIZE (256 * 1024)
+
+// SCPM̐ǂ݃obt@̐Ƒ傫
+//	t@C̓ǂݍ݂ƁAGUIXbhł̈ÍEMsčs
+#define SCPSEND_BUFFERS 3
+#define SCPSEND_BUFFER_SIZE (256 * 1024)
+
+// SCPMŃt@C֏ޒPʂ̏ (MB)
+#define SCPRCV_MAX_BLOCK 4
+// SCPM̎MEBhȄ
+//	Oobt@͂ 2{ + ݒP 2ȏ̑傫mۂ
+#define SCPRCV_WINDOW_LIMIT (16 * 1024 * 1024)
+
+// SCPMp̃Oobt@
+//	SSH̎M(ݑ) ssh_scp_receive_thread(ǂݏo) 1Ȃ̂ŁA
+//	bN͎g킸 head/tail ̍XVŎ󂯓nB
+//	head/tail ͗ݐς̃oCgŁAsize(2ׂ̂)Ŋ]肪obt@̈ʒuB
+typedef struct scp_ring {
+	unsigned char *buf;
+	unsigned int size;          // obt@̑傫(block ̔{)
+	unsigned int block;         // t@C֏ޒP
+	unsigned int window;        // MEBhȄ
+	volatile LONG head;         // 񂾗ʁBSSH̎MXV
+	volatile LONG tail;         // oʁBssh_scp_receive_thread XV
+	volatile LONG waiting;      // 1 ̂ƂAǂݏo event ҂Ă
+	volatile LONG suspended;    // 1 ̂ƂA󂫕sŎM~߂Ă
+	volatile LONG closing;      // 1 ̂ƂAǂݏo̓f[^҂ɏI
+	HANDLE event;
+} scp_ring_t;
 
 typedef struct scp {
 	enum scp_dir dir;              // transfer direction
@@ -549,9 +589,13 @@ typedef struct scp {
 	long long filercvsize;
 	DWORD filemtime;
 	DWORD fileatime;
-	PacketList_t *pktlist_head;
-	PacketList_t *pktlist_tail;
-	unsigned long pktlist_cursize;
+	scp_ring_t ring;
+	// for sending file
+	struct {
+		unsigned char *buf[SCPSEND_BUFFERS];  // ǂ݂f[^
+		unsigned int len[SCPSEND_BUFFERS];
+		HANDLE free;                          // 󂢂Ăobt@̐(Z}tH)
+	} send;
 	struct {
 		uint64_t received_size;
 	} recv;
@@ -559,8 +603,47 @@ typedef struct scp {
 
 enum sftp_state {
 	SFTP_INIT, SFTP_CONNECTED, SFTP_REALPATH,
+	SFTP_OPEN, SFTP_TRANSFER, SFTP_CLOSE,
 };
 
+// get/put ̓]v (sftp_t.jobs ɓo^Ɍq)
+typedef struct sftp_job {
+	struct sftp_job *next;
+	enum scp_dir dir;              // transfer direction
+	char localfile[MAX_PATH];      // local filename (UTF-8)
+	char remotefile[1024];         // remote filename (UTF-8)
+} sftp_job_t;
+
+// ҂ SSH2_FXP_READ/SSH2_FXP_WRITE v
+typedef struct sftp_request {
+	BOOL used;
+	unsigned int id;
+	unsigned long long offset;
+	unsigned int len;
+} sftp_request_t;
+
+//  get/put
+typedef struct sftp_transfer {
+	sftp_job_t *job;
+	FILE *localfp;
+	char *handle;                  // SSH2_FXP_HANDLE Ŏ󂯎nh
+	int handle_len;
+	unsigned int id;               // SSH2_FXP_OPEN/SSH2_FXP_CLOSE ̗vID
+	sftp_request_t *requests;      // sftp_t.num_requests 
+	unsigned int outstanding;      // ҂̗v
+	unsigned char *iobuf;          // put ̃t@Cǂݍݗp (sftp_t.transfer_buflen)
+	unsigned long long offset;     // ɗvʒu
+	unsigned long long filepos;    // get ̃[Jt@C݈̏ʒu
+	unsigned long long bytes;      // ]ς݃oCg
+	BOOL eof;
+	BOOL failed;
+	// v
+	DWORD start_tick;
+	unsigned int max_outstanding;
+	unsigned int reordered;        // vƈقȂ鏇œ͂̐
+	unsigned int short_reads;      // vZf[^ԂĂ
+} sftp_transfer_t;
+
 typedef struct sftp {
 	enum sftp_state state;
 	HWND console_window;
@@ -576,6 +659,14 @@ typedef struct sftp {
 	unsigned long long limit_kbps;
 	//struct bwlimit bwlimit_in, bwlimit_out;
 	char path[1024];
+	struct {                       // MrSFTPpPbg
+		unsigned char *buf;
+		unsigned int size;
+		unsigned int start;
+		unsigned int len;
+	} recv;
+	sftp_job_t *jobs;              // ̓]v
+	sftp_transfer_t xfer;
 } sftp_t;
 
 typedef struct channel {
@@ -588,10 +679,24 @@ typedef struct channel {
 	unsigned int local_maxpacket;
 	unsigned int remote_window;
 	unsigned int remote_maxpacket;
+	// MEBhE(local_window_max)̎ ssh2_channel_tune_window()
+	struct {
+		unsigned int floor;          // local_window_max ̉ (`l쐬̒l)
+		DWORD adjust_tick;           // O SSH2_MSG_CHANNEL_WINDOW_ADJUST 𑗂
+		DWORD stall_tick;            // EBhEg؂Ԃ WINDOW_ADJUST 𑗂 (RTTvp)
+		unsigned int srtt;           // RTT (ms, 0=v)
+		unsigned int rate;           // Mx (bytes/s)
+		BOOL behind;                 // Mf[^̏(SCP, ]\Pbg)xĂ
+		// v
+		unsigned long long received;
+		unsigned int peak;
+		unsigned int adjusts;
+		unsigned int grows;
+		unsigned int shrinks;
+	} window;
 	enum channel_type type;
 	int local_num;
-	bufchain_t *bufchain;
-	unsigned long bufchain_amount;
+	bufchain_t bufchain;
 	BOOL bufchain_recv_suspended;
 	scp_t scp;
 	buffer_t *agent_msg;
@@ -603,6 +708,8 @@ typedef struct channel {
 
 unsigned char *begin_send_packet(PTInstVar pvar, int type, int len);
 void finish_send_packet_special(PTInstVar pvar, int skip_compress);
+void SSH_sendq_begin(PTInstVar pvar);
+void SSH_sendq_end(PTInstVar pvar);
 void SSH2_send_channel_data(PTInstVar pvar, Channel_t *c, unsigned char *buf, unsigned int buflen, int retry);
 Channel_t* ssh2_local_channel_lookup(int local_num);
 void normalize_generic_order(char *buf, char default_strings[], int default_strings_len);
@@ -51,6 +51,7 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <time.h>
+#include <process.h>
 #include <locale.h>		// for setlocale()
 
 #include "resource.h"
@@ -418,6 +419,46 @@ static void read_ssh_options(PTInstVar pvar, const wchar_t *fileName)
 
 	settings->AuthBanner = GetPrivateProfileInt("TTSSH", "AuthBanner", 3, fileName);
 
+	settings->ChannelWindowMax = GetPrivateProfileInt("TTSSH", "ChannelWindowMax", 8192, fileName);
+	if (settings->ChannelWindowMax < 0) {
+		settings->ChannelWindowMax = 0;
+	}
+	else if (settings->ChannelWindowMax > 1024 * 1024) {
+		settings->ChannelWindowMax = 1024 * 1024;
+	}
+
+	settings->SftpRequests = GetPrivateProfileInt("TTSSH", "SftpRequests", DEFAULT_NUM_REQUESTS, fileName);
+	if (settings->SftpRequests < 1) {
+		settings->SftpRequests = 1;
+	}
+	else if (settings->SftpRequests > MAX_NUM_REQUESTS) {
+		settings->SftpRequests = MAX_NUM_REQUESTS;
+	}
+	settings->SftpBufferSize = GetPrivateProfileInt("TTSSH", "SftpBufferSize", DEFAULT_COPY_BUFLEN / 1024, fileName);
+	if (settings->SftpBufferSize < 1) {
+		settings->SftpBufferSize = 1;
+	}
+	else if (settings->SftpBufferSize > SFTP_MAX_XFER_LENGTH / 1024) {
+		settings->SftpBufferSize = SFTP_MAX_XFER_LENGTH / 1024;
+	}
+
+	settings->ScpRecvBlockSize = GetPrivateProfileInt("TTSSH", "ScpRecvBlockSize", 1, fileName);
+	if (settings->ScpRecvBlockSize < 1) {
+		settings->ScpRecvBlockSize = 1;
+	}
+	else if (settings->ScpRecvBlockSize > SCPRCV_MAX_BLOCK) {
+		settings->ScpRecvBlockSize = SCPRCV_MAX_BLOCK;
+	}
+	settings->ScpPreallocate = GetPrivateProfileInt("TTSSH", "ScpPreallocate", 1, fileName);
+
+	settings->SendCoalesceDelay = GetPrivateProfileInt("TTSSH", "SendCoalesceDelay", 10, fileName);
+	if (settings->SendCoalesceDelay < 0) {
+		settings->SendCoalesceDelay = 0;
+	}
+	else if (settings->SendCoalesceDelay > 1000) {
+		settings->SendCoalesceDelay = 1000;
+	}
+
 #ifdef _DEBUG
 	GetPrivateProfileStringW(L"TTSSH", L"KexKeyLogFile", L"", settings->KexKeyLogFile, _countof(settings->KexKeyLogFile), fileName);
 	if (settings->KexKeyLogFile[0] == 0) {
@@ -566,6 +607,24 @@ static void write_ssh_options(PTInstVar pvar, const wchar_t *fileName,
 	_itoa_s(settings->AuthBanner, buf, sizeof(buf), 10);
 	WritePrivateProfileString("TTSSH", "AuthBanner", buf, fileName);
 
+	_itoa_s(settings->ChannelWindowMax, buf, sizeof(buf), 10);
+	WritePrivateProfileString("TTSSH", "ChannelWindowMax", buf, fileName);
+
+	_itoa_s(settings->SftpRequests, buf, sizeof(buf), 10);
+	WritePrivateProfileString("TTSSH", "SftpRequests", buf, fileName);
+
+	_itoa_s(settings->SftpBufferSize, buf, sizeof(buf), 10);
+	WritePrivateProfileString("TTSSH", "SftpBufferSize", buf, fileName);
+
+	_itoa_s(settings->ScpRecvBlockSize, buf, sizeof(buf), 10);
+	WritePrivateProfileString("TTSSH", "ScpRecvBlockSize", buf, fileName);
+
+	_itoa_s(settings->ScpPreallocate, buf, sizeof(buf), 10);
+	WritePrivateProfileString("TTSSH", "ScpPreallocate", buf, fileName);
+
+	_itoa_s(settings->SendCoalesceDelay, buf, sizeof(buf), 10);
+	WritePrivateProfileString("TTSSH", "SendCoalesceDelay", buf, fileName);
+
 #ifdef _DEBUG
 	WritePrivateProfileStringW(L"TTSSH", L"KexKeyLogFile", settings->KexKeyLogFile, fileName);
 	WritePrivateProfileString("TTSSH", "KexKeyLogging",
@@ -703,7 +762,10 @@ static int PASCAL TTXrecv(SOCKET s, char *buf, int len, int flags)
 		int ret;
 
 		ssh_heartbeat_lock();
+		// MpPbg̏ɑ`l̃f[^́A܂Ƃ߂đ
+		SSH_sendq_begin(pvar);
 		ret = PKT_recv(pvar, buf, len);
+		SSH_sendq_end(pvar);
 		ssh_heartbeat_unlock();
 		return (ret);
 
@@ -816,39 +878,346 @@ void notify_fatal_error(PTInstVar pvar, char *msg, BOOL send_disconnect)
 	}
 }
 
-void logputs(int level, char *msg)
+/*
+ * TTSSH.LOG ւ̏
+ *	logputs() ̓bZ[WOobt@ɓ邾ŁAt@Cւ݂̏
+ *	log_writer_thread() t@CJ܂܁A܂Ƃ߂čsB
+ *	logputs() ͕̃XbhĂ΂̂ŁAOobt@̊eGg
+ *	ʂԍ(seq)AInterlocked ֐ŒǉB
+ *	Oobt@t̂Ƃ̓bZ[ŴāÂĂOɎcB
+ */
+#define LOG_RING_SIZE 2048              // Gg(2ׂ̂)
+#define LOG_RING_TEXT 240               // 蒷bZ[W malloc 
+#define LOG_WRITE_BUFSIZE (64 * 1024)   // 1Ƀt@C֏ޑ傫
+
+enum {
+	LOG_WRITER_NONE,        // ݃XbhNĂȂ
+	LOG_WRITER_STARTING,
+	LOG_WRITER_RUNNING,
+	LOG_WRITER_STOPPED,     // IBȍ~ logputs() Œڏ
+};
+
+typedef struct {
+	volatile LONG seq;      // == ʒu: , == ʒu+1: ݍς
+	SYSTEMTIME time;
+	char *heap;             // LOG_RING_TEXT ɓȂbZ[W
+	char text[LOG_RING_TEXT];
+} log_entry_t;
+
+static log_entry_t log_ring[LOG_RING_SIZE];
+
+static struct {
+	volatile LONG state;    // LOG_WRITER_*
+	volatile LONG enqueue;  // ɒǉʒu
+	volatile LONG written;  // t@Cɏ񂾈ʒuB݃XbhXV
+	volatile LONG dropped;  // ̂ĂbZ[W̐
+	volatile LONG waiting;  // 1 ̂ƂA݃Xbh event ҂Ă
+	volatile LONG stop;
+	HANDLE event;
+	HANDLE thread;
+} log_writer;
+
+// t@CJ 1s(݃XbhĂȂƂ)
+static void logputs_direct(const char *msg)
 {
-	if (level <= pvar->settings.LogLevel) {
-		char *buf;
-		char *strtime;
-		int len;
-		int file;
-		BOOL enable_log = TRUE;
-		BOOL enable_outputdebugstring = FALSE;
-
-		strtime = mctimelocal("%Y-%m-%d %H:%M:%S.%NZ", TRUE);
-		len = asprintf(&buf, "%s [%lu] %s\n",
-					   strtime, GetCurrentProcessId(), msg);
-		free(strtime);
-
-		if (enable_log) {
-			wchar_t *fname = get_log_dir_relative_nameW(L"TTSSH.LOG");
-			file = _wopen(fname, _O_RDWR | _O_APPEND | _O_CREAT | _O_TEXT,
-						  _S_IREAD | _S_IWRITE);
-			free(fname);
-
-			if (file >= 0) {
-				_write(file, buf, len - 1);	// len includes '\0'
-				_close(file);
-			}
+	char *buf;
+	char *strtime;
+	int len;
+	int file;
+	BOOL enable_log = TRUE;
+	BOOL enable_outputdebugstring = FALSE;
+
+	strtime = mctimelocal("%Y-%m-%d %H:%M:%S.%NZ", TRUE);
+	len = asprintf(&buf, "%s [%lu] %s\n",
+				   strtime, GetCurrentProcessId(), msg);
+	free(strtime);
+
+	if (enable_log) {
+		wchar_t *fname = get_log_dir_relative_nameW(L"TTSSH.LOG");
+		file = _wopen(fname, _O_RDWR | _O_APPEND | _O_CREAT | _O_TEXT,
+					  _S_IREAD | _S_IWRITE);
+		free(fname);
+
+		if (file >= 0) {
+			_write(file, buf, len - 1);	// len includes '\0'
+			_close(file);
+		}
+	}
+
+	if (enable_outputdebugstring) {
+		OutputDebugStringA(buf);
+	}
+
+	free(buf);
+}
+
+static void log_writer_output(int *file, char *buf, size_t len)
+{
+	if (len == 0) {
+		return;
+	}
+	if (*file < 0) {
+		wchar_t *fname = get_log_dir_relative_nameW(L"TTSSH.LOG");
+		*file = _wopen(fname, _O_RDWR | _O_APPEND | _O_CREAT | _O_TEXT,
+					   _S_IREAD | _S_IWRITE);
+		free(fname);
+		if (*file < 0) {
+			// JȂΎ̂ĂB݂̏ŊJ
+			return;
 		}
+	}
+	_write(*file, buf, (unsigned int)len);
+}
+
+// 1s buf ɒǉBȂƂ͐ɏ
+static size_t log_writer_append(int *file, char *buf, size_t len, const SYSTEMTIME *t, const char *msg)
+{
+	char head[64];
+	size_t head_len, msg_len;
+
+	head_len = _snprintf_s(head, sizeof(head), _TRUNCATE, "%04d-%02d-%02d %02d:%02d:%02d.%03dZ [%lu] ",
+	                       t->wYear, t->wMonth, t->wDay, t->wHour, t->wMinute, t->wSecond, t->wMilliseconds,
+	                       GetCurrentProcessId());
+	msg_len = strlen(msg);
+
+	if (len + head_len + msg_len + 1 > LOG_WRITE_BUFSIZE) {
+		log_writer_output(file, buf, len);
+		len = 0;
+		if (head_len + msg_len + 1 > LOG_WRITE_BUFSIZE) {
+			// obt@蒷bZ[W͂̂܂܏
+			log_writer_output(file, head, head_len);
+			log_writer_output(file, (char *)msg, msg_len);
+			log_writer_output(file, "\n", 1);
+			return 0;
+		}
+	}
+	memcpy(buf + len, head, head_len);
+	len += head_len;
+	memcpy(buf + len, msg, msg_len);
+	len += msg_len;
+	buf[len++] = '\n';
+	return len;
+}
+
+// pos ǉς݂̃bZ[Wo buf ɒǉB̈ʒuԂ
+static LONG log_writer_take(LONG pos, int *file, char *buf, size_t *len)
+{
+	log_entry_t *e;
+
+	for (;;) {
+		e = &log_ring[pos & (LOG_RING_SIZE - 1)];
+		if (e->seq != pos + 1) {
+			return pos;
+		}
+		MemoryBarrier();
+		if (buf != NULL) {
+			*len = log_writer_append(file, buf, *len, &e->time, e->heap != NULL ? e->heap : e->text);
+		}
+		free(e->heap);
+		e->heap = NULL;
+		InterlockedExchange(&e->seq, pos + LOG_RING_SIZE);
+		pos++;
+	}
+}
+
+static unsigned __stdcall log_writer_thread(void *p)
+{
+	char *buf = malloc(LOG_WRITE_BUFSIZE);
+	size_t len = 0;
+	int file = -1;
+	LONG pos = 0;
+	LONG dropped;
+
+	(void)p;
+	for (;;) {
+		pos = log_writer_take(pos, &file, buf, &len);
+
+		// ̂ĂbZ[W΁A̐c
+		if (log_writer.dropped != 0 && buf != NULL) {
+			char msg[64];
+			SYSTEMTIME t;
+
+			dropped = InterlockedExchange(&log_writer.dropped, 0);
+			_snprintf_s(msg, sizeof(msg), _TRUNCATE, "%ld messages dropped", dropped);
+			GetSystemTime(&t);
+			len = log_writer_append(&file, buf, len, &t, msg);
+		}
+
+		// ôȂȂ珑
+		log_writer_output(&file, buf, len);
+		len = 0;
+		InterlockedExchange(&log_writer.written, pos);
+
+		if (log_writer.stop) {
+			break;
+		}
+
+		InterlockedExchange(&log_writer.waiting, 1);
+		if (log_ring[pos & (LOG_RING_SIZE - 1)].seq != pos + 1 && !log_writer.stop) {
+			WaitForSingleObject(log_writer.event, 1000);
+		}
+		InterlockedExchange(&log_writer.waiting, 0);
+	}
 
-		if (enable_outputdebugstring) {
-			OutputDebugStringA(buf);
+	if (file >= 0) {
+		_close(file);
+	}
+	free(buf);
+	return 0;
+}
+
+// ŏɃOo͂Ƃɏ݃XbhN
+static BOOL log_writer_start(void)
+{
+	LONG state;
+	unsigned int tid;
+	int i;
+
+	state = InterlockedCompareExchange(&log_writer.state, LOG_WRITER_STARTING, LOG_WRITER_NONE);
+	if (state != LOG_WRITER_NONE) {
+		// N(̃Xbh)܂͏Iς
+		return state == LOG_WRITER_RUNNING;
+	}
+
+	for (i = 0; i < LOG_RING_SIZE; i++) {
+		log_ring[i].seq = i;
+		log_ring[i].heap = NULL;
+	}
+	log_writer.enqueue = 0;
+	log_writer.written = 0;
+	log_writer.dropped = 0;
+	log_writer.waiting = 0;
+	log_writer.stop = 0;
+	log_writer.event = CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (log_writer.event != NULL) {
+		log_writer.thread = (HANDLE)_beginthreadex(NULL, 0, log_writer_thread, NULL, 0, &tid);
+	}
+	if (log_writer.event == NULL || log_writer.thread == 0) {
+		if (log_writer.event != NULL) {
+			CloseHandle(log_writer.event);
+			log_writer.event = NULL;
 		}
+		log_writer.thread = NULL;
+		InterlockedExchange(&log_writer.state, LOG_WRITER_STOPPED);
+		return FALSE;
+	}
+	InterlockedExchange(&log_writer.state, LOG_WRITER_RUNNING);
+	return TRUE;
+}
+
+// ݃XbhɎc܂ďIBTTXEnd() Ă
+static void log_writer_stop(void)
+{
+	char *buf;
+	size_t len = 0;
+	int file = -1;
+	LONG pos;
 
+	if (InterlockedCompareExchange(&log_writer.state, LOG_WRITER_STOPPED, LOG_WRITER_RUNNING) != LOG_WRITER_RUNNING) {
+		return;
+	}
+	InterlockedExchange(&log_writer.stop, 1);
+	SetEvent(log_writer.event);
+	WaitForSingleObject(log_writer.thread, INFINITE);
+	CloseHandle(log_writer.thread);
+	log_writer.thread = NULL;
+	// state ςO logputs() n߂Xbh SetEvent() 邩Ȃ̂ŁA
+	// event ͕Ȃ
+
+	// ݃XbhŌɎoɒǉꂽbZ[W
+	buf = malloc(LOG_WRITE_BUFSIZE);
+	pos = log_writer_take(log_writer.written, &file, buf, &len);
+	if (buf != NULL) {
+		log_writer_output(&file, buf, len);
 		free(buf);
 	}
+	if (file >= 0) {
+		_close(file);
+	}
+	InterlockedExchange(&log_writer.written, pos);
+}
+
+// Oobt@֒ǉBt̂Ƃ FALSE Ԃ
+static BOOL log_writer_enqueue(const char *msg, LONG *added)
+{
+	log_entry_t *e;
+	LONG pos = log_writer.enqueue;
+	LONG diff;
+	size_t len;
+
+	for (;;) {
+		e = &log_ring[pos & (LOG_RING_SIZE - 1)];
+		diff = (LONG)((ULONG)e->seq - (ULONG)pos);
+		if (diff == 0) {
+			LONG prev = InterlockedCompareExchange(&log_writer.enqueue, pos + 1, pos);
+			if (prev == pos) {
+				break;
+			}
+			pos = prev;
+		}
+		else if (diff < 0) {
+			// ݂ǂĂȂ
+			return FALSE;
+		}
+		else {
+			// ̃Xbhɒǉ
+			pos = log_writer.enqueue;
+		}
+	}
+	MemoryBarrier();
+
+	GetSystemTime(&e->time);
+	len = strlen(msg);
+	if (len < sizeof(e->text) || (e->heap = _strdup(msg)) == NULL) {
+		strncpy_s(e->text, sizeof(e->text), msg, _TRUNCATE);
+	}
+	InterlockedExchange(&e->seq, pos + 1);
+
+	if (log_writer.waiting) {
+		SetEvent(log_writer.event);
+	}
+	*added = pos;
+	return TRUE;
+}
+
+// pos ̃bZ[Wt@Cɏ܂܂ő҂(ő 1b)
+static void log_writer_flush(LONG pos)
+{
+	int i;
+
+	for (i = 0; i < 1000 && (LONG)((ULONG)log_writer.written - (ULONG)pos) <= 0; i++) {
+		SetEvent(log_writer.event);
+		Sleep(1);
+	}
+}
+
+void logputs(int level, char *msg)
+{
+	if (level <= pvar->settings.LogLevel) {
+		LONG pos;
+
+		if (log_writer.state != LOG_WRITER_RUNNING && !log_writer_start()) {
+			logputs_direct(msg);
+			return;
+		}
+		if (level > LOG_LEVEL_FATAL) {
+			if (!log_writer_enqueue(msg, &pos)) {
+				// ̂Ă͌ŏ݃XbhL^
+				InterlockedIncrement(&log_writer.dropped);
+			}
+			return;
+		}
+		// ɏI邩Ȃ̂ŁÂĂɏ݂҂
+		while (!log_writer_enqueue(msg, &pos)) {
+			if (log_writer.state != LOG_WRITER_RUNNING) {
+				logputs_direct(msg);
+				return;
+			}
+			SetEvent(log_writer.event);
+			Sleep(1);
+		}
+		log_writer_flush(pos);
+	}
 }
 
 #if defined(_MSC_VER)
@@ -3602,11 +3971,34 @@ __declspec(dllexport) int CALLBACK TTXScpSendingStatus(void)
 	return SSH_scp_sending_status();
 }
 
+// }NR}h"scpsendstatus"Ăяo߂ɁADLLOփGNX|[gB"ttxssh.def"t@CɋLځB
+__declspec(dllexport) int CALLBACK TTXScpSendingProgress(int *percent, int *rate, int *eta)
+{
+	return SSH_scp_sending_progress(percent, rate, eta);
+}
+
 __declspec(dllexport) int CALLBACK TTXScpReceivefile(char *remotefile, char *localfile)
 {
 	return SSH_scp_transaction(pvar, remotefile, localfile, FROMREMOTE);
 }
 
+// }NR}h"sftpget"/"sftpput"Ăяo߂ɁADLLOփGNX|[gB"ttxssh.def"t@CɋLځB
+__declspec(dllexport) int CALLBACK TTXSftpGetfile(char *remotefile, char *localfile)
+{
+	return SSH_sftp_transfer(pvar, localfile, remotefile, FROMREMOTE);
+}
+
+__declspec(dllexport) int CALLBACK TTXSftpPutfile(char *localfile, char *remotefile)
+{
+	return SSH_sftp_transfer(pvar, localfile, remotefile, TOREMOTE);
+}
+
+// }NR}h"sftpstatus"Ăяo߂ɁADLLOփGNX|[gB"ttxssh.def"t@CɋLځB
+__declspec(dllexport) int CALLBACK TTXSftpTransferStatus(int *done, int *failed)
+{
+	return SSH_sftp_transfer_status(done, failed);
+}
+
 
 /**
  * TTSSH̐ݒe(known hosts file)ԂB
@@ -5011,6 +5403,8 @@ static void PASCAL TTXEnd(void)
 		free(pvar->err_msg);
 		pvar->err_msg = NULL;
 	}
+
+	log_writer_stop();
 }
 
 /* This record contains all the information that the extension forwards to the
@@ -217,6 +217,23 @@ typedef struct _TS_SSH {
 	//   for publickey authentication (not for server hostkey)
 	//   for RSA key only
 	char RSAPubkeySignAlgorithmOrder[RSA_PUBKEY_SIGN_ALGO_MAX+1];
+
+	// SSH2 `l̎MEBhȄ (KB)
+	//   `l쐬̃EBhEȉȂ玩Ȃ
+	int ChannelWindowMax;
+
+	// SFTP get/put ŉ҂ɑ READ/WRITE v̐ƁA1ṽTCY (KB)
+	int SftpRequests;
+	int SftpBufferSize;
+
+	// SCPMŃt@Cւ܂Ƃ߂ďޒP (MB)
+	int ScpRecvBlockSize;
+	// SCPM̊JnɃt@CTCŸ̗mۂ
+	int ScpPreallocate;
+
+	// `l̃f[^܂Ƃ߂đƂɑ҂ő厞 (ms)
+	//   0 Ȃ܂Ƃ߂Ȃ
+	int SendCoalesceDelay;
 } TS_SSH;
 
 typedef struct _TInstVar {
@@ -35,7 +35,12 @@ See LICENSE.TXT for the license.
 #ifndef __UTIL_H
 #define __UTIL_H
 
+#if defined(TTXSSH_HEADLESS)
+// tools/bench_ssh (Linux, LP64) ł long  64bit ɂȂ邽
+typedef unsigned int uint32;
+#else
 typedef unsigned long uint32;
+#endif
 typedef unsigned short uint16;
 
 #define NUM_ELEM(a) (sizeof(a) / sizeof((a)[0]))